@@ -4655,6 +4655,12 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
 	RNA_def_property_enum_items(prop, solver_items);
 	RNA_def_property_ui_text(prop, "Physics Solver", "Physics constraint solver");
 
+	prop = RNA_def_property(srna, "use_physics_multithread", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_PHYSICS_MULTITHREAD);
+	RNA_def_property_ui_text(prop, "Multithreaded Physics",
+	                         "Integrate the rigid bodies and solve the simulation islands on several threads "
+	                         "(only with the sequential impulse solver for the islands)");
+
 	prop = RNA_def_property(srna, "occlusion_culling_resolution", PROP_INT, PROP_PIXEL);
 	RNA_def_property_int_sdna(prop, NULL, "occlusionRes");
 	RNA_def_property_range(prop, 128.0, 1024.0);
@@ -0,0 +1,296 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Profiler.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Profiler.h"
+#include "CM_Thread.h"
+#include "CM_Message.h"
+
+#include "PIL_time.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include <fstream>
+#include <algorithm>
+
+/// Number of scopes kept per thread, the oldest are overwritten.
+#define CM_PROFILER_BUFFER_SIZE (1 << 16)
+
+namespace {
+
+struct Event
+{
+	const char *m_name;
+	double m_start;
+	double m_end;
+	/// Value of a counter event, the value of a scope is negative.
+	double m_value;
+};
+
+/// Scopes of a thread, written only by this thread.
+struct ThreadBuffer
+{
+	unsigned int m_id;
+	/// Capture the events belong to.
+	unsigned int m_capture;
+	/// Number of events added, the last ones are in the ring.
+	std::atomic<unsigned int> m_count;
+	std::vector<Event> m_events;
+};
+
+std::atomic<bool> capturing(false);
+/// Number of events being recorded, the capture is written when none is left.
+std::atomic<unsigned int> recording(0);
+/// Incremented for each capture, the buffers of a previous capture are reset on their next event.
+std::atomic<unsigned int> captureId(0);
+std::string captureFilepath;
+unsigned int captureFrames = 0;
+double captureStart = 0.0;
+double frameStart = 0.0;
+/// Capture requested by StartCapture, started at the next frame boundary.
+bool startPending = false;
+std::string pendingFilepath;
+unsigned int pendingFrames = 0;
+
+/// All the thread buffers, kept until the end of the program as the threads can end before the capture.
+std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+CM_ThreadMutex buffersMutex;
+thread_local ThreadBuffer *threadBuffer = nullptr;
+
+std::unordered_set<std::string> names;
+CM_ThreadMutex namesMutex;
+
+ThreadBuffer *getThreadBuffer()
+{
+	if (!threadBuffer) {
+		buffersMutex.Lock();
+		ThreadBuffer *buffer = new ThreadBuffer();
+		buffer->m_id = buffers.size();
+		buffer->m_capture = captureId;
+		buffer->m_count = 0;
+		buffer->m_events.resize(CM_PROFILER_BUFFER_SIZE);
+		buffers.emplace_back(buffer);
+		buffersMutex.Unlock();
+
+		threadBuffer = buffer;
+	}
+
+	return threadBuffer;
+}
+
+void writeString(std::ofstream& file, const char *str)
+{
+	file << '"';
+	for (const char *c = str; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			file << '\\';
+		}
+		if ((unsigned char)*c >= 0x20) {
+			file << *c;
+		}
+	}
+	file << '"';
+}
+
+void writeCapture()
+{
+	std::ofstream file(captureFilepath);
+	if (!file) {
+		CM_Error("unable to write profile capture to \"" << captureFilepath << "\"");
+		return;
+	}
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	buffersMutex.Lock();
+	for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+		if (buffer->m_capture != captureId) {
+			continue;
+		}
+
+		const unsigned int count = buffer->m_count.load(std::memory_order_acquire);
+		if (count == 0) {
+			continue;
+		}
+
+		if (!first) {
+			file << ",";
+		}
+		first = false;
+
+		// The first thread recording events is the main thread.
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->m_id << ",\"args\":{\"name\":";
+		writeString(file, (buffer->m_id == 0) ? "Main" : ("Thread " + std::to_string(buffer->m_id)).c_str());
+		file << "}}";
+
+		const unsigned int size = std::min(count, (unsigned int)CM_PROFILER_BUFFER_SIZE);
+		for (unsigned int i = count - size; i < count; ++i) {
+			const Event& event = buffer->m_events[i % CM_PROFILER_BUFFER_SIZE];
+			file << ",{\"name\":";
+			writeString(file, event.m_name);
+			if (event.m_value < 0.0) {
+				file << ",\"cat\":\"bge\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->m_id
+				     << ",\"ts\":" << (long long)((event.m_start - captureStart) * 1e6)
+				     << ",\"dur\":" << (long long)((event.m_end - event.m_start) * 1e6) << "}";
+			}
+			else {
+				file << ",\"cat\":\"bge\",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->m_id
+				     << ",\"ts\":" << (long long)((event.m_start - captureStart) * 1e6)
+				     << ",\"args\":{\"value\":" << event.m_value << "}}";
+			}
+		}
+	}
+	buffersMutex.Unlock();
+
+	file << "]}" << std::endl;
+
+	CM_Message("profile capture written to \"" << captureFilepath << "\"");
+}
+
+void addEvent(const Event& event)
+{
+	/* Test again after the increment, the capture can be stopped and written since the test
+	 * of the caller. */
+	++recording;
+	if (!capturing) {
+		--recording;
+		return;
+	}
+
+	ThreadBuffer *buffer = getThreadBuffer();
+
+	const unsigned int capture = captureId.load(std::memory_order_relaxed);
+	if (buffer->m_capture != capture) {
+		buffer->m_capture = capture;
+		buffer->m_count.store(0, std::memory_order_relaxed);
+	}
+
+	const unsigned int index = buffer->m_count.load(std::memory_order_relaxed);
+	buffer->m_events[index % CM_PROFILER_BUFFER_SIZE] = event;
+	buffer->m_count.store(index + 1, std::memory_order_release);
+
+	--recording;
+}
+
+}
+
+bool CM_Profiler::IsCapturing()
+{
+	return capturing.load(std::memory_order_relaxed);
+}
+
+double CM_Profiler::GetTime()
+{
+	return PIL_check_seconds_timer();
+}
+
+const char *CM_Profiler::InternName(const std::string& name)
+{
+	namesMutex.Lock();
+	const char *str = names.insert(name).first->c_str();
+	namesMutex.Unlock();
+
+	return str;
+}
+
+void CM_Profiler::ClearNames()
+{
+	namesMutex.Lock();
+	names.clear();
+	namesMutex.Unlock();
+}
+
+void CM_Profiler::AddEvent(const char *name, double start, double end)
+{
+	// A scope begun during the capture can end after, when the buffers are written.
+	if (!IsCapturing()) {
+		return;
+	}
+
+	addEvent({name, start, end, -1.0});
+}
+
+void CM_Profiler::AddCounter(const char *name, double value)
+{
+	if (!IsCapturing()) {
+		return;
+	}
+
+	const double time = GetTime();
+	addEvent({name, time, time, std::max(value, 0.0)});
+}
+
+void CM_Profiler::StartCapture(const std::string& filepath, unsigned int frames)
+{
+	// Register the main thread first.
+	getThreadBuffer();
+
+	pendingFilepath = filepath;
+	pendingFrames = std::max(frames, 1u);
+	startPending = true;
+}
+
+void CM_Profiler::NextFrame()
+{
+	const double now = GetTime();
+
+	if (IsCapturing()) {
+		AddEvent("Frame", frameStart, now);
+		frameStart = now;
+
+		// A new capture replaces the running one.
+		if (--captureFrames == 0 || startPending) {
+			StopCapture();
+		}
+	}
+
+	if (startPending) {
+		startPending = false;
+		captureFilepath = pendingFilepath;
+		captureFrames = pendingFrames;
+		captureStart = frameStart = now;
+		++captureId;
+		capturing = true;
+	}
+}
+
+void CM_Profiler::StopCapture()
+{
+	if (!IsCapturing()) {
+		return;
+	}
+
+	capturing = false;
+	// Wait for the events recorded by the other threads, their ring can't be written concurrently.
+	while (recording != 0) {
+		std::this_thread::yield();
+	}
+
+	writeCapture();
+}
@@ -0,0 +1,104 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Profiler.h
+ *  \ingroup common
+ */
+
+#ifndef __CM_PROFILER_H__
+#define __CM_PROFILER_H__
+
+#include <string>
+
+/** Frame capture of named and nested time scopes, exported to the Chrome trace event format
+ * (chrome://tracing). Each thread records its scopes in its own ring buffer without locking,
+ * the scopes cost only a test of the capture state when no capture is running.
+ */
+class CM_Profiler
+{
+public:
+	/// Return true if a capture is running.
+	static bool IsCapturing();
+	/// Return the time in seconds of the capture clock.
+	static double GetTime();
+	/** Return a name valid until ClearNames for a temporary string,
+	 * used for the names of the scenes, objects or logic bricks.
+	 */
+	static const char *InternName(const std::string& name);
+	/// Free the interned names, no scope must be running, e.g at the engine exit.
+	static void ClearNames();
+	/// Record a scope of the current thread.
+	static void AddEvent(const char *name, double start, double end);
+	/// Record the value of a counter at the current time, e.g. a number of objects.
+	static void AddCounter(const char *name, double value);
+
+	/** Start a capture of several frames, the capture is written once the frames are done.
+	 * The capture begins at the next frame boundary, a running capture is written there.
+	 * \param filepath The trace file path.
+	 * \param frames The number of frames to capture.
+	 */
+	static void StartCapture(const std::string& filepath, unsigned int frames);
+	/// Mark the end of a frame, finish the capture after the last requested frame.
+	static void NextFrame();
+	/** Stop the running capture and write it. The recording is stopped first, the capture
+	 * is written once the events being recorded by the other threads are complete.
+	 */
+	static void StopCapture();
+};
+
+/// Record the time spent between the construction and the destruction.
+class CM_ProfileScope
+{
+private:
+	const char *m_name;
+	double m_start;
+
+public:
+	/// \param name A name valid until the end of the capture, usually a literal.
+	CM_ProfileScope(const char *name)
+		:m_name(nullptr)
+	{
+		if (CM_Profiler::IsCapturing()) {
+			m_name = name;
+			m_start = CM_Profiler::GetTime();
+		}
+	}
+
+	/// \param name A temporary name, copied only during a capture.
+	CM_ProfileScope(const std::string& name)
+		:m_name(nullptr)
+	{
+		if (CM_Profiler::IsCapturing()) {
+			m_name = CM_Profiler::InternName(name);
+			m_start = CM_Profiler::GetTime();
+		}
+	}
+
+	~CM_ProfileScope()
+	{
+		if (m_name) {
+			CM_Profiler::AddEvent(m_name, m_start, CM_Profiler::GetTime());
+		}
+	}
+};
+
+#endif  // __CM_PROFILER_H__
@@ -0,0 +1,142 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Sort.h
+ *  \ingroup common
+ */
+
+#ifndef __CM_SORT_H__
+#define __CM_SORT_H__
+
+#include <vector>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+
+/// Average number of moves per item allowed to the insertion sort before using a radix sort.
+#define CM_SORT_MAX_MOVES_PER_ITEM 8
+
+/** Sort items by increasing float key with an insertion sort. This is linear
+ * when the items are almost sorted, e.g. when they are in the order of the previous frame.
+ * \param maxMoves The maximum number of item moves allowed.
+ * \return False if the sort was stopped because it needed more moves,
+ * the items are then in an arbitrary order.
+ */
+template <class Item, class KeyFunc>
+bool CM_InsertionSort(std::vector<Item>& items, KeyFunc key, unsigned int maxMoves)
+{
+	unsigned int moves = 0;
+	for (unsigned int i = 1, size = items.size(); i < size; ++i) {
+		const float itemKey = key(items[i]);
+		if (!(itemKey < key(items[i - 1]))) {
+			continue;
+		}
+
+		const Item item = items[i];
+		unsigned int j = i;
+		do {
+			items[j] = items[j - 1];
+			--j;
+			if (++moves > maxMoves) {
+				items[j] = item;
+				return false;
+			}
+		} while (j > 0 && itemKey < key(items[j - 1]));
+		items[j] = item;
+	}
+
+	return true;
+}
+
+/// Convert a float to an unsigned integer with the same ordering.
+inline uint32_t CM_SortableFloatBits(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+/** Sort items by increasing float key with a stable LSD radix sort.
+ * \param scratch A buffer reused between the calls to avoid allocations.
+ */
+template <class Item, class KeyFunc>
+void CM_RadixSort(std::vector<Item>& items, std::vector<Item>& scratch, KeyFunc key)
+{
+	const unsigned int size = items.size();
+	if (size < 2) {
+		return;
+	}
+	scratch.resize(size);
+
+	unsigned int histograms[4][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (const Item& item : items) {
+		const uint32_t bits = CM_SortableFloatBits(key(item));
+		for (unsigned short pass = 0; pass < 4; ++pass) {
+			++histograms[pass][(bits >> (pass * 8)) & 0xFF];
+		}
+	}
+
+	std::vector<Item> *source = &items;
+	std::vector<Item> *dest = &scratch;
+	for (unsigned short pass = 0; pass < 4; ++pass) {
+		unsigned int *histogram = histograms[pass];
+		const unsigned int shift = pass * 8;
+
+		// All the items have the same digit, nothing to sort.
+		if (histogram[(CM_SortableFloatBits(key((*source)[0])) >> shift) & 0xFF] == size) {
+			continue;
+		}
+
+		unsigned int offset = 0;
+		for (unsigned short digit = 0; digit < 256; ++digit) {
+			const unsigned int count = histogram[digit];
+			histogram[digit] = offset;
+			offset += count;
+		}
+
+		for (const Item& item : *source) {
+			(*dest)[histogram[(CM_SortableFloatBits(key(item)) >> shift) & 0xFF]++] = item;
+		}
+		std::swap(source, dest);
+	}
+
+	if (source != &items) {
+		items.swap(scratch);
+	}
+}
+
+/** Sort items by increasing float key, reusing the previous order of the items.
+ * An insertion sort is tried first and a radix sort is used if the items
+ * were too far from their sorted order.
+ */
+template <class Item, class KeyFunc>
+void CM_CoherentSort(std::vector<Item>& items, std::vector<Item>& scratch, KeyFunc key)
+{
+	if (items.size() < 2) {
+		return;
+	}
+
+	if (!CM_InsertionSort(items, key, items.size() * CM_SORT_MAX_MOVES_PER_ITEM)) {
+		CM_RadixSort(items, scratch, key);
+	}
+}
+
+#endif  // __CM_SORT_H__
@@ -59,6 +59,8 @@ extern "C" {
 
 #include "MT_Matrix4x4.h"
 
+#include <atomic>
+
 #include "CM_Message.h"
 
 /**
@@ -202,6 +204,13 @@ static void game_blend_poses(bPose *dst, bPose *src, float srcweight, short mode
 	dst->ctime = src->ctime;
 }
 
+/// Return a new pose phase, the armatures can be created by the asynchronous library loading.
+static unsigned int new_pose_phase()
+{
+	static std::atomic<unsigned int> counter(0);
+	return counter++;
+}
+
 BL_ArmatureObject::BL_ArmatureObject(void *sgReplicationInfo,
                                      SG_Callbacks callbacks,
                                      Object *armature,
@@ -210,7 +219,8 @@ BL_ArmatureObject::BL_ArmatureObject(void *sgReplicationInfo,
 	m_scene(scene),
 	m_lastframe(0.0),
 	m_drawDebug(false),
-	m_lastapplyframe(0.0)
+	m_lastapplyframe(0.0),
+	m_posePhase(new_pose_phase())
 {
 	m_controlledConstraints = new EXP_ListValue<BL_ArmatureConstraint>();
 	m_poseChannels = new EXP_ListValue<BL_ArmatureChannel>();
@@ -386,6 +396,8 @@ void BL_ArmatureObject::ProcessReplica()
 	bArmature *tmp = (bArmature *)m_objArma->data;
 	m_objArma = BKE_object_copy(G.main, m_objArma);
 	m_objArma->data = BKE_armature_copy(G.main, tmp);
+
+	m_posePhase = new_pose_phase();
 }
 
 int BL_ArmatureObject::GetGameObjectType() const
@@ -508,6 +520,11 @@ double BL_ArmatureObject::GetLastFrame()
 	return m_lastframe;
 }
 
+unsigned int BL_ArmatureObject::GetPosePhase() const
+{
+	return m_posePhase;
+}
+
 bool BL_ArmatureObject::GetBoneMatrix(Bone *bone, MT_Matrix4x4& matrix)
 {
 	ApplyPose();
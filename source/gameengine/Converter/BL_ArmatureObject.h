@@ -68,6 +68,9 @@ protected:
 
 	double m_lastapplyframe;
 
+	/// Unique number of the armature, spreads the pose evaluations skipped by the animation scheduler.
+	unsigned int m_posePhase;
+
 public:
 	BL_ArmatureObject(void *sgReplicationInfo,
 	                  SG_Callbacks callbacks,
@@ -83,6 +86,7 @@ public:
 	virtual bool UnlinkObject(SCA_IObject *clientobj);
 
 	double GetLastFrame();
+	unsigned int GetPosePhase() const;
 
 	void GetPose(bPose **pose) const;
 	/// Never edit this, only for accessing names.
@@ -43,6 +43,7 @@
 #include "KX_PythonInit.h" // So we can handle adding new text datablocks for Python to import
 #include "KX_LibLoadStatus.h"
 #include "BL_BlenderScalarInterpolator.h"
+#include "BL_CompiledAction.h"
 #include "BL_BlenderConverter.h"
 #include "BL_BlenderSceneConverter.h"
 #include "BL_BlenderDataConversion.h"
@@ -84,7 +85,13 @@ extern "C" {
 #include "BLI_task.h"
 #include "CM_Message.h"
 
+#include "PIL_time.h"
+
 #include <cstring>
+#include <limits>
+
+/// Default time in seconds spent merging the streamed libloads per logic frame.
+#define BL_STREAM_DEFAULT_BUDGET 0.005
 
 BL_BlenderConverter::SceneSlot::SceneSlot() = default;
 
@@ -106,7 +113,11 @@ void BL_BlenderConverter::SceneSlot::Merge(BL_BlenderConverter::SceneSlot& other
 	m_meshobjects.insert(m_meshobjects.begin(),
 						 std::make_move_iterator(other.m_meshobjects.begin()),
 						 std::make_move_iterator(other.m_meshobjects.end()));
+	m_compiledActions.insert(m_compiledActions.begin(),
+							 std::make_move_iterator(other.m_compiledActions.begin()),
+							 std::make_move_iterator(other.m_compiledActions.end()));
 	m_actionToInterp.insert(other.m_actionToInterp.begin(), other.m_actionToInterp.end());
+	m_actionToCompiled.insert(other.m_actionToCompiled.begin(), other.m_actionToCompiled.end());
 }
 
 void BL_BlenderConverter::SceneSlot::Merge(const BL_BlenderSceneConverter& converter)
@@ -119,8 +130,18 @@ void BL_BlenderConverter::SceneSlot::Merge(const BL_BlenderSceneConverter& conve
 	}
 }
 
+BL_BlenderConverter::StreamedScene::StreamedScene(KX_LibLoadStatus *status, BL_BlenderSceneConverter&& converter)
+	:m_status(status),
+	m_converter(std::move(converter)),
+	m_objectsMerged(false),
+	m_initializedMaterials(0)
+{
+}
+
 BL_BlenderConverter::BL_BlenderConverter(Main *maggie, KX_KetsjiEngine *engine)
-	:m_maggie(maggie),
+	:m_streamBudget(BL_STREAM_DEFAULT_BUDGET),
+	m_actionBakeRate(0.0f),
+	m_maggie(maggie),
 	m_ketsjiEngine(engine),
 	m_alwaysUseExpandFraming(false)
 {
@@ -227,7 +248,12 @@ void BL_BlenderConverter::ConvertScene(BL_BlenderSceneConverter& converter, bool
 		m_alwaysUseExpandFraming,
 		libloading);
 
+	// The decoded meshes are only used by the conversion.
+	converter.ReleaseDerivedMeshes();
+
+	m_threadinfo.m_mutex.Lock();
 	m_sceneSlots.emplace(scene, converter);
+	m_threadinfo.m_mutex.Unlock();
 }
 
 void BL_BlenderConverter::InitSceneShaders(const BL_BlenderSceneConverter& converter, KX_Scene *mergeScene)
@@ -243,6 +269,9 @@ void BL_BlenderConverter::InitSceneShaders(const BL_BlenderSceneConverter& conve
 
 void BL_BlenderConverter::RemoveScene(KX_Scene *scene)
 {
+	// The libraries loading in this scene are merged before it is freed.
+	FinishSceneLoads(scene);
+
 	KX_WorldInfo *world = scene->GetWorldInfo();
 	if (world) {
 		delete world;
@@ -256,13 +285,21 @@ void BL_BlenderConverter::RemoveScene(KX_Scene *scene)
 	 * e.g the display array bucket owned by the meshes and needed to be unregistered
 	 * from the bucket manager in the scene.
 	 */
-	SceneSlot& sceneSlot = m_sceneSlots[scene];
+	m_threadinfo.m_mutex.Lock();
+	std::map<KX_Scene *, SceneSlot>::iterator it = m_sceneSlots.find(scene);
+	/* Move the slot out of the map, the meshes are freed and the scene released
+	 * without holding the lock. */
+	SceneSlot sceneSlot;
+	if (it != m_sceneSlots.end()) {
+		sceneSlot.Merge(it->second);
+		m_sceneSlots.erase(it);
+	}
+	m_threadinfo.m_mutex.Unlock();
+
 	sceneSlot.m_meshobjects.clear();
 
 	// Delete the scene.
 	scene->Release();
-
-	m_sceneSlots.erase(scene);
 }
 
 void BL_BlenderConverter::SetAlwaysUseExpandFraming(bool to_what)
@@ -272,14 +309,64 @@ void BL_BlenderConverter::SetAlwaysUseExpandFraming(bool to_what)
 
 void BL_BlenderConverter::RegisterInterpolatorList(KX_Scene *scene, BL_InterpolatorList *interpolator, bAction *for_act)
 {
+	m_threadinfo.m_mutex.Lock();
 	SceneSlot& sceneSlot = m_sceneSlots[scene];
 	sceneSlot.m_interpolators.emplace_back(interpolator);
 	sceneSlot.m_actionToInterp[for_act] = interpolator;
+	m_threadinfo.m_mutex.Unlock();
 }
 
 BL_InterpolatorList *BL_BlenderConverter::FindInterpolatorList(KX_Scene *scene, bAction *for_act)
 {
-	return m_sceneSlots[scene].m_actionToInterp[for_act];
+	BL_InterpolatorList *interpolator = nullptr;
+
+	m_threadinfo.m_mutex.Lock();
+	std::map<KX_Scene *, SceneSlot>::const_iterator sit = m_sceneSlots.find(scene);
+	if (sit != m_sceneSlots.end()) {
+		std::map<bAction *, BL_InterpolatorList *>::const_iterator it = sit->second.m_actionToInterp.find(for_act);
+		if (it != sit->second.m_actionToInterp.end()) {
+			interpolator = it->second;
+		}
+	}
+	m_threadinfo.m_mutex.Unlock();
+
+	return interpolator;
+}
+
+void BL_BlenderConverter::RegisterCompiledAction(KX_Scene *scene, BL_CompiledAction *compiled, bAction *for_act)
+{
+	m_threadinfo.m_mutex.Lock();
+	SceneSlot& sceneSlot = m_sceneSlots[scene];
+	sceneSlot.m_compiledActions.emplace_back(compiled);
+	sceneSlot.m_actionToCompiled[for_act] = compiled;
+	m_threadinfo.m_mutex.Unlock();
+}
+
+BL_CompiledAction *BL_BlenderConverter::FindCompiledAction(KX_Scene *scene, bAction *for_act)
+{
+	BL_CompiledAction *compiled = nullptr;
+
+	m_threadinfo.m_mutex.Lock();
+	std::map<KX_Scene *, SceneSlot>::const_iterator sit = m_sceneSlots.find(scene);
+	if (sit != m_sceneSlots.end()) {
+		std::map<bAction *, BL_CompiledAction *>::const_iterator it = sit->second.m_actionToCompiled.find(for_act);
+		if (it != sit->second.m_actionToCompiled.end()) {
+			compiled = it->second;
+		}
+	}
+	m_threadinfo.m_mutex.Unlock();
+
+	return compiled;
+}
+
+float BL_BlenderConverter::GetActionBakeRate() const
+{
+	return m_actionBakeRate;
+}
+
+void BL_BlenderConverter::SetActionBakeRate(float rate)
+{
+	m_actionBakeRate = rate;
 }
 
 Main *BL_BlenderConverter::CreateMainDynamic(const std::string& path)
@@ -309,9 +396,14 @@ Main *BL_BlenderConverter::GetMainDynamicPath(const std::string& path) const
 
 void BL_BlenderConverter::MergeAsyncLoads()
 {
+	/* The queue is taken under the lock and merged without it as the merge
+	 * locks again to access the scene slots. */
+	std::vector<KX_LibLoadStatus *> mergequeue;
 	m_threadinfo.m_mutex.Lock();
+	mergequeue.swap(m_mergequeue);
+	m_threadinfo.m_mutex.Unlock();
 
-	for (KX_LibLoadStatus *libload : m_mergequeue) {
+	for (KX_LibLoadStatus *libload : mergequeue) {
 		KX_Scene *mergeScene = libload->GetMergeScene();
 		for (const BL_BlenderSceneConverter& converter : libload->GetSceneConverters()) {
 			KX_Scene *scene = converter.GetScene();
@@ -324,9 +416,7 @@ void BL_BlenderConverter::MergeAsyncLoads()
 		libload->Finish();
 	}
 
-	m_mergequeue.clear();
-
-	m_threadinfo.m_mutex.Unlock();
+	MergeStreamedScenes(m_streamBudget);
 }
 
 void BL_BlenderConverter::FinalizeAsyncLoads()
@@ -335,6 +425,7 @@ void BL_BlenderConverter::FinalizeAsyncLoads()
 	BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
 	// Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
 	MergeAsyncLoads();
+	MergeStreamedScenes(std::numeric_limits<double>::infinity());
 }
 
 void BL_BlenderConverter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
@@ -344,6 +435,132 @@ void BL_BlenderConverter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
 	m_threadinfo.m_mutex.Unlock();
 }
 
+void BL_BlenderConverter::AddSceneToStreamQueue(KX_LibLoadStatus *status, BL_BlenderSceneConverter&& converter)
+{
+	m_threadinfo.m_mutex.Lock();
+	m_streamqueue.emplace_back(status, std::move(converter));
+	// We'll call conversion 90% and merging 10% for now.
+	status->AddProgress((1.0f / status->GetBlenderScenes().size()) * 0.9f);
+	m_threadinfo.m_mutex.Unlock();
+}
+
+double BL_BlenderConverter::GetStreamBudget() const
+{
+	return m_streamBudget;
+}
+
+void BL_BlenderConverter::SetStreamBudget(double budget)
+{
+	m_streamBudget = budget;
+}
+
+bool BL_BlenderConverter::MergeStreamedSceneStep(StreamedScene& streamed)
+{
+	KX_LibLoadStatus *status = streamed.m_status;
+	KX_Scene *mergeScene = status->GetMergeScene();
+	KX_Scene *scene = streamed.m_converter.GetScene();
+	const std::vector<KX_BlenderMaterial *>& materials = streamed.m_converter.m_materials;
+	// One step to merge the objects, one per material and one to merge the buckets.
+	const float stepProgress = (1.0f / status->GetBlenderScenes().size()) * 0.1f / (materials.size() + 2);
+
+	bool merged = false;
+	if (!streamed.m_objectsMerged) {
+		/* The buckets are kept in the converted scene until all the materials
+		 * are initialized, the objects are then not rendered with invalid shaders. */
+		mergeScene->MergeScene(scene, false);
+		MergeSceneSlot(mergeScene, scene);
+
+		delete scene->GetWorldInfo();
+		scene->SetWorldInfo(nullptr);
+
+		streamed.m_objectsMerged = true;
+	}
+	else if (streamed.m_initializedMaterials < materials.size()) {
+		// Do this after lights are available so materials can use the lights in shaders.
+		materials[streamed.m_initializedMaterials++]->InitScene(mergeScene);
+	}
+	else {
+		// Generate the attribute layers of the converted scene only.
+		scene->GetBucketManager()->GenerateAttribLayers();
+		mergeScene->MergeSceneBuckets(scene);
+		delete scene;
+
+		merged = true;
+	}
+
+	m_threadinfo.m_mutex.Lock();
+	status->AddProgress(stepProgress);
+	m_threadinfo.m_mutex.Unlock();
+
+	return merged;
+}
+
+void BL_BlenderConverter::MergeStreamedScenes(double budget)
+{
+	m_threadinfo.m_mutex.Lock();
+	m_streammerges.splice(m_streammerges.end(), m_streamqueue);
+	m_threadinfo.m_mutex.Unlock();
+
+	const double endtime = PIL_check_seconds_timer() + budget;
+
+	// At least one step is done per call to always progress.
+	while (!m_streammerges.empty()) {
+		StreamedScene& streamed = m_streammerges.front();
+		if (MergeStreamedSceneStep(streamed)) {
+			KX_LibLoadStatus *status = streamed.m_status;
+			m_streammerges.pop_front();
+
+			if (status->AddMergedScene()) {
+				status->Finish();
+			}
+		}
+
+		if (PIL_check_seconds_timer() > endtime) {
+			break;
+		}
+	}
+}
+
+void BL_BlenderConverter::FinishSceneLoads(KX_Scene *scene)
+{
+	bool loading = false;
+	m_threadinfo.m_mutex.Lock();
+	for (const std::pair<const std::string, KX_LibLoadStatus *>& pair : m_status_map) {
+		KX_LibLoadStatus *status = pair.second;
+		if (status->GetMergeScene() == scene && !status->IsFinished()) {
+			loading = true;
+			break;
+		}
+	}
+	m_threadinfo.m_mutex.Unlock();
+
+	if (!loading) {
+		return;
+	}
+
+	// The conversion tasks can't be waited separately.
+	BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
+	MergeAsyncLoads();
+
+	/* Merge completely the streamed scenes of this scene, the other scenes
+	 * keep their budget. */
+	for (std::list<StreamedScene>::iterator it = m_streammerges.begin(); it != m_streammerges.end();) {
+		KX_LibLoadStatus *status = it->m_status;
+		if (status->GetMergeScene() != scene) {
+			++it;
+			continue;
+		}
+
+		while (!MergeStreamedSceneStep(*it)) {
+		}
+		it = m_streammerges.erase(it);
+
+		if (status->AddMergedScene()) {
+			status->Finish();
+		}
+	}
+}
+
 static void async_convert(TaskPool *pool, void *ptr, int UNUSED(threadid))
 {
 	KX_LibLoadStatus *status = static_cast<KX_LibLoadStatus *>(ptr);
@@ -366,6 +583,30 @@ static void async_convert(TaskPool *pool, void *ptr, int UNUSED(threadid))
 	status->GetConverter()->AddScenesToMergeQueue(status);
 }
 
+static void async_stream_convert(TaskPool *pool, void *ptr, int UNUSED(threadid))
+{
+	KX_LibLoadStatus *status = static_cast<KX_LibLoadStatus *>(ptr);
+	KX_KetsjiEngine *engine = status->GetEngine();
+	BL_BlenderConverter *converter = status->GetConverter();
+
+	/* The status can be freed once the last scene is merged,
+	 * don't access to its scene list after. */
+	const std::vector<Scene *> blenderScenes = status->GetBlenderScenes();
+
+	/* Each scene is queued once converted, the first scenes are then merged
+	 * while the next ones are converting. */
+	for (Scene *blenderScene : blenderScenes) {
+		KX_Scene *scene = engine->CreateScene(blenderScene);
+
+		BL_BlenderSceneConverter sceneConverter(scene);
+		// Decode the meshes in parallel before the objects conversion.
+		BL_DecodeSceneMeshes(blenderScene, sceneConverter);
+		converter->ConvertScene(sceneConverter, true);
+
+		converter->AddSceneToStreamQueue(status, std::move(sceneConverter));
+	}
+}
+
 KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFileMemory(void *data, int length, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options)
 {
 	BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(data, length);
@@ -416,7 +657,19 @@ KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib, c
 		return nullptr;
 	}
 
-	if (GetMainDynamicPath(path)) {
+	Main *main_loaded = GetMainDynamicPath(path);
+	if (main_loaded && (options & LIB_LOAD_STREAM) && idcode == ID_SCE) {
+		/* A streamed library already loaded in the same scene is reused
+		 * instead of failing, its status is returned without any conversion. */
+		std::map<std::string, KX_LibLoadStatus *>::const_iterator it = m_status_map.find(main_loaded->name);
+		KX_LibLoadStatus *loadedStatus = (it != m_status_map.end()) ? it->second : nullptr;
+		if (loadedStatus && loadedStatus->GetMergeScene() == scene_merge && !loadedStatus->GetBlenderScenes().empty()) {
+			BLO_blendhandle_close(bpy_openlib);
+			return loadedStatus;
+		}
+	}
+
+	if (main_loaded) {
 		snprintf(err_local, sizeof(err_local), "blend file already open \"%s\"\n", path);
 		*err_str = err_local;
 		BLO_blendhandle_close(bpy_openlib);
@@ -466,6 +719,14 @@ KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib, c
 		ID *mesh;
 
 		BL_BlenderSceneConverter sceneConverter(scene_merge);
+
+		// Decode all the meshes in parallel before their conversion.
+		std::vector<Mesh *> meshes;
+		for (mesh = (ID *)main_newlib->mesh.first; mesh; mesh = (ID *)mesh->next) {
+			meshes.push_back((Mesh *)mesh);
+		}
+		BL_DecodeMeshes(meshes, sceneConverter);
+
 		for (mesh = (ID *)main_newlib->mesh.first; mesh; mesh = (ID *)mesh->next) {
 			if (options & LIB_LOAD_VERBOSE) {
 				CM_Debug("mesh name: " << mesh->name + 2);
@@ -476,7 +737,10 @@ KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib, c
 
 		// Finalize material and mesh conversion.
 		InitSceneShaders(sceneConverter, scene_merge);
+
+		m_threadinfo.m_mutex.Lock();
 		m_sceneSlots[scene_merge].Merge(sceneConverter);
+		m_threadinfo.m_mutex.Unlock();
 	}
 	else if (idcode == ID_AC) {
 		// Convert all actions
@@ -504,7 +768,12 @@ KX_LibLoadStatus *BL_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib, c
 			}
 
 			status->SetBlenderScenes(blenderScenes);
-			BLI_task_pool_push(m_threadinfo.m_pool, async_convert, (void *)status, false, TASK_PRIORITY_LOW);
+			if ((options & LIB_LOAD_STREAM) && !blenderScenes.empty()) {
+				BLI_task_pool_push(m_threadinfo.m_pool, async_stream_convert, (void *)status, false, TASK_PRIORITY_LOW);
+			}
+			else {
+				BLI_task_pool_push(m_threadinfo.m_pool, async_convert, (void *)status, false, TASK_PRIORITY_LOW);
+			}
 		}
 		else {
 			for (Scene *scene = (Scene *)main_newlib->scene.first; scene; scene = (Scene *)scene->id.next) {
@@ -564,9 +833,10 @@ bool BL_BlenderConverter::FreeBlendFile(Main *maggie)
 	}
 
 	// If the given library is currently in loading, we do nothing.
-	if (m_status_map.count(maggie->name)) {
+	std::map<std::string, KX_LibLoadStatus *>::iterator statusIt = m_status_map.find(maggie->name);
+	if (statusIt != m_status_map.end() && statusIt->second) {
 		m_threadinfo.m_mutex.Lock();
-		const bool finished = m_status_map[maggie->name]->IsFinished();
+		const bool finished = statusIt->second->IsFinished();
 		m_threadinfo.m_mutex.Unlock();
 
 		if (!finished) {
@@ -596,7 +866,9 @@ bool BL_BlenderConverter::FreeBlendFile(Main *maggie)
 		KX_Scene *scene = scenes->GetValue(sce_idx);
 		if (IS_TAGGED(scene->GetBlenderScene())) {
 			m_ketsjiEngine->RemoveScene(scene->GetName());
+			m_threadinfo.m_mutex.Lock();
 			m_sceneSlots.erase(scene);
+			m_threadinfo.m_mutex.Unlock();
 			sce_idx--;
 			numScenes--;
 		}
@@ -682,6 +954,10 @@ bool BL_BlenderConverter::FreeBlendFile(Main *maggie)
 		}
 	}
 
+	/* The slots are only erased by the main thread, but the conversion tasks
+	 * can insert new slots while they are iterated. */
+	m_threadinfo.m_mutex.Lock();
+
 	for (std::map<KX_Scene *, SceneSlot>::iterator sit = m_sceneSlots.begin(), send = m_sceneSlots.end(); sit != send; ++sit) {
 		KX_Scene *scene = sit->first;
 		SceneSlot& sceneSlot = sit->second;
@@ -719,16 +995,31 @@ bool BL_BlenderConverter::FreeBlendFile(Main *maggie)
 				++it;
 			}
 		}
+
+		for (UniquePtrList<BL_CompiledAction>::iterator it = sceneSlot.m_compiledActions.begin(); it != sceneSlot.m_compiledActions.end(); ) {
+			bAction *action = (*it)->GetAction();
+			if (IS_TAGGED(action)) {
+				sceneSlot.m_actionToCompiled.erase(action);
+				it = sceneSlot.m_compiledActions.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
 	}
 
+	m_threadinfo.m_mutex.Unlock();
+
 #ifdef WITH_PYTHON
 	/* make sure this maggie is removed from the import list if it's there
 	 * (this operation is safe if it isn't in the list) */
 	removeImportMain(maggie);
 #endif
 
-	delete m_status_map[maggie->name];
-	m_status_map.erase(maggie->name);
+	if (statusIt != m_status_map.end()) {
+		delete statusIt->second;
+		m_status_map.erase(statusIt);
+	}
 
 	BKE_main_free(maggie);
 
@@ -740,12 +1031,22 @@ bool BL_BlenderConverter::FreeBlendFile(const std::string& path)
 	return FreeBlendFile(GetMainDynamicPath(path));
 }
 
+void BL_BlenderConverter::MergeSceneSlot(KX_Scene *to, KX_Scene *from)
+{
+	m_threadinfo.m_mutex.Lock();
+	std::map<KX_Scene *, SceneSlot>::iterator it = m_sceneSlots.find(from);
+	if (it != m_sceneSlots.end()) {
+		m_sceneSlots[to].Merge(it->second);
+		m_sceneSlots.erase(it);
+	}
+	m_threadinfo.m_mutex.Unlock();
+}
+
 void BL_BlenderConverter::MergeScene(KX_Scene *to, KX_Scene *from)
 {
-	to->MergeScene(from);
+	to->MergeScene(from, true);
 
-	m_sceneSlots[to].Merge(m_sceneSlots[from]);
-	m_sceneSlots.erase(from);
+	MergeSceneSlot(to, from);
 
 	// Delete from scene's world info.
 	delete from->GetWorldInfo();
@@ -834,7 +1135,10 @@ RAS_MeshObject *BL_BlenderConverter::ConvertMeshSpecial(KX_Scene *kx_scene, Main
 
 	// Finalize material and mesh conversion.
 	InitSceneShaders(sceneConverter, kx_scene);
+
+	m_threadinfo.m_mutex.Lock();
 	m_sceneSlots[kx_scene].Merge(sceneConverter);
+	m_threadinfo.m_mutex.Unlock();
 
 	return meshobj;
 }
@@ -848,6 +1152,8 @@ void BL_BlenderConverter::PrintStats()
 	unsigned int nummesh = 0;
 	unsigned int numinter = 0;
 
+	m_threadinfo.m_mutex.Lock();
+
 	for (const auto& pair : m_sceneSlots) {
 		KX_Scene *scene = pair.first;
 		const SceneSlot& sceneSlot = pair.second;
@@ -864,6 +1170,9 @@ void BL_BlenderConverter::PrintStats()
 
 	CM_Message(std::endl << "Total:");
 	CM_Message("\t scenes: " << m_sceneSlots.size());
+
+	m_threadinfo.m_mutex.Unlock();
+
 	CM_Message("\t materials: " << nummat);
 	CM_Message("\t meshes: " << nummesh);
 	CM_Message("\t interpolators: " << numinter);
@@ -34,22 +34,26 @@
 
 #include <map>
 #include <vector>
+#include <list>
 
 #ifdef _MSC_VER // MSVC doesn't support incomplete type in std::unique_ptr.
 #  include "KX_BlenderMaterial.h"
 #  include "RAS_MeshObject.h"
 
 #  include "BL_BlenderScalarInterpolator.h"
+#  include "BL_CompiledAction.h"
 #endif
 
+#include "BL_BlenderSceneConverter.h"
+
 #include "CM_Thread.h"
 
 class EXP_StringValue;
-class BL_BlenderSceneConverter;
 class KX_KetsjiEngine;
 class KX_LibLoadStatus;
 class KX_BlenderMaterial;
 class BL_InterpolatorList;
+class BL_CompiledAction;
 class SCA_IActuator;
 class SCA_IController;
 class RAS_MeshObject;
@@ -75,8 +79,10 @@ private:
 		UniquePtrList<KX_BlenderMaterial> m_materials;
 		UniquePtrList<RAS_MeshObject> m_meshobjects;
 		UniquePtrList<BL_InterpolatorList> m_interpolators;
+		UniquePtrList<BL_CompiledAction> m_compiledActions;
 
 		std::map<bAction *, BL_InterpolatorList *> m_actionToInterp;
+		std::map<bAction *, BL_CompiledAction *> m_actionToCompiled;
 
 		SceneSlot();
 		SceneSlot(const BL_BlenderSceneConverter& converter);
@@ -90,6 +96,7 @@ private:
 
 	struct ThreadInfo {
 		TaskPool *m_pool;
+		/// Protects the scene slots, the merge queues and the load status progress.
 		CM_ThreadMutex m_mutex;
 	} m_threadinfo;
 
@@ -97,6 +104,29 @@ private:
 	std::map<std::string, KX_LibLoadStatus *> m_status_map;
 	std::vector<KX_LibLoadStatus *> m_mergequeue;
 
+	/// Scene converted by a streamed libload, merged by steps over several frames.
+	struct StreamedScene
+	{
+		KX_LibLoadStatus *m_status;
+		BL_BlenderSceneConverter m_converter;
+		/// True when the objects are merged, the materials are then initialized one per step.
+		bool m_objectsMerged;
+		/// Number of materials with initialized shaders.
+		unsigned int m_initializedMaterials;
+
+		StreamedScene(KX_LibLoadStatus *status, BL_BlenderSceneConverter&& converter);
+	};
+
+	/// Scenes converted by the streaming tasks, protected by the thread mutex.
+	std::list<StreamedScene> m_streamqueue;
+	/// Scenes being merged, only used by the main thread.
+	std::list<StreamedScene> m_streammerges;
+	/// Maximum time in seconds spent merging streamed scenes per logic frame.
+	double m_streamBudget;
+
+	/// Number of samples per frame baked for the compiled actions, zero to not bake.
+	float m_actionBakeRate;
+
 	Main *m_maggie;
 	std::vector<Main *> m_DynamicMaggie;
 
@@ -131,6 +161,12 @@ public:
 
 	void RegisterInterpolatorList(KX_Scene *scene, BL_InterpolatorList *interpolator, bAction *for_act);
 	BL_InterpolatorList *FindInterpolatorList(KX_Scene *scene, bAction *for_act);
+	void RegisterCompiledAction(KX_Scene *scene, BL_CompiledAction *compiled, bAction *for_act);
+	BL_CompiledAction *FindCompiledAction(KX_Scene *scene, bAction *for_act);
+
+	float GetActionBakeRate() const;
+	/// Set the number of samples per frame baked for the actions compiled afterward.
+	void SetActionBakeRate(float rate);
 
 	Scene *GetBlenderSceneForName(const std::string& name);
 	EXP_ListValue<EXP_StringValue> *GetInactiveSceneNames();
@@ -153,9 +189,31 @@ public:
 	void MergeAsyncLoads();
 	void FinalizeAsyncLoads();
 	void AddScenesToMergeQueue(KX_LibLoadStatus *status);
+	/// Queue a scene converted by a streamed libload, called by the conversion task.
+	void AddSceneToStreamQueue(KX_LibLoadStatus *status, BL_BlenderSceneConverter&& converter);
+
+	double GetStreamBudget() const;
+	void SetStreamBudget(double budget);
 
 	void PrintStats();
 
+private:
+	/// Move the converted data of a scene into the slot of the scene it is merged in.
+	void MergeSceneSlot(KX_Scene *to, KX_Scene *from);
+	/** Run one merge step of a streamed scene: merge the objects, initialize one
+	 * material or merge the material buckets.
+	 * \return True when the scene is completely merged.
+	 */
+	bool MergeStreamedSceneStep(StreamedScene& streamed);
+	/// Merge the streamed scenes until the time budget is exceeded.
+	void MergeStreamedScenes(double budget);
+	/** Wait for the libraries loading in a scene and merge them completely,
+	 * used before the scene is freed.
+	 */
+	void FinishSceneLoads(KX_Scene *scene);
+
+public:
+
 	// LibLoad Options.
 	enum
 	{
@@ -163,6 +221,8 @@ public:
 		LIB_LOAD_VERBOSE = 2,
 		LIB_LOAD_LOAD_SCRIPTS = 4,
 		LIB_LOAD_ASYNC = 8,
+		/// Asynchronous load merged by steps under a time budget, implies LIB_LOAD_ASYNC.
+		LIB_LOAD_STREAM = 16,
 	};
 };
 
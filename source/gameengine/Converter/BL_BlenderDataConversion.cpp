@@ -49,6 +49,7 @@
 
 #include <math.h>
 #include <vector>
+#include <set>
 #include <algorithm>
 
 
@@ -128,6 +129,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_threads.h"
+#include "BLI_task.h"
 
 #include "DNA_object_types.h"
 #include "DNA_material_types.h"
@@ -414,6 +416,65 @@ static RAS_MaterialBucket *BL_ConvertMaterial(Material *ma, int lightlayer, KX_S
 	return bucket;
 }
 
+struct BL_DecodeMeshesData
+{
+	Mesh * const *meshes;
+	DerivedMesh **dms;
+};
+
+static void BL_DecodeMeshTask(void *userdata, const int iter)
+{
+	BL_DecodeMeshesData *data = (BL_DecodeMeshesData *)userdata;
+	Mesh *me = data->meshes[iter];
+
+	DerivedMesh *dm = CDDM_from_mesh(me);
+
+	// Compute the data needed by BL_ConvertDerivedMeshToArray.
+	dm->calcLoopNormals(dm, (me->flag & ME_AUTOSMOOTH), me->smoothresh);
+	if (CustomData_number_of_layers(&dm->loopData, CD_MLOOPUV) > 0) {
+		DM_calc_loop_tangents(dm, true, nullptr, 0);
+	}
+	dm->getLoopTriArray(dm);
+
+	data->dms[iter] = dm;
+}
+
+void BL_DecodeMeshes(const std::vector<Mesh *>& meshes, BL_BlenderSceneConverter& converter)
+{
+	const unsigned int count = meshes.size();
+	std::vector<DerivedMesh *> dms(count);
+
+	BL_DecodeMeshesData data;
+	data.meshes = meshes.data();
+	data.dms = dms.data();
+
+	BLI_task_parallel_range(0, count, &data, BL_DecodeMeshTask, (count > 1));
+
+	for (unsigned int i = 0; i < count; ++i) {
+		converter.RegisterDerivedMesh(dms[i], meshes[i]);
+	}
+}
+
+void BL_DecodeSceneMeshes(Scene *blenderscene, BL_BlenderSceneConverter& converter)
+{
+	std::vector<Mesh *> meshes;
+	std::set<Mesh *> visited;
+
+	Scene *sce_iter;
+	Base *base;
+	for (SETLOOPER(blenderscene, sce_iter, base)) {
+		Object *ob = base->object;
+		if (ob->type == OB_MESH) {
+			Mesh *me = (Mesh *)ob->data;
+			if (visited.insert(me).second) {
+				meshes.push_back(me);
+			}
+		}
+	}
+
+	BL_DecodeMeshes(meshes, converter);
+}
+
 /* blenderobj can be nullptr, make sure its checked for */
 RAS_MeshObject *BL_ConvertMesh(Mesh *me, Object *blenderobj, KX_Scene *scene, BL_BlenderSceneConverter& converter)
 {
@@ -430,8 +491,12 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *me, Object *blenderobj, KX_Scene *scene, BL
 		}
 	}
 
-	// Get DerivedMesh data.
-	DerivedMesh *dm = CDDM_from_mesh(me);
+	// Get DerivedMesh data, the mesh could be already decoded by BL_DecodeMeshes.
+	DerivedMesh *dm = converter.FindDerivedMesh(me);
+	const bool decoded = (dm != nullptr);
+	if (!decoded) {
+		dm = CDDM_from_mesh(me);
+	}
 
 	/* Extract available layers.
 	 * Get the active color and uv layer. */
@@ -491,7 +556,10 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *me, Object *blenderobj, KX_Scene *scene, BL
 
 	meshobj->EndConversion(scene->GetBoundingBoxManager());
 
-	dm->release(dm);
+	// The decoded meshes are released by the converter.
+	if (!decoded) {
+		dm->release(dm);
+	}
 
 	converter.RegisterGameMesh(meshobj, me);
 	return meshobj;
@@ -45,6 +45,7 @@ struct Mesh;
 struct DerivedMesh;
 struct Object;
 struct Main;
+struct Scene;
 
 struct BL_MeshMaterial {
 	RAS_IDisplayArray *array;
@@ -55,6 +56,13 @@ struct BL_MeshMaterial {
 	bool wire;
 };
 
+/** Decode the meshes in parallel, computing their normals, tangents and triangles
+ * before their conversion by BL_ConvertMesh. The decoded meshes are owned by the converter.
+ */
+void BL_DecodeMeshes(const std::vector<Mesh *>& meshes, BL_BlenderSceneConverter& converter);
+/// Decode the meshes used by the objects of a blender scene.
+void BL_DecodeSceneMeshes(Scene *blenderscene, BL_BlenderSceneConverter& converter);
+
 RAS_MeshObject *BL_ConvertMesh(Mesh *mesh, Object *lightobj, KX_Scene *scene, BL_BlenderSceneConverter& converter);
 void BL_ConvertDerivedMeshToArray(DerivedMesh *dm, Mesh *me, const std::vector<BL_MeshMaterial>& mats,
                                   const RAS_MeshObject::LayersInfo& layersInfo);
@@ -32,6 +32,10 @@
 #include "BL_BlenderSceneConverter.h"
 #include "KX_GameObject.h"
 
+extern "C" {
+#  include "BKE_DerivedMesh.h"
+}
+
 BL_BlenderSceneConverter::BL_BlenderSceneConverter(KX_Scene *scene)
 	:m_scene(scene)
 {
@@ -44,8 +48,15 @@ BL_BlenderSceneConverter::BL_BlenderSceneConverter(BL_BlenderSceneConverter&& ot
 	m_map_mesh_to_gamemesh(std::move(other.m_map_mesh_to_gamemesh)),
 	m_map_mesh_to_polyaterial(std::move(other.m_map_mesh_to_polyaterial)),
 	m_map_blender_to_gameactuator(std::move(m_map_blender_to_gameactuator)),
-	m_map_blender_to_gamecontroller(std::move(m_map_blender_to_gamecontroller))
+	m_map_blender_to_gamecontroller(std::move(m_map_blender_to_gamecontroller)),
+	m_map_mesh_to_derivedmesh(std::move(other.m_map_mesh_to_derivedmesh))
+{
+	other.m_map_mesh_to_derivedmesh.clear();
+}
+
+BL_BlenderSceneConverter::~BL_BlenderSceneConverter()
 {
+	ReleaseDerivedMeshes();
 }
 
 KX_Scene *BL_BlenderSceneConverter::GetScene() const
@@ -92,6 +103,26 @@ RAS_MeshObject *BL_BlenderSceneConverter::FindGameMesh(Mesh *for_blendermesh)
 	return m_map_mesh_to_gamemesh[for_blendermesh];
 }
 
+void BL_BlenderSceneConverter::RegisterDerivedMesh(DerivedMesh *dm, Mesh *for_blendermesh)
+{
+	m_map_mesh_to_derivedmesh[for_blendermesh] = dm;
+}
+
+DerivedMesh *BL_BlenderSceneConverter::FindDerivedMesh(Mesh *for_blendermesh) const
+{
+	std::map<Mesh *, DerivedMesh *>::const_iterator it = m_map_mesh_to_derivedmesh.find(for_blendermesh);
+	return (it != m_map_mesh_to_derivedmesh.end()) ? it->second : nullptr;
+}
+
+void BL_BlenderSceneConverter::ReleaseDerivedMeshes()
+{
+	for (const std::pair<Mesh * const, DerivedMesh *>& pair : m_map_mesh_to_derivedmesh) {
+		DerivedMesh *dm = pair.second;
+		dm->release(dm);
+	}
+	m_map_mesh_to_derivedmesh.clear();
+}
+
 void BL_BlenderSceneConverter::RegisterMaterial(KX_BlenderMaterial *blmat, Material *mat)
 {
 	if (mat) {
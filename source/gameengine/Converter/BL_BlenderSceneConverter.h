@@ -50,6 +50,7 @@ struct BlendHandle;
 struct Object;
 struct Scene;
 struct Mesh;
+struct DerivedMesh;
 struct Material;
 struct bActuator;
 struct bController;
@@ -69,10 +70,12 @@ private:
 	std::map<Material *, KX_BlenderMaterial *> m_map_mesh_to_polyaterial;
 	std::map<bActuator *, SCA_IActuator *> m_map_blender_to_gameactuator;
 	std::map<bController *, SCA_IController *> m_map_blender_to_gamecontroller;
+	/// Meshes decoded before the conversion, released once the scene is converted.
+	std::map<Mesh *, DerivedMesh *> m_map_mesh_to_derivedmesh;
 
 public:
 	BL_BlenderSceneConverter(KX_Scene *scene);
-	~BL_BlenderSceneConverter() = default;
+	~BL_BlenderSceneConverter();
 
 	// Disable dangerous copy.
 	BL_BlenderSceneConverter(const BL_BlenderSceneConverter& other) = delete;
@@ -88,6 +91,11 @@ public:
 	void RegisterGameMesh(RAS_MeshObject *gamemesh, Mesh *for_blendermesh);
 	RAS_MeshObject *FindGameMesh(Mesh *for_blendermesh);
 
+	void RegisterDerivedMesh(DerivedMesh *dm, Mesh *for_blendermesh);
+	DerivedMesh *FindDerivedMesh(Mesh *for_blendermesh) const;
+	/// Free the decoded meshes, they are not used after the conversion.
+	void ReleaseDerivedMeshes();
+
 	void RegisterMaterial(KX_BlenderMaterial *blmat, Material *mat);
 	KX_BlenderMaterial *FindMaterial(Material *mat);
 
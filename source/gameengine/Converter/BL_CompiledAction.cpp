@@ -0,0 +1,332 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_CompiledAction.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_CompiledAction.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+
+extern "C" {
+#include "BLI_listbase.h"
+#include "BLI_utildefines.h"
+#include "DNA_ID.h"
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_curve_types.h"
+#include "DNA_key_types.h"
+#include "DNA_object_types.h"
+#include "BKE_action.h"
+#include "BKE_animsys.h"
+#include "BKE_fcurve.h"
+#include "BKE_key.h"
+#include "RNA_access.h"
+}
+
+BL_CompiledAction::BL_CompiledAction(bAction *action, float bakeRate)
+	:m_action(action),
+	m_supported(true),
+	m_bakeRate(0.0f),
+	m_bakeStart(0.0f),
+	m_numSamples(0),
+	m_numBakedChannels(0)
+{
+	for (FCurve *fcu = (FCurve *)action->curves.first; fcu; fcu = fcu->next) {
+		// The drivers write the curve value, they can't be evaluated concurrently from the shared action.
+		if (fcu->driver) {
+			m_supported = false;
+			return;
+		}
+
+		// Same skipped curves as the animation system.
+		if ((fcu->grp && (fcu->grp->flag & AGRP_MUTED)) || (fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED)) || !fcu->rna_path) {
+			continue;
+		}
+
+		Channel channel;
+		if (ParseChannel(fcu, channel)) {
+			channel.m_fcurve = fcu;
+			channel.m_hasData = (fcu->totvert || list_has_suitable_fmodifier(&fcu->modifiers, 0, FMI_TYPE_GENERATE_CURVE));
+			m_channels.push_back(channel);
+		}
+		else {
+			m_propertyCurves.push_back(fcu);
+		}
+	}
+
+	if (bakeRate > 0.0f) {
+		Bake(bakeRate);
+	}
+}
+
+BL_CompiledAction::~BL_CompiledAction()
+{
+}
+
+bool BL_CompiledAction::ParseChannel(FCurve *fcu, Channel& channel)
+{
+	static const char *bonePrefix = "pose.bones[\"";
+	static const char *keyPrefix = "key_blocks[\"";
+
+	const char *path = fcu->rna_path;
+	const bool bone = STRPREFIX(path, bonePrefix);
+	if (!bone && !STRPREFIX(path, keyPrefix)) {
+		return false;
+	}
+
+	const char *name = path + strlen(bone ? bonePrefix : keyPrefix);
+	const char *nameEnd = strchr(name, '"');
+	// Escaped names are left to the RNA path resolution.
+	if (!nameEnd || nameEnd[1] != ']' || nameEnd[2] != '.' || std::find(name, nameEnd, '\\') != nameEnd) {
+		return false;
+	}
+
+	const char *property = nameEnd + 3;
+	const int index = fcu->array_index;
+
+	if (bone) {
+		if (STREQ(property, "location") && index >= 0 && index < 3) {
+			channel.m_type = CHANNEL_BONE_LOCATION;
+		}
+		else if (STREQ(property, "rotation_quaternion") && index >= 0 && index < 4) {
+			channel.m_type = CHANNEL_BONE_ROTATION_QUATERNION;
+		}
+		else if (STREQ(property, "rotation_euler") && index >= 0 && index < 3) {
+			channel.m_type = CHANNEL_BONE_ROTATION_EULER;
+		}
+		else if (STREQ(property, "rotation_axis_angle") && index >= 0 && index < 4) {
+			channel.m_type = CHANNEL_BONE_ROTATION_AXIS_ANGLE;
+		}
+		else if (STREQ(property, "scale") && index >= 0 && index < 3) {
+			channel.m_type = CHANNEL_BONE_SCALE;
+		}
+		else {
+			return false;
+		}
+	}
+	else if (STREQ(property, "value")) {
+		channel.m_type = CHANNEL_SHAPE_KEY;
+	}
+	else {
+		return false;
+	}
+
+	channel.m_name = std::string(name, nameEnd);
+	channel.m_index = index;
+
+	return true;
+}
+
+bool BL_CompiledAction::CanBake(FCurve *fcu, float start, float end)
+{
+	if (fcu->flag & FCURVE_INT_VALUES) {
+		return false;
+	}
+
+	// Constant interpolation can't be approximated by linear interpolation.
+	if (fcu->bezt) {
+		for (unsigned int i = 0; i + 1 < fcu->totvert; ++i) {
+			if (fcu->bezt[i].ipo == BEZT_IPO_CONST) {
+				return false;
+			}
+		}
+	}
+
+	if (BLI_listbase_is_empty(&fcu->modifiers)) {
+		return true;
+	}
+
+	for (FModifier *fcm = (FModifier *)fcu->modifiers.first; fcm; fcm = fcm->next) {
+		if (fcm->type != FMODIFIER_TYPE_CYCLES) {
+			return false;
+		}
+	}
+
+	// The cycles must only be applied outside of the baked range, a curve ending before the action
+	// jumps back to its first key value and can't be interpolated across the jump.
+	float min;
+	float max;
+	calc_fcurve_range(fcu, &min, &max, false, false);
+	return (min <= start && max >= end);
+}
+
+float BL_CompiledAction::EvaluateChannel(const Channel& channel, float frame)
+{
+	return channel.m_hasData ? evaluate_fcurve(channel.m_fcurve, frame) : 0.0f;
+}
+
+void BL_CompiledAction::Bake(float bakeRate)
+{
+	float start;
+	float end;
+	calc_action_range(m_action, &start, &end, 0);
+
+	const float numSamples = std::floor((end - start) * bakeRate) + 1.0f;
+	if (numSamples < 2.0f || numSamples > BL_COMPILED_ACTION_MAX_SAMPLES) {
+		return;
+	}
+
+	// Put the channels to bake first.
+	std::vector<Channel>::iterator bakedEnd = std::stable_partition(m_channels.begin(), m_channels.end(),
+		[start, end](const Channel& channel) { return channel.m_hasData && CanBake(channel.m_fcurve, start, end); });
+	const unsigned int numBakedChannels = bakedEnd - m_channels.begin();
+	if (numBakedChannels == 0) {
+		return;
+	}
+
+	m_bakeRate = bakeRate;
+	m_bakeStart = start;
+	m_numSamples = (unsigned int)numSamples;
+	m_numBakedChannels = numBakedChannels;
+	m_samples.resize(m_numSamples * m_numBakedChannels);
+
+	for (unsigned int i = 0; i < m_numSamples; ++i) {
+		const float frame = m_bakeStart + (float)i / m_bakeRate;
+		float *values = &m_samples[i * m_numBakedChannels];
+		for (unsigned int j = 0; j < m_numBakedChannels; ++j) {
+			values[j] = evaluate_fcurve(m_channels[j].m_fcurve, frame);
+		}
+	}
+}
+
+bAction *BL_CompiledAction::GetAction() const
+{
+	return m_action;
+}
+
+bool BL_CompiledAction::IsSupported() const
+{
+	return m_supported;
+}
+
+void BL_CompiledAction::Bind(ID *id, std::vector<Target>& targets) const
+{
+	targets.resize(m_channels.size());
+
+	const ID_Type type = GS(id->name);
+	bPose *pose = (type == ID_OB) ? ((Object *)id)->pose : nullptr;
+	Key *key = (type == ID_KE) ? (Key *)id : nullptr;
+
+	for (unsigned int i = 0, size = m_channels.size(); i < size; ++i) {
+		const Channel& channel = m_channels[i];
+		Target& target = targets[i];
+		target.m_value = nullptr;
+		target.m_min = -FLT_MAX;
+		target.m_max = FLT_MAX;
+
+		if (channel.m_type == CHANNEL_SHAPE_KEY) {
+			KeyBlock *kb = key ? BKE_keyblock_find_name(key, channel.m_name.c_str()) : nullptr;
+			if (kb) {
+				target.m_value = &kb->curval;
+				target.m_min = kb->slidermin;
+				target.m_max = kb->slidermax;
+			}
+			continue;
+		}
+
+		bPoseChannel *pchan = pose ? BKE_pose_channel_find_name(pose, channel.m_name.c_str()) : nullptr;
+		if (!pchan) {
+			continue;
+		}
+
+		switch (channel.m_type) {
+			case CHANNEL_BONE_LOCATION:
+			{
+				target.m_value = &pchan->loc[channel.m_index];
+				break;
+			}
+			case CHANNEL_BONE_ROTATION_QUATERNION:
+			{
+				target.m_value = &pchan->quat[channel.m_index];
+				break;
+			}
+			case CHANNEL_BONE_ROTATION_EULER:
+			{
+				target.m_value = &pchan->eul[channel.m_index];
+				break;
+			}
+			case CHANNEL_BONE_ROTATION_AXIS_ANGLE:
+			{
+				// The angle is the first value of the RNA property.
+				target.m_value = (channel.m_index == 0) ? &pchan->rotAngle : &pchan->rotAxis[channel.m_index - 1];
+				break;
+			}
+			case CHANNEL_BONE_SCALE:
+			{
+				target.m_value = &pchan->size[channel.m_index];
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+	}
+}
+
+void BL_CompiledAction::Evaluate(float frame, const std::vector<Target>& targets, ID *id) const
+{
+	unsigned int firstChannel = 0;
+
+	if (m_numSamples > 0) {
+		const float position = (frame - m_bakeStart) * m_bakeRate;
+		// Outside of the baked range the curves are extrapolated.
+		if (position >= 0.0f && position <= (float)(m_numSamples - 1)) {
+			const unsigned int sample = std::min((unsigned int)position, m_numSamples - 2);
+			const float factor = position - (float)sample;
+			const float *prev = &m_samples[sample * m_numBakedChannels];
+			const float *next = prev + m_numBakedChannels;
+
+			for (unsigned int i = 0; i < m_numBakedChannels; ++i) {
+				const Target& target = targets[i];
+				if (target.m_value) {
+					const float value = prev[i] + (next[i] - prev[i]) * factor;
+					*target.m_value = std::min(std::max(value, target.m_min), target.m_max);
+				}
+			}
+
+			firstChannel = m_numBakedChannels;
+		}
+	}
+
+	for (unsigned int i = firstChannel, size = m_channels.size(); i < size; ++i) {
+		const Target& target = targets[i];
+		if (target.m_value) {
+			const float value = EvaluateChannel(m_channels[i], frame);
+			*target.m_value = std::min(std::max(value, target.m_min), target.m_max);
+		}
+	}
+
+	if (!m_propertyCurves.empty()) {
+		PointerRNA ptrrna;
+		RNA_id_pointer_create(id, &ptrrna);
+
+		for (FCurve *fcu : m_propertyCurves) {
+			const float value = (fcu->totvert || list_has_suitable_fmodifier(&fcu->modifiers, 0, FMI_TYPE_GENERATE_CURVE)) ?
+				evaluate_fcurve(fcu, frame) : 0.0f;
+			BKE_animsys_execute_fcurve(&ptrrna, nullptr, fcu, value);
+		}
+	}
+}
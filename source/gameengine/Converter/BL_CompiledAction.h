@@ -0,0 +1,128 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_CompiledAction.h
+ *  \ingroup bgeconv
+ */
+
+#ifndef __BL_COMPILEDACTION_H__
+#define __BL_COMPILEDACTION_H__
+
+#include <vector>
+#include <string>
+
+/// Maximum number of baked samples per action, longer actions are not baked.
+#define BL_COMPILED_ACTION_MAX_SAMPLES 65536
+
+struct bAction;
+struct FCurve;
+struct ID;
+
+/** Action with its F-Curves resolved to the values they animate, shared by all the objects
+ * playing the action in a scene.
+ * The pose bone transforms and the shape key values are written directly in the pose channels
+ * and key blocks of the object instead of resolving the RNA path of each F-Curve every frame.
+ * The other F-Curves still use their RNA path.
+ * These direct channels can be baked into samples regularly spaced over the action frame range,
+ * a channel value is then the linear interpolation of the two surrounding samples which are
+ * stored next to the samples of the other channels.
+ */
+class BL_CompiledAction
+{
+public:
+	/// Value animated by a direct channel for an object.
+	struct Target
+	{
+		/// The value to write, nullptr if the channel doesn't exist in the object.
+		float *m_value;
+		float m_min;
+		float m_max;
+	};
+
+private:
+	enum ChannelType {
+		CHANNEL_BONE_LOCATION = 0,
+		CHANNEL_BONE_ROTATION_QUATERNION,
+		CHANNEL_BONE_ROTATION_EULER,
+		CHANNEL_BONE_ROTATION_AXIS_ANGLE,
+		CHANNEL_BONE_SCALE,
+		CHANNEL_SHAPE_KEY
+	};
+
+	struct Channel
+	{
+		ChannelType m_type;
+		/// Name of the bone or the key block.
+		std::string m_name;
+		int m_index;
+		FCurve *m_fcurve;
+		/// False when the F-Curve has no data and always evaluates to zero.
+		bool m_hasData;
+	};
+
+	bAction *m_action;
+	/// False if the action can't be evaluated without modifying it, e.g. it uses drivers.
+	bool m_supported;
+	/// Direct channels, the baked channels first.
+	std::vector<Channel> m_channels;
+	/// F-Curves of the other properties, written through their RNA path.
+	std::vector<FCurve *> m_propertyCurves;
+
+	/// Number of samples per frame, zero when the action is not baked.
+	float m_bakeRate;
+	float m_bakeStart;
+	unsigned int m_numSamples;
+	unsigned int m_numBakedChannels;
+	/// Baked values ordered by sample then by channel.
+	std::vector<float> m_samples;
+
+	/// Resolve the RNA path of a F-Curve to a direct channel.
+	static bool ParseChannel(FCurve *fcu, Channel& channel);
+	/// Return true if the linear interpolation of the samples of a F-Curve is close to the curve in a frame range.
+	static bool CanBake(FCurve *fcu, float start, float end);
+	static float EvaluateChannel(const Channel& channel, float frame);
+
+	void Bake(float bakeRate);
+
+public:
+	/** Compile an action.
+	 * \param bakeRate The number of samples per frame to bake, zero to not bake the action.
+	 */
+	BL_CompiledAction(bAction *action, float bakeRate);
+	~BL_CompiledAction();
+
+	bAction *GetAction() const;
+	/// Return false if the action must be evaluated by the animation system.
+	bool IsSupported() const;
+
+	/** Resolve the direct channels in the pose of an armature object or the key blocks of a shape key.
+	 * \param id The armature object or the shape key animated by the action.
+	 * \param targets The values animated by the channels, in the channel order.
+	 */
+	void Bind(ID *id, std::vector<Target>& targets) const;
+
+	/** Evaluate the action at a frame.
+	 * \param targets The values bound for the animated ID.
+	 * \param id The ID animated, used to write the properties not resolved to a direct channel.
+	 */
+	void Evaluate(float frame, const std::vector<Target>& targets, ID *id) const;
+};
+
+#endif  // __BL_COMPILEDACTION_H__
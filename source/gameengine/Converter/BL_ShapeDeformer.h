@@ -68,6 +68,12 @@ public:
 		m_lastShapeUpdate = -1.0;
 	}
 
+	/// The shape key weights are specific to each object, the deformation is never shared.
+	virtual bool IsShareable()
+	{
+		return false;
+	}
+
 protected:
 	bool m_useShapeDrivers;
 	double m_lastShapeUpdate;
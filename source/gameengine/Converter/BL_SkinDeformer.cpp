@@ -65,6 +65,9 @@ extern "C" {
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
+
+#include <algorithm>
 
 static short get_deformflags(Object *bmeshobj)
 {
@@ -150,6 +153,9 @@ void BL_SkinDeformer::ProcessReplica()
 	BL_MeshDeformer::ProcessReplica();
 	m_lastArmaUpdate = -1.0;
 	m_dfnrToPC.clear();
+	m_skinInfluences.Clear();
+	m_palettePC.clear();
+	m_palette.clear();
 }
 
 void BL_SkinDeformer::BlenderDeformVerts()
@@ -170,90 +176,87 @@ void BL_SkinDeformer::BlenderDeformVerts()
 	RecalcNormals();
 }
 
-void BL_SkinDeformer::BGEDeformVerts()
+void BL_SkinDeformer::BuildSkinInfluences()
 {
 	Object *par_arma = m_armobj->GetArmatureObject();
-	MDeformVert *dverts = m_bmesh->dvert;
-	Eigen::Matrix4f pre_mat, post_mat, chan_mat, norm_chan_mat;
-
-	if (!dverts)
-		return;
-
 	const unsigned short defbase_tot = BLI_listbase_count(&m_objMesh->defbase);
 
-	if (m_dfnrToPC.empty()) {
-		m_dfnrToPC.resize(defbase_tot);
-		int i;
-		bDeformGroup *dg;
-		for (i = 0, dg = (bDeformGroup *)m_objMesh->defbase.first; dg; ++i, dg = dg->next) {
-			m_dfnrToPC[i] = BKE_pose_channel_find_name(par_arma->pose, dg->name);
+	m_dfnrToPC.resize(defbase_tot);
+	int i;
+	bDeformGroup *dg;
+	for (i = 0, dg = (bDeformGroup *)m_objMesh->defbase.first; dg; ++i, dg = dg->next) {
+		m_dfnrToPC[i] = BKE_pose_channel_find_name(par_arma->pose, dg->name);
 
-			if (m_dfnrToPC[i] && m_dfnrToPC[i]->bone->flag & BONE_NO_DEFORM) {
-				m_dfnrToPC[i] = nullptr;
-			}
+		if (m_dfnrToPC[i] && m_dfnrToPC[i]->bone->flag & BONE_NO_DEFORM) {
+			m_dfnrToPC[i] = nullptr;
 		}
 	}
 
-	post_mat = Eigen::Matrix4f::Map((float *)m_obmat).inverse() * Eigen::Matrix4f::Map((float *)m_armobj->GetArmatureObject()->obmat);
-	pre_mat = post_mat.inverse();
-
-	MDeformVert *dv = dverts;
-	MDeformWeight *dw;
-
-	for (int i = 0; i < m_bmesh->totvert; ++i, dv++) {
-		float contrib = 0.0f, weight, max_weight = -1.0f;
-		bPoseChannel *pchan = nullptr;
-		Eigen::Vector3f normorg(m_bmesh->mvert[i].no[0], m_bmesh->mvert[i].no[1], m_bmesh->mvert[i].no[2]);
-		Eigen::Map<Eigen::Vector3f> norm = Eigen::Vector3f::Map(m_transnors[i].data());
-		Eigen::Vector4f vec(0.0f, 0.0f, 0.0f, 1.0f);
-		Eigen::Vector4f co(m_transverts[i][0],
-		                   m_transverts[i][1],
-		                   m_transverts[i][2],
-		                   1.0f);
-
-		if (!dv->totweight)
-			continue;
-
-		co = pre_mat * co;
-
-		dw = dv->dw;
-
-		for (unsigned int j = dv->totweight; j != 0; j--, dw++) {
-			const int index = dw->def_nr;
+	// Palette index of each deform group, -1 for the groups not deforming the mesh.
+	std::vector<int> dfnrToPalette(defbase_tot, -1);
+	m_palettePC.clear();
+	for (unsigned short j = 0; j < defbase_tot; ++j) {
+		if (m_dfnrToPC[j]) {
+			dfnrToPalette[j] = m_palettePC.size();
+			m_palettePC.push_back(m_dfnrToPC[j]);
+		}
+	}
+	m_palette.resize(m_palettePC.size() * 16);
 
-			if (index < defbase_tot && (pchan = m_dfnrToPC[index])) {
-				weight = dw->weight;
+	m_skinInfluences.Build(m_bmesh->dvert, m_bmesh->totvert, dfnrToPalette);
+}
 
-				if (weight) {
-					chan_mat = Eigen::Matrix4f::Map((float *)pchan->chan_mat);
+struct BGEDeformData
+{
+	BL_SkinDeformer *deformer;
+	float pre_mat[16];
+	float post_mat[16];
+	int totvert;
+};
+
+/// Number of vertices deformed by each task.
+#define BGE_DEFORM_CHUNK_SIZE 256
+/// Minimum number of vertices to deform the mesh in several threads.
+#define BGE_DEFORM_PARALLEL_MIN_VERTS 2048
+
+void BL_SkinDeformer::BGEDeformVertsTask(void *userdata, const int iter)
+{
+	BGEDeformData *data = (BGEDeformData *)userdata;
+	const int start = iter * BGE_DEFORM_CHUNK_SIZE;
+	const int end = std::min(start + BGE_DEFORM_CHUNK_SIZE, data->totvert);
+	BL_SkinDeformer *deformer = data->deformer;
+	BL_SkinDeformVerts(deformer->m_skinInfluences, deformer->m_palette.data(), deformer->m_bmesh->mvert, data->pre_mat, data->post_mat,
+	                   (float (*)[3])deformer->m_transverts.data(), (float (*)[3])deformer->m_transnors.data(), start, end);
+}
 
-					// Update Vertex Position
-					vec.noalias() += (chan_mat * co - co) * weight;
+void BL_SkinDeformer::BGEDeformVerts()
+{
+	if (!m_bmesh->dvert)
+		return;
 
-					// Save the most influential channel so we can use it to update the vertex normal
-					if (weight > max_weight)
-					{
-						max_weight = weight;
-						norm_chan_mat = chan_mat;
-					}
+	// The deform weights don't change during the game, the influences are gathered once.
+	if (m_skinInfluences.Empty()) {
+		BuildSkinInfluences();
+	}
 
-					contrib += weight;
-				}
-			}
-		}
+	// Copy the bone matrices once instead of for each vertex influence.
+	for (unsigned int i = 0, size = m_palettePC.size(); i < size; ++i) {
+		memcpy(&m_palette[i * 16], m_palettePC[i]->chan_mat, sizeof(float[16]));
+	}
 
-		// Update Vertex Normal
-		norm = norm_chan_mat.topLeftCorner<3, 3>() * normorg;
+	BGEDeformData data;
+	data.deformer = this;
+	data.totvert = m_bmesh->totvert;
 
-		co.noalias() += vec / contrib;
-		co[3] = 1.0f; // Make sure we have a 1 for the w component!
+	Eigen::Matrix4f post_mat = Eigen::Matrix4f::Map((float *)m_obmat).inverse() * Eigen::Matrix4f::Map((float *)m_armobj->GetArmatureObject()->obmat);
+	Eigen::Matrix4f pre_mat = post_mat.inverse();
+	Eigen::Matrix4f::Map(data.post_mat) = post_mat;
+	Eigen::Matrix4f::Map(data.pre_mat) = pre_mat;
 
-		co = post_mat * co;
+	// The vertices are independent, deform them by chunks in several threads for big meshes.
+	const int chunks = (data.totvert + BGE_DEFORM_CHUNK_SIZE - 1) / BGE_DEFORM_CHUNK_SIZE;
+	BLI_task_parallel_range(0, chunks, &data, BGEDeformVertsTask, (data.totvert >= BGE_DEFORM_PARALLEL_MIN_VERTS));
 
-		m_transverts[i][0] = co[0];
-		m_transverts[i][1] = co[1];
-		m_transverts[i][2] = co[2];
-	}
 	m_copyNormals = true;
 }
 
@@ -335,6 +338,58 @@ bool BL_SkinDeformer::UpdateInternal(bool shape_applied)
 	return false;
 }
 
+bool BL_SkinDeformer::IsShareable()
+{
+	return (PoseUpdated() && m_armobj->GetVertDeformType() == ARM_VDEF_BGE_CPU && m_bmesh->dvert);
+}
+
+bool BL_SkinDeformer::HasSameDeform(BL_SkinDeformer *other)
+{
+	if (m_bmesh != other->m_bmesh || m_objMesh != other->m_objMesh ||
+	    m_armobj->GetOrigArmatureObject() != other->m_armobj->GetOrigArmatureObject())
+	{
+		return false;
+	}
+
+	if (memcmp(m_obmat, other->m_obmat, sizeof(m_obmat)) != 0 ||
+	    memcmp(m_armobj->GetArmatureObject()->obmat, other->m_armobj->GetArmatureObject()->obmat, sizeof(float[4][4])) != 0)
+	{
+		return false;
+	}
+
+	if (m_skinInfluences.Empty()) {
+		BuildSkinInfluences();
+	}
+	if (other->m_skinInfluences.Empty()) {
+		other->BuildSkinInfluences();
+	}
+
+	// Both armatures come from the same original, the palettes use the same bones in the same order.
+	if (m_palettePC.size() != other->m_palettePC.size()) {
+		return false;
+	}
+
+	for (unsigned int i = 0, size = m_palettePC.size(); i < size; ++i) {
+		if (memcmp(m_palettePC[i]->chan_mat, other->m_palettePC[i]->chan_mat, sizeof(float[4][4])) != 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void BL_SkinDeformer::CopyDeform(BL_SkinDeformer *other)
+{
+	m_transverts = other->m_transverts;
+	m_transnors = other->m_transnors;
+	m_copyNormals = true;
+
+	m_lastArmaUpdate = m_armobj->GetLastFrame();
+	m_bDynamic = true;
+
+	UpdateTransverts();
+}
+
 bool BL_SkinDeformer::Update(void)
 {
 	return UpdateInternal(false);
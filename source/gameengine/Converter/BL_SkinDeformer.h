@@ -38,6 +38,7 @@
 
 #include "BL_MeshDeformer.h"
 #include "BL_ArmatureObject.h"
+#include "BL_SkinKernel.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -87,6 +88,20 @@ public:
 		m_lastArmaUpdate = -1.0;
 	}
 
+	BL_ArmatureObject *GetArmature() const
+	{
+		return m_armobj;
+	}
+
+	/// Return true if the deformed vertices only depend on the mesh and the armature pose.
+	virtual bool IsShareable();
+	/** Return true if the other deformer produces the same vertices than this deformer
+	 * for the current pose. The poses of both armatures must be applied.
+	 */
+	bool HasSameDeform(BL_SkinDeformer *other);
+	/// Use the deformed vertices of a deformer producing the same deformation.
+	void CopyDeform(BL_SkinDeformer *other);
+
 protected:
 	BL_ArmatureObject *m_armobj; // Our parent object
 	double m_lastArmaUpdate;
@@ -95,8 +110,18 @@ protected:
 	std::vector<bPoseChannel *> m_dfnrToPC;
 	short m_deformflags;
 
+	/// Influences of all the vertices, built once from the mesh deform weights.
+	BL_SkinInfluences m_skinInfluences;
+	/// Pose channels of the bones deforming the mesh, one per palette matrix.
+	std::vector<bPoseChannel *> m_palettePC;
+	/// Skinning matrices of the bones (16 floats each), copied once per deform.
+	std::vector<float> m_palette;
+
 	void BlenderDeformVerts();
+	/// Build the packed influence table from the mesh deform weights.
+	void BuildSkinInfluences();
 	void BGEDeformVerts();
+	static void BGEDeformVertsTask(void *userdata, const int iter);
 
 	virtual void UpdateTransverts();
 };
@@ -0,0 +1,203 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_SkinKernel.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_SkinKernel.h"
+
+#include "DNA_meshdata_types.h"
+
+#include <Eigen/Core>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+void BL_SkinInfluences::Build(const MDeformVert *dverts, int totvert, const std::vector<int>& dfnrToPalette)
+{
+	const int defbase_tot = dfnrToPalette.size();
+
+	m_vertices.resize(totvert);
+	m_influences.clear();
+
+	const MDeformVert *dv = dverts;
+	for (int v = 0; v < totvert; ++v, ++dv) {
+		BL_SkinVertex& skinvert = m_vertices[v];
+		skinvert.m_start = m_influences.size();
+		skinvert.m_count = 0;
+		skinvert.m_normalPalette = 0;
+
+		float max_weight = -1.0f;
+		const MDeformWeight *dw = dv->dw;
+		for (unsigned int j = dv->totweight; j != 0; j--, dw++) {
+			const int index = dw->def_nr;
+			if (index >= defbase_tot || dfnrToPalette[index] == -1 || !dw->weight) {
+				continue;
+			}
+
+			const BL_SkinInfluence influence = {(unsigned short)dfnrToPalette[index], dw->weight};
+			m_influences.push_back(influence);
+			++skinvert.m_count;
+
+			// Save the most influential channel so we can use it to update the vertex normal
+			if (dw->weight > max_weight) {
+				max_weight = dw->weight;
+				skinvert.m_normalPalette = influence.m_palette;
+			}
+		}
+	}
+}
+
+void BL_SkinInfluences::Clear()
+{
+	m_vertices.clear();
+	m_influences.clear();
+}
+
+bool BL_SkinInfluences::Empty() const
+{
+	return m_vertices.empty();
+}
+
+void BL_SkinDeformVerts(const BL_SkinInfluences& influences, const float *palette, const MVert *mverts,
+                        const float pre_mat[16], const float post_mat[16], float (*transverts)[3], float (*transnors)[3],
+                        int start, int end)
+{
+#ifdef __SSE2__
+	BL_SkinDeformVertsSSE2(influences, palette, mverts, pre_mat, post_mat, transverts, transnors, start, end);
+#else
+	BL_SkinDeformVertsScalar(influences, palette, mverts, pre_mat, post_mat, transverts, transnors, start, end);
+#endif
+}
+
+void BL_SkinDeformVertsScalar(const BL_SkinInfluences& influences, const float *palette, const MVert *mverts,
+                              const float pre_mat_data[16], const float post_mat_data[16], float (*transverts)[3], float (*transnors)[3],
+                              int start, int end)
+{
+	const Eigen::Matrix4f pre_mat = Eigen::Matrix4f::Map(pre_mat_data);
+	const Eigen::Matrix4f post_mat = Eigen::Matrix4f::Map(post_mat_data);
+	Eigen::Matrix4f chan_mat;
+
+	for (int i = start; i < end; ++i) {
+		const BL_SkinVertex& skinvert = influences.m_vertices[i];
+
+		// Vertices without deforming bones keep their original position and normal.
+		if (skinvert.m_count == 0) {
+			continue;
+		}
+
+		float contrib = 0.0f;
+		Eigen::Vector3f normorg(mverts[i].no[0], mverts[i].no[1], mverts[i].no[2]);
+		Eigen::Map<Eigen::Vector3f> norm = Eigen::Vector3f::Map(transnors[i]);
+		Eigen::Vector4f vec(0.0f, 0.0f, 0.0f, 1.0f);
+		Eigen::Vector4f co(transverts[i][0],
+		                   transverts[i][1],
+		                   transverts[i][2],
+		                   1.0f);
+
+		co = pre_mat * co;
+
+		const BL_SkinInfluence *influence = &influences.m_influences[skinvert.m_start];
+		for (unsigned short j = skinvert.m_count; j != 0; j--, influence++) {
+			const float weight = influence->m_weight;
+			chan_mat = Eigen::Matrix4f::Map(&palette[influence->m_palette * 16]);
+
+			// Update Vertex Position
+			vec.noalias() += (chan_mat * co - co) * weight;
+
+			contrib += weight;
+		}
+
+		// Update Vertex Normal
+		chan_mat = Eigen::Matrix4f::Map(&palette[skinvert.m_normalPalette * 16]);
+		norm = chan_mat.topLeftCorner<3, 3>() * normorg;
+
+		co.noalias() += vec / contrib;
+		co[3] = 1.0f; // Make sure we have a 1 for the w component!
+
+		co = post_mat * co;
+
+		transverts[i][0] = co[0];
+		transverts[i][1] = co[1];
+		transverts[i][2] = co[2];
+	}
+}
+
+#ifdef __SSE2__
+/// Product of a column major 4x4 matrix with a vector.
+static inline __m128 mul_m4_v4_sse2(const float mat[16], __m128 vec)
+{
+	__m128 result = _mm_mul_ps(_mm_loadu_ps(mat), _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 0)));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(mat + 4), _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 1, 1))));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(mat + 8), _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 2, 2, 2))));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(mat + 12), _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(3, 3, 3, 3))));
+	return result;
+}
+
+void BL_SkinDeformVertsSSE2(const BL_SkinInfluences& influences, const float *palette, const MVert *mverts,
+                            const float pre_mat[16], const float post_mat[16], float (*transverts)[3], float (*transnors)[3],
+                            int start, int end)
+{
+	for (int i = start; i < end; ++i) {
+		const BL_SkinVertex& skinvert = influences.m_vertices[i];
+
+		// Vertices without deforming bones keep their original position and normal.
+		if (skinvert.m_count == 0) {
+			continue;
+		}
+
+		__m128 co = mul_m4_v4_sse2(pre_mat, _mm_setr_ps(transverts[i][0], transverts[i][1], transverts[i][2], 1.0f));
+		__m128 vec = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+		float contrib = 0.0f;
+
+		const BL_SkinInfluence *influence = &influences.m_influences[skinvert.m_start];
+		for (unsigned short j = skinvert.m_count; j != 0; j--, influence++) {
+			const float *chan_mat = &palette[influence->m_palette * 16];
+			const __m128 weight = _mm_set1_ps(influence->m_weight);
+
+			// Update Vertex Position
+			vec = _mm_add_ps(vec, _mm_mul_ps(_mm_sub_ps(mul_m4_v4_sse2(chan_mat, co), co), weight));
+
+			contrib += influence->m_weight;
+		}
+
+		// Update Vertex Normal, the null w component excludes the translation.
+		const __m128 normorg = _mm_setr_ps(mverts[i].no[0], mverts[i].no[1], mverts[i].no[2], 0.0f);
+		float norm[4];
+		_mm_storeu_ps(norm, mul_m4_v4_sse2(&palette[skinvert.m_normalPalette * 16], normorg));
+		transnors[i][0] = norm[0];
+		transnors[i][1] = norm[1];
+		transnors[i][2] = norm[2];
+
+		co = _mm_add_ps(co, _mm_div_ps(vec, _mm_set1_ps(contrib)));
+
+		float result[4];
+		_mm_storeu_ps(result, co);
+		// Make sure we have a 1 for the w component!
+		_mm_storeu_ps(result, mul_m4_v4_sse2(post_mat, _mm_setr_ps(result[0], result[1], result[2], 1.0f)));
+
+		transverts[i][0] = result[0];
+		transverts[i][1] = result[1];
+		transverts[i][2] = result[2];
+	}
+}
+#endif  // __SSE2__
@@ -0,0 +1,94 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file BL_SkinKernel.h
+ *  \ingroup bgeconv
+ */
+
+#ifndef __BL_SKINKERNEL_H__
+#define __BL_SKINKERNEL_H__
+
+#include <vector>
+
+struct MDeformVert;
+struct MVert;
+
+/// Deforming bone influence of a vertex.
+struct BL_SkinInfluence
+{
+	/// Index of the bone matrix in the palette.
+	unsigned short m_palette;
+	float m_weight;
+};
+
+/// Influences of a vertex in the packed influence table.
+struct BL_SkinVertex
+{
+	/// Index of the first influence.
+	unsigned int m_start;
+	/// Number of influences.
+	unsigned short m_count;
+	/// Palette index of the most influent bone, used to deform the normal.
+	unsigned short m_normalPalette;
+};
+
+/** Influences of all the vertices of a mesh, only the groups whose bone deforms the mesh
+ * and which have a non-zero weight are kept.
+ */
+class BL_SkinInfluences
+{
+public:
+	std::vector<BL_SkinVertex> m_vertices;
+	std::vector<BL_SkinInfluence> m_influences;
+
+	/** Build the table from the mesh deform weights.
+	 * \param dfnrToPalette Palette index of each deform group, -1 for the groups not deforming the mesh.
+	 */
+	void Build(const MDeformVert *dverts, int totvert, const std::vector<int>& dfnrToPalette);
+	void Clear();
+	bool Empty() const;
+};
+
+/** Deform the vertices in [start, end[ with the bone palette, the vertices without influence
+ * keep their position and normal.
+ * \param palette The skinning matrices of the bones, 16 floats each in column major order.
+ * \param pre_mat The matrix from the mesh to the armature space.
+ * \param post_mat The matrix from the armature to the mesh space.
+ * \param transverts The positions to deform.
+ * \param transnors The deformed normals, computed from the normals of mverts.
+ */
+void BL_SkinDeformVerts(const BL_SkinInfluences& influences, const float *palette, const MVert *mverts,
+                        const float pre_mat[16], const float post_mat[16], float (*transverts)[3], float (*transnors)[3],
+                        int start, int end);
+
+/// Scalar version of BL_SkinDeformVerts.
+void BL_SkinDeformVertsScalar(const BL_SkinInfluences& influences, const float *palette, const MVert *mverts,
+                              const float pre_mat[16], const float post_mat[16], float (*transverts)[3], float (*transnors)[3],
+                              int start, int end);
+
+#ifdef __SSE2__
+/// SSE2 version of BL_SkinDeformVerts, used by default when available.
+void BL_SkinDeformVertsSSE2(const BL_SkinInfluences& influences, const float *palette, const MVert *mverts,
+                            const float pre_mat[16], const float post_mat[16], float (*transverts)[3], float (*transnors)[3],
+                            int start, int end);
+#endif
+
+#endif  // __BL_SKINKERNEL_H__
@@ -33,6 +33,8 @@ public:
 	virtual double GetNumber();
 	virtual EXP_Value *Calculate();
 
+	EXP_Value *GetValue() const;
+
 private:
 	EXP_Value *m_value;
 };
@@ -39,6 +39,8 @@ class EXP_IdentifierExpr : public EXP_Expression
 private:
 	EXP_Value *m_idContext;
 	std::string m_identifier;
+	/// Key of the identifier resolved at the parsing, invalid if the identifier is a path with dots.
+	EXP_PropertyKey m_key;
 
 public:
 	EXP_IdentifierExpr(const std::string& identifier, EXP_Value *id_context);
@@ -46,6 +48,9 @@ public:
 
 	virtual EXP_Value *Calculate();
 	virtual unsigned char GetExpressionID();
+
+	const std::string& GetIdentifier() const;
+	const EXP_PropertyKey& GetKey() const;
 };
 
 #endif  // __EXP_IDENTIFIEREXPR_H__
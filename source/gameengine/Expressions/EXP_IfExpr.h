@@ -35,6 +35,10 @@ public:
 
 	virtual unsigned char GetExpressionID();
 	virtual EXP_Value *Calculate();
+
+	EXP_Expression *GetGuard() const;
+	EXP_Expression *GetThenExpression() const;
+	EXP_Expression *GetElseExpression() const;
 };
 
 #endif  // __EXP_IFEXPR_H__
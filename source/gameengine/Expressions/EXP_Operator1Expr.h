@@ -31,6 +31,9 @@ public:
 	virtual unsigned char GetExpressionID();
 	virtual EXP_Value *Calculate();
 
+	VALUE_OPERATOR GetOperator() const;
+	EXP_Expression *GetOperand() const;
+
 private:
 	VALUE_OPERATOR m_op;
 	EXP_Expression *m_lhs;
@@ -32,6 +32,10 @@ public:
 	virtual unsigned char GetExpressionID();
 	virtual EXP_Value *Calculate();
 
+	VALUE_OPERATOR GetOperator() const;
+	EXP_Expression *GetLeftOperand() const;
+	EXP_Expression *GetRightOperand() const;
+
 protected:
 	EXP_Expression *m_rhs;
 	EXP_Expression *m_lhs;
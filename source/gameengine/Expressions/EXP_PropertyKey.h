@@ -0,0 +1,84 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file EXP_PropertyKey.h
+ *  \ingroup expressions
+ */
+
+#ifndef __EXP_PROPERTY_KEY_H__
+#define __EXP_PROPERTY_KEY_H__
+
+#include <string>
+
+/** Interned name of a property. Every distinct name gets a unique id, so a key
+ * resolved once can be used to find a property without comparing or hashing strings.
+ * The names are shared by all the values and scenes and kept until the game engine exits.
+ */
+class EXP_PropertyKey
+{
+private:
+	/// Index of the name in the registry plus one, zero for an invalid key.
+	unsigned int m_id;
+
+	explicit EXP_PropertyKey(unsigned int id);
+
+public:
+	/// Create an invalid key, matching no property.
+	EXP_PropertyKey();
+	/// Create the key of a name, the name is interned if needed.
+	explicit EXP_PropertyKey(const std::string& name);
+
+	/// Return the key of a name without interning it, the key is invalid if the name is unknown.
+	static EXP_PropertyKey Find(const std::string& name);
+
+	inline bool IsValid() const
+	{
+		return (m_id != 0);
+	}
+
+	inline unsigned int GetId() const
+	{
+		return m_id;
+	}
+
+	/** Return the interned name, empty for an invalid key.
+	 * The reference stays valid until ReleaseNames, it can be cached to avoid locking the registry.
+	 */
+	const std::string& GetName() const;
+
+	/** Release all the interned names, the ids are given again from the start.
+	 * Called when the game engine exits, once no value or logic brick uses a key.
+	 */
+	static void ReleaseNames();
+
+	inline bool operator==(const EXP_PropertyKey& other) const
+	{
+		return (m_id == other.m_id);
+	}
+
+	inline bool operator!=(const EXP_PropertyKey& other) const
+	{
+		return (m_id != other.m_id);
+	}
+};
+
+#endif  // __EXP_PROPERTY_KEY_H__
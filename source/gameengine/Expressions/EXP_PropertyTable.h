@@ -0,0 +1,103 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file EXP_PropertyTable.h
+ *  \ingroup expressions
+ */
+
+#ifndef __EXP_PROPERTY_TABLE_H__
+#define __EXP_PROPERTY_TABLE_H__
+
+#include "EXP_PropertyKey.h"
+
+#include <vector>
+
+class EXP_Value;
+
+/// Number of properties stored in the table itself before using an allocated array and an index.
+#define EXP_PROPERTY_TABLE_INLINE_SIZE 4
+
+/** Named properties of a value. The entries are kept sorted by name to iterate them in
+ * alphabetical order. A few entries are stored inline and searched linearly by key, more
+ * entries are stored in an array indexed by an open addressing hash table of the key ids.
+ * The table doesn't manage the reference count of the values.
+ */
+class EXP_PropertyTable
+{
+public:
+	struct Entry
+	{
+		EXP_PropertyKey m_key;
+		/// Interned name of the key, cached to sort the entries without locking the key registry.
+		const std::string *m_name;
+		EXP_Value *m_value;
+	};
+
+private:
+	Entry m_inline[EXP_PROPERTY_TABLE_INLINE_SIZE];
+	/// Entries used when the inline storage is too small.
+	std::vector<Entry> m_entries;
+	unsigned int m_size;
+	/// Entry index plus one of each slot, zero for an empty slot. Used only with the allocated entries.
+	std::vector<unsigned int> m_slots;
+
+	inline Entry *GetEntries()
+	{
+		return (m_size > EXP_PROPERTY_TABLE_INLINE_SIZE) ? m_entries.data() : m_inline;
+	}
+
+	inline const Entry *GetEntries() const
+	{
+		return (m_size > EXP_PROPERTY_TABLE_INLINE_SIZE) ? m_entries.data() : m_inline;
+	}
+
+	/// Build the index of all the entries when the number of entries changes of storage or slot count.
+	void BuildIndex();
+	/// Return the slot of an entry in the index.
+	unsigned int FindSlot(unsigned int index) const;
+
+public:
+	EXP_PropertyTable();
+	~EXP_PropertyTable() = default;
+
+	inline unsigned int GetSize() const
+	{
+		return m_size;
+	}
+
+	inline Entry& operator[](unsigned int index)
+	{
+		return GetEntries()[index];
+	}
+
+	/// Return the value of a key, nullptr if not found.
+	EXP_Value *Find(const EXP_PropertyKey& key) const;
+	/// Return the index of a key, -1 if not found.
+	int FindIndex(const EXP_PropertyKey& key) const;
+
+	/// Insert a value for a key not already in the table, the index is updated in place.
+	void Insert(const EXP_PropertyKey& key, EXP_Value *value);
+	/// Remove the entry at index, the next entries are shifted and the index updated in place.
+	void Remove(unsigned int index);
+};
+
+#endif  // __EXP_PROPERTY_TABLE_H__
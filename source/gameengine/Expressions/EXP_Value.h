@@ -25,7 +25,9 @@
 
 #include "CM_RefCount.h"
 
-#include <map> // Array functionality for the property list.
+#include "EXP_PropertyKey.h"
+
+#include <map>
 #include <vector>
 #include <string> // std::string class.
 
@@ -73,6 +75,25 @@ enum VALUE_DATA_TYPE {
 #include "object.h"
 #endif
 
+class EXP_Value;
+class EXP_PropertyTable;
+
+/** Interface of the objects notified of the modifications of a value instead of polling it,
+ * e.g. the property sensors.
+ */
+class EXP_ValueObserver
+{
+public:
+	virtual ~EXP_ValueObserver()
+	{
+	}
+
+	/// The observed value was modified.
+	virtual void ValueModified(EXP_Value *value) = 0;
+	/// The observed value was removed from its owner or freed, the observer is unregistered.
+	virtual void ValueRemoved(EXP_Value *value) = 0;
+};
+
 /**
  * Baseclass EXP_Value
  *
@@ -125,7 +146,10 @@ public:
 	/// Property Management
 	/// Set property <ioProperty>, overwrites and releases a previous property with the same name if needed.
 	virtual void SetProperty(const std::string& name, EXP_Value *ioProperty);
+	void SetProperty(const EXP_PropertyKey& key, EXP_Value *ioProperty);
 	virtual EXP_Value *GetProperty(const std::string & inName);
+	/// Get pointer to a property from its key without looking up its name, returns nullptr if not found.
+	EXP_Value *GetProperty(const EXP_PropertyKey& key);
 	/// Get text description of property with name <inName>, returns an empty string if there is no property named <inName>.
 	const std::string GetPropertyText(const std::string & inName);
 	float GetPropertyNumber(const std::string& inName, float defnumber);
@@ -141,6 +165,8 @@ public:
 	virtual int GetPropertyCount();
 
 	virtual EXP_Value *FindIdentifier(const std::string& identifiername);
+	/// Find an identifier without dots from its key, returns a new reference or an error value.
+	virtual EXP_Value *FindIdentifier(const EXP_PropertyKey& key);
 
 	virtual std::string GetText();
 	virtual double GetNumber();
@@ -169,12 +195,29 @@ public:
 		return m_error;
 	}
 
+	/// Register an observer notified of the modifications of this value.
+	void RegisterObserver(EXP_ValueObserver *observer);
+	void UnregisterObserver(EXP_ValueObserver *observer);
+
 protected:
 	virtual void DestructFromPython();
 
+	/// Notify the observers that the value was modified, called by the setters of the value types.
+	inline void NotifyModified()
+	{
+		if (m_observers) {
+			NotifyObservers(false);
+		}
+	}
+
 private:
+	/// Notify the observers of a modification or a removal, in case of removal the observers are unregistered.
+	void NotifyObservers(bool removed);
+
 	/// Properties for user/game etc.
-	std::map<std::string, EXP_Value *> *m_pNamedPropertyArray;
+	EXP_PropertyTable *m_properties;
+	/// Observers of the value, allocated only when observed.
+	std::vector<EXP_ValueObserver *> *m_observers;
 	bool m_error;
 };
 
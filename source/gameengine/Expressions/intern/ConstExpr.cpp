@@ -49,3 +49,8 @@ double EXP_ConstExpr::GetNumber()
 {
 	return -1.0;
 }
+
+EXP_Value *EXP_ConstExpr::GetValue() const
+{
+	return m_value;
+}
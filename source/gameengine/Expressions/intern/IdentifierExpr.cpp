@@ -35,6 +35,10 @@
 EXP_IdentifierExpr::EXP_IdentifierExpr(const std::string& identifier, EXP_Value *id_context)
 	:m_identifier(identifier)
 {
+	if (m_identifier.find('.') == std::string::npos) {
+		m_key = EXP_PropertyKey(m_identifier);
+	}
+
 	if (id_context) {
 		m_idContext = id_context->AddRef();
 	}
@@ -54,7 +58,7 @@ EXP_Value *EXP_IdentifierExpr::Calculate()
 {
 	EXP_Value *result = nullptr;
 	if (m_idContext) {
-		result = m_idContext->FindIdentifier(m_identifier);
+		result = (m_key.IsValid()) ? m_idContext->FindIdentifier(m_key) : m_idContext->FindIdentifier(m_identifier);
 	}
 
 	return result;
@@ -64,3 +68,13 @@ unsigned char EXP_IdentifierExpr::GetExpressionID()
 {
 	return CIDENTIFIEREXPRESSIONID;
 }
+
+const std::string& EXP_IdentifierExpr::GetIdentifier() const
+{
+	return m_identifier;
+}
+
+const EXP_PropertyKey& EXP_IdentifierExpr::GetKey() const
+{
+	return m_key;
+}
@@ -67,3 +67,18 @@ unsigned char EXP_IfExpr::GetExpressionID()
 {
 	return CIFEXPRESSIONID;
 }
+
+EXP_Expression *EXP_IfExpr::GetGuard() const
+{
+	return m_guard;
+}
+
+EXP_Expression *EXP_IfExpr::GetThenExpression() const
+{
+	return m_e1;
+}
+
+EXP_Expression *EXP_IfExpr::GetElseExpression() const
+{
+	return m_e2;
+}
@@ -52,3 +52,13 @@ EXP_Value *EXP_Operator1Expr::Calculate()
 
 	return ret;
 }
+
+VALUE_OPERATOR EXP_Operator1Expr::GetOperator() const
+{
+	return m_op;
+}
+
+EXP_Expression *EXP_Operator1Expr::GetOperand() const
+{
+	return m_lhs;
+}
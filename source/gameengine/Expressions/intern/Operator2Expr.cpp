@@ -59,3 +59,18 @@ EXP_Value *EXP_Operator2Expr::Calculate()
 
 	return calculate;
 }
+
+VALUE_OPERATOR EXP_Operator2Expr::GetOperator() const
+{
+	return m_op;
+}
+
+EXP_Expression *EXP_Operator2Expr::GetLeftOperand() const
+{
+	return m_lhs;
+}
+
+EXP_Expression *EXP_Operator2Expr::GetRightOperand() const
+{
+	return m_rhs;
+}
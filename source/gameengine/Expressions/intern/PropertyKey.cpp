@@ -0,0 +1,113 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Expressions/PropertyKey.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_PropertyKey.h"
+
+#include "CM_Thread.h"
+
+#include <unordered_map>
+#include <deque>
+
+/// Names interned by the property keys, shared with the asynchronous library loading threads.
+struct EXP_PropertyKeyRegistry
+{
+	CM_ThreadSpinLock m_lock;
+	/// Interned names, the deque doesn't move them when growing.
+	std::deque<std::string> m_names;
+	std::unordered_map<std::string, unsigned int> m_ids;
+};
+
+static EXP_PropertyKeyRegistry& getRegistry()
+{
+	static EXP_PropertyKeyRegistry registry;
+	return registry;
+}
+
+static const std::string emptyName;
+
+EXP_PropertyKey::EXP_PropertyKey()
+	:m_id(0)
+{
+}
+
+EXP_PropertyKey::EXP_PropertyKey(unsigned int id)
+	:m_id(id)
+{
+}
+
+EXP_PropertyKey::EXP_PropertyKey(const std::string& name)
+{
+	EXP_PropertyKeyRegistry& registry = getRegistry();
+	registry.m_lock.Lock();
+
+	const std::unordered_map<std::string, unsigned int>::const_iterator it = registry.m_ids.find(name);
+	if (it != registry.m_ids.end()) {
+		m_id = it->second;
+	}
+	else {
+		registry.m_names.push_back(name);
+		m_id = registry.m_names.size();
+		registry.m_ids.emplace(name, m_id);
+	}
+
+	registry.m_lock.Unlock();
+}
+
+EXP_PropertyKey EXP_PropertyKey::Find(const std::string& name)
+{
+	EXP_PropertyKeyRegistry& registry = getRegistry();
+	registry.m_lock.Lock();
+
+	const std::unordered_map<std::string, unsigned int>::const_iterator it = registry.m_ids.find(name);
+	const unsigned int id = (it != registry.m_ids.end()) ? it->second : 0;
+
+	registry.m_lock.Unlock();
+
+	return EXP_PropertyKey(id);
+}
+
+const std::string& EXP_PropertyKey::GetName() const
+{
+	if (m_id == 0) {
+		return emptyName;
+	}
+
+	EXP_PropertyKeyRegistry& registry = getRegistry();
+	registry.m_lock.Lock();
+	const std::string& name = registry.m_names[m_id - 1];
+	registry.m_lock.Unlock();
+
+	return name;
+}
+
+void EXP_PropertyKey::ReleaseNames()
+{
+	EXP_PropertyKeyRegistry& registry = getRegistry();
+	registry.m_lock.Lock();
+	registry.m_names.clear();
+	registry.m_ids.clear();
+	registry.m_lock.Unlock();
+}
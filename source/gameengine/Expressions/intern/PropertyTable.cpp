@@ -0,0 +1,192 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Expressions/PropertyTable.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_PropertyTable.h"
+
+#include <algorithm>
+
+/// Mix the bits of a key id, the consecutive ids would otherwise fill consecutive slots.
+static inline unsigned int hashKeyId(unsigned int id)
+{
+	id ^= id >> 16;
+	id *= 0x7FEB352D;
+	id ^= id >> 15;
+	return id;
+}
+
+EXP_PropertyTable::EXP_PropertyTable()
+	:m_size(0)
+{
+}
+
+void EXP_PropertyTable::BuildIndex()
+{
+	if (m_size <= EXP_PROPERTY_TABLE_INLINE_SIZE) {
+		m_slots.clear();
+		return;
+	}
+
+	// Keep the load factor under one half.
+	unsigned int numSlots = 16;
+	while (numSlots < m_size * 2) {
+		numSlots *= 2;
+	}
+
+	m_slots.assign(numSlots, 0);
+	const unsigned int mask = numSlots - 1;
+	for (unsigned int i = 0; i < m_size; ++i) {
+		unsigned int slot = hashKeyId(m_entries[i].m_key.GetId()) & mask;
+		while (m_slots[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+		m_slots[slot] = i + 1;
+	}
+}
+
+unsigned int EXP_PropertyTable::FindSlot(unsigned int index) const
+{
+	const unsigned int mask = m_slots.size() - 1;
+	unsigned int slot = hashKeyId(m_entries[index].m_key.GetId()) & mask;
+	while (m_slots[slot] != index + 1) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+int EXP_PropertyTable::FindIndex(const EXP_PropertyKey& key) const
+{
+	if (m_size <= EXP_PROPERTY_TABLE_INLINE_SIZE) {
+		for (unsigned int i = 0; i < m_size; ++i) {
+			if (m_inline[i].m_key == key) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	const unsigned int mask = m_slots.size() - 1;
+	for (unsigned int slot = hashKeyId(key.GetId()) & mask; m_slots[slot] != 0; slot = (slot + 1) & mask) {
+		const unsigned int index = m_slots[slot] - 1;
+		if (m_entries[index].m_key == key) {
+			return index;
+		}
+	}
+
+	return -1;
+}
+
+EXP_Value *EXP_PropertyTable::Find(const EXP_PropertyKey& key) const
+{
+	const int index = FindIndex(key);
+	return (index != -1) ? GetEntries()[index].m_value : nullptr;
+}
+
+void EXP_PropertyTable::Insert(const EXP_PropertyKey& key, EXP_Value *value)
+{
+	const Entry entry = {key, &key.GetName(), value};
+	const Entry *entries = GetEntries();
+	// Keep the entries sorted by name.
+	const unsigned int index = std::lower_bound(entries, entries + m_size, *entry.m_name,
+		[](const Entry& item, const std::string& name) { return *item.m_name < name; }) - entries;
+
+	if (m_size < EXP_PROPERTY_TABLE_INLINE_SIZE) {
+		std::copy_backward(m_inline + index, m_inline + m_size, m_inline + m_size + 1);
+		m_inline[index] = entry;
+		++m_size;
+		return;
+	}
+
+	// Move the inline entries to the allocated array.
+	if (m_size == EXP_PROPERTY_TABLE_INLINE_SIZE) {
+		m_entries.assign(m_inline, m_inline + m_size);
+	}
+	m_entries.insert(m_entries.begin() + index, entry);
+	++m_size;
+
+	// The index is built when the entries are allocated or when the load factor reaches one half.
+	if (m_slots.size() < m_size * 2) {
+		BuildIndex();
+		return;
+	}
+
+	// Shift the indices of the entries after the inserted one.
+	for (unsigned int& slot : m_slots) {
+		if (slot > index) {
+			++slot;
+		}
+	}
+
+	const unsigned int mask = m_slots.size() - 1;
+	unsigned int slot = hashKeyId(key.GetId()) & mask;
+	while (m_slots[slot] != 0) {
+		slot = (slot + 1) & mask;
+	}
+	m_slots[slot] = index + 1;
+}
+
+void EXP_PropertyTable::Remove(unsigned int index)
+{
+	if (m_size <= EXP_PROPERTY_TABLE_INLINE_SIZE) {
+		std::copy(m_inline + index + 1, m_inline + m_size, m_inline + index);
+		--m_size;
+		return;
+	}
+
+	// Move back the entries to the inline storage.
+	if (m_size == EXP_PROPERTY_TABLE_INLINE_SIZE + 1) {
+		m_entries.erase(m_entries.begin() + index);
+		std::copy(m_entries.begin(), m_entries.end(), m_inline);
+		m_entries.clear();
+		m_slots.clear();
+		--m_size;
+		return;
+	}
+
+	/* Empty the slot of the entry and move back the next slots of the probe sequence
+	 * which can be found from the emptied slot, no tombstone is needed.
+	 */
+	const unsigned int mask = m_slots.size() - 1;
+	unsigned int hole = FindSlot(index);
+	for (unsigned int slot = (hole + 1) & mask; m_slots[slot] != 0; slot = (slot + 1) & mask) {
+		const unsigned int ideal = hashKeyId(m_entries[m_slots[slot] - 1].m_key.GetId()) & mask;
+		// The entry can't move before its ideal slot.
+		if (((slot - ideal) & mask) >= ((slot - hole) & mask)) {
+			m_slots[hole] = m_slots[slot];
+			hole = slot;
+		}
+	}
+	m_slots[hole] = 0;
+
+	m_entries.erase(m_entries.begin() + index);
+	--m_size;
+
+	// Shift the indices of the entries after the removed one.
+	for (unsigned int& slot : m_slots) {
+		if (slot > index + 1) {
+			--slot;
+		}
+	}
+}
@@ -97,6 +97,7 @@ EXP_Value *EXP_StringValue::CalcFinal(VALUE_DATA_TYPE dtype, VALUE_OPERATOR op,
 void EXP_StringValue::SetValue(EXP_Value *newval)
 {
 	m_strString = newval->GetText();
+	NotifyModified();
 }
 
 double EXP_StringValue::GetNumber()
@@ -18,6 +18,7 @@
  *
  */
 #include "EXP_Value.h"
+#include "EXP_PropertyTable.h"
 #include "EXP_BoolValue.h"
 #include "EXP_FloatValue.h"
 #include "EXP_IntValue.h"
@@ -25,6 +26,8 @@
 #include "EXP_ErrorValue.h"
 #include "EXP_ListValue.h"
 
+#include <algorithm>
+
 #ifdef WITH_PYTHON
 
 PyTypeObject EXP_Value::Type = {
@@ -59,7 +62,8 @@ PyMethodDef EXP_Value::Methods[] = {
 #endif  // WITH_PYTHON
 
 EXP_Value::EXP_Value()
-	:m_pNamedPropertyArray(nullptr),
+	:m_properties(nullptr),
+	m_observers(nullptr),
 	m_error(false)
 {
 }
@@ -67,6 +71,10 @@ EXP_Value::EXP_Value()
 EXP_Value::~EXP_Value()
 {
 	ClearProperties();
+
+	if (m_observers) {
+		NotifyObservers(true);
+	}
 }
 
 std::string EXP_Value::op2str(VALUE_OPERATOR op)
@@ -148,6 +156,11 @@ std::string EXP_Value::op2str(VALUE_OPERATOR op)
 
 /// Set property <ioProperty>, overwrites and releases a previous property with the same name if needed.
 void EXP_Value::SetProperty(const std::string & name, EXP_Value *ioProperty)
+{
+	SetProperty(EXP_PropertyKey(name), ioProperty);
+}
+
+void EXP_Value::SetProperty(const EXP_PropertyKey& key, EXP_Value *ioProperty)
 {
 	// Check if somebody is setting an empty property.
 	if (ioProperty == nullptr) {
@@ -156,33 +169,49 @@ void EXP_Value::SetProperty(const std::string & name, EXP_Value *ioProperty)
 	}
 
 	// Try to replace property (if so -> exit as soon as we replaced it).
-	if (m_pNamedPropertyArray) {
-		EXP_Value *oldval = (*m_pNamedPropertyArray)[name];
-		if (oldval) {
+	if (m_properties) {
+		const int index = m_properties->FindIndex(key);
+		if (index != -1) {
+			EXP_PropertyTable::Entry& entry = (*m_properties)[index];
+			EXP_Value *oldval = entry.m_value;
+			entry.m_value = ioProperty->AddRef();
+			// The observers of the old property have to find the new one.
+			if (oldval->m_observers) {
+				oldval->NotifyObservers(true);
+			}
 			oldval->Release();
+			return;
 		}
 	}
 	// Make sure we have a property array.
 	else {
-		m_pNamedPropertyArray = new std::map<std::string, EXP_Value *>;
+		m_properties = new EXP_PropertyTable();
 	}
 
-	// Add property at end of array.
-	(*m_pNamedPropertyArray)[name] = ioProperty->AddRef();
+	m_properties->Insert(key, ioProperty->AddRef());
 }
 
 /// Get pointer to a property with name <inName>, returns nullptr if there is no property named <inName>.
 EXP_Value *EXP_Value::GetProperty(const std::string & inName)
 {
-	if (m_pNamedPropertyArray) {
-		std::map<std::string, EXP_Value *>::iterator it = m_pNamedPropertyArray->find(inName);
-		if (it != m_pNamedPropertyArray->end()) {
-			return (*it).second;
+	if (m_properties) {
+		// An unknown name can't be the name of a property.
+		const EXP_PropertyKey key = EXP_PropertyKey::Find(inName);
+		if (key.IsValid()) {
+			return m_properties->Find(key);
 		}
 	}
 	return nullptr;
 }
 
+EXP_Value *EXP_Value::GetProperty(const EXP_PropertyKey& key)
+{
+	if (m_properties) {
+		return m_properties->Find(key);
+	}
+	return nullptr;
+}
+
 /// Get text description of property with name <inName>, returns an empty string if there is no property named <inName>.
 const std::string EXP_Value::GetPropertyText(const std::string & inName)
 {
@@ -210,11 +239,15 @@ float EXP_Value::GetPropertyNumber(const std::string& inName, float defnumber)
 bool EXP_Value::RemoveProperty(const std::string& inName)
 {
 	// Check if there are properties at all which can be removed.
-	if (m_pNamedPropertyArray) {
-		std::map<std::string, EXP_Value *>::iterator it = m_pNamedPropertyArray->find(inName);
-		if (it != m_pNamedPropertyArray->end()) {
-			((*it).second)->Release();
-			m_pNamedPropertyArray->erase(it);
+	if (m_properties) {
+		const int index = m_properties->FindIndex(EXP_PropertyKey::Find(inName));
+		if (index != -1) {
+			EXP_Value *val = (*m_properties)[index].m_value;
+			m_properties->Remove(index);
+			if (val->m_observers) {
+				val->NotifyObservers(true);
+			}
+			val->Release();
 			return true;
 		}
 	}
@@ -226,15 +259,13 @@ bool EXP_Value::RemoveProperty(const std::string& inName)
 std::vector<std::string> EXP_Value::GetPropertyNames()
 {
 	std::vector<std::string> result;
-	if (!m_pNamedPropertyArray) {
+	if (!m_properties) {
 		return result;
 	}
-	result.reserve(m_pNamedPropertyArray->size());
+	result.reserve(m_properties->GetSize());
 
-	std::map<std::string, EXP_Value *>::iterator it;
-	for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++)
-	{
-		result.push_back((*it).first);
+	for (unsigned int i = 0, size = m_properties->GetSize(); i < size; ++i) {
+		result.push_back(*(*m_properties)[i].m_name);
 	}
 	return result;
 }
@@ -243,46 +274,38 @@ std::vector<std::string> EXP_Value::GetPropertyNames()
 void EXP_Value::ClearProperties()
 {
 	// Check if we have any properties.
-	if (m_pNamedPropertyArray == nullptr) {
+	if (m_properties == nullptr) {
 		return;
 	}
 
 	// Remove all properties.
-	std::map<std::string, EXP_Value *>::iterator it;
-	for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++)
-	{
-		EXP_Value *tmpval = (*it).second;
+	for (unsigned int i = 0, size = m_properties->GetSize(); i < size; ++i) {
+		EXP_Value *tmpval = (*m_properties)[i].m_value;
+		if (tmpval->m_observers) {
+			tmpval->NotifyObservers(true);
+		}
 		tmpval->Release();
 	}
 
 	// Delete property array.
-	delete m_pNamedPropertyArray;
-	m_pNamedPropertyArray = nullptr;
+	delete m_properties;
+	m_properties = nullptr;
 }
 
 /// Get property number <inIndex>.
 EXP_Value *EXP_Value::GetProperty(int inIndex)
 {
-	int count = 0;
-	EXP_Value *result = nullptr;
-
-	if (m_pNamedPropertyArray) {
-		std::map<std::string, EXP_Value *>::iterator it;
-		for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++) {
-			if (count++ == inIndex) {
-				result = (*it).second;
-				break;
-			}
-		}
+	if (m_properties && inIndex >= 0 && inIndex < (int)m_properties->GetSize()) {
+		return (*m_properties)[inIndex].m_value;
 	}
-	return result;
+	return nullptr;
 }
 
 /// Get the amount of properties assiocated with this value.
 int EXP_Value::GetPropertyCount()
 {
-	if (m_pNamedPropertyArray) {
-		return m_pNamedPropertyArray->size();
+	if (m_properties) {
+		return m_properties->GetSize();
 	}
 	else {
 		return 0;
@@ -298,20 +321,63 @@ void EXP_Value::DestructFromPython()
 #endif  // WITH_PYTHON
 }
 
+void EXP_Value::RegisterObserver(EXP_ValueObserver *observer)
+{
+	if (!m_observers) {
+		m_observers = new std::vector<EXP_ValueObserver *>();
+	}
+	m_observers->push_back(observer);
+}
+
+void EXP_Value::UnregisterObserver(EXP_ValueObserver *observer)
+{
+	if (!m_observers) {
+		return;
+	}
+
+	std::vector<EXP_ValueObserver *>::iterator it = std::find(m_observers->begin(), m_observers->end(), observer);
+	if (it != m_observers->end()) {
+		m_observers->erase(it);
+	}
+
+	if (m_observers->empty()) {
+		delete m_observers;
+		m_observers = nullptr;
+	}
+}
+
+void EXP_Value::NotifyObservers(bool removed)
+{
+	if (removed) {
+		// The observers are unregistered before the notification as they can register to an other value.
+		std::vector<EXP_ValueObserver *> *observers = m_observers;
+		m_observers = nullptr;
+		for (EXP_ValueObserver *observer : *observers) {
+			observer->ValueRemoved(this);
+		}
+		delete observers;
+	}
+	else {
+		for (EXP_ValueObserver *observer : *m_observers) {
+			observer->ValueModified(this);
+		}
+	}
+}
+
 void EXP_Value::ProcessReplica()
 {
 	EXP_PyObjectPlus::ProcessReplica();
 
+	// The observers are watching the original value.
+	m_observers = nullptr;
+
 	// Copy all props.
-	if (m_pNamedPropertyArray) {
-		std::map<std::string, EXP_Value *> *pOldArray = m_pNamedPropertyArray;
-		m_pNamedPropertyArray = nullptr;
-		std::map<std::string, EXP_Value *>::iterator it;
-		for (it = pOldArray->begin(); (it != pOldArray->end()); it++)
-		{
-			EXP_Value *val = (*it).second->GetReplica();
-			SetProperty((*it).first, val);
-			val->Release();
+	if (m_properties) {
+		// The table is shared with the original value, copy it and replace its values by replicas.
+		m_properties = new EXP_PropertyTable(*m_properties);
+		for (unsigned int i = 0, size = m_properties->GetSize(); i < size; ++i) {
+			EXP_Value *&value = (*m_properties)[i].m_value;
+			value = value->GetReplica();
 		}
 	}
 }
@@ -347,6 +413,16 @@ EXP_Value *EXP_Value::FindIdentifier(const std::string& identifiername)
 	return result;
 }
 
+EXP_Value *EXP_Value::FindIdentifier(const EXP_PropertyKey& key)
+{
+	EXP_Value *result = GetProperty(key);
+	if (result) {
+		return result->AddRef();
+	}
+
+	return new EXP_ErrorValue(key.GetName() + " not found");
+}
+
 #ifdef WITH_PYTHON
 
 PyAttributeDef EXP_Value::Attributes[] = {
@@ -408,13 +484,11 @@ EXP_Value *EXP_Value::ConvertPythonToValue(PyObject *pyobj, const bool do_type_e
 
 PyObject *EXP_Value::ConvertKeysToPython(void)
 {
-	if (m_pNamedPropertyArray) {
-		PyObject *pylist = PyList_New(m_pNamedPropertyArray->size());
-		Py_ssize_t i = 0;
+	if (m_properties) {
+		PyObject *pylist = PyList_New(m_properties->GetSize());
 
-		std::map<std::string, EXP_Value *>::iterator it;
-		for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++) {
-			PyList_SET_ITEM(pylist, i++, PyUnicode_FromStdString((*it).first));
+		for (unsigned int i = 0, size = m_properties->GetSize(); i < size; ++i) {
+			PyList_SET_ITEM(pylist, i, PyUnicode_FromStdString(*(*m_properties)[i].m_name));
 		}
 
 		return pylist;
@@ -34,6 +34,7 @@
 
 
 #include "SCA_ExpressionController.h"
+#include "SCA_ExpressionProgram.h"
 #include "SCA_ISensor.h"
 #include "SCA_LogicManager.h"
 #include "EXP_BoolValue.h"
@@ -50,7 +51,9 @@ SCA_ExpressionController::SCA_ExpressionController(SCA_IObject* gameobj,
 												   const std::string& exprtext)
 	:SCA_IController(gameobj),
 	m_exprText(exprtext),
-	m_exprCache(nullptr)
+	m_exprCache(nullptr),
+	m_program(nullptr),
+	m_programCompiled(false)
 {
 }
 
@@ -60,6 +63,7 @@ SCA_ExpressionController::~SCA_ExpressionController()
 {
 	if (m_exprCache)
 		m_exprCache->Release();
+	delete m_program;
 }
 
 
@@ -69,6 +73,9 @@ EXP_Value* SCA_ExpressionController::GetReplica()
 	SCA_ExpressionController* replica = new SCA_ExpressionController(*this);
 	replica->m_exprText = m_exprText;
 	replica->m_exprCache = nullptr;
+	// The program references the sensors of the original.
+	replica->m_program = nullptr;
+	replica->m_programCompiled = false;
 	// this will copy properties and so on...
 	replica->ProcessReplica();
 
@@ -85,10 +92,34 @@ void SCA_ExpressionController::Delete()
 		m_exprCache->Release();
 		m_exprCache = nullptr;
 	}
+	delete m_program;
+	m_program = nullptr;
+	m_programCompiled = false;
 	Release();
 }
 
 
+bool SCA_ExpressionController::CalculateExpression()
+{
+	bool expressionresult = false;
+	EXP_Value* value = m_exprCache->Calculate();
+	if (value)
+	{
+		if (value->IsError())
+		{
+			CM_LogicBrickError(this, value->GetText());
+		} else
+		{
+			float num = (float)value->GetNumber();
+			expressionresult = !MT_fuzzyZero(num);
+		}
+		value->Release();
+
+	}
+
+	return expressionresult;
+}
+
 void SCA_ExpressionController::Trigger(SCA_LogicManager* logicmgr)
 {
 
@@ -101,19 +132,24 @@ void SCA_ExpressionController::Trigger(SCA_LogicManager* logicmgr)
 	}
 	if (m_exprCache)
 	{
-		EXP_Value* value = m_exprCache->Calculate();
-		if (value)
-		{
-			if (value->IsError())
-			{
-				CM_LogicBrickError(this, value->GetText());
-			} else
-			{
-				float num = (float)value->GetNumber();
-				expressionresult = !MT_fuzzyZero(num);
-			}
-			value->Release();
+		// The sensors are resolved at the compilation, compile again if the links changed.
+		if (m_programCompiled && m_program && !m_program->IsBoundTo(m_linkedsensors)) {
+			delete m_program;
+			m_program = nullptr;
+			m_programCompiled = false;
+		}
+		if (!m_programCompiled) {
+			m_program = SCA_ExpressionProgram::Compile(m_exprCache, m_linkedsensors);
+			m_programCompiled = true;
+		}
 
+		const SCA_ExpressionProgram::Result result = (m_program) ?
+			m_program->Execute(GetParent()) : SCA_ExpressionProgram::RESULT_FALLBACK;
+		if (result == SCA_ExpressionProgram::RESULT_FALLBACK) {
+			expressionresult = CalculateExpression();
+		}
+		else {
+			expressionresult = (result == SCA_ExpressionProgram::RESULT_TRUE);
 		}
 	}
 
@@ -156,3 +192,17 @@ EXP_Value* SCA_ExpressionController::FindIdentifier(const std::string& identifie
 	return  GetParent()->FindIdentifier(identifiername);
 
 }
+
+EXP_Value *SCA_ExpressionController::FindIdentifier(const EXP_PropertyKey& key)
+{
+	if (!m_linkedsensors.empty()) {
+		const std::string& identifiername = key.GetName();
+		for (SCA_ISensor *sensor : m_linkedsensors) {
+			if (sensor->GetName() == identifiername) {
+				return new EXP_BoolValue(sensor->GetState());
+			}
+		}
+	}
+
+	return GetParent()->FindIdentifier(key);
+}
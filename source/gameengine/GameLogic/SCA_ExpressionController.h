@@ -38,12 +38,20 @@
 #include "SCA_IController.h"
 
 class EXP_Expression;
+class SCA_ExpressionProgram;
 
 class SCA_ExpressionController : public SCA_IController
 {
 //	Py_Header
 	std::string			m_exprText;
 	EXP_Expression*		m_exprCache;
+	/// Compiled expression, nullptr if the expression can only be calculated by the tree.
+	SCA_ExpressionProgram *m_program;
+	/// The expression was compiled for the current linked sensors.
+	bool m_programCompiled;
+
+	/// Calculate the expression tree.
+	bool CalculateExpression();
 
 public:
 	SCA_ExpressionController(SCA_IObject* gameobj,
@@ -53,6 +61,7 @@ public:
 	virtual EXP_Value* GetReplica();
 	virtual void Trigger(SCA_LogicManager* logicmgr);
 	virtual EXP_Value*		FindIdentifier(const std::string& identifiername);
+	virtual EXP_Value *FindIdentifier(const EXP_PropertyKey& key);
 	/** 
 	 *  used to release the expression cache
 	 *  so that self references are removed before the controller itself is released
@@ -0,0 +1,603 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/GameLogic/SCA_ExpressionProgram.cpp
+ *  \ingroup gamelogic
+ */
+
+#include "SCA_ExpressionProgram.h"
+#include "SCA_ISensor.h"
+
+#include "EXP_ConstExpr.h"
+#include "EXP_IdentifierExpr.h"
+#include "EXP_IfExpr.h"
+#include "EXP_Operator1Expr.h"
+#include "EXP_Operator2Expr.h"
+#include "EXP_FloatValue.h"
+#include "EXP_BoolValue.h"
+
+#include "MT_Scalar.h" // for fuzzyZero
+
+#include <cmath>
+#include <climits>
+
+SCA_ExpressionProgram::SCA_ExpressionProgram(const std::vector<SCA_ISensor *>& linkedsensors)
+	:m_linkedSensors(linkedsensors)
+{
+}
+
+SCA_ExpressionProgram::~SCA_ExpressionProgram()
+{
+}
+
+SCA_ExpressionProgram *SCA_ExpressionProgram::Compile(EXP_Expression *expr, const std::vector<SCA_ISensor *>& linkedsensors)
+{
+	SCA_ExpressionProgram *program = new SCA_ExpressionProgram(linkedsensors);
+
+	unsigned int depth = 0;
+	// The jump targets are stored on 16 bits.
+	if (!program->Emit(expr, linkedsensors, depth) || program->m_instructions.size() > USHRT_MAX) {
+		delete program;
+		return nullptr;
+	}
+
+	return program;
+}
+
+void SCA_ExpressionProgram::AddInstruction(Opcode opcode, unsigned char op, unsigned int arg)
+{
+	Instruction instruction;
+	instruction.m_opcode = opcode;
+	instruction.m_operator = op;
+	instruction.m_arg = arg;
+	m_instructions.push_back(instruction);
+}
+
+bool SCA_ExpressionProgram::Emit(EXP_Expression *expr, const std::vector<SCA_ISensor *>& linkedsensors, unsigned int& depth)
+{
+	switch (expr->GetExpressionID()) {
+		case EXP_Expression::CCONSTEXPRESSIONID:
+		{
+			Slot slot;
+			if (depth == SCA_EXPRESSION_PROGRAM_MAX_STACK || m_constants.size() == USHRT_MAX ||
+				!ToSlot(static_cast<EXP_ConstExpr *>(expr)->GetValue(), slot))
+			{
+				return false;
+			}
+
+			AddInstruction(OP_CONSTANT, 0, m_constants.size());
+			m_constants.push_back(slot);
+			++depth;
+			return true;
+		}
+		case EXP_Expression::CIDENTIFIEREXPRESSIONID:
+		{
+			EXP_IdentifierExpr *identifierExpr = static_cast<EXP_IdentifierExpr *>(expr);
+			const EXP_PropertyKey& key = identifierExpr->GetKey();
+			// Paths with dots are resolved by the tree only.
+			if (depth == SCA_EXPRESSION_PROGRAM_MAX_STACK || !key.IsValid() ||
+				m_sensors.size() == USHRT_MAX || m_keys.size() == USHRT_MAX)
+			{
+				return false;
+			}
+
+			// The linked sensors hide the properties of the same name, as in SCA_ExpressionController::FindIdentifier.
+			const std::string& name = identifierExpr->GetIdentifier();
+			for (unsigned int i = 0, size = linkedsensors.size(); i < size; ++i) {
+				SCA_ISensor *sensor = linkedsensors[i];
+				if (sensor->GetName() == name) {
+					AddInstruction(OP_SENSOR, 0, m_sensors.size());
+					m_sensors.push_back(sensor);
+					++depth;
+					return true;
+				}
+			}
+
+			AddInstruction(OP_PROPERTY, 0, m_keys.size());
+			m_keys.push_back(key);
+			++depth;
+			return true;
+		}
+		case EXP_Expression::COPERATOR1EXPRESSIONID:
+		{
+			EXP_Operator1Expr *operatorExpr = static_cast<EXP_Operator1Expr *>(expr);
+			const VALUE_OPERATOR op = operatorExpr->GetOperator();
+			if (op != VALUE_NEG_OPERATOR && op != VALUE_POS_OPERATOR && op != VALUE_NOT_OPERATOR) {
+				return false;
+			}
+
+			if (!Emit(operatorExpr->GetOperand(), linkedsensors, depth)) {
+				return false;
+			}
+
+			AddInstruction(OP_UNARY, op, 0);
+			return true;
+		}
+		case EXP_Expression::COPERATOR2EXPRESSIONID:
+		{
+			EXP_Operator2Expr *operatorExpr = static_cast<EXP_Operator2Expr *>(expr);
+			const VALUE_OPERATOR op = operatorExpr->GetOperator();
+			switch (op) {
+				case VALUE_MOD_OPERATOR:
+				case VALUE_ADD_OPERATOR:
+				case VALUE_SUB_OPERATOR:
+				case VALUE_MUL_OPERATOR:
+				case VALUE_DIV_OPERATOR:
+				case VALUE_AND_OPERATOR:
+				case VALUE_OR_OPERATOR:
+				case VALUE_EQL_OPERATOR:
+				case VALUE_NEQ_OPERATOR:
+				case VALUE_GRE_OPERATOR:
+				case VALUE_LES_OPERATOR:
+				case VALUE_GEQ_OPERATOR:
+				case VALUE_LEQ_OPERATOR:
+				{
+					break;
+				}
+				default:
+				{
+					return false;
+				}
+			}
+
+			// Both operands are always calculated, as in EXP_Operator2Expr::Calculate.
+			if (!Emit(operatorExpr->GetLeftOperand(), linkedsensors, depth) ||
+				!Emit(operatorExpr->GetRightOperand(), linkedsensors, depth))
+			{
+				return false;
+			}
+
+			AddInstruction(OP_BINARY, op, 0);
+			--depth;
+			return true;
+		}
+		case EXP_Expression::CIFEXPRESSIONID:
+		{
+			EXP_IfExpr *ifExpr = static_cast<EXP_IfExpr *>(expr);
+			if (!Emit(ifExpr->GetGuard(), linkedsensors, depth)) {
+				return false;
+			}
+
+			const unsigned int jumpElse = m_instructions.size();
+			AddInstruction(OP_JUMP_IF_FALSE, 0, 0);
+			--depth;
+
+			if (!Emit(ifExpr->GetThenExpression(), linkedsensors, depth)) {
+				return false;
+			}
+			--depth;
+
+			const unsigned int jumpEnd = m_instructions.size();
+			AddInstruction(OP_JUMP, 0, 0);
+
+			m_instructions[jumpElse].m_arg = m_instructions.size();
+			// A missing else is a constant empty value and is not compiled.
+			if (!Emit(ifExpr->GetElseExpression(), linkedsensors, depth)) {
+				return false;
+			}
+			m_instructions[jumpEnd].m_arg = m_instructions.size();
+
+			return true;
+		}
+		default:
+		{
+			return false;
+		}
+	}
+}
+
+bool SCA_ExpressionProgram::ToSlot(EXP_Value *value, Slot& slot)
+{
+	switch (value->GetValueType()) {
+		case VALUE_INT_TYPE:
+		{
+			slot.m_type = SLOT_INT;
+			slot.m_int = static_cast<EXP_IntValue *>(value)->GetInt();
+			return true;
+		}
+		case VALUE_FLOAT_TYPE:
+		{
+			slot.m_type = SLOT_FLOAT;
+			slot.m_float = static_cast<EXP_FloatValue *>(value)->GetFloat();
+			return true;
+		}
+		case VALUE_BOOL_TYPE:
+		{
+			slot.m_type = SLOT_BOOL;
+			slot.m_bool = static_cast<EXP_BoolValue *>(value)->GetBool();
+			return true;
+		}
+		default:
+		{
+			return false;
+		}
+	}
+}
+
+static inline void SetBool(bool value, bool& result, bool& isBool)
+{
+	result = value;
+	isBool = true;
+}
+
+/* The operations below mirror EXP_IntValue, EXP_FloatValue and EXP_BoolValue::CalcFinal
+ * with the same C++ types, so the results are identical. The cases returning an error value
+ * there return false to fallback to the tree.
+ */
+
+bool SCA_ExpressionProgram::CalcUnary(VALUE_OPERATOR op, Slot& value)
+{
+	switch (value.m_type) {
+		case SLOT_INT:
+		{
+			switch (op) {
+				case VALUE_NEG_OPERATOR:
+				{
+					value.m_int = -value.m_int;
+					return true;
+				}
+				case VALUE_POS_OPERATOR:
+				{
+					return true;
+				}
+				case VALUE_NOT_OPERATOR:
+				{
+					const bool result = (value.m_int == 0);
+					value.m_type = SLOT_BOOL;
+					value.m_bool = result;
+					return true;
+				}
+				default:
+				{
+					return false;
+				}
+			}
+		}
+		case SLOT_FLOAT:
+		{
+			switch (op) {
+				case VALUE_NEG_OPERATOR:
+				{
+					value.m_float = -value.m_float;
+					return true;
+				}
+				case VALUE_POS_OPERATOR:
+				{
+					return true;
+				}
+				case VALUE_NOT_OPERATOR:
+				{
+					const bool result = (value.m_float == 0);
+					value.m_type = SLOT_BOOL;
+					value.m_bool = result;
+					return true;
+				}
+				default:
+				{
+					return false;
+				}
+			}
+		}
+		case SLOT_BOOL:
+		{
+			if (op == VALUE_NOT_OPERATOR) {
+				value.m_bool = !value.m_bool;
+				return true;
+			}
+			return false;
+		}
+	}
+
+	return false;
+}
+
+bool SCA_ExpressionProgram::CalcBinary(VALUE_OPERATOR op, Slot& left, const Slot& right)
+{
+	bool result;
+	bool isBool = false;
+
+	if (left.m_type == SLOT_BOOL || right.m_type == SLOT_BOOL) {
+		// Booleans don't mix with numbers.
+		if (left.m_type != right.m_type) {
+			return false;
+		}
+
+		switch (op) {
+			case VALUE_AND_OPERATOR:
+			{
+				left.m_bool = left.m_bool && right.m_bool;
+				return true;
+			}
+			case VALUE_OR_OPERATOR:
+			{
+				left.m_bool = left.m_bool || right.m_bool;
+				return true;
+			}
+			case VALUE_EQL_OPERATOR:
+			{
+				left.m_bool = (left.m_bool == right.m_bool);
+				return true;
+			}
+			case VALUE_NEQ_OPERATOR:
+			{
+				left.m_bool = (left.m_bool != right.m_bool);
+				return true;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+	}
+
+	if (left.m_type == SLOT_INT && right.m_type == SLOT_INT) {
+		const cInt l = left.m_int;
+		const cInt r = right.m_int;
+		switch (op) {
+			case VALUE_MOD_OPERATOR:
+			{
+				if (r == 0) {
+					return false;
+				}
+				left.m_int = l % r;
+				break;
+			}
+			case VALUE_ADD_OPERATOR:
+			{
+				left.m_int = l + r;
+				break;
+			}
+			case VALUE_SUB_OPERATOR:
+			{
+				left.m_int = l - r;
+				break;
+			}
+			case VALUE_MUL_OPERATOR:
+			{
+				left.m_int = l * r;
+				break;
+			}
+			case VALUE_DIV_OPERATOR:
+			{
+				if (r == 0) {
+					return false;
+				}
+				left.m_int = l / r;
+				break;
+			}
+			case VALUE_EQL_OPERATOR:
+			{
+				SetBool(l == r, result, isBool);
+				break;
+			}
+			case VALUE_NEQ_OPERATOR:
+			{
+				SetBool(l != r, result, isBool);
+				break;
+			}
+			case VALUE_GRE_OPERATOR:
+			{
+				SetBool(l > r, result, isBool);
+				break;
+			}
+			case VALUE_LES_OPERATOR:
+			{
+				SetBool(l < r, result, isBool);
+				break;
+			}
+			case VALUE_GEQ_OPERATOR:
+			{
+				SetBool(l >= r, result, isBool);
+				break;
+			}
+			case VALUE_LEQ_OPERATOR:
+			{
+				SetBool(l <= r, result, isBool);
+				break;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+	}
+	else {
+		// At least one float operand, the integer is converted to float as in the mixed operations of the values.
+		const float l = (left.m_type == SLOT_INT) ? left.m_int : left.m_float;
+		const float r = (right.m_type == SLOT_INT) ? right.m_int : right.m_float;
+		float value;
+		switch (op) {
+			case VALUE_MOD_OPERATOR:
+			{
+				// The integer operand of fmod is promoted to double, not float.
+				const double dl = (left.m_type == SLOT_INT) ? (double)left.m_int : (double)left.m_float;
+				const double dr = (right.m_type == SLOT_INT) ? (double)right.m_int : (double)right.m_float;
+				value = fmod(dl, dr);
+				break;
+			}
+			case VALUE_ADD_OPERATOR:
+			{
+				value = l + r;
+				break;
+			}
+			case VALUE_SUB_OPERATOR:
+			{
+				value = l - r;
+				break;
+			}
+			case VALUE_MUL_OPERATOR:
+			{
+				value = l * r;
+				break;
+			}
+			case VALUE_DIV_OPERATOR:
+			{
+				if (r == 0) {
+					return false;
+				}
+				value = l / r;
+				break;
+			}
+			case VALUE_EQL_OPERATOR:
+			{
+				SetBool(l == r, result, isBool);
+				break;
+			}
+			case VALUE_NEQ_OPERATOR:
+			{
+				SetBool(l != r, result, isBool);
+				break;
+			}
+			case VALUE_GRE_OPERATOR:
+			{
+				SetBool(l > r, result, isBool);
+				break;
+			}
+			case VALUE_LES_OPERATOR:
+			{
+				SetBool(l < r, result, isBool);
+				break;
+			}
+			case VALUE_GEQ_OPERATOR:
+			{
+				SetBool(l >= r, result, isBool);
+				break;
+			}
+			case VALUE_LEQ_OPERATOR:
+			{
+				SetBool(l <= r, result, isBool);
+				break;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+
+		if (!isBool) {
+			left.m_type = SLOT_FLOAT;
+			left.m_float = value;
+		}
+	}
+
+	if (isBool) {
+		left.m_type = SLOT_BOOL;
+		left.m_bool = result;
+	}
+
+	return true;
+}
+
+bool SCA_ExpressionProgram::IsBoundTo(const std::vector<SCA_ISensor *>& linkedsensors) const
+{
+	/* The whole list is compared and not only the sensors read by the program:
+	 * a new linked sensor can hide an identifier compiled as a property. */
+	return (linkedsensors == m_linkedSensors);
+}
+
+SCA_ExpressionProgram::Result SCA_ExpressionProgram::Execute(EXP_Value *object) const
+{
+	Slot stack[SCA_EXPRESSION_PROGRAM_MAX_STACK];
+	unsigned int top = 0;
+
+	const Instruction *instructions = m_instructions.data();
+	for (unsigned int pc = 0, size = m_instructions.size(); pc < size;) {
+		const Instruction& instruction = instructions[pc++];
+		switch (instruction.m_opcode) {
+			case OP_CONSTANT:
+			{
+				stack[top++] = m_constants[instruction.m_arg];
+				break;
+			}
+			case OP_SENSOR:
+			{
+				Slot& slot = stack[top++];
+				slot.m_type = SLOT_BOOL;
+				slot.m_bool = m_sensors[instruction.m_arg]->GetState();
+				break;
+			}
+			case OP_PROPERTY:
+			{
+				// The property can be removed or change of type at any time.
+				EXP_Value *property = object->GetProperty(m_keys[instruction.m_arg]);
+				if (!property || !ToSlot(property, stack[top++])) {
+					return RESULT_FALLBACK;
+				}
+				break;
+			}
+			case OP_UNARY:
+			{
+				if (!CalcUnary((VALUE_OPERATOR)instruction.m_operator, stack[top - 1])) {
+					return RESULT_FALLBACK;
+				}
+				break;
+			}
+			case OP_BINARY:
+			{
+				--top;
+				if (!CalcBinary((VALUE_OPERATOR)instruction.m_operator, stack[top - 1], stack[top])) {
+					return RESULT_FALLBACK;
+				}
+				break;
+			}
+			case OP_JUMP_IF_FALSE:
+			{
+				// The tree only accepts a boolean guard.
+				const Slot& guard = stack[--top];
+				if (guard.m_type != SLOT_BOOL) {
+					return RESULT_FALLBACK;
+				}
+				if (!guard.m_bool) {
+					pc = instruction.m_arg;
+				}
+				break;
+			}
+			case OP_JUMP:
+			{
+				pc = instruction.m_arg;
+				break;
+			}
+		}
+	}
+
+	// Same conversion as SCA_ExpressionController::Trigger with EXP_Value::GetNumber.
+	const Slot& value = stack[0];
+	double number;
+	switch (value.m_type) {
+		case SLOT_INT:
+		{
+			number = (double)value.m_int;
+			break;
+		}
+		case SLOT_FLOAT:
+		{
+			number = value.m_float;
+			break;
+		}
+		case SLOT_BOOL:
+		default:
+		{
+			number = (double)value.m_bool;
+			break;
+		}
+	}
+
+	return MT_fuzzyZero((float)number) ? RESULT_FALSE : RESULT_TRUE;
+}
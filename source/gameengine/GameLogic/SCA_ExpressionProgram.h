@@ -0,0 +1,137 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file SCA_ExpressionProgram.h
+ *  \ingroup gamelogic
+ */
+
+#ifndef __SCA_EXPRESSIONPROGRAM_H__
+#define __SCA_EXPRESSIONPROGRAM_H__
+
+#include "EXP_Value.h"
+#include "EXP_IntValue.h"
+#include "EXP_PropertyKey.h"
+
+#include <vector>
+
+/// Maximum number of values on the stack of a program, deeper expressions are not compiled.
+#define SCA_EXPRESSION_PROGRAM_MAX_STACK 32
+
+class EXP_Expression;
+class SCA_ISensor;
+
+/** Expression of a controller compiled to a stack bytecode. The program reads the states of the
+ * linked sensors and the properties of the object directly and evaluates with typed values on
+ * a fixed size stack, without allocating any value.
+ * The program only covers the integer, float and boolean values. When an operation
+ * would produce anything else, e.g. a string or an error, the evaluation is cancelled and the
+ * expression tree must be calculated instead to get the exact result and error message.
+ */
+class SCA_ExpressionProgram
+{
+public:
+	enum Result {
+		RESULT_FALSE = 0,
+		RESULT_TRUE,
+		/// The program can't evaluate the expression with the current values.
+		RESULT_FALLBACK
+	};
+
+private:
+	enum Opcode {
+		/// Push the constant at index m_arg.
+		OP_CONSTANT = 0,
+		/// Push the state of the sensor at index m_arg.
+		OP_SENSOR,
+		/// Push the object property of key at index m_arg.
+		OP_PROPERTY,
+		/// Replace the top value by the result of the unary operator.
+		OP_UNARY,
+		/// Replace the two top values by the result of the binary operator.
+		OP_BINARY,
+		/// Pop the boolean guard and jump to the instruction m_arg if false.
+		OP_JUMP_IF_FALSE,
+		/// Jump to the instruction m_arg.
+		OP_JUMP
+	};
+
+	enum SlotType {
+		SLOT_INT = 0,
+		SLOT_FLOAT,
+		SLOT_BOOL
+	};
+
+	struct Slot {
+		SlotType m_type;
+		union {
+			cInt m_int;
+			float m_float;
+			bool m_bool;
+		};
+	};
+
+	struct Instruction {
+		unsigned char m_opcode;
+		unsigned char m_operator;
+		unsigned short m_arg;
+	};
+
+	std::vector<Instruction> m_instructions;
+	std::vector<Slot> m_constants;
+	std::vector<EXP_PropertyKey> m_keys;
+	/// Sensors read by the program.
+	std::vector<SCA_ISensor *> m_sensors;
+	/** Linked sensors of the controller at the compilation, any of them can hide
+	 * a property of the same name.
+	 */
+	std::vector<SCA_ISensor *> m_linkedSensors;
+
+	SCA_ExpressionProgram(const std::vector<SCA_ISensor *>& linkedsensors);
+
+	/** Emit the instructions of an expression node.
+	 * \param depth The stack depth before the node, increased by one on success.
+	 * \return False if the node can't be compiled.
+	 */
+	bool Emit(EXP_Expression *expr, const std::vector<SCA_ISensor *>& linkedsensors, unsigned int& depth);
+	void AddInstruction(Opcode opcode, unsigned char op, unsigned int arg);
+
+	static bool ToSlot(EXP_Value *value, Slot& slot);
+	static bool CalcUnary(VALUE_OPERATOR op, Slot& value);
+	static bool CalcBinary(VALUE_OPERATOR op, Slot& left, const Slot& right);
+
+public:
+	~SCA_ExpressionProgram();
+
+	/** Compile an expression parsed for a controller.
+	 * \param linkedsensors The linked sensors of the controller, looked up before the properties.
+	 * \return The program or nullptr if the expression uses unsupported nodes.
+	 */
+	static SCA_ExpressionProgram *Compile(EXP_Expression *expr, const std::vector<SCA_ISensor *>& linkedsensors);
+
+	/// Return true if the program was compiled for these linked sensors.
+	bool IsBoundTo(const std::vector<SCA_ISensor *>& linkedsensors) const;
+
+	/** Evaluate the program.
+	 * \param object The object owning the properties.
+	 */
+	Result Execute(EXP_Value *object) const;
+};
+
+#endif  // __SCA_EXPRESSIONPROGRAM_H__
@@ -41,7 +41,9 @@
 SCA_IController::SCA_IController(SCA_IObject *gameobj)
 	:SCA_ILogicBrick(gameobj),
 	m_statemask(0),
-	m_justActivated(false)
+	m_justActivated(false),
+	m_bookmark(false),
+	m_triggered(false)
 {
 }
 
@@ -49,6 +51,13 @@ SCA_IController::~SCA_IController()
 {
 }
 
+void SCA_IController::ProcessReplica()
+{
+	SCA_ILogicBrick::ProcessReplica();
+	// The replica is not in the queue of the logic manager.
+	m_triggered = false;
+}
+
 std::vector<SCA_ISensor *>& SCA_IController::GetLinkedSensors()
 {
 	return m_linkedsensors;
@@ -161,12 +170,6 @@ void SCA_IController::ApplyState(unsigned int state)
 	}
 }
 
-void SCA_IController::Deactivate()
-{
-	// the controller can only be part of a sensor m_newControllers list
-	Delink();
-}
-
 bool SCA_IController::IsJustActivated()
 {
 	return m_justActivated;
@@ -182,20 +185,19 @@ void SCA_IController::SetBookmark(bool bookmark)
 	m_bookmark = bookmark;
 }
 
-void SCA_IController::Activate(SG_DList& head)
+bool SCA_IController::IsBookmark() const
 {
-	if (QEmpty()) {
-		if (m_bookmark) {
-			SG_QList& list = SCA_IObject::GetActiveBookmarkedControllers();
-			list.QAddBack(this);
-			head.AddFront(&list);
-		}
-		else {
-			SG_QList& list = m_gameobj->GetActiveActuators();
-			InsertActiveQList(list);
-			head.AddBack(&list);
-		}
-	}
+	return m_bookmark;
+}
+
+bool SCA_IController::IsTriggered() const
+{
+	return m_triggered;
+}
+
+void SCA_IController::SetTriggered(bool triggered)
+{
+	m_triggered = triggered;
 }
 
 #ifdef WITH_PYTHON
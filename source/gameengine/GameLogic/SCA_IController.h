@@ -36,8 +36,8 @@
 
 /**
  * Use of SG_DList element: none
- * Use of SG_QList element: build ordered list of activated controller on the owner object
- *                          Head: SCA_IObject::m_activeControllers
+ * Use of SG_QList element: none
+ * The triggered controllers are queued in SCA_LogicManager::m_triggeredControllers.
  */
 class SCA_IController : public SCA_ILogicBrick
 {
@@ -49,12 +49,15 @@ protected:
 	unsigned int m_statemask;
 	bool m_justActivated;
 	bool m_bookmark;
+	/// True while the controller is in the triggered controllers queue of the logic manager.
+	bool m_triggered;
 
 public:
 	SCA_IController(SCA_IObject *gameobj);
 	virtual ~SCA_IController();
 
 	virtual void Trigger(SCA_LogicManager *logicmgr) = 0;
+	virtual void ProcessReplica();
 
 	void LinkToSensor(SCA_ISensor *sensor);
 	void LinkToActuator(SCA_IActuator *);
@@ -66,11 +69,12 @@ public:
 	void UnlinkSensor(SCA_ISensor *sensor);
 	void SetState(unsigned int state);
 	void ApplyState(unsigned int state);
-	void Deactivate();
 	bool IsJustActivated();
 	void ClrJustActivated();
 	void SetBookmark(bool bookmark);
-	void Activate(SG_DList& head);
+	bool IsBookmark() const;
+	bool IsTriggered() const;
+	void SetTriggered(bool triggered);
 
 #ifdef WITH_PYTHON
 	static PyObject *pyattr_get_state(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
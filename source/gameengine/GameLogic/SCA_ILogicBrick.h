@@ -60,6 +60,10 @@ public:
 	virtual ~SCA_ILogicBrick();
 
 	void SetExecutePriority(int execute_Priority);
+	int GetExecutePriority() const
+	{
+		return m_Execute_Priority;
+	}
 	void SetUeberExecutePriority(int execute_Priority);
 
 	SCA_IObject*	GetParent() { return m_gameobj; }
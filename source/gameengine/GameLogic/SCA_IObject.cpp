@@ -39,8 +39,6 @@
 #include "MT_Vector3.h"
 #include "EXP_ListValue.h"
 
-SG_QList SCA_IObject::m_activeBookmarkedControllers;
-
 SCA_IObject::SCA_IObject()
 	:m_initState(0),
 	m_state(0),
@@ -50,6 +48,11 @@ SCA_IObject::SCA_IObject()
 }
 
 SCA_IObject::~SCA_IObject()
+{
+	ClearLogic();
+}
+
+void SCA_IObject::ClearLogic()
 {
 	for (SCA_ISensor *sensor : m_sensors) {
 		// Use Delete for sensor to ensure proper cleaning.
@@ -69,6 +72,24 @@ SCA_IObject::~SCA_IObject()
 	for (SCA_IObject *object : m_registeredObjects) {
 		object->UnlinkObject(this);
 	}
+
+	m_sensors.clear();
+	m_controllers.clear();
+	m_actuators.clear();
+	m_registeredActuators.clear();
+	m_registeredObjects.clear();
+	m_firstState = nullptr;
+}
+
+void SCA_IObject::ShareLogic(SCA_IObject *other)
+{
+	BLI_assert(m_sensors.empty() && m_controllers.empty() && m_actuators.empty());
+
+	// The bricks are not owned until ReParentLogic replaces them by replicas.
+	m_sensors = other->m_sensors;
+	m_controllers = other->m_controllers;
+	m_actuators = other->m_actuators;
+	m_state = 0;
 }
 
 SCA_ControllerList& SCA_IObject::GetControllers()
@@ -88,11 +109,6 @@ SG_QList& SCA_IObject::GetActiveActuators()
 	return m_activeActuators;
 }
 
-SG_QList& SCA_IObject::GetActiveBookmarkedControllers()
-{
-	return m_activeBookmarkedControllers;
-}
-
 void SCA_IObject::AddSensor(SCA_ISensor *act)
 {
 	act->AddRef();
@@ -265,6 +281,11 @@ void SCA_IObject::Resume()
 	}
 }
 
+bool SCA_IObject::IsSuspended() const
+{
+	return m_suspended;
+}
+
 void SCA_IObject::SetInitState(unsigned int initState)
 {
 	m_initState = initState;
@@ -69,20 +69,6 @@ protected:
 	 */
 	SG_QList m_activeActuators;
 
-	/** SG_Dlist: element of list os lists with active controllers
-	 *            Head: SCA_LogicManager::m_activeControllers
-	 *  SG_QList: Head of active controller list on this object
-	 *            Elements: SCA_IController
-	 */
-	SG_QList m_activeControllers;
-
-	/** SG_Dlist: element of list of lists of active controllers
-	 *            Head: SCA_LogicManager::m_activeControllers
-	 *  SG_QList: Head of active bookmarked controller list globally
-	 *            Elements: SCA_IController with bookmark option
-	 */
-	static SG_QList m_activeBookmarkedControllers;
-
 	/// Ignore activity culling requests?
 	bool m_ignore_activity_culling;
 
@@ -106,7 +92,6 @@ public:
 	SCA_SensorList& GetSensors();
 	SCA_ActuatorList& GetActuators();
 	SG_QList& GetActiveActuators();
-	static SG_QList& GetActiveBookmarkedControllers();
 
 	void AddSensor(SCA_ISensor *act);
 	void ReserveSensor(int num);
@@ -132,6 +117,15 @@ public:
 
 	virtual void ReParentLogic();
 
+	/** Delete the logic bricks and unlink the bricks and objects using this object,
+	 * as done when the object is destructed.
+	 */
+	void ClearLogic();
+	/** Use the logic bricks of an other object, they must be replicated with ReParentLogic
+	 * as for a new replica. Used to reuse a replica of the object after ClearLogic.
+	 */
+	void ShareLogic(SCA_IObject *other);
+
 	/// Set whether or not to ignore activity culling requests.
 	void SetIgnoreActivityCulling(bool b);
 
@@ -147,6 +141,9 @@ public:
 	/// Resume progress.
 	void Resume();
 
+	/// Return true if the object is suspended by the activity culling.
+	bool IsSuspended() const;
+
 	/// Set init state.
 	void SetInitState(unsigned int initState);
 
@@ -37,8 +37,25 @@
 #include "SCA_IActuator.h"
 #include "SCA_EventManager.h"
 #include "SCA_PythonController.h"
+#include "CM_Profiler.h"
 #include <set>
-
+#include <algorithm>
+
+/// Profiler scope names of the sensors per event manager type.
+static const char *eventManagerNames[] = {
+	"Keyboard sensors", // KEYBOARD_EVENTMGR
+	"Mouse sensors", // MOUSE_EVENTMGR
+	"Always sensors", // ALWAYS_EVENTMGR
+	"Collision sensors", // TOUCH_EVENTMGR
+	"Property sensors", // PROPERTY_EVENTMGR
+	"Time sensors", // TIME_EVENTMGR
+	"Random sensors", // RANDOM_EVENTMGR
+	"Ray sensors", // RAY_EVENTMGR
+	"Message sensors", // NETWORK_EVENTMGR
+	"Joystick sensors", // JOY_EVENTMGR
+	"Actuator sensors", // ACTUATOR_EVENTMGR
+	"Sensors" // BASIC_EVENTMGR
+};
 
 SCA_LogicManager::SCA_LogicManager()
 {
@@ -129,7 +146,14 @@ void SCA_LogicManager::RemoveController(SCA_IController* controller)
 {
 	controller->UnlinkAllSensors();
 	controller->UnlinkAllActuators();
-	controller->Deactivate();
+
+	if (controller->IsTriggered()) {
+		std::vector<SCA_IController *>::iterator it = std::find(m_triggeredControllers.begin(), m_triggeredControllers.end(), controller);
+		BLI_assert(it != m_triggeredControllers.end());
+		// Don't change the size of the queue as it could be iterated.
+		*it = nullptr;
+		controller->SetTriggered(false);
+	}
 }
 
 
@@ -160,27 +184,70 @@ void SCA_LogicManager::RegisterToActuator(SCA_IController* controller,SCA_IActua
 
 void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
 {
-	for (std::vector<SCA_EventManager*>::const_iterator ie=m_eventmanagers.begin(); !(ie==m_eventmanagers.end()); ie++)
+	for (std::vector<SCA_EventManager*>::const_iterator ie=m_eventmanagers.begin(); !(ie==m_eventmanagers.end()); ie++) {
+		CM_ProfileScope scope(eventManagerNames[(*ie)->GetType()]);
 		(*ie)->NextFrame(curtime, fixedtime);
+	}
 
-	for (SG_QList* obj = (SG_QList*)m_triggeredControllerSet.Remove();
-		obj != nullptr;
-		obj = (SG_QList*)m_triggeredControllerSet.Remove())
-	{
-		for (SCA_IController* contr = (SCA_IController*)obj->QRemove();
-			contr != nullptr;
-			contr = (SCA_IController*)obj->QRemove())
-		{
-			contr->Trigger(this);
-			contr->ClrJustActivated();
+	CM_ProfileScope scope("Controllers");
+	SortTriggeredControllers();
+
+	// Controllers triggered during the execution are appended, iterate by index.
+	for (unsigned int i = 0; i < m_triggeredControllers.size(); ++i) {
+		SCA_IController *contr = m_triggeredControllers[i];
+		if (!contr) {
+			continue;
 		}
+
+		contr->SetTriggered(false);
+		contr->Trigger(this);
+		contr->ClrJustActivated();
+	}
+	m_triggeredControllers.clear();
+}
+
+void SCA_LogicManager::SortTriggeredControllers()
+{
+	// Discard the removed controllers.
+	m_triggeredControllers.erase(std::remove(m_triggeredControllers.begin(), m_triggeredControllers.end(), nullptr),
+	                             m_triggeredControllers.end());
+
+	if (m_triggeredControllers.size() < 2) {
+		return;
+	}
+
+	m_triggeredObjectOrder.clear();
+	for (SCA_IController *contr : m_triggeredControllers) {
+		// Only the first insertion of an object is kept.
+		m_triggeredObjectOrder.emplace(contr->GetParent(), m_triggeredObjectOrder.size());
 	}
+
+	// The sort is stable to keep the trigger order for the equal controllers.
+	std::stable_sort(m_triggeredControllers.begin(), m_triggeredControllers.end(),
+	                 [this](SCA_IController *contr1, SCA_IController *contr2)
+	{
+		const bool bookmark1 = contr1->IsBookmark();
+		const bool bookmark2 = contr2->IsBookmark();
+		if (bookmark1 || bookmark2) {
+			return (bookmark1 && !bookmark2);
+		}
+
+		SCA_IObject *obj1 = contr1->GetParent();
+		SCA_IObject *obj2 = contr2->GetParent();
+		if (obj1 != obj2) {
+			return (m_triggeredObjectOrder[obj1] < m_triggeredObjectOrder[obj2]);
+		}
+
+		return (contr1->GetExecutePriority() < contr2->GetExecutePriority());
+	});
 }
 
 
 
 void SCA_LogicManager::UpdateFrame(double curtime)
 {
+	CM_ProfileScope scope("Actuators");
+
 	for (std::vector<SCA_EventManager*>::const_iterator ie=m_eventmanagers.begin(); !(ie==m_eventmanagers.end()); ie++)
 		(*ie)->UpdateFrame();
 
@@ -270,7 +337,10 @@ void SCA_LogicManager::EndFrame()
 
 void SCA_LogicManager::AddTriggeredController(SCA_IController* controller, SCA_ISensor* sensor)
 {
-	controller->Activate(m_triggeredControllerSet);
+	if (!controller->IsTriggered()) {
+		controller->SetTriggered(true);
+		m_triggeredControllers.push_back(controller);
+	}
 
 #ifdef WITH_PYTHON
 
@@ -37,6 +37,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <list>
 
 #include <string>
@@ -50,8 +51,8 @@ typedef std::map<class SCA_ISensor*,controllerlist > sensormap_t;
  * This manager handles sensor, controllers and actuators.
  * logic executes each frame the following way:
  * find triggering sensors
- * build list of controllers that are triggered by these triggering sensors
- * process all triggered controllers
+ * build the queue of controllers that are triggered by these triggering sensors
+ * process all triggered controllers ordered by object and priority
  * during this phase actuators can be added to the active actuator list
  * process all active actuators
  * clear triggering sensors
@@ -71,9 +72,15 @@ class SCA_LogicManager
 	// SG_DList: Head of objects having activated actuators
 	//           element: SCA_IObject::m_activeActuators
 	SG_DList							m_activeActuators;
-	// SG_DList: Head of objects having activated controllers
-	//           element: SCA_IObject::m_activeControllers
-	SG_DList							m_triggeredControllerSet;
+	/// Queue of the triggered controllers without duplicates, removed controllers are set to nullptr.
+	std::vector<SCA_IController *>		m_triggeredControllers;
+	/// Order of the first trigger of the objects in the queue, used to sort the controllers.
+	std::unordered_map<SCA_IObject *, unsigned int>	m_triggeredObjectOrder;
+
+	/** Sort the triggered controllers: bookmarked controllers first in order of trigger,
+	 * then the controllers grouped by object in order of first trigger and sorted by priority.
+	 */
+	void SortTriggeredControllers();
 
 	// need to find better way for this
 	// also known as FactoryManager...
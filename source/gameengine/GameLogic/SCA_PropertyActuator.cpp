@@ -49,6 +49,7 @@ SCA_PropertyActuator::SCA_PropertyActuator(SCA_IObject* gameobj,SCA_IObject* sou
 	m_type(acttype),
 	m_propname(propname),
 	m_exprtxt(expr),
+	m_propkey(propname),
 	m_sourceObj(sourceObj)
 {
 	// protect ourselves against someone else deleting the source object
@@ -76,7 +77,7 @@ bool SCA_PropertyActuator::Update()
 		if (m_type==KX_ACT_PROP_LEVEL)
 		{
 			EXP_Value* newval = new EXP_BoolValue(false);
-			EXP_Value* oldprop = propowner->GetProperty(m_propname);
+			EXP_Value* oldprop = propowner->GetProperty(m_propkey);
 			if (oldprop)
 			{
 				oldprop->SetValue(newval);
@@ -96,7 +97,7 @@ bool SCA_PropertyActuator::Update()
 	{
 		/* don't use */
 		EXP_Value* newval;
-		EXP_Value* oldprop = propowner->GetProperty(m_propname);
+		EXP_Value* oldprop = propowner->GetProperty(m_propkey);
 		if (oldprop)
 		{
 			newval = new EXP_BoolValue((oldprop->GetNumber()==0.0) ? true:false);
@@ -104,20 +105,20 @@ bool SCA_PropertyActuator::Update()
 		} else
 		{	/* as not been assigned, evaluate as false, so assign true */
 			newval = new EXP_BoolValue(true);
-			propowner->SetProperty(m_propname,newval);
+			propowner->SetProperty(m_propkey,newval);
 		}
 		newval->Release();
 	}
 	else if (m_type==KX_ACT_PROP_LEVEL)
 	{
 		EXP_Value* newval = new EXP_BoolValue(true);
-		EXP_Value* oldprop = propowner->GetProperty(m_propname);
+		EXP_Value* oldprop = propowner->GetProperty(m_propkey);
 		if (oldprop)
 		{
 			oldprop->SetValue(newval);
 		} else
 		{
-			propowner->SetProperty(m_propname,newval);
+			propowner->SetProperty(m_propkey,newval);
 		}
 		newval->Release();
 	}
@@ -129,20 +130,20 @@ bool SCA_PropertyActuator::Update()
 			{
 				
 				EXP_Value* newval = userexpr->Calculate();
-				EXP_Value* oldprop = propowner->GetProperty(m_propname);
+				EXP_Value* oldprop = propowner->GetProperty(m_propkey);
 				if (oldprop)
 				{
 					oldprop->SetValue(newval);
 				} else
 				{
-					propowner->SetProperty(m_propname,newval);
+					propowner->SetProperty(m_propkey,newval);
 				}
 				newval->Release();
 				break;
 			}
 		case KX_ACT_PROP_ADD:
 			{
-				EXP_Value* oldprop = propowner->GetProperty(m_propname);
+				EXP_Value* oldprop = propowner->GetProperty(m_propkey);
 				if (oldprop)
 				{
 					// int waarde = (int)oldprop->GetNumber();  /*unused*/
@@ -162,12 +163,15 @@ bool SCA_PropertyActuator::Update()
 			{
 				if (m_sourceObj)
 				{
-					EXP_Value* copyprop = m_sourceObj->GetProperty(m_exprtxt);
+					if (!m_sourcekey.IsValid()) {
+						m_sourcekey = EXP_PropertyKey(m_exprtxt);
+					}
+					EXP_Value* copyprop = m_sourceObj->GetProperty(m_sourcekey);
 					if (copyprop)
 					{
 						EXP_Value *val = copyprop->GetReplica();
 						GetParent()->SetProperty(
-							 m_propname,
+							 m_propkey,
 							 val);
 						val->Release();
 
@@ -239,6 +243,25 @@ void SCA_PropertyActuator::Relink(std::map<SCA_IObject *, SCA_IObject *>& obj_ma
 /* Python functions                                                          */
 /* ------------------------------------------------------------------------- */
 
+int SCA_PropertyActuator::CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+	if (CheckProperty(self, attrdef) != 0) {
+		return 1;
+	}
+
+	SCA_PropertyActuator *actuator = static_cast<SCA_PropertyActuator *>(self);
+	actuator->m_propkey = EXP_PropertyKey(actuator->m_propname);
+	return 0;
+}
+
+int SCA_PropertyActuator::CheckValue(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+	// The value is an expression in most modes, the copied property key is resolved when needed.
+	SCA_PropertyActuator *actuator = static_cast<SCA_PropertyActuator *>(self);
+	actuator->m_sourcekey = EXP_PropertyKey();
+	return 0;
+}
+
 /* Integration hooks ------------------------------------------------------- */
 PyTypeObject SCA_PropertyActuator::Type = {
 	PyVarObject_HEAD_INIT(nullptr, 0)
@@ -267,8 +290,8 @@ PyMethodDef SCA_PropertyActuator::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertyActuator::Attributes[] = {
-	EXP_PYATTRIBUTE_STRING_RW_CHECK("propName",0,MAX_PROP_NAME,false,SCA_PropertyActuator,m_propname,CheckProperty),
-	EXP_PYATTRIBUTE_STRING_RW("value",0,100,false,SCA_PropertyActuator,m_exprtxt),
+	EXP_PYATTRIBUTE_STRING_RW_CHECK("propName",0,MAX_PROP_NAME,false,SCA_PropertyActuator,m_propname,CheckPropertyName),
+	EXP_PYATTRIBUTE_STRING_RW_CHECK("value",0,100,false,SCA_PropertyActuator,m_exprtxt,CheckValue),
 	EXP_PYATTRIBUTE_INT_RW("mode", KX_ACT_PROP_NODEF+1, KX_ACT_PROP_MAX-1, false, SCA_PropertyActuator, m_type), /* ATTR_TODO add constents to game logic dict */
 	EXP_PYATTRIBUTE_NULL	//Sentinel
 };
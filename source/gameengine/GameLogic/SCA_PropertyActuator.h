@@ -51,6 +51,10 @@ class SCA_PropertyActuator : public SCA_IActuator
 	int			m_type;
 	std::string	m_propname;
 	std::string	m_exprtxt;
+	/// Key of the modified property.
+	EXP_PropertyKey m_propkey;
+	/// Key of the copied property, resolved from m_exprtxt at the first copy.
+	EXP_PropertyKey m_sourcekey;
 	SCA_IObject* m_sourceObj; // for copy property actuator
 
 public:
@@ -81,7 +85,11 @@ public:
 	/* --------------------------------------------------------------------- */
 	/* Python interface ---------------------------------------------------- */
 	/* --------------------------------------------------------------------- */
-	
+
+#ifdef WITH_PYTHON
+	static int CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
+	static int CheckValue(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
+#endif  // WITH_PYTHON
 };
 
 #endif  /* __KX_PROPERTYACTUATOR_DOC */
@@ -54,13 +54,17 @@ SCA_PropertySensor::SCA_PropertySensor(SCA_EventManager* eventmgr,
 	  m_checktype(checktype),
 	  m_checkpropval(propval),
 	  m_checkpropmaxval(propmaxval),
-	  m_checkpropname(propname)
+	  m_checkpropname(propname),
+	  m_property(nullptr),
+	  m_modified(true)
 {
 	//EXP_Parser pars;
 	//pars.SetContext(this->AddRef());
 	//EXP_Value* resultval = m_rightexpr->Calculate();
 
-	EXP_Value* orgprop = GetParent()->FindIdentifier(m_checkpropname);
+	ResolvePropertyKey();
+
+	EXP_Value* orgprop = FindCheckProperty();
 	if (!orgprop->IsError())
 	{
 		m_previoustext = orgprop->GetText();
@@ -75,6 +79,7 @@ void SCA_PropertySensor::Init()
 	m_recentresult = false;
 	m_lastresult = m_invert?true:false;
 	m_reset = true;
+	m_modified = true;
 }
 
 EXP_Value* SCA_PropertySensor::GetReplica()
@@ -87,6 +92,97 @@ EXP_Value* SCA_PropertySensor::GetReplica()
 	return replica;
 }
 
+void SCA_PropertySensor::ProcessReplica()
+{
+	SCA_ISensor::ProcessReplica();
+	// The property observed belongs to the original object.
+	m_property = nullptr;
+	m_modified = true;
+}
+
+void SCA_PropertySensor::ReParent(SCA_IObject *parent)
+{
+	UnobserveProperty();
+	m_modified = true;
+	SCA_ISensor::ReParent(parent);
+}
+
+void SCA_PropertySensor::UnregisterToManager()
+{
+	// Inactive sensors don't need to be notified.
+	UnobserveProperty();
+	SCA_ISensor::UnregisterToManager();
+}
+
+bool SCA_PropertySensor::ObserveProperty()
+{
+	if (m_property) {
+		return true;
+	}
+
+	// Properties accessed through other values are still polled.
+	if (!m_checkpropkey.IsValid()) {
+		return false;
+	}
+
+	EXP_Value *prop = GetParent()->GetProperty(m_checkpropkey);
+	if (!prop) {
+		return false;
+	}
+
+	// Only the value types notifying their modifications can be observed.
+	switch (prop->GetValueType()) {
+		case VALUE_INT_TYPE:
+		case VALUE_FLOAT_TYPE:
+		case VALUE_STRING_TYPE:
+		case VALUE_BOOL_TYPE:
+		{
+			break;
+		}
+		default:
+		{
+			return false;
+		}
+	}
+
+	m_property = prop;
+	m_property->RegisterObserver(this);
+	return true;
+}
+
+void SCA_PropertySensor::UnobserveProperty()
+{
+	if (m_property) {
+		m_property->UnregisterObserver(this);
+		m_property = nullptr;
+	}
+}
+
+void SCA_PropertySensor::ResolvePropertyKey()
+{
+	m_checkpropkey = (m_checkpropname.find('.') == std::string::npos) ? EXP_PropertyKey(m_checkpropname) : EXP_PropertyKey();
+}
+
+EXP_Value *SCA_PropertySensor::FindCheckProperty()
+{
+	if (m_checkpropkey.IsValid()) {
+		return GetParent()->FindIdentifier(m_checkpropkey);
+	}
+	return GetParent()->FindIdentifier(m_checkpropname);
+}
+
+void SCA_PropertySensor::ValueModified(EXP_Value *value)
+{
+	m_modified = true;
+}
+
+void SCA_PropertySensor::ValueRemoved(EXP_Value *value)
+{
+	// The observer was already unregistered by the value.
+	m_property = nullptr;
+	m_modified = true;
+}
+
 
 
 bool SCA_PropertySensor::IsPositiveTrigger()
@@ -102,15 +198,26 @@ bool SCA_PropertySensor::IsPositiveTrigger()
 
 SCA_PropertySensor::~SCA_PropertySensor()
 {
+	UnobserveProperty();
 }
 
 
 
 bool SCA_PropertySensor::Evaluate()
 {
-	bool result = CheckPropertyCondition();
 	bool reset = m_reset && m_level;
-	
+
+	/* The condition depends only on the property value and the sensor settings,
+	 * it is not checked again until one of them is modified. */
+	const bool observed = ObserveProperty();
+	if (observed && !m_modified && !reset) {
+		return false;
+	}
+
+	bool result = CheckPropertyCondition();
+	// The changed mode must be evaluated one more time to fall back to false.
+	m_modified = (m_checktype == KX_PROPSENSOR_CHANGED && result);
+
 	m_reset = false;
 	if (m_lastresult!=result)
 	{
@@ -133,7 +240,7 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 		ATTR_FALLTHROUGH;
 	case KX_PROPSENSOR_EQUAL:
 		{
-			EXP_Value* orgprop = GetParent()->FindIdentifier(m_checkpropname);
+			EXP_Value* orgprop = FindCheckProperty();
 			if (!orgprop->IsError())
 			{
 				const std::string& testprop = orgprop->GetText();
@@ -170,7 +277,7 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 		}
 	case KX_PROPSENSOR_INTERVAL:
 		{
-			EXP_Value* orgprop = GetParent()->FindIdentifier(m_checkpropname);
+			EXP_Value* orgprop = FindCheckProperty();
 			if (!orgprop->IsError())
 			{
 				float min;
@@ -194,7 +301,7 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 		}
 	case KX_PROPSENSOR_CHANGED:
 		{
-			EXP_Value* orgprop = GetParent()->FindIdentifier(m_checkpropname);
+			EXP_Value* orgprop = FindCheckProperty();
 				
 			if (!orgprop->IsError())
 			{
@@ -213,7 +320,7 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 		ATTR_FALLTHROUGH;
 	case KX_PROPSENSOR_GREATERTHAN:
 		{
-			EXP_Value* orgprop = GetParent()->FindIdentifier(m_checkpropname);
+			EXP_Value* orgprop = FindCheckProperty();
 			if (!orgprop->IsError())
 			{
 				float ref;
@@ -255,6 +362,11 @@ EXP_Value* SCA_PropertySensor::FindIdentifier(const std::string& identifiername)
 	return  GetParent()->FindIdentifier(identifiername);
 }
 
+EXP_Value *SCA_PropertySensor::FindIdentifier(const EXP_PropertyKey& key)
+{
+	return GetParent()->FindIdentifier(key);
+}
+
 #ifdef WITH_PYTHON
 
 /* ------------------------------------------------------------------------- */
@@ -268,6 +380,29 @@ int SCA_PropertySensor::validValueForProperty(EXP_PyObjectPlus *self, const PyAt
 	 * function directly */
 
 	/*  There is no type checking at this moment, unfortunately...           */
+	SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+	sensor->m_modified = true;
+	return 0;
+}
+
+int SCA_PropertySensor::CheckMode(EXP_PyObjectPlus *self, const PyAttributeDef*)
+{
+	SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+	sensor->m_modified = true;
+	return 0;
+}
+
+int SCA_PropertySensor::CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+	if (CheckProperty(self, attrdef) != 0) {
+		return 1;
+	}
+
+	// Observe the new property at the next evaluation.
+	SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+	sensor->ResolvePropertyKey();
+	sensor->UnobserveProperty();
+	sensor->m_modified = true;
 	return 0;
 }
 
@@ -299,8 +434,8 @@ PyMethodDef SCA_PropertySensor::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertySensor::Attributes[] = {
-	EXP_PYATTRIBUTE_INT_RW("mode",KX_PROPSENSOR_NODEF,KX_PROPSENSOR_MAX-1,false,SCA_PropertySensor,m_checktype),
-	EXP_PYATTRIBUTE_STRING_RW_CHECK("propName",0,MAX_PROP_NAME,false,SCA_PropertySensor,m_checkpropname,CheckProperty),
+	EXP_PYATTRIBUTE_INT_RW_CHECK("mode",KX_PROPSENSOR_NODEF,KX_PROPSENSOR_MAX-1,false,SCA_PropertySensor,m_checktype,CheckMode),
+	EXP_PYATTRIBUTE_STRING_RW_CHECK("propName",0,MAX_PROP_NAME,false,SCA_PropertySensor,m_checkpropname,CheckPropertyName),
 	EXP_PYATTRIBUTE_STRING_RW_CHECK("value",0,100,false,SCA_PropertySensor,m_checkpropval,validValueForProperty),
 	EXP_PYATTRIBUTE_STRING_RW_CHECK("min",0,100,false,SCA_PropertySensor,m_checkpropval,validValueForProperty),
 	EXP_PYATTRIBUTE_STRING_RW_CHECK("max",0,100,false,SCA_PropertySensor,m_checkpropmaxval,validValueForProperty),
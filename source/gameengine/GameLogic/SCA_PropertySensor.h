@@ -35,7 +35,7 @@
 
 #include "SCA_ISensor.h"
 
-class SCA_PropertySensor : public SCA_ISensor
+class SCA_PropertySensor : public SCA_ISensor, public EXP_ValueObserver
 {
 	Py_Header
 	//class EXP_Expression*	m_rightexpr;
@@ -43,9 +43,23 @@ class SCA_PropertySensor : public SCA_ISensor
 	std::string		m_checkpropval;
 	std::string		m_checkpropmaxval;
 	std::string		m_checkpropname;
+	/// Key of the checked property, invalid when the name is a path through other values.
+	EXP_PropertyKey	m_checkpropkey;
 	std::string		m_previoustext;
 	bool			m_lastresult;
 	bool			m_recentresult;
+	/// The observed property, nullptr when not found or when the name is a path through other values.
+	EXP_Value		*m_property;
+	/// True when the observed property or the sensor settings changed since the last evaluation.
+	bool			m_modified;
+
+	/// Find and observe the property, return false if the property can't be observed.
+	bool ObserveProperty();
+	void UnobserveProperty();
+	/// Resolve the key of the checked property name.
+	void ResolvePropertyKey();
+	/// Find the checked property, return a new reference or an error value.
+	EXP_Value *FindCheckProperty();
 
  protected:
 
@@ -73,12 +87,19 @@ public:
 
 	virtual ~SCA_PropertySensor();
 	virtual EXP_Value* GetReplica();
+	virtual void ProcessReplica();
+	virtual void ReParent(SCA_IObject *parent);
+	virtual void UnregisterToManager();
 	virtual void Init();
 	bool	CheckPropertyCondition();
 
 	virtual bool Evaluate();
 	virtual bool	IsPositiveTrigger();
 	virtual EXP_Value*		FindIdentifier(const std::string& identifiername);
+	virtual EXP_Value *FindIdentifier(const EXP_PropertyKey& key);
+
+	virtual void ValueModified(EXP_Value *value);
+	virtual void ValueRemoved(EXP_Value *value);
 
 #ifdef WITH_PYTHON
 
@@ -90,6 +111,8 @@ public:
 	 * Test whether this is a sensible value (type check)
 	 */
 	static int validValueForProperty(EXP_PyObjectPlus *self, const PyAttributeDef*);
+	static int CheckMode(EXP_PyObjectPlus *self, const PyAttributeDef*);
+	static int CheckPropertyName(EXP_PyObjectPlus *self, const PyAttributeDef *attrdef);
 
 #endif
 };
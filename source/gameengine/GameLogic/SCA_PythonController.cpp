@@ -47,6 +47,7 @@ extern "C" {
 }
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 // initialize static member variables
 SCA_PythonController* SCA_PythonController::m_sCurrentController = nullptr;
@@ -342,6 +343,9 @@ bool SCA_PythonController::Import()
 
 void SCA_PythonController::Trigger(SCA_LogicManager* logicmgr)
 {
+	// Scripts are usually shared by several controllers, the scope is named after the script.
+	CM_ProfileScope scope(m_scriptName);
+
 	m_sCurrentController = this;
 
 	PyObject *excdict=		nullptr;
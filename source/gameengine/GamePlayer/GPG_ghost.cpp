@@ -496,9 +496,18 @@ static void usage(const std::string& program, bool isBlenderPlayer)
 	CM_Message("       show_armatures                 0         Show debug armatures");
 	CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
 	CM_Message("       show_shadow_frustum            0         Show debug light shadow frustum volume");
+	CM_Message("       pipelined_physics              0         Proceed physics in parallel of the rendering");
+	CM_Message("       parallel_scenes                0         Proceed physics of all scenes in parallel");
+	CM_Message("       profile_capture                          Write a Chrome trace of the first frames to this file");
+	CM_Message("       profile_capture_frames         1         Number of frames captured by profile_capture");
+	CM_Message("       benchmark_output      benchmark.json     File the --benchmark frame times are written to");
 	CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings" << std::endl);
 	CM_Message("  -p: override python main loop script");
 	CM_Message(std::endl);
+	CM_Message("  --benchmark: run a number of frames on a fixed time step without drawing, then quit");
+	CM_Message("       and write the frame times per profiling category to the benchmark_output file,");
+	CM_Message("       the player window and its GL context are still opened");
+	CM_Message("       Example: --benchmark 1000  or  --benchmark 1000 -g benchmark_output = times.json" << std::endl);
 	CM_Message("  - : all arguments after this are ignored, allowing python to access them from sys.argv");
 	CM_Message(std::endl);
 	CM_Message("example: " << program << " -w 320 200 10 10 -g noaudio " << example_pathname << example_filename);
@@ -1079,6 +1088,17 @@ int main(
 				pythonControllerFile = argv[i++];
 				break;
 			}
+			case '-':
+			{
+				if (strcmp(argv[i], "--benchmark") == 0 && (i + 1) <= validArguments) {
+					++i;
+					SYS_WriteCommandLineInt(syshandle, "benchmark", atoi(argv[i++]));
+				}
+				else {
+					CM_Warning("unknown argument: " << argv[i++]);
+				}
+				break;
+			}
 			default:  //not recognized
 			{
 				CM_Warning("unknown argument: " << argv[i++]);
@@ -64,6 +64,8 @@ BL_Action::BL_Action(class KX_GameObject* gameobj)
 :
 	m_action(nullptr),
 	m_tmpaction(nullptr),
+	m_compiledAction(nullptr),
+	m_boundId(nullptr),
 	m_blendpose(nullptr),
 	m_blendinpose(nullptr),
 	m_obj(gameobj),
@@ -153,12 +155,23 @@ bool BL_Action::Play(const std::string& name,
 			&& m_priority == priority && m_speed == playback_speed)
 		return false;
 
-	// Keep a copy of the action for threading purposes
+	// Get the compiled action shared by the objects of the scene.
+	BL_BlenderConverter *converter = KX_GetActiveEngine()->GetConverter();
+	m_compiledAction = converter->FindCompiledAction(kxscene, m_action);
+	if (!m_compiledAction) {
+		m_compiledAction = new BL_CompiledAction(m_action, converter->GetActionBakeRate());
+		converter->RegisterCompiledAction(kxscene, m_compiledAction, m_action);
+	}
+	m_boundId = nullptr;
+
 	if (m_tmpaction) {
 		BKE_libblock_free(G.main, m_tmpaction);
 		m_tmpaction = nullptr;
 	}
-	m_tmpaction = BKE_action_copy(G.main, m_action);
+	// Keep a copy of the action for threading purposes
+	if (!m_compiledAction->IsSupported()) {
+		m_tmpaction = BKE_action_copy(G.main, m_action);
+	}
 
 	// First get rid of any old controllers
 	ClearControllerList();
@@ -317,6 +330,11 @@ void BL_Action::SetPlayMode(short play_mode)
 	m_playmode = play_mode;
 }
 
+void BL_Action::DelayStartTime(float delay)
+{
+	m_starttime += delay;
+}
+
 void BL_Action::SetLocalTime(float curtime)
 {
 	float dt = (curtime-m_starttime)*(float)KX_GetActiveEngine()->GetAnimFrameRate()*m_speed;
@@ -365,6 +383,25 @@ void BL_Action::BlendShape(Key* key, float srcweight, std::vector<float>& blends
 	}
 }
 
+void BL_Action::EvaluateAction(ID *id)
+{
+	if (!m_compiledAction->IsSupported()) {
+		PointerRNA ptrrna;
+		RNA_id_pointer_create(id, &ptrrna);
+
+		animsys_evaluate_action(&ptrrna, m_tmpaction, nullptr, m_localframe);
+		return;
+	}
+
+	// The channels are resolved again only if the animated data changed, e.g. a new deformer.
+	if (id != m_boundId) {
+		m_compiledAction->Bind(id, m_targets);
+		m_boundId = id;
+	}
+
+	m_compiledAction->Evaluate(m_localframe, m_targets, id);
+}
+
 void BL_Action::Update(float curtime, bool applyToObject)
 {
 	/* Don't bother if we're done with the animation and if the animation was already applied to the object.
@@ -433,7 +470,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
 			obj->GetPose(&m_blendpose);
 
 		// Extract the pose from the action
-		obj->SetPoseByAction(m_tmpaction, m_localframe);
+		EvaluateAction(&obj->GetArmatureObject()->id);
 
 		// Handle blending between armature actions
 		if (m_blendin && m_blendframe<m_blendin)
@@ -464,10 +501,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
 		{
 			Key *key = shape_deformer->GetKey();
 
-			PointerRNA ptrrna;
-			RNA_id_pointer_create(&key->id, &ptrrna);
-
-			animsys_evaluate_action(&ptrrna, m_tmpaction, nullptr, m_localframe);
+			EvaluateAction(&key->id);
 
 			// Handle blending between shape actions
 			if (m_blendin && m_blendframe < m_blendin)
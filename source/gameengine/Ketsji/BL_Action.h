@@ -30,11 +30,19 @@
 #include <string>
 #include <vector>
 
+#include "BL_CompiledAction.h"
+
 class BL_Action
 {
 private:
 	struct bAction* m_action;
+	/// Copy of the action evaluated by the animation system when it can't be compiled.
 	struct bAction* m_tmpaction;
+	/// Compiled action shared in the scene.
+	BL_CompiledAction *m_compiledAction;
+	/// ID bound to the compiled action channels.
+	struct ID *m_boundId;
+	std::vector<BL_CompiledAction::Target> m_targets;
 	struct bPose* m_blendpose;
 	struct bPose* m_blendinpose;
 	std::vector<class SG_Controller*> m_sg_contr_list;
@@ -82,6 +90,8 @@ private:
 	void ResetStartTime(float curtime);
 	void IncrementBlending(float curtime);
 	void BlendShape(struct Key* key, float srcweight, std::vector<float>& blendshape);
+	/// Evaluate the action at the current frame for the armature object or the shape key.
+	void EvaluateAction(struct ID *id);
 public:
 	BL_Action(class KX_GameObject* gameobj);
 	~BL_Action();
@@ -124,6 +134,8 @@ public:
 	// Mutators
 	void SetFrame(float frame);
 	void SetPlayMode(short play_mode);
+	/// Delay the action by a duration in seconds, e.g. the time its object was suspended.
+	void DelayStartTime(float delay);
 
 	enum
 	{
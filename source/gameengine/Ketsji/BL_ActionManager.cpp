@@ -86,6 +86,13 @@ void BL_ActionManager::SetPlayMode(short layer, short mode)
 	if (action) action->SetPlayMode(mode);
 }
 
+void BL_ActionManager::DelayActions(float delay)
+{
+	for (const auto& pair : m_layers) {
+		pair.second->DelayStartTime(delay);
+	}
+}
+
 bool BL_ActionManager::PlayAction(const std::string& name,
 								float start,
 								float end,
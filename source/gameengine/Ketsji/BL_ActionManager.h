@@ -92,6 +92,11 @@ public:
 	 */
 	void SetPlayMode(short layer, short mode);
 
+	/**
+	 * Delay all the actions by a duration in seconds
+	 */
+	void DelayActions(float delay);
+
 	/**
 	 * Stop playing the action on the given layer
 	 */
@@ -31,54 +31,194 @@
  */
 
 #include "KX_NetworkMessageManager.h"
-#include <iostream>
+
+#include <algorithm>
+
+/// Maximum number of interned names kept between two frames.
+#define KX_NETWORK_MAX_NAMES 4096
 
 KX_NetworkMessageManager::KX_NetworkMessageManager()
-	:m_currentList(0)
+	:m_generation(0)
 {
+	ResetIds();
 }
 
 KX_NetworkMessageManager::~KX_NetworkMessageManager()
 {
-	ClearMessages();
 }
 
-void KX_NetworkMessageManager::AddMessage(KX_NetworkMessageManager::Message message)
+void KX_NetworkMessageManager::ResetIds()
+{
+	m_nameIds.clear();
+	m_names.clear();
+	m_groupIds.clear();
+	m_groups.clear();
+	m_usedGroups.clear();
+	m_receiverRanges.clear();
+	// The filters resolved with the previous ids are resolved again.
+	++m_generation;
+
+	// The empty name used by the messages without receiver or subject.
+	GetNameId("");
+}
+
+unsigned int KX_NetworkMessageManager::GetNameId(const std::string& name)
+{
+	const auto pair = m_nameIds.emplace(name, m_names.size());
+	if (pair.second) {
+		// The key of a node is never moved, we can point to it.
+		m_names.push_back(&pair.first->first);
+		m_receiverRanges.push_back({nullptr, nullptr});
+	}
+	return pair.first->second;
+}
+
+unsigned int KX_NetworkMessageManager::GetGroupId(unsigned int to, unsigned int subject)
 {
-	// Put the new message in map for the given receiver and subject.
-	m_messages[m_currentList][message.to][message.subject].push_back(message);
+	const uint64_t key = ((uint64_t)to << 32) | subject;
+	const auto pair = m_groupIds.emplace(key, m_groups.size());
+	if (pair.second) {
+		m_groups.push_back({to, subject, 0, 0, {nullptr, nullptr}});
+	}
+	return pair.first->second;
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageManager::GetMessages(std::string to, std::string subject)
+void KX_NetworkMessageManager::AddMessage(KX_NetworkMessageManager::Message&& message)
 {
-	std::vector<KX_NetworkMessageManager::Message> messages;
+	m_pendingMessages.push_back(std::move(message));
+}
+
+KX_NetworkMessageManager::MessageRange KX_NetworkMessageManager::FindReceiverRange(unsigned int to) const
+{
+	return m_receiverRanges[to];
+}
+
+KX_NetworkMessageManager::MessageRange KX_NetworkMessageManager::FindGroupRange(unsigned int to, unsigned int subject) const
+{
+	const auto it = m_groupIds.find(((uint64_t)to << 32) | subject);
+	if (it == m_groupIds.end()) {
+		return {nullptr, nullptr};
+	}
+	return m_groups[it->second].m_range;
+}
+
+KX_NetworkMessageManager::MessageList KX_NetworkMessageManager::GetMessages(const std::string& to, const std::string& subject) const
+{
+	static const MessageRange emptyRange = {nullptr, nullptr};
+
+	// Look at messages without receiver, the empty name is always 0.
+	const auto toIt = m_nameIds.find(to);
+	const bool hasReceiver = (toIt != m_nameIds.end() && toIt->second != 0);
 
-	// look at messages without receiver.
-	std::map<std::string, std::vector<Message> >& messagesNoReceiver = m_messages[1 - m_currentList][""];
-	std::map<std::string, std::vector<Message> >& messagesReceiver = m_messages[1 - m_currentList][to];
 	if (subject.empty()) {
-		// Add all message without receiver and subject.
-		for (const auto& pair : messagesNoReceiver) {
-			messages.insert(messages.end(), pair.second.begin(), pair.second.end());
-		}
-		// Add all message with the given receiver and no subject.
-		for (const auto& pair : messagesReceiver) {
-			messages.insert(messages.end(), pair.second.begin(), pair.second.end());
-		}
+		// All messages without receiver and all messages of the given receiver, whatever the subject.
+		return MessageList(FindReceiverRange(0), hasReceiver ? FindReceiverRange(toIt->second) : emptyRange);
+	}
+
+	const auto subjectIt = m_nameIds.find(subject);
+	if (subjectIt == m_nameIds.end()) {
+		return MessageList(emptyRange, emptyRange);
+	}
+
+	return MessageList(FindGroupRange(0, subjectIt->second),
+	                   hasReceiver ? FindGroupRange(toIt->second, subjectIt->second) : emptyRange);
+}
+
+void KX_NetworkMessageManager::UpdateFilter(const std::string& to, const std::string& subject, Filter& filter)
+{
+	if (filter.m_generation == m_generation && filter.m_to == to && filter.m_subject == subject) {
+		return;
 	}
-	else {
-		std::vector<KX_NetworkMessageManager::Message>& messagesNoReceiverSubject = messagesNoReceiver[subject];
-		messages.insert(messages.end(), messagesNoReceiverSubject.begin(), messagesNoReceiverSubject.end());
-		std::vector<KX_NetworkMessageManager::Message>& messagesReceiverSubject = messagesReceiver[subject];
-		messages.insert(messages.end(), messagesReceiverSubject.begin(), messagesReceiverSubject.end());
+
+	filter.m_to = to;
+	filter.m_subject = subject;
+	filter.m_toId = GetNameId(to);
+	const unsigned int subjectId = GetNameId(subject);
+	filter.m_noReceiverGroup = GetGroupId(0, subjectId);
+	filter.m_receiverGroup = GetGroupId(filter.m_toId, subjectId);
+	filter.m_generation = m_generation;
+}
+
+KX_NetworkMessageManager::MessageList KX_NetworkMessageManager::GetMessages(const Filter& filter) const
+{
+	static const MessageRange emptyRange = {nullptr, nullptr};
+
+	// Look at messages without receiver, the empty name is always 0.
+	const bool hasReceiver = (filter.m_toId != 0);
+
+	if (filter.m_subject.empty()) {
+		// All messages without receiver and all messages of the given receiver, whatever the subject.
+		return MessageList(FindReceiverRange(0), hasReceiver ? FindReceiverRange(filter.m_toId) : emptyRange);
 	}
 
-	return messages;
+	return MessageList(m_groups[filter.m_noReceiverGroup].m_range,
+	                   hasReceiver ? m_groups[filter.m_receiverGroup].m_range : emptyRange);
 }
 
 void KX_NetworkMessageManager::ClearMessages()
 {
-	// Clear previous list.
-	m_messages[1 - m_currentList].clear();
-	m_currentList = 1 - m_currentList;
+	// Clear the ranges of the previous list.
+	for (unsigned int index : m_usedGroups) {
+		MessageGroup& group = m_groups[index];
+		group.m_count = 0;
+		group.m_range = {nullptr, nullptr};
+		m_receiverRanges[group.m_to] = {nullptr, nullptr};
+	}
+	m_usedGroups.clear();
+
+	// Don't keep the names of an unbounded number of receivers and subjects.
+	if (m_names.size() > KX_NETWORK_MAX_NAMES) {
+		ResetIds();
+	}
+
+	const unsigned int count = m_pendingMessages.size();
+	m_pendingGroups.resize(count);
+
+	for (unsigned int i = 0; i < count; ++i) {
+		const Message& message = m_pendingMessages[i];
+		const unsigned int to = GetNameId(message.to);
+		const unsigned int subject = GetNameId(message.subject);
+		const unsigned int index = GetGroupId(to, subject);
+
+		MessageGroup& group = m_groups[index];
+		if (group.m_count++ == 0) {
+			m_usedGroups.push_back(index);
+		}
+		m_pendingGroups[i] = index;
+	}
+
+	// Sort the groups by names to group the messages of a same receiver, the subjects are sorted by name.
+	std::sort(m_usedGroups.begin(), m_usedGroups.end(), [this](unsigned int index1, unsigned int index2) {
+		const MessageGroup& group1 = m_groups[index1];
+		const MessageGroup& group2 = m_groups[index2];
+		if (group1.m_to != group2.m_to) {
+			return *m_names[group1.m_to] < *m_names[group2.m_to];
+		}
+		return *m_names[group1.m_subject] < *m_names[group2.m_subject];
+	});
+
+	m_messages.resize(count);
+	const Message *data = m_messages.data();
+	unsigned int position = 0;
+	for (unsigned int index : m_usedGroups) {
+		MessageGroup& group = m_groups[index];
+		group.m_position = position;
+		group.m_range = {data + position, data + position + group.m_count};
+		position += group.m_count;
+	}
+
+	// Move the messages in their group keeping the sending order inside a group.
+	for (unsigned int i = 0; i < count; ++i) {
+		m_messages[m_groups[m_pendingGroups[i]].m_position++] = std::move(m_pendingMessages[i]);
+	}
+	m_pendingMessages.clear();
+
+	for (unsigned int index : m_usedGroups) {
+		const MessageGroup& group = m_groups[index];
+		MessageRange& receiverRange = m_receiverRanges[group.m_to];
+		if (!receiverRange.m_begin) {
+			receiverRange.m_begin = group.m_range.m_begin;
+		}
+		receiverRange.m_end = group.m_range.m_end;
+	}
 }
@@ -36,8 +36,9 @@ conflicts with KX_NetworkMessageManager::SendMessage */
 #endif
 
 #include <string>
-#include <map>
 #include <vector>
+#include <unordered_map>
+#include <cstdint>
 
 class SCA_IObject;
 
@@ -56,17 +57,163 @@ public:
 		std::string body;
 	};
 
-private:
-	/** List of all messages, filtered by receiver object(s) name and subject name.
-	 * We use two lists, one handle sended message in the current frame and the other
-	 * is used for handle message sended in the last frame for sensors.
+	/// Contiguous range of messages.
+	struct MessageRange
+	{
+		const Message *m_begin;
+		const Message *m_end;
+	};
+
+	/** Messages found for a receiver and a subject, the messages without receiver come first.
+	 * The messages are not copied, the list is valid until the next call to ClearMessages.
+	 */
+	class MessageList
+	{
+	public:
+		class const_iterator
+		{
+		private:
+			const MessageRange *m_range;
+			const MessageRange *m_rangeEnd;
+			const Message *m_message;
+
+			/// Move to the next non empty range if the current one is finished.
+			void SkipEmptyRanges()
+			{
+				while (m_range != m_rangeEnd && m_message == m_range->m_end) {
+					if (++m_range != m_rangeEnd) {
+						m_message = m_range->m_begin;
+					}
+					else {
+						m_message = nullptr;
+					}
+				}
+			}
+
+		public:
+			const_iterator(const MessageRange *range, const MessageRange *rangeEnd)
+				:m_range(range),
+				m_rangeEnd(rangeEnd),
+				m_message((range != rangeEnd) ? range->m_begin : nullptr)
+			{
+				SkipEmptyRanges();
+			}
+
+			const Message& operator*() const
+			{
+				return *m_message;
+			}
+
+			const Message *operator->() const
+			{
+				return m_message;
+			}
+
+			const_iterator& operator++()
+			{
+				++m_message;
+				SkipEmptyRanges();
+				return *this;
+			}
+
+			bool operator!=(const const_iterator& other) const
+			{
+				return (m_range != other.m_range || m_message != other.m_message);
+			}
+		};
+
+	private:
+		MessageRange m_ranges[2];
+
+	public:
+		MessageList(const MessageRange& noReceiver, const MessageRange& receiver)
+			:m_ranges{noReceiver, receiver}
+		{
+		}
+
+		const_iterator begin() const
+		{
+			return const_iterator(m_ranges, m_ranges + 2);
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(m_ranges + 2, m_ranges + 2);
+		}
+
+		unsigned int size() const
+		{
+			return (m_ranges[0].m_end - m_ranges[0].m_begin) + (m_ranges[1].m_end - m_ranges[1].m_begin);
+		}
+
+		bool empty() const
+		{
+			return (size() == 0);
+		}
+	};
+
+	/** Receiver and subject names resolved to the interned names, used by the readers of the same
+	 * names every frame to not look up the names at each read.
 	 */
-	std::map<std::string, std::map<std::string, std::vector<Message> > > m_messages[2];
+	struct Filter
+	{
+		/// The resolved names.
+		std::string m_to;
+		std::string m_subject;
+		/// Group of the messages without receiver and group of the messages of the receiver.
+		unsigned int m_noReceiverGroup;
+		unsigned int m_receiverGroup;
+		/// Id of the receiver name, zero for no receiver.
+		unsigned int m_toId;
+		/// Generation of the interned names the filter was resolved with, zero if not resolved.
+		unsigned int m_generation;
+	};
+
+private:
+	/// Messages of a receiver and subject pair.
+	struct MessageGroup
+	{
+		unsigned int m_to;
+		unsigned int m_subject;
+		/// Number of messages in the current frame.
+		unsigned int m_count;
+		/// Insertion position of the next message in m_messages.
+		unsigned int m_position;
+		/// Messages sent in the last frame.
+		MessageRange m_range;
+	};
 
-	/** Since we use two list for the current and last frame we have to switch of
-	 * current message list each frame. This value is only 0 or 1.
+	/// Messages sent in the current frame, they are readable in the next frame.
+	std::vector<Message> m_pendingMessages;
+	/** Messages sent in the last frame, sorted by receiver and subject names so that
+	 * the messages of a receiver or a receiver and subject pair are contiguous.
 	 */
-	unsigned short m_currentList;
+	std::vector<Message> m_messages;
+
+	/// Interned receiver and subject names, the empty name is always 0.
+	std::unordered_map<std::string, unsigned int> m_nameIds;
+	/// Names by id.
+	std::vector<const std::string *> m_names;
+	/// Messages sent in the last frame for each receiver name id.
+	std::vector<MessageRange> m_receiverRanges;
+
+	/// Index in m_groups of receiver and subject name id pairs.
+	std::unordered_map<uint64_t, unsigned int> m_groupIds;
+	std::vector<MessageGroup> m_groups;
+	/// Groups used in the last frame.
+	std::vector<unsigned int> m_usedGroups;
+	/// Group of each pending message.
+	std::vector<unsigned int> m_pendingGroups;
+	/// Incremented when the interned names and groups are cleared.
+	unsigned int m_generation;
+
+	unsigned int GetNameId(const std::string& name);
+	unsigned int GetGroupId(unsigned int to, unsigned int subject);
+	/// Clear the interned names and groups, used when too much unique names were used.
+	void ResetIds();
+
+	MessageRange FindReceiverRange(unsigned int to) const;
+	MessageRange FindGroupRange(unsigned int to, unsigned int subject) const;
 
 public:
 	KX_NetworkMessageManager();
@@ -75,14 +222,23 @@ public:
 	/** Add a message in the next message list.
 	 * \param message The given message to add.
 	 */
-	void AddMessage(Message message);
+	void AddMessage(Message&& message);
 	/** Get all messages for a given receiver object name and message subject.
 	 * \param to The object(s) name.
 	 * \param subject The message subject/filter.
 	 */
-	const std::vector<Message> GetMessages(std::string to, std::string subject);
+	MessageList GetMessages(const std::string& to, const std::string& subject) const;
+	/** Resolve the names of a filter if they changed or if the interned names were cleared.
+	 * \param to The object(s) name.
+	 * \param subject The message subject/filter.
+	 */
+	void UpdateFilter(const std::string& to, const std::string& subject, Filter& filter);
+	/** Get all messages for the names of a filter.
+	 * \param filter The filter resolved with UpdateFilter in the current frame.
+	 */
+	MessageList GetMessages(const Filter& filter) const;
 
-	/// Clear all messages
+	/// Clear all the messages of the last frame and make readable the messages of the current frame.
 	void ClearMessages();
 };
 
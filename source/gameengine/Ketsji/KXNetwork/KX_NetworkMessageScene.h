@@ -40,8 +40,6 @@ conflicts with KX_NetworkMessageScene::SendMessage */
 
 #include "KX_NetworkMessageManager.h"
 #include <string>
-#include <map>
-#include <vector>
 
 class SCA_IObject;
 
@@ -61,13 +59,19 @@ public:
 	 * \param subject The message subject, used as filter for receiver object(s).
 	 * \param message The body of the message.
 	 */
-	void SendMessage(std::string to, SCA_IObject *from, std::string subject, std::string body);
+	void SendMessage(const std::string& to, SCA_IObject *from, const std::string& subject, const std::string& body);
 
 	/** Get all messages for a given receiver object name and message subject.
 	 * \param to The object(s) name.
 	 * \param subject The message subject/filter.
 	 */
-	const std::vector<KX_NetworkMessageManager::Message> FindMessages(std::string to, std::string subject);
+	KX_NetworkMessageManager::MessageList FindMessages(const std::string& to, const std::string& subject) const;
+	/** Get all messages for a given receiver object name and message subject, using the names
+	 * resolved in a filter kept by the caller.
+	 * \param filter The filter of the last call, resolved again if the names changed.
+	 */
+	KX_NetworkMessageManager::MessageList FindMessages(const std::string& to, const std::string& subject,
+			KX_NetworkMessageManager::Filter& filter) const;
 };
 
 #endif // __KX_NETWORKMESSAGESCENE_H__
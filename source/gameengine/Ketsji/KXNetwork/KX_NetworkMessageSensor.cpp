@@ -52,6 +52,7 @@ KX_NetworkMessageSensor::KX_NetworkMessageSensor(
 	:SCA_ISensor(gameobj, eventmgr),
 	m_NetworkScene(NetworkScene),
 	m_subject(subject),
+	m_filter({"", "", 0, 0, 0, 0}),
 	m_frame_message_count(0),
 	m_BodyList(nullptr),
 	m_SubjectList(nullptr)
@@ -100,11 +101,8 @@ bool KX_NetworkMessageSensor::Evaluate()
 		m_SubjectList = nullptr;
 	}
 
-	std::string toname = GetParent()->GetName();
-	std::string& subject = this->m_subject;
-
-	const std::vector<KX_NetworkMessageManager::Message> messages =
-	    m_NetworkScene->FindMessages(toname, subject);
+	const KX_NetworkMessageManager::MessageList messages =
+	    m_NetworkScene->FindMessages(GetParent()->GetName(), m_subject, m_filter);
 
 	m_frame_message_count = messages.size();
 
@@ -117,12 +115,11 @@ bool KX_NetworkMessageSensor::Evaluate()
 		m_SubjectList = new EXP_ListValue<EXP_StringValue>();
 	}
 
-	std::vector<KX_NetworkMessageManager::Message>::const_iterator mesit;
-	for (mesit = messages.begin(); mesit != messages.end(); mesit++) {
+	for (const KX_NetworkMessageManager::Message& message : messages) {
 		// save the body
-		const std::string& body = (*mesit).body;
+		const std::string& body = message.body;
 		// save the subject
-		const std::string& messub = (*mesit).subject;
+		const std::string& messub = message.subject;
 #ifdef NAN_NET_DEBUG
 		if (body) {
 			cout << "body [" << body << "]\n";
@@ -33,6 +33,7 @@
 #define __KX_NETWORKMESSAGESENSOR_H__
 
 #include "SCA_ISensor.h"
+#include "KX_NetworkMessageManager.h"
 
 class KX_NetworkMessageScene;
 class EXP_StringValue;
@@ -47,6 +48,8 @@ class KX_NetworkMessageSensor : public SCA_ISensor
 
 	// The subject we filter on.
 	std::string m_subject;
+	// The receiver and subject names resolved in the message manager.
+	KX_NetworkMessageManager::Filter m_filter;
 
 	// The number of messages caught since the last frame.
 	int m_frame_message_count;
@@ -73,6 +76,7 @@ public:
 	virtual void Replace_NetworkScene(KX_NetworkMessageScene *val)
 	{
 		m_NetworkScene = val;
+		m_filter.m_generation = 0;
 	};
 
 #ifdef WITH_PYTHON
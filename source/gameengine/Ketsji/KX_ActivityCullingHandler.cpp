@@ -0,0 +1,257 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_ActivityCullingHandler.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_ActivityCullingHandler.h"
+#include "KX_GameObject.h"
+
+#include "EXP_ListValue.h"
+
+#include "SG_Node.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Factor of the activity radius after which an active object is suspended.
+#define KX_ACTIVITY_HYSTERESIS 1.2f
+
+/// Pack the integer coordinates of a cell, distant cells can share a key but are filtered by the distance test.
+static uint64_t cellKey(int64_t x, int64_t y, int64_t z)
+{
+	return (((uint64_t)x & 0x1FFFFF) << 42) | (((uint64_t)y & 0x1FFFFF) << 21) | ((uint64_t)z & 0x1FFFFF);
+}
+
+KX_ActivityCullingHandler::KX_ActivityCullingHandler()
+	:m_cellSize(0.0f),
+	m_maxRadius(0.0f),
+	m_pass(0)
+{
+}
+
+uint64_t KX_ActivityCullingHandler::GetCell(const MT_Vector3& point) const
+{
+	return cellKey(std::floor(point.x() / m_cellSize), std::floor(point.y() / m_cellSize), std::floor(point.z() / m_cellSize));
+}
+
+void KX_ActivityCullingHandler::AddToCell(unsigned int index)
+{
+	std::vector<unsigned int>& cell = m_grid[m_cells[index]];
+	m_cellIndices[index] = cell.size();
+	cell.push_back(index);
+}
+
+void KX_ActivityCullingHandler::RemoveFromCell(unsigned int index)
+{
+	std::unordered_map<uint64_t, std::vector<unsigned int> >::iterator it = m_grid.find(m_cells[index]);
+	std::vector<unsigned int>& cell = it->second;
+
+	// Move the last object of the cell in place of the removed one.
+	const unsigned int last = cell.back();
+	cell[m_cellIndices[index]] = last;
+	m_cellIndices[last] = m_cellIndices[index];
+	cell.pop_back();
+
+	if (cell.empty()) {
+		m_grid.erase(it);
+	}
+}
+
+void KX_ActivityCullingHandler::Resize(unsigned int count, float radius)
+{
+	const float cellSize = radius * KX_ACTIVITY_HYSTERESIS;
+	if (cellSize != m_cellSize) {
+		// Build the grid again with the new cell size.
+		m_grid.clear();
+		m_inGrid.assign(m_inGrid.size(), false);
+		m_objects.assign(m_objects.size(), nullptr);
+		m_cellSize = cellSize;
+	}
+
+	// Remove the slots after the end of the list.
+	for (unsigned int i = count, size = m_inGrid.size(); i < size; ++i) {
+		if (m_inGrid[i]) {
+			RemoveFromCell(i);
+		}
+	}
+
+	m_objects.resize(count, nullptr);
+	m_inGrid.resize(count, false);
+	m_centers.resize(count);
+	m_radius.resize(count, 0.0f);
+	m_cells.resize(count);
+	m_cellIndices.resize(count);
+	m_resumePass.resize(count, 0);
+	m_keepPass.resize(count, 0);
+}
+
+void KX_ActivityCullingHandler::SetSphere(unsigned int index, const MT_Vector3& center, float radius)
+{
+	m_centers[index] = center;
+	m_radius[index] = radius;
+
+	const uint64_t cell = GetCell(center);
+	if (!m_inGrid[index] || cell != m_cells[index]) {
+		if (m_inGrid[index]) {
+			RemoveFromCell(index);
+		}
+		m_cells[index] = cell;
+		AddToCell(index);
+		m_inGrid[index] = true;
+	}
+}
+
+void KX_ActivityCullingHandler::UpdateObject(unsigned int index, KX_GameObject *gameobj)
+{
+	SG_Node *sgnode = gameobj->GetSGNode();
+	if (m_objects[index] == gameobj && !sgnode->IsDirty(SG_Node::DIRTY_ACTIVITY)) {
+		return;
+	}
+
+	m_objects[index] = gameobj;
+
+	const MT_Vector3& scale = sgnode->GetWorldScaling();
+	const SG_BBox& aabb = gameobj->GetCullingNode()->GetAabb();
+	SetSphere(index, sgnode->GetWorldTransform()(aabb.GetCenter()), std::fabs(scale[scale.closestAxis()]) * aabb.GetRadius());
+
+	sgnode->ClearDirty(SG_Node::DIRTY_ACTIVITY);
+}
+
+void KX_ActivityCullingHandler::TestObject(unsigned int index, const MT_Vector3& position, float radius)
+{
+	const float resumeRadius = radius + m_radius[index];
+	const float keepRadius = resumeRadius * KX_ACTIVITY_HYSTERESIS;
+	const float distance2 = (m_centers[index] - position).length2();
+
+	if (distance2 <= keepRadius * keepRadius) {
+		m_keepPass[index] = m_pass;
+		if (distance2 <= resumeRadius * resumeRadius) {
+			m_resumePass[index] = m_pass;
+		}
+	}
+}
+
+void KX_ActivityCullingHandler::TestCamera(const MT_Vector3& position, float radius)
+{
+	const float extent = (radius + m_maxRadius) * KX_ACTIVITY_HYSTERESIS;
+	int64_t min[3];
+	int64_t max[3];
+	double cellCount = 1.0;
+	for (unsigned short axis = 0; axis < 3; ++axis) {
+		min[axis] = std::floor((position[axis] - extent) / m_cellSize);
+		max[axis] = std::floor((position[axis] + extent) / m_cellSize);
+		cellCount *= (double)(max[axis] - min[axis] + 1);
+	}
+
+	// With large objects the range can cover more cells than filled, test all the objects.
+	if (cellCount > (double)m_grid.size()) {
+		for (unsigned int i = 0, size = m_centers.size(); i < size; ++i) {
+			TestObject(i, position, radius);
+		}
+		return;
+	}
+
+	for (int64_t x = min[0]; x <= max[0]; ++x) {
+		for (int64_t y = min[1]; y <= max[1]; ++y) {
+			for (int64_t z = min[2]; z <= max[2]; ++z) {
+				std::unordered_map<uint64_t, std::vector<unsigned int> >::const_iterator it = m_grid.find(cellKey(x, y, z));
+				if (it == m_grid.end()) {
+					continue;
+				}
+				for (unsigned int index : it->second) {
+					TestObject(index, position, radius);
+				}
+			}
+		}
+	}
+}
+
+void KX_ActivityCullingHandler::TestCameras(const std::vector<MT_Vector3>& cameras, float radius)
+{
+	// The largest radius is computed again as the objects can shrink or be removed.
+	m_maxRadius = 0.0f;
+	for (float sphereRadius : m_radius) {
+		m_maxRadius = std::max(m_maxRadius, sphereRadius);
+	}
+
+	++m_pass;
+	for (const MT_Vector3& position : cameras) {
+		TestCamera(position, radius);
+	}
+}
+
+bool KX_ActivityCullingHandler::MustSuspend(unsigned int index, bool suspended) const
+{
+	return suspended ? (m_resumePass[index] != m_pass) : (m_keepPass[index] != m_pass);
+}
+
+unsigned int KX_ActivityCullingHandler::Process(EXP_ListValue<KX_GameObject> *objects, const std::vector<MT_Vector3>& cameras, float radius)
+{
+	const unsigned int count = objects->GetCount();
+	Resize(count, radius);
+
+	for (unsigned int i = 0; i < count; ++i) {
+		UpdateObject(i, objects->GetValue(i));
+	}
+
+	// Without camera the activity is left unchanged.
+	if (cameras.empty()) {
+		return 0;
+	}
+
+	TestCameras(cameras, radius);
+
+	unsigned int suspended = 0;
+	for (unsigned int i = 0; i < count; ++i) {
+		KX_GameObject *gameobj = m_objects[i];
+		if (gameobj->GetIgnoreActivityCulling()) {
+			// The object could be suspended before ignoring the activity culling.
+			gameobj->Resume();
+			continue;
+		}
+
+		if (MustSuspend(i, gameobj->IsSuspended())) {
+			gameobj->Suspend();
+			++suspended;
+		}
+		else {
+			gameobj->Resume();
+		}
+	}
+
+	return suspended;
+}
+
+void KX_ActivityCullingHandler::Clear(EXP_ListValue<KX_GameObject> *objects)
+{
+	for (KX_GameObject *gameobj : objects) {
+		gameobj->Resume();
+	}
+
+	m_grid.clear();
+	m_objects.clear();
+	m_inGrid.clear();
+	m_cellSize = 0.0f;
+	m_maxRadius = 0.0f;
+}
@@ -0,0 +1,113 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ActivityCullingHandler.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_ACTIVITY_CULLING_HANDLER_H__
+#define __KX_ACTIVITY_CULLING_HANDLER_H__
+
+#include "MT_Vector3.h"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+template <class T>
+class EXP_ListValue;
+class KX_GameObject;
+
+/** Activity culling of the objects of a scene.
+ * The objects far from every camera are suspended: their sensors, actions and dynamics
+ * are stopped until a camera comes close again. The world bounding spheres of the objects
+ * are stored in a uniform grid updated only for the objects whose transform or bounding
+ * box changed, the cameras only test the objects of the cells around them.
+ * An object is resumed when it is in the activity radius of a camera and suspended when it
+ * leaves a larger radius to avoid switching every frame at the limit.
+ * The activity radius is the one of the scene extended by the bounding radius of each object,
+ * the objects have no activity radius of their own.
+ */
+class KX_ActivityCullingHandler
+{
+private:
+	/// Objects of the last pass, in the same order as the object list.
+	std::vector<KX_GameObject *> m_objects;
+	/// True for the slots whose bounding sphere is in the grid.
+	std::vector<bool> m_inGrid;
+	/// World bounding spheres of the objects.
+	std::vector<MT_Vector3> m_centers;
+	std::vector<float> m_radius;
+	/// Grid cell of each object and its index in the cell.
+	std::vector<uint64_t> m_cells;
+	std::vector<unsigned int> m_cellIndices;
+	/// Last pass an object was in the resume and suspend radius of a camera.
+	std::vector<unsigned int> m_resumePass;
+	std::vector<unsigned int> m_keepPass;
+
+	/// Objects per grid cell.
+	std::unordered_map<uint64_t, std::vector<unsigned int> > m_grid;
+	/// Size of the cells, the grid is built again when it changes.
+	float m_cellSize;
+	/// Largest bounding radius of the objects in the grid.
+	float m_maxRadius;
+	unsigned int m_pass;
+
+	uint64_t GetCell(const MT_Vector3& point) const;
+	void AddToCell(unsigned int index);
+	void RemoveFromCell(unsigned int index);
+	/// Refresh the bounding sphere of an object if it moved or if the slot was used by another object.
+	void UpdateObject(unsigned int index, KX_GameObject *gameobj);
+	/// Mark the objects close to a camera position.
+	void TestCamera(const MT_Vector3& position, float radius);
+	void TestObject(unsigned int index, const MT_Vector3& position, float radius);
+
+public:
+	KX_ActivityCullingHandler();
+	~KX_ActivityCullingHandler() = default;
+
+	/** Set the number of slots of bounding spheres and the activity radius, the grid is
+	 * built again when the radius changes and the bounding spheres must be set again.
+	 */
+	void Resize(unsigned int count, float radius);
+	/// Set the bounding sphere of a slot and move it in the grid.
+	void SetSphere(unsigned int index, const MT_Vector3& center, float radius);
+	/// Test the bounding spheres of all the slots against the camera positions.
+	void TestCameras(const std::vector<MT_Vector3>& cameras, float radius);
+	/** Return true if the object of a slot must be suspended after the last camera test.
+	 * \param suspended The current state of the object, a suspended object is resumed only in the
+	 * activity radius, an active object is suspended only out of the larger radius.
+	 */
+	bool MustSuspend(unsigned int index, bool suspended) const;
+
+	/** Suspend or resume the objects depending on their distance to the cameras.
+	 * \param cameras The world positions of the active cameras.
+	 * \param radius The activity radius added to the bounding radius of each object.
+	 * \return The number of suspended objects.
+	 */
+	unsigned int Process(EXP_ListValue<KX_GameObject> *objects, const std::vector<MT_Vector3>& cameras, float radius);
+
+	/// Resume all the objects suspended by the activity culling and clear the grid.
+	void Clear(EXP_ListValue<KX_GameObject> *objects);
+};
+
+#endif  // __KX_ACTIVITY_CULLING_HANDLER_H__
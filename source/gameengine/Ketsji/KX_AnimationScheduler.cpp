@@ -0,0 +1,258 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_AnimationScheduler.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_AnimationScheduler.h"
+#include "KX_DeformerScheduler.h"
+#include "KX_GameObject.h"
+
+#include "BL_ArmatureObject.h"
+
+#include "EXP_ListValue.h"
+
+#include "CM_Profiler.h"
+
+#include "BLI_task.h"
+
+#include <algorithm>
+
+/// Minimum cost in seconds of an object, used for the objects never updated.
+#define KX_ANIMATION_MIN_COST 1.0e-6
+/// Cost in seconds of the objects grouped in one task.
+#define KX_ANIMATION_CHUNK_COST 1.0e-4
+
+KX_AnimationScheduler::KX_AnimationScheduler()
+	:m_curtime(0.0),
+	m_deformerScheduler(nullptr),
+	m_frame(0),
+	m_halfRateDistance(0.0f),
+	m_quarterRateDistance(0.0f)
+{
+}
+
+void KX_AnimationScheduler::SetLodDistances(float halfRateDistance, float quarterRateDistance)
+{
+	m_halfRateDistance = halfRateDistance;
+	m_quarterRateDistance = quarterRateDistance;
+}
+
+float KX_AnimationScheduler::GetHalfRateDistance() const
+{
+	return m_halfRateDistance;
+}
+
+float KX_AnimationScheduler::GetQuarterRateDistance() const
+{
+	return m_quarterRateDistance;
+}
+
+unsigned int KX_AnimationScheduler::GetPoseRate(KX_GameObject *gameobj, const std::vector<MT_Vector3>& cameras) const
+{
+	if ((m_halfRateDistance <= 0.0f && m_quarterRateDistance <= 0.0f) || cameras.empty()) {
+		return 1;
+	}
+
+	const MT_Vector3& position = gameobj->NodeGetWorldPosition();
+	MT_Scalar distance2 = MT_INFINITY;
+	for (const MT_Vector3& camera : cameras) {
+		distance2 = std::min(distance2, position.distance2(camera));
+	}
+
+	if (m_quarterRateDistance > 0.0f && distance2 >= (m_quarterRateDistance * m_quarterRateDistance)) {
+		return 4;
+	}
+	if (m_halfRateDistance > 0.0f && distance2 >= (m_halfRateDistance * m_halfRateDistance)) {
+		return 2;
+	}
+	return 1;
+}
+
+void KX_AnimationScheduler::UpdateObject(const Job& job)
+{
+	KX_GameObject *gameobj = job.m_object;
+
+	// Non-armature updates are fast enough, so just update them
+	bool needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
+
+	if (!needs_update && !job.m_skipPose) {
+		// If we got here, we're looking to update an armature, so check its children meshes
+		// to see if we need to bother with a more expensive pose update
+		EXP_ListValue<KX_GameObject> *children = gameobj->GetChildren();
+
+		bool has_mesh = false, has_non_mesh = false;
+
+		// Check for meshes that haven't been culled by a pass of the frame
+		for (KX_GameObject *child : children) {
+			if (!child->GetFrameCulled()) {
+				needs_update = true;
+				break;
+			}
+
+			if (child->GetMeshList().empty())
+				has_non_mesh = true;
+			else
+				has_mesh = true;
+		}
+
+		// If we didn't find a non-culled mesh, check to see
+		// if we even have any meshes, and update if this
+		// armature has only non-mesh children.
+		if (!needs_update && !has_mesh && has_non_mesh)
+			needs_update = true;
+
+		children->Release();
+	}
+
+	/* If the object is a culled armature or an armature skipped by its reduced rate,
+	 * then we manage only the animation time and end of its animations. */
+	gameobj->UpdateActionManager(m_curtime, needs_update);
+
+	if (needs_update) {
+		EXP_ListValue<KX_GameObject> *children = gameobj->GetChildren();
+		KX_GameObject *parent = gameobj->GetParent();
+
+		// Only do deformers here if they are not parented to an armature, otherwise the armature will
+		// handle updating its children
+		if (gameobj->GetDeformer() && (!parent || parent->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE))
+			m_deformerScheduler->AddDeformer(gameobj);
+
+		bool scheduledChild = false;
+		for (KX_GameObject *child : children) {
+			if (child->GetDeformer()) {
+				scheduledChild |= m_deformerScheduler->AddDeformer(child);
+			}
+		}
+
+		// The children deformers are updated in parallel, apply the pose they share now.
+		if (scheduledChild && gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+			static_cast<BL_ArmatureObject *>(gameobj)->ApplyPose();
+		}
+
+		children->Release();
+	}
+}
+
+void KX_AnimationScheduler::UpdateJob(const Job& job)
+{
+	const double start = CM_Profiler::GetTime();
+	UpdateObject(job);
+	const double end = CM_Profiler::GetTime();
+
+	// Keep the cost of a full update for the chunks of the next frames.
+	if (!job.m_skipPose) {
+		job.m_object->SetAnimationCost(end - start);
+	}
+	if (CM_Profiler::IsCapturing()) {
+		CM_Profiler::AddEvent(job.m_object->GetAnimationProfileName(), start, end);
+	}
+}
+
+void KX_AnimationScheduler::UpdateChunkTask(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	const Chunk *chunk = (const Chunk *)taskdata;
+	KX_AnimationScheduler *scheduler = chunk->m_scheduler;
+
+	for (unsigned int i = chunk->m_start; i < chunk->m_end; ++i) {
+		scheduler->UpdateJob(scheduler->m_jobs[i]);
+	}
+}
+
+bool KX_AnimationScheduler::SkipPose(unsigned int frame, unsigned int phase, unsigned int rate)
+{
+	return (rate > 1 && ((frame + phase) % rate) != 0);
+}
+
+void KX_AnimationScheduler::UpdateJobs(TaskPool *pool)
+{
+	// Update the parent armatures before their children.
+	const auto compareDepth = [](const Job& job1, const Job& job2) {
+		return job1.m_depth < job2.m_depth;
+	};
+	if (!std::is_sorted(m_jobs.begin(), m_jobs.end(), compareDepth)) {
+		std::stable_sort(m_jobs.begin(), m_jobs.end(), compareDepth);
+	}
+
+	for (unsigned int levelStart = 0, size = m_jobs.size(); levelStart < size; ) {
+		const unsigned int depth = m_jobs[levelStart].m_depth;
+
+		// Group the jobs of the level in chunks of similar cost.
+		unsigned int chunkStart = levelStart;
+		double chunkCost = 0.0;
+		unsigned int i = levelStart;
+		for (; i < size && m_jobs[i].m_depth == depth; ++i) {
+			chunkCost += std::max(m_jobs[i].m_cost, KX_ANIMATION_MIN_COST);
+			if (chunkCost >= KX_ANIMATION_CHUNK_COST) {
+				m_chunks.push_back({this, chunkStart, i + 1});
+				chunkStart = i + 1;
+				chunkCost = 0.0;
+			}
+		}
+		if (chunkStart < i) {
+			m_chunks.push_back({this, chunkStart, i});
+		}
+
+		for (Chunk& chunk : m_chunks) {
+			BLI_task_pool_push(pool, UpdateChunkTask, &chunk, false, TASK_PRIORITY_LOW);
+		}
+
+		BLI_task_pool_work_and_wait(pool);
+
+		m_chunks.clear();
+		levelStart = i;
+	}
+
+	m_jobs.clear();
+}
+
+void KX_AnimationScheduler::Update(double curtime, const std::vector<KX_GameObject *>& objects, const std::vector<MT_Vector3>& cameras,
+		KX_DeformerScheduler *deformerScheduler, TaskPool *pool)
+{
+	m_curtime = curtime;
+	m_deformerScheduler = deformerScheduler;
+	++m_frame;
+
+	for (unsigned int i = 0, size = objects.size(); i < size; ++i) {
+		KX_GameObject *gameobj = objects[i];
+		// The actions of the objects suspended by the activity culling are paused.
+		if (gameobj->IsSuspended()) {
+			continue;
+		}
+
+		unsigned int depth = 0;
+		for (KX_GameObject *parent = gameobj->GetParent(); parent; parent = parent->GetParent()) {
+			if (parent->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+				++depth;
+			}
+		}
+
+		bool skipPose = false;
+		if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+			const unsigned int rate = GetPoseRate(gameobj, cameras);
+			skipPose = SkipPose(m_frame, static_cast<BL_ArmatureObject *>(gameobj)->GetPosePhase(), rate);
+		}
+
+		m_jobs.push_back({gameobj, depth, gameobj->GetAnimationCost(), skipPose});
+	}
+
+	UpdateJobs(pool);
+}
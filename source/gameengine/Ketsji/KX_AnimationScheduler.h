@@ -0,0 +1,115 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_AnimationScheduler.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_ANIMATION_SCHEDULER_H__
+#define __KX_ANIMATION_SCHEDULER_H__
+
+#include "MT_Vector3.h"
+
+#include <vector>
+
+class KX_GameObject;
+class KX_DeformerScheduler;
+struct TaskPool;
+
+/** Update the animations of the objects of a scene in parallel.
+ * The objects are updated by levels, an object is updated after all the armatures
+ * it is parented to. In a level the objects are grouped in tasks of similar cost using the cost
+ * measured in their previous update, so many cheap objects share a task and an expensive
+ * armature gets its own one.
+ * The armatures far from the cameras can have their pose evaluated at a reduced rate, the time
+ * of their actions still advances every frame and the pose catches up in the next evaluation.
+ */
+class KX_AnimationScheduler
+{
+protected:
+	struct Job
+	{
+		KX_GameObject *m_object;
+		/// Number of armatures the object is parented to, directly or through other objects.
+		unsigned int m_depth;
+		/// Time in seconds of the last full update of the object.
+		double m_cost;
+		/// The pose is not evaluated in this frame because of the reduced rate.
+		bool m_skipPose;
+	};
+
+	/// Objects to update, added in the order of the animated objects list.
+	std::vector<Job> m_jobs;
+
+	/// Update the jobs by levels of parent armatures, the chunks of a level are updated in parallel.
+	void UpdateJobs(TaskPool *pool);
+	/// Update the animations of an object and keep its cost.
+	virtual void UpdateJob(const Job& job);
+
+private:
+	/// Consecutive jobs updated in one task.
+	struct Chunk
+	{
+		KX_AnimationScheduler *m_scheduler;
+		unsigned int m_start;
+		unsigned int m_end;
+	};
+
+	std::vector<Chunk> m_chunks;
+
+	double m_curtime;
+	KX_DeformerScheduler *m_deformerScheduler;
+	/// Number of updates, used to spread the reduced rate evaluations over the frames.
+	unsigned int m_frame;
+
+	/// Distances from the cameras from which the armatures are evaluated at half and quarter rate, zero to disable.
+	float m_halfRateDistance;
+	float m_quarterRateDistance;
+
+	/// Return the number of frames between two pose evaluations of an armature.
+	unsigned int GetPoseRate(KX_GameObject *gameobj, const std::vector<MT_Vector3>& cameras) const;
+
+	void UpdateObject(const Job& job);
+	static void UpdateChunkTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+
+public:
+	KX_AnimationScheduler();
+	virtual ~KX_AnimationScheduler() = default;
+
+	void SetLodDistances(float halfRateDistance, float quarterRateDistance);
+	float GetHalfRateDistance() const;
+	float GetQuarterRateDistance() const;
+
+	/** Return true if the pose of an armature is not evaluated in a frame.
+	 * \param frame The number of the update.
+	 * \param phase The pose phase of the armature, the armatures of the same rate are evaluated in different frames.
+	 * \param rate The number of frames between two pose evaluations.
+	 */
+	static bool SkipPose(unsigned int frame, unsigned int phase, unsigned int rate);
+
+	/** Update the animations and schedule the deformers of the objects.
+	 * \param objects The animated objects of the scene.
+	 * \param cameras The world positions of the cameras used for the reduced rates.
+	 */
+	void Update(double curtime, const std::vector<KX_GameObject *>& objects, const std::vector<MT_Vector3>& cameras,
+			KX_DeformerScheduler *deformerScheduler, TaskPool *pool);
+};
+
+#endif  // __KX_ANIMATION_SCHEDULER_H__
@@ -44,44 +44,12 @@ KX_CollisionEventManager::KX_CollisionEventManager(class SCA_LogicManager *logic
 	:SCA_EventManager(logicmgr, TOUCH_EVENTMGR),
 	m_physEnv(physEnv)
 {
-	m_physEnv->AddCollisionCallback(PHY_OBJECT_RESPONSE, KX_CollisionEventManager::newCollisionResponse, this);
-	m_physEnv->AddCollisionCallback(PHY_SENSOR_RESPONSE, KX_CollisionEventManager::newCollisionResponse, this);
 	m_physEnv->AddCollisionCallback(PHY_BROADPH_RESPONSE, KX_CollisionEventManager::newBroadphaseResponse, this);
 
 }
 
 KX_CollisionEventManager::~KX_CollisionEventManager()
 {
-	RemoveNewCollisions();
-}
-
-void KX_CollisionEventManager::RemoveNewCollisions()
-{
-	for (const NewCollision& collision : m_newCollisions) {
-		delete collision.colldata;
-	}
-	m_newCollisions.clear();
-}
-
-bool KX_CollisionEventManager::NewHandleCollision(void *object1, void *object2, const PHY_CollData *coll_data)
-{
-	PHY_IPhysicsController *obj1 = static_cast<PHY_IPhysicsController *>(object1);
-	PHY_IPhysicsController *obj2 = static_cast<PHY_IPhysicsController *>(object2);
-
-	m_newCollisions.insert(NewCollision(obj1, obj2, coll_data));
-
-	return false;
-}
-
-
-bool KX_CollisionEventManager::newCollisionResponse(void *client_data,
-                                                    void *object1,
-                                                    void *object2,
-                                                    const PHY_CollData *coll_data)
-{
-	KX_CollisionEventManager *collisionmgr = (KX_CollisionEventManager *)client_data;
-	collisionmgr->NewHandleCollision(object1, object2, coll_data);
-	return false;
 }
 
 bool KX_CollisionEventManager::newBroadphaseResponse(void *client_data,
@@ -191,10 +159,11 @@ void KX_CollisionEventManager::NextFrame()
 		static_cast<KX_CollisionSensor *>(sensor)->SynchronizeTransform();
 	}
 
-	for (const NewCollision& collision : m_newCollisions) {
+	// The collisions recorded by the physics steps since the last frame.
+	for (const PHY_CollisionPair& collision : m_physEnv->GetCollisions()) {
 		// Controllers
-		PHY_IPhysicsController *ctrl1 = collision.first;
-		PHY_IPhysicsController *ctrl2 = collision.second;
+		PHY_IPhysicsController *ctrl1 = collision.m_first;
+		PHY_IPhysicsController *ctrl2 = collision.m_second;
 		// Sensor iterator
 		std::list<SCA_ISensor *>::iterator sit;
 
@@ -219,7 +188,7 @@ void KX_CollisionEventManager::NextFrame()
 			}
 		}
 		// Run python callbacks
-		const PHY_CollData *colldata = collision.colldata;
+		const PHY_CollData *colldata = collision.m_collData;
 		KX_CollisionContactPointList contactPointList0 = KX_CollisionContactPointList(colldata, true);
 		KX_CollisionContactPointList contactPointList1 = KX_CollisionContactPointList(colldata, false);
 		kxObj1->RunCollisionCallbacks(kxObj2, contactPointList0);
@@ -230,33 +199,5 @@ void KX_CollisionEventManager::NextFrame()
 		sensor->Activate(m_logicmgr);
 	}
 
-	RemoveNewCollisions();
-}
-
-KX_CollisionEventManager::NewCollision::NewCollision(PHY_IPhysicsController *first,
-                                                     PHY_IPhysicsController *second,
-                                                     const PHY_CollData *colldata)
-	:first(first),
-	second(second),
-	colldata(colldata)
-{
-}
-
-KX_CollisionEventManager::NewCollision::NewCollision(const NewCollision &to_copy)
-	:first(to_copy.first),
-	second(to_copy.second),
-	colldata(to_copy.colldata)
-{
-}
-
-bool KX_CollisionEventManager::NewCollision::operator<(const NewCollision &other) const
-{
-	//see strict weak ordering: https://support.microsoft.com/en-us/kb/949171
-	if (first == other.first) {
-		if (second == other.second) {
-			return colldata < other.colldata;
-		}
-		return second < other.second;
-	}
-	return first < other.first;
+	m_physEnv->ClearCollisions();
 }
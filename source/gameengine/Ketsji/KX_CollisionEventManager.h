@@ -38,56 +38,19 @@
 #include "KX_GameObject.h"
 
 #include <vector>
-#include <set>
 
 class SCA_ISensor;
 class PHY_IPhysicsEnvironment;
 
 class KX_CollisionEventManager : public SCA_EventManager
 {
-	/**
-	 * Contains two colliding objects and the first contact point.
-	 */
-	class NewCollision
-	{
-	public:
-		PHY_IPhysicsController *first;
-		PHY_IPhysicsController *second;
-		const PHY_CollData *colldata;
-
-		/**
-		 * Creates a copy of the given PHY_CollData; freeing that copy should be done by the owner of
-		 * the NewCollision object.
-		 *
-		 * This allows us to efficiently store NewCollision objects in a std::set without creating more
-		 * copies of colldata, as the NewCollision copy constructor reuses the pointer and doesn't clone
-		 * it again. */
-		NewCollision(PHY_IPhysicsController *first,
-		             PHY_IPhysicsController *second,
-		             const PHY_CollData *colldata);
-		NewCollision(const NewCollision &to_copy);
-		bool operator<(const NewCollision &other) const;
-	};
-
 	PHY_IPhysicsEnvironment *m_physEnv;
 
-	std::set<NewCollision> m_newCollisions;
-
-	static bool newCollisionResponse(void *client_data,
-	                                 void *object1,
-	                                 void *object2,
-	                                 const PHY_CollData *coll_data);
-
 	static bool newBroadphaseResponse(void *client_data,
 	                                  void *object1,
 	                                  void *object2,
 	                                  const PHY_CollData *coll_data);
 
-	virtual bool NewHandleCollision(void *obj1, void *obj2,
-									const PHY_CollData *coll_data);
-
-	void RemoveNewCollisions();
-
 public:
 	KX_CollisionEventManager(class SCA_LogicManager *logicmgr,
 	                         PHY_IPhysicsEnvironment *physEnv);
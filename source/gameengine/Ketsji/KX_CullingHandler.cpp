@@ -1,36 +1,200 @@
 #include "KX_CullingHandler.h"
 #include "KX_GameObject.h"
 
+#include "RAS_Deformer.h"
+
+#include "EXP_ListValue.h"
+
 #include "SG_Node.h"
 
-KX_CullingHandler::KX_CullingHandler(KX_CullingNodeList& nodes, const SG_Frustum& frustum)
-	:m_activeNodes(nodes),
-	m_frustum(frustum)
+#include "BLI_task.h"
+
+/// Number of spheres tested together against a plane.
+#define KX_CULLING_BLOCK_SIZE 8
+/// Number of objects of a sphere test task.
+#define KX_CULLING_TASK_SIZE 512
+/// Minimum number of objects to test the spheres in several threads.
+#define KX_CULLING_PARALLEL_MIN_OBJECTS 2048
+/// Minimum number of objects to test the boxes in several threads.
+#define KX_CULLING_PARALLEL_MIN_BOXES 64
+
+KX_CullingHandler::KX_CullingHandler()
+	:m_lastLayer(0),
+	m_lastValid(false)
 {
 }
 
-void KX_CullingHandler::Process(KX_CullingNode *node)
+bool KX_CullingHandler::UpdateBounds(unsigned int index, KX_GameObject *gameobj)
 {
-	SG_Node *sgnode = node->GetObject()->GetSGNode();
+	SG_Node *sgnode = gameobj->GetSGNode();
+	if (m_objects[index] == gameobj && !sgnode->IsDirty(SG_Node::DIRTY_CULLING)) {
+		return false;
+	}
+
 	const MT_Transform trans = sgnode->GetWorldTransform();
-	const MT_Vector3 &scale = sgnode->GetWorldScaling();
-	const SG_BBox& aabb = node->GetAabb();
+	const MT_Vector3& scale = sgnode->GetWorldScaling();
+	const SG_BBox& aabb = gameobj->GetCullingNode()->GetAabb();
+	const MT_Vector3 center = trans(aabb.GetCenter());
+
+	m_centerX[index] = center.x();
+	m_centerY[index] = center.y();
+	m_centerZ[index] = center.z();
+	m_radius[index] = fabs(scale[scale.closestAxis()]) * aabb.GetRadius();
+
+	m_objects[index] = gameobj;
+	sgnode->ClearDirty(SG_Node::DIRTY_CULLING);
+
+	return true;
+}
 
-	bool culled = true;
-	const SG_Frustum::TestType sphereTest = m_frustum.SphereInsideFrustum(trans(aabb.GetCenter()), fabs(scale[scale.closestAxis()]) * aabb.GetRadius());
+void KX_CullingHandler::SphereTest(const TestData& data, unsigned int start, unsigned int end)
+{
+	const float *centerX = m_centerX.data();
+	const float *centerY = m_centerY.data();
+	const float *centerZ = m_centerZ.data();
+	const float *radius = m_radius.data();
+	unsigned char *results = m_results.data();
+
+	for (unsigned int block = start; block < end; block += KX_CULLING_BLOCK_SIZE) {
+		const unsigned int size = std::min(end - block, (unsigned int)KX_CULLING_BLOCK_SIZE);
+
+		unsigned char blockResults[KX_CULLING_BLOCK_SIZE];
+		bool decided[KX_CULLING_BLOCK_SIZE];
+		for (unsigned int i = 0; i < KX_CULLING_BLOCK_SIZE; ++i) {
+			blockResults[i] = SG_Frustum::INSIDE;
+			decided[i] = false;
+		}
+
+		/* Same classification as SG_Frustum::SphereInsideFrustum: the first plane
+		 * outside or intersecting the sphere decides of the result. */
+		for (unsigned short p = 0; p < 6; ++p) {
+			const float *plane = data.planes[p];
+			for (unsigned int i = 0; i < size; ++i) {
+				const unsigned int index = block + i;
+				const float distance = plane[0] * centerX[index] + plane[1] * centerY[index] + plane[2] * centerZ[index] + plane[3];
+				const bool outside = (distance < -radius[index]);
+				const bool intersect = (fabs(distance) <= radius[index]);
+
+				if (!decided[i]) {
+					blockResults[i] = outside ? SG_Frustum::OUTSIDE : (intersect ? SG_Frustum::INTERSECT : SG_Frustum::INSIDE);
+				}
+				decided[i] = decided[i] || outside || intersect;
+			}
+		}
 
-	// First test if the sphere is in the frustum as it is faster to test than box.
-	if (sphereTest == SG_Frustum::INSIDE) {
-		culled = false;
+		for (unsigned int i = 0; i < size; ++i) {
+			results[block + i] = blockResults[i];
+		}
 	}
+}
+
+void KX_CullingHandler::SphereTestTask(void *userdata, const int iter)
+{
+	TestData *data = (TestData *)userdata;
+	const unsigned int start = iter * KX_CULLING_TASK_SIZE;
+	const unsigned int end = std::min(start + KX_CULLING_TASK_SIZE, data->count);
+	data->handler->SphereTest(*data, start, end);
+}
+
+void KX_CullingHandler::BoxTestTask(void *userdata, const int iter)
+{
+	TestData *data = (TestData *)userdata;
+	KX_CullingHandler *handler = data->handler;
+	const unsigned int index = handler->m_intersectObjects[iter];
+
+	KX_GameObject *gameobj = handler->m_objects[index];
+	const SG_BBox& aabb = gameobj->GetCullingNode()->GetAabb();
+	const MT_Matrix4x4 mat = MT_Matrix4x4(gameobj->GetSGNode()->GetWorldTransform());
+
 	// If the sphere intersects we made a box test because the box could be not homogeneous.
-	else if (sphereTest == SG_Frustum::INTERSECT) {
-		const MT_Matrix4x4 mat = MT_Matrix4x4(trans);
-		culled = (m_frustum.AabbInsideFrustum(aabb.GetMin(), aabb.GetMax(), mat) == SG_Frustum::OUTSIDE);
+	const bool culled = (data->frustum->AabbInsideFrustum(aabb.GetMin(), aabb.GetMax(), mat) == SG_Frustum::OUTSIDE);
+	handler->m_results[index] = culled ? SG_Frustum::OUTSIDE : SG_Frustum::INSIDE;
+}
+
+void KX_CullingHandler::Process(EXP_ListValue<KX_GameObject> *objects, const SG_Frustum& frustum, int layer, KX_CullingNodeList& nodes)
+{
+	const unsigned int count = objects->GetCount();
+	const MT_Matrix4x4& matrix = frustum.GetMatrix();
+
+	// Any change since the last pass invalidates its results.
+	bool modified = (!m_lastValid || layer != m_lastLayer || count != m_objects.size());
+	for (unsigned short i = 0; i < 4 && !modified; ++i) {
+		for (unsigned short j = 0; j < 4; ++j) {
+			if (matrix[i][j] != m_lastMatrix[i][j]) {
+				modified = true;
+				break;
+			}
+		}
 	}
 
-	node->SetCulled(culled);
-	if (!culled) {
-		m_activeNodes.push_back(node);
+	m_objects.resize(count, nullptr);
+	m_centerX.resize(count);
+	m_centerY.resize(count);
+	m_centerZ.resize(count);
+	m_radius.resize(count);
+	m_tested.resize(count, false);
+	m_results.resize(count);
+
+	for (unsigned int i = 0; i < count; ++i) {
+		KX_GameObject *gameobj = objects->GetValue(i);
+		const bool tested = (gameobj->UseCulling() && gameobj->GetVisible() && (layer == 0 || gameobj->GetLayer() & layer));
+
+		if (tested) {
+			if (gameobj->GetDeformer()) {
+				/** Update all the deformer, not only per material.
+				 * One of the side effect is to clear some flags about AABB calculation.
+				 * like in KX_SoftBodyDeformer.
+				 */
+				gameobj->GetDeformer()->UpdateBuckets();
+			}
+			// Update the object bounding volume box.
+			gameobj->UpdateBounds(false);
+		}
+
+		if (UpdateBounds(i, gameobj) || tested != (bool)m_tested[i]) {
+			modified = true;
+		}
+		m_tested[i] = tested;
+	}
+
+	if (modified) {
+		TestData data;
+		data.handler = this;
+		data.frustum = &frustum;
+		data.count = count;
+		const std::array<MT_Vector4, 6>& planes = frustum.GetPlanes();
+		for (unsigned short p = 0; p < 6; ++p) {
+			planes[p].getValue(data.planes[p]);
+		}
+
+		const unsigned int tasks = (count + KX_CULLING_TASK_SIZE - 1) / KX_CULLING_TASK_SIZE;
+		BLI_task_parallel_range(0, tasks, &data, SphereTestTask, (count >= KX_CULLING_PARALLEL_MIN_OBJECTS));
+
+		m_intersectObjects.clear();
+		for (unsigned int i = 0; i < count; ++i) {
+			if (m_tested[i] && m_results[i] == SG_Frustum::INTERSECT) {
+				m_intersectObjects.push_back(i);
+			}
+		}
+
+		const unsigned int boxes = m_intersectObjects.size();
+		BLI_task_parallel_range(0, boxes, &data, BoxTestTask, (boxes >= KX_CULLING_PARALLEL_MIN_BOXES));
+
+		m_lastMatrix = matrix;
+		m_lastLayer = layer;
+		m_lastValid = true;
+	}
+
+	for (unsigned int i = 0; i < count; ++i) {
+		if (!m_tested[i]) {
+			continue;
+		}
+
+		KX_CullingNode *node = m_objects[i]->GetCullingNode();
+		const bool culled = (m_results[i] == SG_Frustum::OUTSIDE);
+		node->SetCulled(culled);
+		if (!culled) {
+			nodes.push_back(node);
+		}
 	}
 }
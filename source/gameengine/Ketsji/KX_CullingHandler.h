@@ -4,22 +4,60 @@
 #include "KX_CullingNode.h"
 #include "SG_Frustum.h"
 
+template <class T>
+class EXP_ListValue;
+class KX_GameObject;
+
+/** Frustum culling of the objects of a scene.
+ * The world bounding spheres of the objects are stored in a structure of arrays refreshed
+ * only for the objects whose transform or bounding box changed. The spheres are tested
+ * by blocks against the frustum planes and only the intersecting objects are tested
+ * with their box. The result of a pass is reused by the next pass using the same frustum.
+ */
 class KX_CullingHandler
 {
 private:
-	/// List of all nodes to render after the culling pass.
-	KX_CullingNodeList& m_activeNodes;
-	/// The camera frustum data.
-	const SG_Frustum& m_frustum;
+	/// Objects of the last culling pass, in the same order as the bounds.
+	std::vector<KX_GameObject *> m_objects;
+	/// World bounding spheres of the objects.
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+	std::vector<float> m_radius;
+	/// True for the objects tested in the last culling pass.
+	std::vector<unsigned char> m_tested;
+	/// The SG_Frustum::TestType of each object in the last culling pass.
+	std::vector<unsigned char> m_results;
+	/// Objects intersecting the frustum with their sphere.
+	std::vector<unsigned int> m_intersectObjects;
+
+	/// Frustum matrix and layer of the last culling pass.
+	MT_Matrix4x4 m_lastMatrix;
+	int m_lastLayer;
+	bool m_lastValid;
+
+	struct TestData
+	{
+		KX_CullingHandler *handler;
+		const SG_Frustum *frustum;
+		float planes[6][4];
+		unsigned int count;
+	};
+
+	/// Refresh the bounding sphere of an object, return true if it was modified.
+	bool UpdateBounds(unsigned int index, KX_GameObject *gameobj);
+	void SphereTest(const TestData& data, unsigned int start, unsigned int end);
+	static void SphereTestTask(void *userdata, const int iter);
+	static void BoxTestTask(void *userdata, const int iter);
 
 public:
-	KX_CullingHandler(KX_CullingNodeList& nodes, const SG_Frustum& frustum);
+	KX_CullingHandler();
 	~KX_CullingHandler() = default;
 
-	/** Process the culling of a new node, if the culling succeeded the
-	 * node is added in m_activeNodes.
+	/** Cull the visible objects of a layer, the objects not culled are added in nodes.
+	 * \param layer The layer of the objects to test, 0 for all the layers.
 	 */
-	void Process(KX_CullingNode *node);
+	void Process(EXP_ListValue<KX_GameObject> *objects, const SG_Frustum& frustum, int layer, KX_CullingNodeList& nodes);
 };
 
 #endif  // __KX_CULLING_HANDLER_H__
@@ -0,0 +1,142 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_DeformerScheduler.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_DeformerScheduler.h"
+#include "KX_GameObject.h"
+
+#include "BL_SkinDeformer.h"
+#include "BL_ArmatureObject.h"
+
+#include "CM_Profiler.h"
+
+#include "BLI_task.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+/// Maximum number of different deformations of a same mesh tested for sharing.
+#define KX_DEFORMER_SHARE_MAX_SOURCES 32
+
+bool KX_DeformerScheduler::AddDeformer(RAS_Deformer *deformer, const SG_CullingNode *node)
+{
+	/* The deformer of a culled object is updated later if the object becomes visible
+	 * for an other camera or in an other frame. The culling of all the passes is used
+	 * as an object seen by a previous pass must stay deformed. */
+	if (node->GetFrameCulled()) {
+		return false;
+	}
+
+	m_lock.Lock();
+	m_deformers.push_back(deformer);
+	m_lock.Unlock();
+
+	return true;
+}
+
+bool KX_DeformerScheduler::AddDeformer(KX_GameObject *gameobj)
+{
+	return AddDeformer(gameobj->GetDeformer(), gameobj->GetCullingNode());
+}
+
+void KX_DeformerScheduler::BeginFrame()
+{
+	m_updatedDeformers.clear();
+}
+
+void KX_DeformerScheduler::UpdateDeformerTask(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	CM_ProfileScope scope("Deformer");
+
+	RAS_Deformer *deformer = (RAS_Deformer *)taskdata;
+	deformer->Update();
+}
+
+void KX_DeformerScheduler::CopyDeformTask(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	CM_ProfileScope scope("Deformer copy");
+
+	SharedDeform *shared = (SharedDeform *)taskdata;
+	shared->m_deformer->CopyDeform(shared->m_source);
+}
+
+void KX_DeformerScheduler::Update(TaskPool *pool)
+{
+	if (m_deformers.empty()) {
+		return;
+	}
+
+	/* A deformer can be scheduled by its object and by its parent, and the deformers
+	 * updated by a previous pass of the frame are already up to date. */
+	m_deformers.erase(std::remove_if(m_deformers.begin(), m_deformers.end(), [this](RAS_Deformer *deformer) {
+		return !m_updatedDeformers.insert(deformer).second;
+	}), m_deformers.end());
+
+	// Deformers computing the vertices for each mesh, candidates for sharing.
+	std::unordered_map<Mesh *, std::vector<BL_SkinDeformer *> > sources;
+
+	for (RAS_Deformer *deformer : m_deformers) {
+		BL_SkinDeformer *skinDeformer = dynamic_cast<BL_SkinDeformer *>(deformer);
+		if (skinDeformer && skinDeformer->PoseUpdated()) {
+			/* The deformers of a same armature are updated in parallel, the pose must be
+			 * applied before. It is usually already done by the armature animation update. */
+			skinDeformer->GetArmature()->ApplyPose();
+
+			if (skinDeformer->IsShareable()) {
+				std::vector<BL_SkinDeformer *>& meshSources = sources[skinDeformer->GetMesh()];
+				BL_SkinDeformer *source = nullptr;
+				for (BL_SkinDeformer *meshSource : meshSources) {
+					if (meshSource->HasSameDeform(skinDeformer)) {
+						source = meshSource;
+						break;
+					}
+				}
+
+				if (source) {
+					m_sharedDeforms.push_back({skinDeformer, source});
+					continue;
+				}
+				else if (meshSources.size() < KX_DEFORMER_SHARE_MAX_SOURCES) {
+					meshSources.push_back(skinDeformer);
+				}
+			}
+		}
+
+		BLI_task_pool_push(pool, UpdateDeformerTask, deformer, false, TASK_PRIORITY_HIGH);
+	}
+
+	BLI_task_pool_work_and_wait(pool);
+
+	if (!m_sharedDeforms.empty()) {
+		for (SharedDeform& shared : m_sharedDeforms) {
+			BLI_task_pool_push(pool, CopyDeformTask, &shared, false, TASK_PRIORITY_HIGH);
+		}
+
+		BLI_task_pool_work_and_wait(pool);
+	}
+
+	m_deformers.clear();
+	m_sharedDeforms.clear();
+}
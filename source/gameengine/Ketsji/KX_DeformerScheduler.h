@@ -0,0 +1,90 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_DeformerScheduler.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_DEFORMER_SCHEDULER_H__
+#define __KX_DEFORMER_SCHEDULER_H__
+
+#include "CM_Thread.h"
+
+#include <unordered_set>
+#include <vector>
+
+class KX_GameObject;
+class RAS_Deformer;
+class BL_SkinDeformer;
+class SG_CullingNode;
+struct TaskPool;
+
+/** Collect the deformers to update in a frame and update them all at once in parallel.
+ * The armature deformers producing the same vertices (same mesh and same pose) are
+ * deformed only once and the result is copied to the other ones.
+ * The animations are updated after each culling pass, a deformer is updated by the first
+ * pass seeing its object and skipped by the next passes of the frame.
+ */
+class KX_DeformerScheduler
+{
+private:
+	/// A deformer copying the vertices of an other deformer.
+	struct SharedDeform
+	{
+		BL_SkinDeformer *m_deformer;
+		BL_SkinDeformer *m_source;
+	};
+
+	/// Deformers to update in the current frame.
+	std::vector<RAS_Deformer *> m_deformers;
+	/// Deformers using the vertices of a deformer of m_deformers.
+	std::vector<SharedDeform> m_sharedDeforms;
+	/// Deformers updated by the previous culling passes of the frame.
+	std::unordered_set<RAS_Deformer *> m_updatedDeformers;
+	/// Lock for the deformers added from the animation threads.
+	CM_ThreadSpinLock m_lock;
+
+	static void UpdateDeformerTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+	static void CopyDeformTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+
+protected:
+	/** Schedule the update of a deformer, thread safe.
+	 * \param node The culling node of the deformed object.
+	 * \return False if the deformer is not updated because all the culling passes of the frame culled the object.
+	 */
+	bool AddDeformer(RAS_Deformer *deformer, const SG_CullingNode *node);
+
+public:
+	KX_DeformerScheduler() = default;
+	virtual ~KX_DeformerScheduler() = default;
+
+	/// Schedule the update of the deformer of an object, thread safe.
+	bool AddDeformer(KX_GameObject *gameobj);
+
+	/// Start a new frame, the deformers updated in the previous frame can be updated again.
+	void BeginFrame();
+
+	/// Update all the scheduled deformers using the task pool and clear the schedule.
+	void Update(TaskPool *pool);
+};
+
+#endif  // __KX_DEFORMER_SCHEDULER_H__
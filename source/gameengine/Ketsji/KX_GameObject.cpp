@@ -94,6 +94,7 @@
 #include "BLI_math.h"
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 static MT_Vector3 dummy_point= MT_Vector3(0.0f, 0.0f, 0.0f);
 static MT_Vector3 dummy_scaling = MT_Vector3(1.0f, 1.0f, 1.0f);
@@ -122,7 +123,12 @@ KX_GameObject::KX_GameObject(
       m_components(nullptr),
       m_pInstanceObjects(nullptr),
       m_pDupliGroupObject(nullptr),
-      m_actionManager(nullptr)
+      m_actionManager(nullptr),
+      m_animationCost(0.0f),
+      m_animationProfileName(nullptr),
+      m_activitySuspendTime(0.0),
+      m_activityDynamicsSuspended(false),
+      m_linearMotionSet(false)
 #ifdef WITH_PYTHON
     , m_attr_dict(nullptr),
     m_collisionCallbacks(nullptr)
@@ -228,6 +234,7 @@ std::string KX_GameObject::GetName()
 void KX_GameObject::SetName(const std::string& name)
 {
 	m_name = name;
+	m_animationProfileName = nullptr;
 }
 
 PHY_IPhysicsController* KX_GameObject::GetPhysicsController()
@@ -336,6 +343,8 @@ void KX_GameObject::SetParent(KX_GameObject* obj, bool addToCompound, bool ghost
 		if (m_pPhysicsController)
 		{
 			m_pPhysicsController->SuspendDynamics(ghost);
+			// The parent keeps the dynamics suspended.
+			m_activityDynamicsSuspended = false;
 		}
 		// Set us to our new scale, position, and orientation
 		scale2[0] = 1.0f/scale2[0];
@@ -404,6 +413,7 @@ void KX_GameObject::RemoveParent()
 				rootobj->m_pPhysicsController->RemoveCompoundChild(m_pPhysicsController);
 			}
 			m_pPhysicsController->RestoreDynamics();
+			m_activityDynamicsSuspended = false;
 			if (m_pPhysicsController->IsDynamic() && (rootobj != nullptr && rootobj->m_pPhysicsController))
 			{
 				// dynamic object should remember the velocity they had while being parented
@@ -466,6 +476,24 @@ void KX_GameObject::UpdateActionManager(float curtime, bool applyToObject)
 	GetActionManager()->Update(curtime, applyToObject);
 }
 
+float KX_GameObject::GetAnimationCost() const
+{
+	return m_animationCost;
+}
+
+void KX_GameObject::SetAnimationCost(float cost)
+{
+	m_animationCost = cost;
+}
+
+const char *KX_GameObject::GetAnimationProfileName()
+{
+	if (!m_animationProfileName) {
+		m_animationProfileName = CM_Profiler::InternName("Animation " + GetName());
+	}
+	return m_animationProfileName;
+}
+
 float KX_GameObject::GetActionFrame(short layer)
 {
 	return GetActionManager()->GetActionFrame(layer);
@@ -663,6 +691,7 @@ void KX_GameObject::ApplyTorque(const MT_Vector3& torque,bool local)
 
 void KX_GameObject::ApplyMovement(const MT_Vector3& dloc,bool local)
 {
+	m_linearMotionSet = true;
 	if (m_pPhysicsController) // (IsDynamic())
 	{
 		m_pPhysicsController->RelativeTranslate(dloc,local);
@@ -811,13 +840,23 @@ void KX_GameObject::UpdateLod(const MT_Vector3& cam_pos, float lodfactor)
 	KX_LodLevel *lodLevel = m_lodManager->GetLevel(scene, m_currentLodLevel, distance2);
 
 	if (lodLevel) {
-		RAS_MeshObject *mesh = lodLevel->GetMesh();
-		if (mesh != m_meshes.front()) {
-			ReplaceMesh(mesh, true, false);
-		}
+		SetLodLevel(lodLevel);
+	}
+}
 
-		m_currentLodLevel = lodLevel->GetLevel();
+short KX_GameObject::GetCurrentLodLevel() const
+{
+	return m_currentLodLevel;
+}
+
+void KX_GameObject::SetLodLevel(KX_LodLevel *lodLevel)
+{
+	RAS_MeshObject *mesh = lodLevel->GetMesh();
+	if (mesh != m_meshes.front()) {
+		ReplaceMesh(mesh, true, false);
 	}
+
+	m_currentLodLevel = lodLevel->GetLevel();
 }
 
 void KX_GameObject::UpdateTransform()
@@ -990,6 +1029,7 @@ KX_GameObject::GetLayer(
 
 void KX_GameObject::addLinearVelocity(const MT_Vector3& lin_vel,bool local)
 {
+	m_linearMotionSet = true;
 	if (m_pPhysicsController)
 	{
 		MT_Vector3 lv = local ? NodeGetWorldOrientation() * lin_vel : lin_vel;
@@ -1001,6 +1041,7 @@ void KX_GameObject::addLinearVelocity(const MT_Vector3& lin_vel,bool local)
 
 void KX_GameObject::setLinearVelocity(const MT_Vector3& lin_vel,bool local)
 {
+	m_linearMotionSet = true;
 	if (m_pPhysicsController)
 		m_pPhysicsController->SetLinearVelocity(lin_vel,local);
 }
@@ -1013,6 +1054,16 @@ void KX_GameObject::setAngularVelocity(const MT_Vector3& ang_vel,bool local)
 		m_pPhysicsController->SetAngularVelocity(ang_vel,local);
 }
 
+bool KX_GameObject::IsLinearMotionSet() const
+{
+	return m_linearMotionSet;
+}
+
+void KX_GameObject::ResetLinearMotionSet()
+{
+	m_linearMotionSet = false;
+}
+
 void KX_GameObject::SetObjectColor(const MT_Vector4& rgbavec)
 {
 	m_objectColor = rgbavec;
@@ -1389,6 +1440,10 @@ void KX_GameObject::SetBoundsAabb(MT_Vector3 aabbMin, MT_Vector3 aabbMax)
 {
 	// Set the AABB in culling node box.
 	m_cullingNode.GetAabb().Set(aabbMin, aabbMax);
+	if (m_pSGNode) {
+		m_pSGNode->SetDirty(SG_Node::DIRTY_CULLING);
+		m_pSGNode->SetDirty(SG_Node::DIRTY_ACTIVITY);
+	}
 
 	// Synchronize the AABB with the graphic controller.
 	if (m_pGraphicController) {
@@ -1481,9 +1536,16 @@ void KX_GameObject::Resume(void)
 {
 	if (m_suspended) {
 		SCA_IObject::Resume();
+		// Only restore the dynamics suspended in Suspend, not the ones suspended by the user or a parent.
 		// Child objects must be static, so we block changing to dynamic
-		if (GetPhysicsController() && !GetParent())
+		if (m_activityDynamicsSuspended && GetPhysicsController() && !GetParent())
 			GetPhysicsController()->RestoreDynamics();
+		m_activityDynamicsSuspended = false;
+
+		// The actions continue from the frame they were suspended at.
+		if (m_actionManager) {
+			m_actionManager->DelayActions(GetSceneTime() - m_activitySuspendTime);
+		}
 
 		m_suspended = false;
 	}
@@ -1493,12 +1555,99 @@ void KX_GameObject::Suspend()
 {
 	if ((!m_ignore_activity_culling) && (!m_suspended)) {
 		SCA_IObject::Suspend();
-		if (GetPhysicsController())
+		if (GetPhysicsController() && !GetPhysicsController()->IsDynamicsSuspended()) {
 			GetPhysicsController()->SuspendDynamics();
+			m_activityDynamicsSuspended = true;
+		}
+		m_activitySuspendTime = GetSceneTime();
 		m_suspended = true;
 	}
 }
 
+double KX_GameObject::GetSceneTime()
+{
+	return KX_GetActiveEngine()->GetFrameTime() - GetScene()->GetSuspendedDelta();
+}
+
+void KX_GameObject::Park()
+{
+	Resume();
+
+#ifdef WITH_PYTHON
+	if (m_attr_dict) {
+		PyDict_Clear(m_attr_dict);
+	}
+	if (m_collisionCallbacks) {
+		UnregisterCollisionCallbacks();
+		Py_CLEAR(m_collisionCallbacks);
+	}
+#endif  // WITH_PYTHON
+
+	ClearLogic();
+
+	if (m_actionManager) {
+		delete m_actionManager;
+		m_actionManager = nullptr;
+	}
+
+	if (m_pPhysicsController) {
+		if (m_pPhysicsController->IsDynamicsSuspended()) {
+			m_pPhysicsController->RestoreDynamics();
+		}
+		m_pPhysicsController->SuspendPhysics(true);
+	}
+
+	if (m_pGraphicController) {
+		m_pGraphicController->Activate(false);
+	}
+}
+
+void KX_GameObject::Respawn(KX_GameObject *original)
+{
+	ClearProperties();
+	for (const std::string& name : original->GetPropertyNames()) {
+		EXP_Value *prop = original->GetProperty(name)->GetReplica();
+		SetProperty(name, prop);
+		prop->Release();
+	}
+
+#ifdef WITH_PYTHON
+	if (original->m_attr_dict) {
+		if (m_attr_dict) {
+			PyDict_Update(m_attr_dict, original->m_attr_dict);
+		}
+		else {
+			m_attr_dict = PyDict_Copy(original->m_attr_dict);
+		}
+	}
+#endif  // WITH_PYTHON
+
+	ShareLogic(original);
+
+	m_objectColor = original->m_objectColor;
+	m_bVisible = original->m_bVisible;
+	m_bOccluder = original->m_bOccluder;
+	m_userCollisionGroup = original->m_userCollisionGroup;
+	m_userCollisionMask = original->m_userCollisionMask;
+
+	SG_Node *orgnode = original->GetSGNode();
+	NodeSetLocalScale(orgnode->GetLocalScale());
+	NodeSetLocalPosition(orgnode->GetLocalPosition());
+	NodeSetLocalOrientation(orgnode->GetLocalOrientation());
+
+	if (m_pPhysicsController) {
+		m_pPhysicsController->RestorePhysics();
+		m_pPhysicsController->RefreshCollisions();
+
+		PHY_IPhysicsController *orgctrl = original->GetPhysicsController();
+		if (orgctrl && m_pPhysicsController->IsDynamic()) {
+			m_pPhysicsController->SetMass(orgctrl->GetMass());
+			m_pPhysicsController->SetLinearVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+			m_pPhysicsController->SetAngularVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+		}
+	}
+}
+
 static void walk_children(SG_Node* node, EXP_ListValue<KX_GameObject> *list, bool recursive)
 {
 	if (!node)
@@ -1885,6 +2034,7 @@ PyMethodDef KX_GameObject::Methods[] = {
 
 PyAttributeDef KX_GameObject::Attributes[] = {
 	EXP_PYATTRIBUTE_SHORT_RO("currentLodLevel", KX_GameObject, m_currentLodLevel),
+	EXP_PYATTRIBUTE_FLOAT_RO("animationCost", KX_GameObject, m_animationCost),
 	EXP_PYATTRIBUTE_RW_FUNCTION("lodManager", KX_GameObject, pyattr_get_lodManager, pyattr_set_lodManager),
 	EXP_PYATTRIBUTE_RW_FUNCTION("name",		KX_GameObject, pyattr_get_name, pyattr_set_name),
 	EXP_PYATTRIBUTE_RO_FUNCTION("parent",	KX_GameObject, pyattr_get_parent),
@@ -3541,6 +3691,8 @@ PyObject *KX_GameObject::PySuspendDynamics(PyObject *args)
 
 	if (GetPhysicsController())
 		GetPhysicsController()->SuspendDynamics(ghost);
+	// The dynamics stay suspended when the activity culling resumes the object.
+	m_activityDynamicsSuspended = false;
 
 	Py_RETURN_NONE;
 }
@@ -3552,6 +3704,7 @@ PyObject *KX_GameObject::PyRestoreDynamics()
 	// Child objects must be static, so we block changing to dynamic
 	if (GetPhysicsController() && !GetParent())
 		GetPhysicsController()->RestoreDynamics();
+	m_activityDynamicsSuspended = false;
 	Py_RETURN_NONE;
 }
 
@@ -54,6 +54,7 @@
 struct KX_ClientObjectInfo;
 class KX_RayCast;
 class KX_LodManager;
+class KX_LodLevel;
 class KX_CullingNode;
 class KX_PythonComponent;
 class RAS_MeshObject;
@@ -123,8 +124,21 @@ protected:
 
 	// The action manager is used to play/stop/update actions
 	BL_ActionManager*					m_actionManager;
+	/// Time in seconds spent by the last animation update of the object.
+	float								m_animationCost;
+	/// Name of the animation updates of the object in the profiler captures, interned on first use.
+	const char							*m_animationProfileName;
+
+	/// Scene time when the activity culling suspended the object, to freeze its actions.
+	double								m_activitySuspendTime;
+	/// True when the activity culling suspended the dynamics, false if they were already suspended.
+	bool								m_activityDynamicsSuspended;
+	/// The linear velocity or the position was changed since ResetLinearMotionSet.
+	bool								m_linearMotionSet;
 
 	BL_ActionManager* GetActionManager();
+	/// Return the frame time minus the time the scene was suspended, the time base of the actions.
+	double GetSceneTime();
 
 public:
 	/**
@@ -297,6 +311,11 @@ public:
 	 */
 	void UpdateActionManager(float curtime, bool applyObject);
 
+	float GetAnimationCost() const;
+	void SetAnimationCost(float cost);
+	/// Return the name of the animation updates of the object in the profiler captures.
+	const char *GetAnimationProfileName();
+
 	/*********************************
 	 * End Animation API
 	 *********************************/
@@ -637,6 +656,12 @@ public:
 		bool local
 	);
 
+	/** Return true if ApplyMovement, addLinearVelocity or setLinearVelocity were called since
+	 * the last ResetLinearMotionSet, used to detect the actuators moving the object after another.
+	 */
+	bool IsLinearMotionSet() const;
+	void ResetLinearMotionSet();
+
 	virtual float	getLinearDamping() const;
 	virtual float	getAngularDamping() const;
 	virtual void	setLinearDamping(float damping);
@@ -734,6 +759,11 @@ public:
 	 */
 	void UpdateLod(const MT_Vector3& cam_pos, float lodfactor);
 
+	/// Get the index of the current lod level.
+	short GetCurrentLodLevel() const;
+	/// Use the mesh of a lod level and set it as the current level.
+	void SetLodLevel(KX_LodLevel *lodLevel);
+
 	const std::vector<RAS_MeshObject *>& GetMeshList() const;
 
 	/// Return the mesh user of this game object.
@@ -775,6 +805,14 @@ public:
 	SetCulled(
 		bool c
 	) { m_cullingNode.SetCulled(c); }
+
+	/**
+	 * Was this object culled by all the culling passes of the frame?
+	 */
+	inline bool
+	GetFrameCulled(
+		void
+	) { return m_cullingNode.GetFrameCulled(); }
 	
 	/**
 	 * Is this object an occluder?
@@ -859,6 +897,16 @@ public:
 	 */
 	void Resume(void);
 
+	/** Disable a removed replica kept in a spawn pool: its logic bricks, actions,
+	 * collision callbacks and python attributes are freed and its physics removed from the world.
+	 */
+	void Park();
+
+	/** Reset a parked replica to the state of its original object before reusing it,
+	 * the logic bricks must then be replicated as for a new replica.
+	 */
+	void Respawn(KX_GameObject *original);
+
 	/**
 	 * add debug object to the debuglist.
 	 */
@@ -35,11 +35,18 @@
 #endif
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 #include <boost/format.hpp>
 
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+
 #include "BLI_task.h"
 
+#include "PIL_time.h"
+
 #include "KX_KetsjiEngine.h"
 
 #include "EXP_ListValue.h"
@@ -133,7 +140,8 @@ const std::string KX_KetsjiEngine::m_profileLabels[tc_numCategories] = {
 	"Services:", // tc_services
 	"Overhead:", // tc_overhead
 	"Outside:", // tc_outside
-	"GPU Latency:" // tc_latency
+	"GPU Latency:", // tc_latency
+	"Physics (async):" // tc_physics_async
 };
 
 const std::string KX_KetsjiEngine::m_renderQueriesLabels[QUERY_MAX] = {
@@ -170,6 +178,7 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system)
 	m_overrideCamZoom(1.0f),
 	m_logger(KX_TimeCategoryLogger(25)),
 	m_average_framerate(0.0),
+	m_benchmark(false),
 	m_showBoundingBox(KX_DebugOption::DISABLE),
 	m_showArmature(KX_DebugOption::DISABLE),
 	m_showCameraFrustum(KX_DebugOption::DISABLE),
@@ -178,6 +187,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system)
 	for (int i = tc_first; i < tc_numCategories; i++) {
 		m_logger.AddCategory((KX_TimeCategory)i);
 	}
+	// The asynchronous physics time overlaps the other categories, don't count it in the frame time.
+	m_logger.SetOverlapCategory(tc_physics_async, true);
 
 	m_renderQueries.push_back(RAS_Query(RAS_Query::SAMPLES));
 	m_renderQueries.push_back(RAS_Query(RAS_Query::PRIMITIVES));
@@ -188,6 +199,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system)
 #endif
 
 	m_taskscheduler = BLI_task_scheduler_create(TASK_SCHEDULER_AUTO_THREADS);
+	m_physicsPool = BLI_task_pool_create(m_taskscheduler, nullptr);
+	m_scenesPhysicsPool = BLI_task_pool_create(m_taskscheduler, nullptr);
 
 	m_scenes = new EXP_ListValue<KX_Scene>();
 }
@@ -201,6 +214,11 @@ KX_KetsjiEngine::~KX_KetsjiEngine()
 	Py_CLEAR(m_pyprofiledict);
 #endif
 
+	if (m_physicsPool)
+		BLI_task_pool_free(m_physicsPool);
+	if (m_scenesPhysicsPool)
+		BLI_task_pool_free(m_scenesPhysicsPool);
+
 	if (m_taskscheduler)
 		BLI_task_scheduler_free(m_taskscheduler);
 
@@ -304,7 +322,7 @@ void KX_KetsjiEngine::EndFrame()
 	m_average_framerate = 1.0 / tottime;
 
 	// Go to next profiling measurement, time spent after this call is shown in the next frame.
-	m_logger.NextMeasurement(m_kxsystem->GetTimeInSeconds());
+	NextMeasurement();
 
 	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
 	m_rasterizer->EndFrame();
@@ -320,8 +338,29 @@ void KX_KetsjiEngine::EndFrame()
 	m_canvas->EndDraw();
 }
 
+void KX_KetsjiEngine::NextMeasurement()
+{
+	m_logger.NextMeasurement(m_kxsystem->GetTimeInSeconds());
+
+	if (m_benchmark) {
+		std::array<double, tc_numCategories + 1> times;
+		for (int i = tc_first; i < tc_numCategories; ++i) {
+			times[i] = m_logger.GetLastMeasurement((KX_TimeCategory)i);
+		}
+		times[tc_numCategories] = m_logger.GetLastMeasurement();
+		m_benchmarkTimes.push_back(times);
+	}
+}
+
 bool KX_KetsjiEngine::NextFrame()
 {
+	// The physics steps ran in parallel of the last render must be finished before any logic.
+	SyncPhysics();
+
+	/* The profiler captures the frames from one logic update to the next. It is called once
+	 * the physics steps are joined as the capture is written when no other thread records. */
+	CM_Profiler::NextFrame();
+
 	m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
 
 	/*
@@ -417,11 +456,13 @@ bool KX_KetsjiEngine::NextFrame()
 			 * entire scene. Objects can be suspended individually, and
 			 * the settings for that precede the logic and physics
 			 * update. */
+			CM_ProfileScope sceneScope(scene->GetName());
 			m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
 
-			scene->UpdateObjectActivity();
-
 			if (!scene->IsSuspended()) {
+				// The activity of the objects of a suspended scene is left unchanged.
+				scene->UpdateObjectActivity();
+
 				m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
 				// set Python hooks for each scene
 #ifdef WITH_PYTHON
@@ -450,19 +491,18 @@ bool KX_KetsjiEngine::NextFrame()
 				m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
 				scene->UpdateParents(m_frameTime);
 
-				m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
-
 				// Perform physics calculations on the scene. This can involve
 				// many iterations of the physics solver.
-				scene->GetPhysicsEnvironment()->ProceedDeltaTime(m_frameTime, timestep, framestep);//m_deltatimerealDeltaTime);
-
-				m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
-				scene->UpdateParents(m_frameTime);
+				ProceedScenePhysics(scene, timestep, framestep, (i == (frames - 1)));
 			}
 
 			m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
 		}
 
+		/* Start the deferred physics steps only now, python scripts of a scene
+		 * are able to access the objects of the other scenes. */
+		ProceedDeferredPhysics();
+
 		m_logger.StartLog(tc_network, m_kxsystem->GetTimeInSeconds());
 		m_networkMessageManager->ClearMessages();
 
@@ -477,12 +517,157 @@ bool KX_KetsjiEngine::NextFrame()
 		ProcessScheduledScenes();
 	}
 
+	// Without render the frame ends here for the profiling.
+	if (doRender && !m_doRender) {
+		/* The benchmark still measures the stages done before drawing, the games
+		 * disabling the render with python don't run them. */
+		if (m_benchmark) {
+			UpdateScenesWithoutRender();
+		}
+		NextMeasurement();
+	}
+
 	// Start logging time spent outside main loop
 	m_logger.StartLog(tc_outside, m_kxsystem->GetTimeInSeconds());
 
 	return doRender && m_doRender;
 }
 
+static void proceed_physics_thread_func(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	KX_KetsjiEngine::PhysicsStepData *data = (KX_KetsjiEngine::PhysicsStepData *)taskdata;
+
+	const double starttime = PIL_check_seconds_timer();
+	data->m_scene->GetPhysicsEnvironment()->ProceedDeltaTime(data->m_curtime, data->m_timestep, data->m_interval);
+	data->m_duration = PIL_check_seconds_timer() - starttime;
+}
+
+void KX_KetsjiEngine::ProceedScenePhysics(KX_Scene *scene, double timestep, double framestep, bool lastFrame)
+{
+	PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+
+	m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+
+	/* The rendering reads only the world transformations of the objects whereas the physics
+	 * writes only their local transformations (see KX_MotionState). The world transformations
+	 * computed before the step can then be rendered while the physics is proceeding, they are
+	 * updated from the local transformations in SyncPhysics. The cost is one physics step of latency
+	 * for the rendered positions.
+	 */
+	if ((m_flags & PIPELINED_PHYSICS) && lastFrame && physEnv->IsRenderIndependent()) {
+		// The step is started in StartPhysics once the logic of all the scenes is done.
+		m_physicsSteps.push_back({scene, m_frameTime, timestep, framestep, 0.0});
+		return;
+	}
+
+	/* The physics environments of the scenes are independent, but the logic is kept serial
+	 * as it can access the other scenes and the engine (scene actuator, messages, python).
+	 */
+	if (m_flags & PARALLEL_SCENES) {
+		m_scenesPhysicsSteps.push_back({scene, m_frameTime, timestep, framestep, 0.0});
+		return;
+	}
+
+	physEnv->ProceedDeltaTime(m_frameTime, timestep, framestep);
+
+	m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+	scene->UpdateParents(m_frameTime);
+}
+
+void KX_KetsjiEngine::ProceedDeferredPhysics()
+{
+	if (m_physicsSteps.empty() && m_scenesPhysicsSteps.empty()) {
+		return;
+	}
+
+	/* All the deferred steps run in the same time, they must use the same process wide
+	 * physics settings. The steps of the environments with other settings than the first
+	 * one are proceeded serially before. */
+	PHY_IPhysicsEnvironment *refEnv = (m_physicsSteps.empty() ? m_scenesPhysicsSteps : m_physicsSteps).front().m_scene->GetPhysicsEnvironment();
+
+	std::vector<PhysicsStepData *> parallelSteps;
+	for (PhysicsStepData& step : m_scenesPhysicsSteps) {
+		PHY_IPhysicsEnvironment *physEnv = step.m_scene->GetPhysicsEnvironment();
+		if (physEnv->IsStepCompatible(refEnv)) {
+			parallelSteps.push_back(&step);
+		}
+		else {
+			m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+			physEnv->ProceedDeltaTime(step.m_curtime, step.m_timestep, step.m_interval);
+		}
+	}
+
+	std::vector<PhysicsStepData *> pipelinedSteps;
+	for (PhysicsStepData& step : m_physicsSteps) {
+		PHY_IPhysicsEnvironment *physEnv = step.m_scene->GetPhysicsEnvironment();
+		if (physEnv->IsStepCompatible(refEnv)) {
+			pipelinedSteps.push_back(&step);
+		}
+		else {
+			// The scene graph is still updated in SyncPhysics.
+			m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+			physEnv->ProceedDeltaTime(step.m_curtime, step.m_timestep, step.m_interval);
+		}
+	}
+
+	// Set the settings once before the steps, they are only read by the worker threads.
+	refEnv->ApplyGlobalSettings();
+
+	for (PhysicsStepData *step : pipelinedSteps) {
+		BLI_task_pool_push(m_physicsPool, proceed_physics_thread_func, step, false, TASK_PRIORITY_HIGH);
+	}
+
+	if (m_scenesPhysicsSteps.empty()) {
+		return;
+	}
+
+	m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+
+	// No need of threads for a single scene.
+	if (parallelSteps.size() == 1) {
+		const PhysicsStepData *step = parallelSteps.front();
+		step->m_scene->GetPhysicsEnvironment()->ProceedDeltaTime(step->m_curtime, step->m_timestep, step->m_interval);
+	}
+	else if (parallelSteps.size() > 1) {
+		for (PhysicsStepData *step : parallelSteps) {
+			BLI_task_pool_push(m_scenesPhysicsPool, proceed_physics_thread_func, step, false, TASK_PRIORITY_HIGH);
+		}
+		BLI_task_pool_work_and_wait(m_scenesPhysicsPool);
+	}
+
+	m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+	for (const PhysicsStepData& step : m_scenesPhysicsSteps) {
+		step.m_scene->UpdateParents(step.m_curtime);
+	}
+
+	m_scenesPhysicsSteps.clear();
+}
+
+void KX_KetsjiEngine::SyncPhysics()
+{
+	if (m_physicsSteps.empty()) {
+		return;
+	}
+
+	const KX_TimeCategoryLogger::TimeCategory category = m_logger.GetCurrentCategory();
+
+	// Time spent by the main thread waiting for the physics, the rest was overlapped.
+	m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+	BLI_task_pool_work_and_wait(m_physicsPool);
+
+	m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+	for (const PhysicsStepData& step : m_physicsSteps) {
+		m_logger.AddTime(tc_physics_async, step.m_duration);
+		step.m_scene->UpdateParents(step.m_curtime);
+	}
+
+	m_physicsSteps.clear();
+
+	if (category != -1) {
+		m_logger.StartLog(category, m_kxsystem->GetTimeInSeconds());
+	}
+}
+
 void KX_KetsjiEngine::UpdateSuspendedScenes(double framestep)
 {
 	for (KX_Scene *scene : m_scenes) {
@@ -518,6 +703,9 @@ KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(KX_Scene
 
 	KX_SetActiveScene(scene);
 #ifdef WITH_PYTHON
+	if (scene->HasDrawingCallbacks(KX_Scene::PRE_DRAW_SETUP)) {
+		SyncPhysics();
+	}
 	scene->RunDrawingCallbacks(KX_Scene::PRE_DRAW_SETUP, rendercam);
 #endif
 
@@ -630,11 +818,15 @@ KX_KetsjiEngine::RenderData KX_KetsjiEngine::GetRenderData()
 
 void KX_KetsjiEngine::Render()
 {
+	CM_ProfileScope scope("Render");
+
 	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
 
 	BeginFrame();
 
 	for (KX_Scene *scene : m_scenes) {
+		// The shadow and camera passes of the frame are culling the objects.
+		scene->BeginCullingFrame();
 		// shadow buffers
 		RenderShadowBuffers(scene);
 		// Render only independent texture renderers here.
@@ -846,12 +1038,54 @@ void KX_KetsjiEngine::UpdateAnimations(KX_Scene *scene)
 			// CM_Debug("Anim fps: " << 1.0/(m_frameTime - m_previousAnimTime));
 			m_previousAnimTime = m_frameTime;
 			for (KX_Scene *scene : m_scenes) {
-				scene->UpdateAnimations(m_frameTime);
+				UpdateSceneAnimations(scene);
 			}
 		}
 	}
 	else
-		scene->UpdateAnimations(m_frameTime);
+		UpdateSceneAnimations(scene);
+}
+
+void KX_KetsjiEngine::UpdateSceneAnimations(KX_Scene *scene)
+{
+	/* Actions modify the local transformations and the physics controllers of the objects,
+	 * the deferred physics step is joined only if an animated object is used by the physics.
+	 * Otherwise it keeps running with the render until the next logic frame. */
+	if (scene->AnimationsUsePhysics()) {
+		SyncPhysics();
+	}
+
+	scene->UpdateAnimations(m_frameTime);
+}
+
+void KX_KetsjiEngine::UpdateScenesWithoutRender()
+{
+	CM_ProfileScope scope("Render update");
+
+	for (KX_Scene *scene : m_scenes) {
+		scene->BeginCullingFrame();
+	}
+
+	const RenderData renderData = GetRenderData();
+	for (const FrameRenderData& frameData : renderData.m_frameDataList) {
+		for (const SceneRenderData& sceneFrameData : frameData.m_sceneDataList) {
+			KX_Scene *scene = sceneFrameData.m_scene;
+			KX_SetActiveScene(scene);
+
+			// Same updates as RenderCamera, the shadow and texture renderers are skipped.
+			for (const CameraRenderData& cameraFrameData : sceneFrameData.m_cameraDataList) {
+				KX_Camera *cullingcam = cameraFrameData.m_cullingCamera;
+
+				m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+				KX_CullingNodeList nodes;
+				scene->CalculateVisibleMeshes(nodes, cullingcam, 0);
+				scene->UpdateObjectLods(cullingcam, nodes);
+
+				m_logger.StartLog(tc_animations, m_kxsystem->GetTimeInSeconds());
+				UpdateAnimations(scene);
+			}
+		}
+	}
 }
 
 void KX_KetsjiEngine::RenderShadowBuffers(KX_Scene *scene)
@@ -869,6 +1103,8 @@ void KX_KetsjiEngine::RenderShadowBuffers(KX_Scene *scene)
 		for (KX_LightObject *light : lightlist) {
 			RAS_ILightObject *raslight = light->GetLightData();
 			if (light->GetVisible() && raslight->HasShadowBuffer() && raslight->NeedShadowUpdate()) {
+				CM_ProfileScope lightScope(light->GetName());
+
 				/* make temporary camera */
 				RAS_CameraData camdata = RAS_CameraData();
 				KX_Camera *cam = new KX_Camera(scene, scene->m_callbacks, camdata, true, true);
@@ -985,6 +1221,8 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene, const CameraRenderData& came
 	const RAS_Rect &area = cameraFrameData.m_area;
 	const RAS_Rect &viewport = cameraFrameData.m_viewport;
 
+	CM_ProfileScope scope(rendercam->GetName());
+
 	KX_SetActiveScene(scene);
 
 	/* Render texture probes depending of the the current viewport and area, these texture probes are commonly the planar map
@@ -1045,14 +1283,21 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene, const CameraRenderData& came
 
 #ifdef WITH_PYTHON
 	PHY_SetActiveEnvironment(scene->GetPhysicsEnvironment());
+	if (scene->HasDrawingCallbacks(KX_Scene::PRE_DRAW)) {
+		SyncPhysics();
+	}
 	// Run any pre-drawing python callbacks
 	scene->RunDrawingCallbacks(KX_Scene::PRE_DRAW, rendercam);
 #endif
 
 	scene->RenderBuckets(nodes, m_rasterizer->GetDrawingMode(), rendercam->GetWorldToCamera(), m_rasterizer, offScreen);
 
-	if (scene->GetPhysicsEnvironment())
-		scene->GetPhysicsEnvironment()->DebugDrawWorld();
+	PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+	// The debug drawing reads the physics world, wait for the step only if something is drawn.
+	if (physEnv && physEnv->GetDebugMode() > 0) {
+		SyncPhysics();
+		physEnv->DebugDrawWorld();
+	}
 }
 
 /*
@@ -1077,6 +1322,9 @@ RAS_OffScreen *KX_KetsjiEngine::PostRenderScene(KX_Scene *scene, RAS_OffScreen *
 	/* We can't deduce what camera should be passed to the python callbacks
 	 * because the post draw callbacks are per scenes and not per cameras.
 	 */
+	if (scene->HasDrawingCallbacks(KX_Scene::POST_DRAW)) {
+		SyncPhysics();
+	}
 	scene->RunDrawingCallbacks(KX_Scene::POST_DRAW, nullptr);
 
 	// Python draw callback can also call debug draw functions, so we have to clear debug shapes.
@@ -1089,6 +1337,7 @@ RAS_OffScreen *KX_KetsjiEngine::PostRenderScene(KX_Scene *scene, RAS_OffScreen *
 void KX_KetsjiEngine::StopEngine()
 {
 	if (m_bInitialized) {
+		SyncPhysics();
 		m_converter->FinalizeAsyncLoads();
 
 		while (m_scenes->GetCount() > 0) {
@@ -1101,6 +1350,11 @@ void KX_KetsjiEngine::StopEngine()
 		// cleanup all the stuff
 		m_rasterizer->Exit();
 	}
+
+	// Write the capture of the last frames if the game ended before the requested frame count.
+	CM_Profiler::StopCapture();
+	// The scenes and objects named in the capture are freed.
+	CM_Profiler::ClearNames();
 }
 
 // Scene Management is able to switch between scenes
@@ -1501,6 +1755,59 @@ double KX_KetsjiEngine::GetTimeScale() const
 	return m_timescale;
 }
 
+void KX_KetsjiEngine::StartBenchmark()
+{
+	m_benchmark = true;
+	m_benchmarkTimes.clear();
+	// The time spent before, e.g converting the scenes, is not part of the first frame.
+	m_logger.NextMeasurement(m_kxsystem->GetTimeInSeconds());
+}
+
+/// Return the value of a sorted list below which a percentage of the values are, by nearest rank.
+static double getPercentile(const std::vector<double>& values, double percent)
+{
+	if (values.empty()) {
+		return 0.0;
+	}
+
+	const unsigned int rank = (unsigned int)std::ceil(percent / 100.0 * values.size());
+	return values[std::max(rank, 1u) - 1];
+}
+
+bool KX_KetsjiEngine::WriteBenchmark(const std::string& filepath) const
+{
+	std::ofstream file(filepath);
+	if (!file.is_open()) {
+		CM_Error("failed to write benchmark file \"" << filepath << "\"");
+		return false;
+	}
+
+	const unsigned int numFrames = m_benchmarkTimes.size();
+	file << "{\n\t\"frames\": " << numFrames << ",\n\t\"tic_rate\": " << m_ticrate << ",\n\t\"unit\": \"ms\",\n\t\"categories\": {";
+
+	std::vector<double> times(numFrames);
+	for (unsigned short i = tc_first; i <= tc_numCategories; ++i) {
+		for (unsigned int j = 0; j < numFrames; ++j) {
+			times[j] = m_benchmarkTimes[j][i] * 1000.0;
+		}
+		std::sort(times.begin(), times.end());
+
+		// Remove the colon of the display labels.
+		const std::string label = (i == tc_numCategories) ? "Frame" : m_profileLabels[i].substr(0, m_profileLabels[i].size() - 1);
+		file << ((i == tc_first) ? "" : ",") << "\n\t\t\"" << label << "\": {"
+			 << "\"min\": " << getPercentile(times, 0.0)
+			 << ", \"median\": " << getPercentile(times, 50.0)
+			 << ", \"p99\": " << getPercentile(times, 99.0)
+			 << ", \"max\": " << getPercentile(times, 100.0) << "}";
+	}
+
+	file << "\n\t}\n}\n";
+
+	CM_Message("benchmark of " << numFrames << " frames written to \"" << filepath << "\"");
+
+	return true;
+}
+
 void KX_KetsjiEngine::SetTimeScale(double timescale)
 {
 	m_timescale = timescale;
@@ -1604,6 +1911,9 @@ void KX_KetsjiEngine::ProcessScheduledScenes(void)
 	    m_replace_scenes.size() ||
 	    m_removingScenes.size()) {
 
+		// The scenes could be freed, finish their physics step first.
+		SyncPhysics();
+
 		// Change the scene list
 		ReplaceScheduledScenes();
 		RemoveScheduledScenes();
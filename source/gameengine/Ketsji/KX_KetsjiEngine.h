@@ -43,8 +43,10 @@
 #include "RAS_CameraData.h"
 #include "RAS_Rasterizer.h"
 #include <vector>
+#include <array>
 
 struct TaskScheduler;
+struct TaskPool;
 class KX_ISystem;
 class BL_BlenderConverter;
 class KX_NetworkMessageManager;
@@ -102,7 +104,22 @@ public:
 		/// Automatic add debug properties to the debug list.
 		AUTO_ADD_DEBUG_PROPERTIES = (1 << 7),
 		/// Use override camera?
-		CAMERA_OVERRIDE = (1 << 8)
+		CAMERA_OVERRIDE = (1 << 8),
+		/// Run the last physics step of a frame in parallel of the rendering?
+		PIPELINED_PHYSICS = (1 << 9),
+		/// Proceed the physics of all the scenes in parallel after their logic?
+		PARALLEL_SCENES = (1 << 10)
+	};
+
+	/// Data of a physics step proceeded in a worker thread.
+	struct PhysicsStepData
+	{
+		KX_Scene *m_scene;
+		double m_curtime;
+		double m_timestep;
+		double m_interval;
+		/// Time spent in the step, measured by the worker thread.
+		double m_duration;
 	};
 
 private:
@@ -225,6 +242,7 @@ private:
 		tc_overhead, // profile info drawing overhead
 		tc_outside, // time spent outside main loop
 		tc_latency, // time spent waiting on the gpu
+		tc_physics_async, // physics time overlapped with the rendering
 		tc_numCategories
 	} KX_TimeCategory;
 
@@ -246,6 +264,11 @@ private:
 	/// Last estimated framerate
 	double m_average_framerate;
 
+	/// Record the time of each frame per category, used by the benchmark mode.
+	bool m_benchmark;
+	/// Time per category of every recorded frame, the grand total is the last element.
+	std::vector<std::array<double, tc_numCategories + 1> > m_benchmarkTimes;
+
 	/// Enable debug draw of culling bounding boxes.
 	KX_DebugOption m_showBoundingBox;
 	/// Enable debug draw armatures.
@@ -261,6 +284,37 @@ private:
 	/// Task scheduler for multi-threading
 	TaskScheduler *m_taskscheduler;
 
+	/// Task pool used to proceed the physics in parallel of the rendering.
+	TaskPool *m_physicsPool;
+	/// Physics steps deferred to the physics task pool and not yet synchronized.
+	std::vector<PhysicsStepData> m_physicsSteps;
+	/// Task pool used to proceed the physics of the scenes in parallel.
+	TaskPool *m_scenesPhysicsPool;
+	/// Physics steps of the current logic frame proceeded in parallel once the logic of all scenes is done.
+	std::vector<PhysicsStepData> m_scenesPhysicsSteps;
+
+	/** Proceed the physics of a scene, or defer it to a worker thread if the pipelined
+	 * physics is enabled and it is the last logic frame before the rendering, or if the
+	 * scenes are proceeded in parallel.
+	 */
+	void ProceedScenePhysics(KX_Scene *scene, double timestep, double framestep, bool lastFrame);
+	/** Push the deferred physics steps in the task pools, the steps of the parallel
+	 * scenes are finished and their scene graphs updated when this function returns.
+	 */
+	void ProceedDeferredPhysics();
+	/** Wait for the physics steps running in parallel of the rendering and update
+	 * the scene graphs they modified. Must be called before any access to the physics
+	 * or to the local transformations of the objects, e.g. logic, animations of physics
+	 * objects, physics debug drawing or python.
+	 */
+	void SyncPhysics();
+	/// Update the animations of a scene, waiting for the physics only if they use physics objects.
+	void UpdateSceneAnimations(KX_Scene *scene);
+	/** Run the culling, levels of detail and animations of each rendered camera without drawing,
+	 * used by the benchmark mode which disables the render.
+	 */
+	void UpdateScenesWithoutRender();
+
 	/** Set scene's total pause duration for animations process.
 	 * This is done in a separate loop to get the proper state of each scenes.
 	 * eg: There's 2 scenes, the first is suspended and the second is active.
@@ -307,6 +361,8 @@ private:
 
 	void BeginFrame();
 	void EndFrame();
+	/// Start the next profiling measurement and record the last one for the benchmark.
+	void NextMeasurement();
 
 public:
 	KX_KetsjiEngine(KX_ISystem *system);
@@ -450,6 +506,14 @@ public:
 	 */
 	double GetAverageFrameRate();
 
+	/// Start recording the time of each frame per profiling category.
+	void StartBenchmark();
+	/** Write the minimum, median and 99th percentile of the recorded frame times per
+	 * category to a JSON file.
+	 * \return False if the file couldn't be written.
+	 */
+	bool WriteBenchmark(const std::string& filepath) const;
+
 	/**
 	 * Gets the time scale multiplier 
 	 */
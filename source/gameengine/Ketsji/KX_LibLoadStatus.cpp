@@ -33,7 +33,8 @@ KX_LibLoadStatus::KX_LibLoadStatus(BL_BlenderConverter *converter, KX_KetsjiEngi
 	m_mergescene(merge_scene),
 	m_libname(path),
 	m_progress(0.0f),
-	m_finished(false)
+	m_finished(false),
+	m_mergedScenes(0)
 #ifdef WITH_PYTHON
 	,
 	m_finish_cb(nullptr),
@@ -108,6 +109,11 @@ void KX_LibLoadStatus::AddSceneConverter(BL_BlenderSceneConverter&& converter)
 	m_sceneConvertes.push_back(std::move(converter));
 }
 
+bool KX_LibLoadStatus::AddMergedScene()
+{
+	return (++m_mergedScenes == m_blenderScenes.size());
+}
+
 bool KX_LibLoadStatus::IsFinished() const
 {
 	return m_finished;
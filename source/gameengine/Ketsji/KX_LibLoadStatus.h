@@ -52,6 +52,8 @@ private:
 
 	/// The current status of this libload, used by the scene converter.
 	bool m_finished;
+	/// Number of scenes merged by a streamed libload.
+	unsigned int m_mergedScenes;
 
 #ifdef WITH_PYTHON
 	PyObject *m_finish_cb;
@@ -74,6 +76,8 @@ public:
 	void SetBlenderScenes(const std::vector<Scene *>& scenes);
 	const std::vector<BL_BlenderSceneConverter>& GetSceneConverters() const;
 	void AddSceneConverter(BL_BlenderSceneConverter&& converter);
+	/// Count a scene merged by a streamed libload, return true when all the scenes are merged.
+	bool AddMergedScene();
 
 	bool IsFinished() const;
 
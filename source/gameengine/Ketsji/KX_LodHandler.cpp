@@ -0,0 +1,124 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_LodHandler.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_LodHandler.h"
+#include "KX_LodManager.h"
+#include "KX_LodLevel.h"
+#include "KX_GameObject.h"
+
+#include "BLI_task.h"
+
+#include <algorithm>
+
+/// Number of objects of which the distances are computed together.
+#define KX_LOD_BLOCK_SIZE 16
+/// Number of objects processed by a task.
+#define KX_LOD_TASK_SIZE 512
+/// Minimum number of objects to select the levels in parallel.
+#define KX_LOD_PARALLEL_MIN_OBJECTS 2048
+
+void KX_LodHandler::SelectLevels(const SelectData& data, unsigned int start, unsigned int end)
+{
+	const float *positionX = m_positionX.data();
+	const float *positionY = m_positionY.data();
+	const float *positionZ = m_positionZ.data();
+	short *levels = m_levels.data();
+
+	for (unsigned int block = start; block < end; block += KX_LOD_BLOCK_SIZE) {
+		const unsigned int size = std::min(end - block, (unsigned int)KX_LOD_BLOCK_SIZE);
+
+		float distances[KX_LOD_BLOCK_SIZE];
+		for (unsigned int i = 0; i < size; ++i) {
+			const unsigned int index = block + i;
+			const float dx = positionX[index] - data.position[0];
+			const float dy = positionY[index] - data.position[1];
+			const float dz = positionZ[index] - data.position[2];
+			distances[i] = (dx * dx + dy * dy + dz * dz) * data.factor2;
+		}
+
+		for (unsigned int i = 0; i < size; ++i) {
+			const unsigned int index = block + i;
+			levels[index] = m_managers[index]->GetLevelIndex(levels[index], distances[i]);
+		}
+	}
+}
+
+void KX_LodHandler::SelectLevelsTask(void *userdata, const int iter)
+{
+	SelectData *data = (SelectData *)userdata;
+	const unsigned int start = iter * KX_LOD_TASK_SIZE;
+	const unsigned int end = std::min(start + KX_LOD_TASK_SIZE, data->count);
+	data->handler->SelectLevels(*data, start, end);
+}
+
+void KX_LodHandler::Process(const KX_CullingNodeList& nodes, const MT_Vector3& cameraPosition, float lodFactor, KX_Scene *scene)
+{
+	m_objects.clear();
+	m_managers.clear();
+	m_positionX.clear();
+	m_positionY.clear();
+	m_positionZ.clear();
+	m_levels.clear();
+
+	for (KX_CullingNode *node : nodes) {
+		KX_GameObject *gameobj = node->GetObject();
+		KX_LodManager *lodManager = gameobj->GetLodManager();
+		if (!lodManager || lodManager->GetLevelCount() == 0) {
+			continue;
+		}
+
+		// The bounds are shared by the objects using the same manager, update them before the parallel selection.
+		lodManager->UpdateLevelBounds(scene);
+
+		const MT_Vector3& position = gameobj->NodeGetWorldPosition();
+		m_objects.push_back(gameobj);
+		m_managers.push_back(lodManager);
+		m_positionX.push_back(position.x());
+		m_positionY.push_back(position.y());
+		m_positionZ.push_back(position.z());
+		m_levels.push_back(gameobj->GetCurrentLodLevel());
+	}
+
+	const unsigned int count = m_objects.size();
+	if (count == 0) {
+		return;
+	}
+
+	SelectData data;
+	data.handler = this;
+	cameraPosition.getValue(data.position);
+	data.factor2 = lodFactor * lodFactor;
+	data.count = count;
+
+	const unsigned int tasks = (count + KX_LOD_TASK_SIZE - 1) / KX_LOD_TASK_SIZE;
+	BLI_task_parallel_range(0, tasks, &data, SelectLevelsTask, (count >= KX_LOD_PARALLEL_MIN_OBJECTS));
+
+	// Replacing a mesh modifies the display arrays and buckets, only the objects changing of level are updated.
+	for (unsigned int i = 0; i < count; ++i) {
+		KX_GameObject *gameobj = m_objects[i];
+		if (m_levels[i] != gameobj->GetCurrentLodLevel()) {
+			gameobj->SetLodLevel(m_managers[i]->GetLevel(m_levels[i]));
+		}
+	}
+}
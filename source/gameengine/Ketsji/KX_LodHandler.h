@@ -0,0 +1,78 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_LodHandler.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_LOD_HANDLER_H__
+#define __KX_LOD_HANDLER_H__
+
+#include "KX_CullingNode.h"
+#include "MT_Vector3.h"
+
+#include <vector>
+
+class KX_GameObject;
+class KX_LodManager;
+class KX_Scene;
+
+/** Level of detail selection of the visible objects of a scene.
+ * The positions of the objects using a lod manager are gathered in a structure of arrays,
+ * their distances to the camera and their new levels are computed by blocks in parallel.
+ * The mesh of an object is replaced afterward and only if its level changed.
+ */
+class KX_LodHandler
+{
+private:
+	/// Objects using a lod manager, in the same order as the positions.
+	std::vector<KX_GameObject *> m_objects;
+	std::vector<KX_LodManager *> m_managers;
+	/// World positions of the objects.
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	/// The current level of the objects, replaced by the selected level.
+	std::vector<short> m_levels;
+
+	struct SelectData
+	{
+		KX_LodHandler *handler;
+		float position[3];
+		float factor2;
+		unsigned int count;
+	};
+
+	void SelectLevels(const SelectData& data, unsigned int start, unsigned int end);
+	static void SelectLevelsTask(void *userdata, const int iter);
+
+public:
+	KX_LodHandler() = default;
+	~KX_LodHandler() = default;
+
+	/** Update the lod level of the objects.
+	 * \param nodes The visible objects.
+	 * \param cameraPosition The camera world position.
+	 * \param lodFactor The camera lod distance factor.
+	 */
+	void Process(const KX_CullingNodeList& nodes, const MT_Vector3& cameraPosition, float lodFactor, KX_Scene *scene);
+};
+
+#endif  // __KX_LOD_HANDLER_H__
@@ -34,66 +34,35 @@
 #include "DNA_object_types.h"
 #include "BLI_listbase.h"
 
-KX_LodManager::LodLevelIterator::LodLevelIterator(const std::vector<KX_LodLevel *>& levels, unsigned short index, KX_Scene *scene)
-	:m_levels(levels),
-	m_index(index),
-	m_scene(scene)
-{
-}
+#include <algorithm>
+#include <cfloat>
 
-inline float KX_LodManager::LodLevelIterator::GetHysteresis(unsigned short level) const
+float KX_LodManager::GetHysteresis(unsigned short level, bool hysteresis, int hysteresisValue) const
 {
-	if (level < 1 || !m_scene->IsActivedLodHysteresis()) {
+	if (level < 1 || !hysteresis) {
 		return 0.0f;
 	}
-	
+
 	KX_LodLevel *lod = m_levels[level];
 	KX_LodLevel *prelod = m_levels[level - 1];
-	
-	float hysteresis = 0.0f;
+
+	float factor = 0.0f;
 	// if exists, LoD level hysteresis will override scene hysteresis
 	if (lod->GetFlag() & KX_LodLevel::USE_HYSTERESIS) {
-		hysteresis = lod->GetHysteresis() / 100.0f;
+		factor = lod->GetHysteresis() / 100.0f;
 	}
 	else {
-		hysteresis = m_scene->GetLodHysteresisValue() / 100.0f;
-	}
-	
-	return MT_abs(prelod->GetDistance() - lod->GetDistance()) * hysteresis;
-}
-
-inline int KX_LodManager::LodLevelIterator::operator++()
-{
-	return m_index++;
-}
-
-inline int KX_LodManager::LodLevelIterator::operator--()
-{
-	return m_index--;
-}
-
-inline short KX_LodManager::LodLevelIterator::operator*() const
-{
-	return m_index;
-}
-
-inline bool KX_LodManager::LodLevelIterator::operator<=(float distance2) const
-{
-	// The last level doesn't have a next level, then the maximum distance is infinite and should always return false.
-	if (m_index == (m_levels.size() - 1)) {
-		return false;
+		factor = hysteresisValue / 100.0f;
 	}
-	
-	return SQUARE(m_levels[m_index + 1]->GetDistance() + GetHysteresis(m_index + 1)) <= distance2;
-}
 
-inline bool KX_LodManager::LodLevelIterator::operator>(float distance2) const
-{
-	return SQUARE(m_levels[m_index]->GetDistance() - GetHysteresis(m_index)) > distance2;
+	return MT_abs(prelod->GetDistance() - lod->GetDistance()) * factor;
 }
 
 KX_LodManager::KX_LodManager(Object *ob, KX_Scene *scene, BL_BlenderSceneConverter& converter)
-	:m_refcount(1),
+	:m_boundsValid(false),
+	m_boundsHysteresis(false),
+	m_boundsHysteresisValue(0),
+	m_refcount(1),
 	m_distanceFactor(ob->lodfactor)
 {
 	if (BLI_listbase_count_ex(&ob->lodlevels, 2) > 1) {
@@ -127,6 +96,16 @@ KX_LodManager::KX_LodManager(Object *ob, KX_Scene *scene, BL_BlenderSceneConvert
 	}
 }
 
+KX_LodManager::KX_LodManager(const std::vector<KX_LodLevel *>& levels, float distanceFactor)
+	:m_levels(levels),
+	m_boundsValid(false),
+	m_boundsHysteresis(false),
+	m_boundsHysteresisValue(0),
+	m_refcount(1),
+	m_distanceFactor(distanceFactor)
+{
+}
+
 KX_LodManager::~KX_LodManager()
 {
 	for (KX_LodLevel *lodLevel : m_levels) {
@@ -149,25 +128,64 @@ KX_LodLevel *KX_LodManager::GetLevel(unsigned int index) const
 	return m_levels[index];
 }
 
-KX_LodLevel *KX_LodManager::GetLevel(KX_Scene *scene, short previouslod, float distance2)
+void KX_LodManager::UpdateLevelBounds(KX_Scene *scene)
 {
-	distance2 *= (m_distanceFactor * m_distanceFactor);
+	UpdateLevelBounds(scene->IsActivedLodHysteresis(), scene->GetLodHysteresisValue());
+}
+
+void KX_LodManager::UpdateLevelBounds(bool hysteresis, int hysteresisValue)
+{
+	if (m_boundsValid && hysteresis == m_boundsHysteresis && hysteresisValue == m_boundsHysteresisValue) {
+		return;
+	}
+
+	const unsigned short count = m_levels.size();
+	m_bounds.resize(count);
+	for (unsigned short i = 0; i < count; ++i) {
+		LevelBounds& bounds = m_bounds[i];
+		// The first level is used for any distance under the second one.
+		bounds.m_min = (i == 0) ? 0.0f : SQUARE(m_levels[i]->GetDistance() - GetHysteresis(i, hysteresis, hysteresisValue));
+		// The last level doesn't have a next level, then the maximum distance is infinite.
+		bounds.m_max = (i == (count - 1)) ? FLT_MAX :
+			SQUARE(m_levels[i + 1]->GetDistance() + GetHysteresis(i + 1, hysteresis, hysteresisValue));
+	}
 
-	LodLevelIterator it(m_levels, previouslod, scene);
+	m_boundsValid = true;
+	m_boundsHysteresis = hysteresis;
+	m_boundsHysteresisValue = hysteresisValue;
+}
+
+short KX_LodManager::GetLevelIndex(short previouslod, float distance2) const
+{
+	distance2 *= (m_distanceFactor * m_distanceFactor);
 
+	const short last = m_bounds.size() - 1;
+	short level = std::min(std::max(previouslod, (short)0), last);
 	while (true) {
-		if (it <= distance2) {
-			++it;
+		const LevelBounds& bounds = m_bounds[level];
+		if (bounds.m_max <= distance2 && level < last) {
+			++level;
 		}
-		else if (it > distance2) {
-			--it;
+		else if (bounds.m_min > distance2 && level > 0) {
+			--level;
 		}
 		else {
 			break;
 		}
 	}
 
-	const unsigned short level = *it;
+	return level;
+}
+
+KX_LodLevel *KX_LodManager::GetLevel(KX_Scene *scene, short previouslod, float distance2)
+{
+	if (m_levels.empty()) {
+		return nullptr;
+	}
+
+	UpdateLevelBounds(scene);
+
+	const short level = GetLevelIndex(previouslod, distance2);
 	return (level == previouslod) ? nullptr : m_levels[level];
 }
 
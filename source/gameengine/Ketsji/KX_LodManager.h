@@ -40,37 +40,29 @@ class KX_LodManager : public EXP_Value
 	Py_Header
 
 private:
-	/** This class helps to compare the object distance to camera with the list of lod levels.
-	 * It represent the gap between two levels, when you compare it with a distance it compare
-	 * with the a N level distance and a N+1 level distance including hysteresis.
-	 */
-	class LodLevelIterator
+	/// Squared distances to leave a level, including the hysteresis.
+	struct LevelBounds
 	{
-	private:
-		const std::vector<KX_LodLevel *>& m_levels;
-		short m_index;
-		KX_Scene *m_scene;
-		float GetHysteresis(unsigned short level) const;
-
-	public:
-		LodLevelIterator(const std::vector<KX_LodLevel *>& levels, unsigned short index, KX_Scene *scene);
-
-		int operator++();
-		int operator--();
-		short operator*() const;
-		/// Compare next level distance more hysteresis with current distance.
-		bool operator<=(float distance2) const;
-		/// Compare the current lod level distance less hysteresis with current distance.
-		bool operator>(float distance2) const;
+		/// The previous level is used under this distance.
+		float m_min;
+		/// The next level is used from this distance.
+		float m_max;
 	};
 
 	std::vector<KX_LodLevel *> m_levels;
+	std::vector<LevelBounds> m_bounds;
+
+	/// Scene hysteresis settings used to compute the bounds.
+	bool m_boundsValid;
+	bool m_boundsHysteresis;
+	int m_boundsHysteresisValue;
 
 	/** Get the hysteresis from the level or the scene.
-	 * \param scene Scene used to get default hysteresis.
 	 * \param level Level index used to get hysteresis.
+	 * \param hysteresis Use the hysteresis, else return zero.
+	 * \param hysteresisValue Default hysteresis of the scene in percent.
 	 */
-	float GetHysteresis(KX_Scene *scene, unsigned short level);
+	float GetHysteresis(unsigned short level, bool hysteresis, int hysteresisValue) const;
 
 	int m_refcount;
 
@@ -79,6 +71,11 @@ private:
 
 public:
 	KX_LodManager(Object *ob, KX_Scene *scene, BL_BlenderSceneConverter& converter);
+	/** Construct a manager of already converted levels.
+	 * \param levels The levels sorted by distance, owned by the manager.
+	 * \param distanceFactor Factor applied to the distance from the camera to the object.
+	 */
+	KX_LodManager(const std::vector<KX_LodLevel *>& levels, float distanceFactor);
 	virtual ~KX_LodManager();
 
 	virtual std::string GetName();
@@ -99,6 +96,22 @@ public:
 	 */
 	KX_LodLevel *GetLevel(KX_Scene *scene, short previouslod, float distance);
 
+	/** Compute the distance bounds of the levels if the scene hysteresis changed.
+	 * Must be called before GetLevelIndex, not thread safe.
+	 */
+	void UpdateLevelBounds(KX_Scene *scene);
+	/** Compute the distance bounds of the levels if the hysteresis settings changed.
+	 * \param hysteresis Use the hysteresis of the levels or the scene.
+	 * \param hysteresisValue Default hysteresis of the scene in percent.
+	 */
+	void UpdateLevelBounds(bool hysteresis, int hysteresisValue);
+
+	/** Get the lod level index cooresponding to distance and previous level, thread safe.
+	 * \param previouslod Previous lod level index.
+	 * \param distance2 Squared distance object to the camera.
+	 */
+	short GetLevelIndex(short previouslod, float distance2) const;
+
 #ifdef WITH_PYTHON
 
 	static PyObject *pyattr_get_levels(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
@@ -78,6 +78,11 @@ SG_ParentRelation *KX_NormalParentRelation::NewCopy()
 	return new KX_NormalParentRelation();
 }
 
+bool KX_NormalParentRelation::IsThreadSafe()
+{
+	return true;
+}
+
 KX_VertexParentRelation::~KX_VertexParentRelation()
 {
 }
@@ -119,6 +124,11 @@ bool KX_VertexParentRelation::IsVertexRelation()
 	return true;
 }
 
+bool KX_VertexParentRelation::IsThreadSafe()
+{
+	return true;
+}
+
 KX_SlowParentRelation::KX_SlowParentRelation(float relaxation)
 	:m_relax(relaxation),
 	m_initialized(false)
@@ -223,3 +233,8 @@ bool KX_SlowParentRelation::IsSlowRelation()
 {
 	return true;
 }
+
+bool KX_SlowParentRelation::IsThreadSafe()
+{
+	return true;
+}
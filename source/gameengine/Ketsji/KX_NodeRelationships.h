@@ -55,6 +55,8 @@ public:
 
 	/// Method inherited from KX_ParentRelation.
 	virtual SG_ParentRelation *NewCopy();
+
+	virtual bool IsThreadSafe();
 };
 
 class KX_VertexParentRelation : public SG_ParentRelation
@@ -70,6 +72,7 @@ public:
 	virtual SG_ParentRelation *NewCopy();
 
 	virtual bool IsVertexRelation();
+	virtual bool IsThreadSafe();
 };
 
 class KX_SlowParentRelation : public SG_ParentRelation
@@ -102,6 +105,7 @@ public:
 	void SetTimeOffset(float relaxation);
 
 	virtual bool IsSlowRelation();
+	virtual bool IsThreadSafe();
 };
 
 #endif  // __KX_NODERELATIONSHIPS_H__
@@ -28,9 +28,22 @@
 
 #include "KX_ObstacleSimulation.h"
 #include "KX_NavMeshObject.h"
+#include "KX_SteeringActuator.h"
 #include "KX_Globals.h"
 #include "DNA_object_types.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
+
+#include <algorithm>
+
+/// Minimum number of agents to adjust their velocities in several threads.
+#define KX_OBSTACLE_PARALLEL_MIN_AGENTS 16
+/// Maximum number of cells of the hash overlapped by an obstacle.
+#define KX_OBSTACLE_HASH_MAX_CELLS 16
+/// Minimum size of the cells of the hash.
+#define KX_OBSTACLE_HASH_MIN_CELL_SIZE 1.0f
+/// Minimum number of buckets of the hash.
+#define KX_OBSTACLE_HASH_MIN_BUCKETS 64
 
 namespace
 {
@@ -172,6 +185,10 @@ static float interpolateToi(float a, const float* dir, const float* toi, const i
 KX_ObstacleSimulation::KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization)
 :	m_levelHeight(levelHeight)
 ,	m_enableVisualization(enableVisualization)
+,	m_cellSize(KX_OBSTACLE_HASH_MIN_CELL_SIZE)
+,	m_maxObstacleRadius(0.0f)
+,	m_maxObstacleSpeed(0.0f)
+,	m_hashDirty(true)
 {
 
 }
@@ -197,8 +214,11 @@ KX_Obstacle* KX_ObstacleSimulation::CreateObstacle(KX_GameObject* gameobj)
 	for (int i = 0; i < VEL_HIST_SIZE; ++i)
 		vset(&obstacle->hvel[i*2], 0,0);
 	obstacle->hhead = 0;
+	obstacle->m_worldPos = MT_Vector3(0.0f, 0.0f, 0.0f);
+	obstacle->m_worldPos2 = MT_Vector3(0.0f, 0.0f, 0.0f);
 
 	m_obstacles.push_back(obstacle);
+	m_hashDirty = true;
 	return obstacle;
 }
 
@@ -233,6 +253,8 @@ void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject* navmeshobj)
 				obstacle->m_pos = MT_Vector3(vj[0], vj[2], vj[1]);
 				obstacle->m_pos2 = MT_Vector3(vi[0], vi[2], vi[1]);
 				obstacle->m_rad = 0;
+				obstacle->m_worldPos = navmeshobj->TransformToWorldCoords(obstacle->m_pos);
+				obstacle->m_worldPos2 = navmeshobj->TransformToWorldCoords(obstacle->m_pos2);
 			}
 		}
 	}
@@ -240,6 +262,17 @@ void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject* navmeshobj)
 
 void KX_ObstacleSimulation::DestroyObstacleForObj(KX_GameObject* gameobj)
 {
+	// Drop the agents of the object or using it as navigation mesh.
+	for (size_t i=0; i<m_agents.size(); )
+	{
+		if (m_agents[i].m_obstacle->m_gameObj == gameobj || m_agents[i].m_navMeshObj == gameobj)
+		{
+			m_agents.erase(m_agents.begin() + i);
+		}
+		else
+			i++;
+	}
+
 	for (size_t i=0; i<m_obstacles.size(); )
 	{
 		if (m_obstacles[i]->m_gameObj == gameobj)
@@ -248,6 +281,7 @@ void KX_ObstacleSimulation::DestroyObstacleForObj(KX_GameObject* gameobj)
 			m_obstacles[i] = m_obstacles.back();
 			m_obstacles.pop_back();
 			delete obstacle;
+			m_hashDirty = true;
 		}
 		else
 			i++;
@@ -258,10 +292,26 @@ void KX_ObstacleSimulation::UpdateObstacles()
 {
 	for (size_t i=0; i<m_obstacles.size(); i++)
 	{
-		if (m_obstacles[i]->m_type==KX_OBSTACLE_NAV_MESH || m_obstacles[i]->m_shape==KX_OBSTACLE_SEGMENT)
+		KX_Obstacle* obs = m_obstacles[i];
+		if (obs->m_shape==KX_OBSTACLE_SEGMENT)
+		{
+			if (obs->m_type==KX_OBSTACLE_NAV_MESH)
+			{
+				KX_NavMeshObject* navmeshobj = static_cast<KX_NavMeshObject*>(obs->m_gameObj);
+				obs->m_worldPos = navmeshobj->TransformToWorldCoords(obs->m_pos);
+				obs->m_worldPos2 = navmeshobj->TransformToWorldCoords(obs->m_pos2);
+			}
+			else
+			{
+				obs->m_worldPos = obs->m_pos;
+				obs->m_worldPos2 = obs->m_pos2;
+			}
+			continue;
+		}
+
+		if (obs->m_type==KX_OBSTACLE_NAV_MESH)
 			continue;
 
-		KX_Obstacle* obs = m_obstacles[i];
 		obs->m_pos = obs->m_gameObj->NodeGetWorldPosition();
 		obs->vel[0] = obs->m_gameObj->GetLinearVelocity().x();
 		obs->vel[1] = obs->m_gameObj->GetLinearVelocity().y();
@@ -274,6 +324,194 @@ void KX_ObstacleSimulation::UpdateObstacles()
 			add_v2_v2v2(obs->pvel, obs->pvel, &obs->hvel[j * 2]);
 		mul_v2_fl(obs->pvel, 1.0f / VEL_HIST_SIZE);
 	}
+
+	BuildObstacleHash();
+}
+
+/// Hash the coordinates of a cell into a bucket.
+static inline unsigned int hashCell(int x, int y, unsigned int mask)
+{
+	return (((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u)) & mask;
+}
+
+/// Compute the range of cells overlapped by a box.
+static inline void cellRange(float minx, float miny, float maxx, float maxy, float cellSize, int range[4])
+{
+	range[0] = (int)floorf(minx / cellSize);
+	range[1] = (int)floorf(miny / cellSize);
+	range[2] = (int)floorf(maxx / cellSize);
+	range[3] = (int)floorf(maxy / cellSize);
+}
+
+static void obstacleCellRange(KX_Obstacle *obs, float cellSize, int range[4])
+{
+	if (obs->m_shape == KX_OBSTACLE_SEGMENT) {
+		const MT_Vector3& p1 = obs->m_worldPos;
+		const MT_Vector3& p2 = obs->m_worldPos2;
+		cellRange(std::min(p1.x(), p2.x()), std::min(p1.y(), p2.y()), std::max(p1.x(), p2.x()), std::max(p1.y(), p2.y()),
+				  cellSize, range);
+	}
+	else {
+		// The circles are hashed by their center, the queries are extended by the maximum radius.
+		cellRange(obs->m_pos.x(), obs->m_pos.y(), obs->m_pos.x(), obs->m_pos.y(), cellSize, range);
+	}
+}
+
+void KX_ObstacleSimulation::BuildObstacleHash()
+{
+	m_hashDirty = false;
+	m_largeObstacles.clear();
+
+	m_maxObstacleRadius = 0.0f;
+	m_maxObstacleSpeed = 0.0f;
+	for (KX_Obstacle *obs : m_obstacles) {
+		if (obs->m_shape == KX_OBSTACLE_CIRCLE) {
+			m_maxObstacleRadius = std::max(m_maxObstacleRadius, (float)obs->m_rad);
+			m_maxObstacleSpeed = std::max(m_maxObstacleSpeed, len_v2(obs->vel));
+		}
+	}
+	m_cellSize = std::max(m_maxObstacleRadius * 4.0f, KX_OBSTACLE_HASH_MIN_CELL_SIZE);
+
+	unsigned int numBuckets = KX_OBSTACLE_HASH_MIN_BUCKETS;
+	while (numBuckets < m_obstacles.size() * 2) {
+		numBuckets *= 2;
+	}
+	const unsigned int mask = numBuckets - 1;
+
+	// Count the obstacles of each bucket and store them with a counting sort.
+	m_cellStart.assign(numBuckets + 1, 0);
+	unsigned int numEntries = 0;
+	for (unsigned int i = 0, size = m_obstacles.size(); i < size; ++i) {
+		int range[4];
+		obstacleCellRange(m_obstacles[i], m_cellSize, range);
+		if ((range[2] - range[0] + 1) * (range[3] - range[1] + 1) > KX_OBSTACLE_HASH_MAX_CELLS) {
+			m_largeObstacles.push_back(i);
+			continue;
+		}
+		for (int y = range[1]; y <= range[3]; ++y) {
+			for (int x = range[0]; x <= range[2]; ++x) {
+				++m_cellStart[hashCell(x, y, mask) + 1];
+				++numEntries;
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < numBuckets; ++i) {
+		m_cellStart[i + 1] += m_cellStart[i];
+	}
+
+	m_cellObstacles.resize(numEntries);
+	std::vector<unsigned int> offsets(m_cellStart.begin(), m_cellStart.end() - 1);
+	for (unsigned int i = 0, size = m_obstacles.size(); i < size; ++i) {
+		int range[4];
+		obstacleCellRange(m_obstacles[i], m_cellSize, range);
+		if ((range[2] - range[0] + 1) * (range[3] - range[1] + 1) > KX_OBSTACLE_HASH_MAX_CELLS) {
+			continue;
+		}
+		for (int y = range[1]; y <= range[3]; ++y) {
+			for (int x = range[0]; x <= range[2]; ++x) {
+				m_cellObstacles[offsets[hashCell(x, y, mask)]++] = i;
+			}
+		}
+	}
+}
+
+void KX_ObstacleSimulation::QueryObstacles(KX_Obstacle *activeObst, float range, KX_Obstacles& obstacles) const
+{
+	const float px = activeObst->m_pos.x();
+	const float py = activeObst->m_pos.y();
+	const float extent = range + m_maxObstacleRadius;
+
+	int cells[4];
+	cellRange(px - extent, py - extent, px + extent, py + extent, m_cellSize, cells);
+
+	std::vector<unsigned int> indices(m_largeObstacles);
+	const unsigned int numBuckets = m_cellStart.size() - 1;
+	const float numCells = (float)(cells[2] - cells[0] + 1) * (float)(cells[3] - cells[1] + 1);
+	if (numCells >= (float)numBuckets) {
+		// The range covers more cells than buckets, visit all the buckets once.
+		indices.insert(indices.end(), m_cellObstacles.begin(), m_cellObstacles.end());
+	}
+	else {
+		const unsigned int mask = numBuckets - 1;
+		for (int y = cells[1]; y <= cells[3]; ++y) {
+			for (int x = cells[0]; x <= cells[2]; ++x) {
+				const unsigned int bucket = hashCell(x, y, mask);
+				indices.insert(indices.end(), m_cellObstacles.begin() + m_cellStart[bucket],
+							   m_cellObstacles.begin() + m_cellStart[bucket + 1]);
+			}
+		}
+	}
+
+	// Remove the duplicates of the obstacles in several cells and keep the order of the obstacles.
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+	const MT_Vector2 pos(px, py);
+	for (unsigned int index : indices) {
+		KX_Obstacle *obs = m_obstacles[index];
+		if (obs->m_shape == KX_OBSTACLE_SEGMENT) {
+			const float p[2] = {px, py};
+			const float a[2] = {(float)obs->m_worldPos.x(), (float)obs->m_worldPos.y()};
+			const float b[2] = {(float)obs->m_worldPos2.x(), (float)obs->m_worldPos2.y()};
+			if (dist_squared_to_line_segment_v2(p, a, b) > range * range) {
+				continue;
+			}
+		}
+		else {
+			const float radius = range + obs->m_rad;
+			if ((obs->m_pos.to2d() - pos).length2() > radius * radius) {
+				continue;
+			}
+		}
+		obstacles.push_back(obs);
+	}
+}
+
+void KX_ObstacleSimulation::AddAgent(KX_SteeringActuator *actuator, KX_Obstacle *activeObst, KX_NavMeshObject *activeNavMeshObj,
+									 const MT_Vector3& velocity, MT_Scalar maxDeltaSpeed, MT_Scalar maxDeltaAngle)
+{
+	vset(activeObst->dvel, velocity.x(), velocity.y());
+
+	KX_ObstacleAgent agent;
+	agent.m_actuator = actuator;
+	agent.m_obstacle = activeObst;
+	agent.m_navMeshObj = activeNavMeshObj;
+	agent.m_velocity = velocity;
+	agent.m_maxDeltaSpeed = maxDeltaSpeed;
+	agent.m_maxDeltaAngle = maxDeltaAngle;
+	copy_v2_v2(agent.m_nvel, activeObst->nvel);
+	m_agents.push_back(agent);
+}
+
+void KX_ObstacleSimulation::SolveAgent(KX_ObstacleAgent& agent)
+{
+}
+
+void KX_ObstacleSimulation::SolveAgentTask(void *userdata, const int iter)
+{
+	KX_ObstacleSimulation *simulation = static_cast<KX_ObstacleSimulation *>(userdata);
+	simulation->SolveAgent(simulation->m_agents[iter]);
+}
+
+void KX_ObstacleSimulation::UpdateAgents()
+{
+	if (m_agents.empty()) {
+		return;
+	}
+
+	if (m_hashDirty) {
+		BuildObstacleHash();
+	}
+
+	// The agents only read the other obstacles, their new velocities are stored in the agents.
+	BLI_task_parallel_range(0, m_agents.size(), this, SolveAgentTask, (m_agents.size() >= KX_OBSTACLE_PARALLEL_MIN_AGENTS));
+
+	for (const KX_ObstacleAgent& agent : m_agents) {
+		copy_v2_v2(agent.m_obstacle->nvel, agent.m_nvel);
+		agent.m_actuator->ApplySteering(agent.m_velocity);
+	}
+	m_agents.clear();
 }
 
 KX_Obstacle* KX_ObstacleSimulation::GetObstacle(KX_GameObject* gameobj)
@@ -388,20 +626,49 @@ void KX_ObstacleSimulationTOI::AdjustObstacleVelocity(KX_Obstacle* activeObst, K
 
 	vset(activeObst->dvel, velocity.x(), velocity.y());
 
+	if (m_hashDirty)
+		BuildObstacleHash();
+
+	KX_ObstacleAgent agent;
+	agent.m_obstacle = activeObst;
+	agent.m_navMeshObj = activeNavMeshObj;
+	agent.m_velocity = velocity;
+	agent.m_maxDeltaSpeed = maxDeltaSpeed;
+	agent.m_maxDeltaAngle = maxDeltaAngle;
+	SolveAgent(agent);
+
+	copy_v2_v2(activeObst->nvel, agent.m_nvel);
+	velocity = agent.m_velocity;
+}
+
+void KX_ObstacleSimulationTOI::SolveAgent(KX_ObstacleAgent& agent)
+{
+	KX_Obstacle *activeObst = agent.m_obstacle;
+
+	/* Only the obstacles reachable before the max TOI change the time of impact of the samples.
+	 * The samples are at most 1.5 times faster than the desired velocity and the relative velocity
+	 * of RVO is twice the sample velocity minus the velocities of both obstacles.
+	 */
+	const float range = (3.0f * len_v2(activeObst->dvel) + len_v2(activeObst->vel) + m_maxObstacleSpeed) * m_maxToi +
+						activeObst->m_rad + 0.01f; // Radius of the agent against the segments in TOI_cells.
+	KX_Obstacles obstacles;
+	QueryObstacles(activeObst, range, obstacles);
+
 	//apply RVO
-	sampleRVO(activeObst, activeNavMeshObj, maxDeltaAngle);
+	sampleRVO(activeObst, agent.m_navMeshObj, obstacles, agent.m_maxDeltaAngle, agent.m_nvel);
 
 	// Fake dynamic constraint.
+	const MT_Scalar maxDeltaSpeed = agent.m_maxDeltaSpeed;
 	float dv[2];
 	float vel[2];
-	sub_v2_v2v2(dv, activeObst->nvel, activeObst->vel);
+	sub_v2_v2v2(dv, agent.m_nvel, activeObst->vel);
 	float ds = len_v2(dv);
 	if (ds > maxDeltaSpeed || ds<-maxDeltaSpeed)
 		mul_v2_fl(dv, fabs(maxDeltaSpeed / ds));
 	add_v2_v2v2(vel, activeObst->vel, dv);
 
-	velocity.x() = vel[0];
-	velocity.y() = vel[1];
+	agent.m_velocity.x() = vel[0];
+	agent.m_velocity.y() = vel[1];
 }
 
 ///////////*********TOI_rays**********/////////////////
@@ -428,8 +695,8 @@ KX_ObstacleSimulationTOI_rays::KX_ObstacleSimulationTOI_rays(MT_Scalar levelHeig
 }
 
 
-void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
-										const float maxDeltaAngle)
+void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj,
+										const KX_Obstacles& obstacles, const float maxDeltaAngle, float nvel[2])
 {
 	MT_Vector2 vel(activeObst->dvel[0], activeObst->dvel[1]);
 	float vmax = (float) vel.length();
@@ -450,7 +717,7 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle* activeObst, KX_NavMes
 	const int iforw = m_maxSamples/2;
 	const float aoff = (float)iforw / (float)m_maxSamples;
 
-	size_t nobs = m_obstacles.size();
+	size_t nobs = obstacles.size();
 	for (int iter = 0; iter < m_maxSamples; ++iter)
 	{
 		// Calculate sample velocity
@@ -465,7 +732,7 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle* activeObst, KX_NavMes
 		float tmine = 0.0f;
 		for (int i = 0; i < nobs; ++i)
 		{
-			KX_Obstacle* ob = m_obstacles[i];
+			KX_Obstacle* ob = obstacles[i];
 			bool res = filterObstacle(activeObst, activeNavMeshObj, ob, m_levelHeight);
 			if (!res)
 				continue;
@@ -493,15 +760,8 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle* activeObst, KX_NavMes
 			}
 			else if (ob->m_shape == KX_OBSTACLE_SEGMENT)
 			{
-				MT_Vector3 p1 = ob->m_pos;
-				MT_Vector3 p2 = ob->m_pos2;
-				//apply world transform
-				if (ob->m_type == KX_OBSTACLE_NAV_MESH)
-				{
-					KX_NavMeshObject* navmeshobj = static_cast<KX_NavMeshObject*>(ob->m_gameObj);
-					p1 = navmeshobj->TransformToWorldCoords(p1);
-					p2 = navmeshobj->TransformToWorldCoords(p2);
-				}
+				const MT_Vector3& p1 = ob->m_worldPos;
+				const MT_Vector3& p2 = ob->m_worldPos2;
 
 				if (!sweepCircleSegment(activeObst->m_pos.to2d(), activeObst->m_rad, svel,
 				                        p1.to2d(), p2.to2d(), ob->m_rad, htmin, htmax))
@@ -569,14 +829,14 @@ void KX_ObstacleSimulationTOI_rays::sampleRVO(KX_Obstacle* activeObst, KX_NavMes
 		vmax *= bestToi/m_minToi;
 
 	// New steering velocity.
-	activeObst->nvel[0] = cosf(bestDir) * vmax;
-	activeObst->nvel[1] = sinf(bestDir) * vmax;
+	nvel[0] = cosf(bestDir) * vmax;
+	nvel[1] = sinf(bestDir) * vmax;
 }
 
 ///////////********* TOI_cells**********/////////////////
 
 static void processSamples(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
-                           KX_Obstacles& obstacles,  float levelHeight, const float vmax,
+                           const KX_Obstacles& obstacles,  float levelHeight, const float vmax,
                            const float* spos, const float cs, const int nspos, float* res,
                            float maxToi, float velWeight, float curVelWeight, float sideWeight,
                            float toiWeight)
@@ -665,15 +925,8 @@ static void processSamples(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavM
 			}
 			else if (ob->m_shape == KX_OBSTACLE_SEGMENT)
 			{
-				MT_Vector3 p1 = ob->m_pos;
-				MT_Vector3 p2 = ob->m_pos2;
-				//apply world transform
-				if (ob->m_type == KX_OBSTACLE_NAV_MESH)
-				{
-					KX_NavMeshObject* navmeshobj = static_cast<KX_NavMeshObject*>(ob->m_gameObj);
-					p1 = navmeshobj->TransformToWorldCoords(p1);
-					p2 = navmeshobj->TransformToWorldCoords(p2);
-				}
+				const MT_Vector3& p1 = ob->m_worldPos;
+				const MT_Vector3& p2 = ob->m_worldPos2;
 				float p[2], q[2];
 				vset(p, p1.x(), p1.y());
 				vset(q, p2.x(), p2.y());
@@ -735,10 +988,10 @@ static void processSamples(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavM
 	}
 }
 
-void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
-					   const float maxDeltaAngle)
+void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj,
+					   const KX_Obstacles& obstacles, const float maxDeltaAngle, float nvel[2])
 {
-	vset(activeObst->nvel, 0.f, 0.f);
+	vset(nvel, 0.f, 0.f);
 	float vmax = len_v2(activeObst->dvel);
 
 	float* spos = new float[2*m_maxSamples];
@@ -767,8 +1020,8 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle* activeObst, KX_NavMe
 				}
 			}
 		}
-		processSamples(activeObst, activeNavMeshObj, m_obstacles, m_levelHeight, vmax, spos, cs/2, 
-			nspos,  activeObst->nvel, m_maxToi, m_velWeight, m_curVelWeight, m_collisionWeight, m_toiWeight);
+		processSamples(activeObst, activeNavMeshObj, obstacles, m_levelHeight, vmax, spos, cs/2, 
+			nspos,  nvel, m_maxToi, m_velWeight, m_curVelWeight, m_collisionWeight, m_toiWeight);
 	}
 	else
 	{
@@ -802,12 +1055,12 @@ void KX_ObstacleSimulationTOI_cells::sampleRVO(KX_Obstacle* activeObst, KX_NavMe
 				}
 			}
 
-			processSamples(activeObst, activeNavMeshObj, m_obstacles, m_levelHeight, vmax, spos, cs/2,
+			processSamples(activeObst, activeNavMeshObj, obstacles, m_levelHeight, vmax, spos, cs/2,
 			               nspos,  res, m_maxToi, m_velWeight, m_curVelWeight, m_collisionWeight, m_toiWeight);
 
 			cs *= 0.5f;
 		}
-		copy_v2_v2(activeObst->nvel, res);
+		copy_v2_v2(nvel, res);
 	}
 
 	delete [] spos;
@@ -32,6 +32,7 @@
 
 class KX_GameObject;
 class KX_NavMeshObject;
+class KX_SteeringActuator;
 
 enum KX_OBSTACLE_TYPE
 {
@@ -61,11 +62,28 @@ struct KX_Obstacle
 	float hvel[VEL_HIST_SIZE*2];
 	int hhead;
 
-	
+	/// World position of the segment points, updated with the obstacles.
+	MT_Vector3 m_worldPos;
+	MT_Vector3 m_worldPos2;
+
 	KX_GameObject* m_gameObj;
 };
 typedef std::vector<KX_Obstacle*> KX_Obstacles;
 
+/// Steering velocity of an agent waiting for the crowd update.
+struct KX_ObstacleAgent
+{
+	KX_SteeringActuator *m_actuator;
+	KX_Obstacle *m_obstacle;
+	KX_NavMeshObject *m_navMeshObj;
+	/// The desired velocity, replaced by the adjusted velocity.
+	MT_Vector3 m_velocity;
+	MT_Scalar m_maxDeltaSpeed;
+	MT_Scalar m_maxDeltaAngle;
+	/// New steering velocity of the obstacle.
+	float m_nvel[2];
+};
+
 class KX_ObstacleSimulation
 {
 protected:
@@ -74,7 +92,34 @@ protected:
 	MT_Scalar m_levelHeight;
 	bool m_enableVisualization;
 
+	/// Agents added since the last crowd update.
+	std::vector<KX_ObstacleAgent> m_agents;
+
+	/** Spatial hash of the obstacles, the indices of the obstacles of a bucket are
+	 * stored in m_cellObstacles from m_cellStart[bucket] to m_cellStart[bucket + 1].
+	 */
+	std::vector<unsigned int> m_cellStart;
+	std::vector<unsigned int> m_cellObstacles;
+	/// Indices of the obstacles overlapping too many cells, returned by every query.
+	std::vector<unsigned int> m_largeObstacles;
+	float m_cellSize;
+	float m_maxObstacleRadius;
+	float m_maxObstacleSpeed;
+	/// Obstacles were added or removed since the last build of the hash.
+	bool m_hashDirty;
+
 	KX_Obstacle* CreateObstacle(KX_GameObject* gameobj);
+
+	void BuildObstacleHash();
+	/** Return the obstacles closer than a range of the active obstacle in the order of m_obstacles.
+	 * The circle obstacles are tested against the range extended by their radius.
+	 */
+	void QueryObstacles(KX_Obstacle *activeObst, float range, KX_Obstacles& obstacles) const;
+
+	/// Compute the adjusted velocity of an agent, called in parallel for all the agents.
+	virtual void SolveAgent(KX_ObstacleAgent& agent);
+	static void SolveAgentTask(void *userdata, const int iter);
+
 public:
 	KX_ObstacleSimulation(MT_Scalar levelHeight, bool enableVisualization);
 	virtual ~KX_ObstacleSimulation();
@@ -90,6 +135,16 @@ public:
 	virtual void AdjustObstacleVelocity(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
 	                                    MT_Vector3& velocity, MT_Scalar maxDeltaSpeed,MT_Scalar maxDeltaAngle);
 
+	/** Add an agent to the next crowd update. The desired velocity is used by the other
+	 * agents of the update.
+	 */
+	void AddAgent(KX_SteeringActuator *actuator, KX_Obstacle *activeObst, KX_NavMeshObject *activeNavMeshObj,
+	              const MT_Vector3& velocity, MT_Scalar maxDeltaSpeed, MT_Scalar maxDeltaAngle);
+	/** Adjust the velocities of all the added agents from the same state of the obstacles,
+	 * in parallel, and apply them to the steering actuators.
+	 */
+	void UpdateAgents();
+
 };
 class KX_ObstacleSimulationTOI: public KX_ObstacleSimulation
 {
@@ -102,8 +157,10 @@ protected:
 	float m_toiWeight;				// Sample selection TOI weight
 	float m_collisionWeight;		// Sample selection collision weight
 
-	virtual void sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
-							const float maxDeltaAngle) = 0;
+	virtual void sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, const KX_Obstacles& obstacles,
+							const float maxDeltaAngle, float nvel[2]) = 0;
+
+	virtual void SolveAgent(KX_ObstacleAgent& agent);
 public:
 	KX_ObstacleSimulationTOI(MT_Scalar levelHeight, bool enableVisualization);
 	virtual void AdjustObstacleVelocity(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
@@ -113,8 +170,8 @@ public:
 class KX_ObstacleSimulationTOI_rays: public KX_ObstacleSimulationTOI
 {
 protected:
-	virtual void sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
-							const float maxDeltaAngle);
+	virtual void sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, const KX_Obstacles& obstacles,
+							const float maxDeltaAngle, float nvel[2]);
 public:
 	KX_ObstacleSimulationTOI_rays(MT_Scalar levelHeight, bool enableVisualization);
 };
@@ -125,8 +182,8 @@ protected:
 	float m_bias;
 	bool m_adaptive;
 	int m_sampleRadius;
-	virtual void sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, 
-							const float maxDeltaAngle);
+	virtual void sampleRVO(KX_Obstacle* activeObst, KX_NavMeshObject* activeNavMeshObj, const KX_Obstacles& obstacles,
+							const float maxDeltaAngle, float nvel[2]);
 public:
 	KX_ObstacleSimulationTOI_cells(MT_Scalar levelHeight, bool enableVisualization);
 };
@@ -123,6 +123,7 @@ extern "C" {
 #include "KX_PythonInitTypes.h"
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 /* we only need this to get a list of libraries from the main struct */
 #include "DNA_ID.h"
@@ -301,6 +302,32 @@ static PyObject *gPyGetProfileInfo(PyObject *)
 	return KX_GetActiveEngine()->GetPyProfileDict();
 }
 
+PyDoc_STRVAR(gPyCaptureProfile_doc,
+"captureProfile(filepath, frames=1)\n"
+"Captures the scopes of the next frames and writes them to a Chrome trace file"
+);
+static PyObject *gPyCaptureProfile(PyObject *, PyObject *args)
+{
+	char expanded[FILE_MAX];
+	char *filepath;
+	int frames = 1;
+
+	if (!PyArg_ParseTuple(args, "s|i:captureProfile", &filepath, &frames)) {
+		return nullptr;
+	}
+
+	if (frames < 1) {
+		PyErr_SetString(PyExc_ValueError, "captureProfile(filepath, frames): frames must be greater than 0");
+		return nullptr;
+	}
+
+	BLI_strncpy(expanded, filepath, FILE_MAX);
+	BLI_path_abs(expanded, KX_GetMainPath().c_str());
+	CM_Profiler::StartCapture(expanded, frames);
+
+	Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR(gPySendMessage_doc,
 "sendMessage(subject, [body, to, from])\n"
 "sends a message in same manner as a message actuator"
@@ -465,6 +492,38 @@ static PyObject *gPySetUseExternalClock(PyObject *, PyObject *args)
 	Py_RETURN_NONE;
 }
 
+static PyObject *gPyGetUsePipelinedPhysics(PyObject *)
+{
+	return PyBool_FromLong(KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::PIPELINED_PHYSICS));
+}
+
+static PyObject *gPySetUsePipelinedPhysics(PyObject *, PyObject *args)
+{
+	int usePipelinedPhysics;
+
+	if (!PyArg_ParseTuple(args, "p:setUsePipelinedPhysics", &usePipelinedPhysics))
+		return nullptr;
+
+	KX_GetActiveEngine()->SetFlag(KX_KetsjiEngine::PIPELINED_PHYSICS, (bool)usePipelinedPhysics);
+	Py_RETURN_NONE;
+}
+
+static PyObject *gPyGetUseParallelScenes(PyObject *)
+{
+	return PyBool_FromLong(KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::PARALLEL_SCENES));
+}
+
+static PyObject *gPySetUseParallelScenes(PyObject *, PyObject *args)
+{
+	int useParallelScenes;
+
+	if (!PyArg_ParseTuple(args, "p:setUseParallelScenes", &useParallelScenes))
+		return nullptr;
+
+	KX_GetActiveEngine()->SetFlag(KX_KetsjiEngine::PARALLEL_SCENES, (bool)useParallelScenes);
+	Py_RETURN_NONE;
+}
+
 static PyObject *gPyGetClockTime(PyObject *)
 {
 	return PyFloat_FromDouble(KX_GetActiveEngine()->GetClockTime());
@@ -626,12 +685,12 @@ static PyObject *gLibLoad(PyObject *, PyObject *args, PyObject *kwds)
 	KX_LibLoadStatus *status = nullptr;
 
 	short options=0;
-	int load_actions=0, verbose=0, load_scripts=1, async=0;
+	int load_actions=0, verbose=0, load_scripts=1, async=0, stream=0;
 
-	static const char *kwlist[] = {"path", "group", "buffer", "load_actions", "verbose", "load_scripts", "async", "scene", nullptr};
+	static const char *kwlist[] = {"path", "group", "buffer", "load_actions", "verbose", "load_scripts", "async", "scene", "stream", nullptr};
 	
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "ss|y*iiIiO:LibLoad", const_cast<char**>(kwlist),
-									&path, &group, &py_buffer, &load_actions, &verbose, &load_scripts, &async, &pyscene))
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "ss|y*iiIiOi:LibLoad", const_cast<char**>(kwlist),
+									&path, &group, &py_buffer, &load_actions, &verbose, &load_scripts, &async, &pyscene, &stream))
 		return nullptr;
 
 	if (!ConvertPythonToScene(pyscene, &kx_scene, true, "invalid scene")) {
@@ -650,6 +709,8 @@ static PyObject *gLibLoad(PyObject *, PyObject *args, PyObject *kwds)
 		options |= BL_BlenderConverter::LIB_LOAD_LOAD_SCRIPTS;
 	if (async != 0)
 		options |= BL_BlenderConverter::LIB_LOAD_ASYNC;
+	if (stream != 0)
+		options |= (BL_BlenderConverter::LIB_LOAD_STREAM | BL_BlenderConverter::LIB_LOAD_ASYNC);
 
 	BL_BlenderConverter *converter = KX_GetActiveEngine()->GetConverter();
 
@@ -768,6 +829,46 @@ static PyObject *gLibList(PyObject *, PyObject *args)
 	return list;
 }
 
+static PyObject *gLibGetStreamBudget(PyObject *)
+{
+	return PyFloat_FromDouble(KX_GetActiveEngine()->GetConverter()->GetStreamBudget());
+}
+
+static PyObject *gLibSetStreamBudget(PyObject *, PyObject *args)
+{
+	double budget;
+	if (!PyArg_ParseTuple(args, "d:setLibLoadStreamBudget", &budget))
+		return nullptr;
+
+	if (budget < 0.0) {
+		PyErr_SetString(PyExc_ValueError, "setLibLoadStreamBudget(budget): budget must be positive");
+		return nullptr;
+	}
+
+	KX_GetActiveEngine()->GetConverter()->SetStreamBudget(budget);
+	Py_RETURN_NONE;
+}
+
+static PyObject *gPyGetActionBakeRate(PyObject *)
+{
+	return PyFloat_FromDouble(KX_GetActiveEngine()->GetConverter()->GetActionBakeRate());
+}
+
+static PyObject *gPySetActionBakeRate(PyObject *, PyObject *args)
+{
+	float rate;
+	if (!PyArg_ParseTuple(args, "f:setActionBakeRate", &rate))
+		return nullptr;
+
+	if (rate < 0.0f) {
+		PyErr_SetString(PyExc_ValueError, "setActionBakeRate(rate): rate must be positive");
+		return nullptr;
+	}
+
+	KX_GetActiveEngine()->GetConverter()->SetActionBakeRate(rate);
+	Py_RETURN_NONE;
+}
+
 struct PyNextFrameState pynextframestate;
 static PyObject *gPyNextFrame(PyObject *)
 {
@@ -815,6 +916,10 @@ static struct PyMethodDef game_methods[] = {
 	{"getRender", (PyCFunction) gPyGetRender, METH_NOARGS, (const char *)"get the global render flag value"},
 	{"getUseExternalClock", (PyCFunction) gPyGetUseExternalClock, METH_NOARGS, (const char *)"Get if we use the time provided by an external clock"},
 	{"setUseExternalClock", (PyCFunction) gPySetUseExternalClock, METH_VARARGS, (const char *)"Set if we use the time provided by an external clock"},
+	{"getUsePipelinedPhysics", (PyCFunction) gPyGetUsePipelinedPhysics, METH_NOARGS, (const char *)"Get if the physics is proceeded in parallel of the rendering"},
+	{"setUsePipelinedPhysics", (PyCFunction) gPySetUsePipelinedPhysics, METH_VARARGS, (const char *)"Set if the physics is proceeded in parallel of the rendering"},
+	{"getUseParallelScenes", (PyCFunction) gPyGetUseParallelScenes, METH_NOARGS, (const char *)"Get if the physics of the scenes is proceeded in parallel"},
+	{"setUseParallelScenes", (PyCFunction) gPySetUseParallelScenes, METH_VARARGS, (const char *)"Set if the physics of the scenes is proceeded in parallel"},
 	{"getClockTime", (PyCFunction) gPyGetClockTime, METH_NOARGS, (const char *)"Get the last BGE render time. "
 	"The BGE render time is the simulated time corresponding to the next scene that will be renderered"},
 	{"setClockTime", (PyCFunction) gPySetClockTime, METH_VARARGS, (const char *)"Set the BGE render time. "
@@ -831,11 +936,16 @@ static struct PyMethodDef game_methods[] = {
 	{"PrintMemInfo", (PyCFunction)pyPrintStats, METH_NOARGS, (const char *)"Print engine statistics"},
 	{"NextFrame", (PyCFunction)gPyNextFrame, METH_NOARGS, (const char *)"Render next frame (if Python has control)"},
 	{"getProfileInfo", (PyCFunction)gPyGetProfileInfo, METH_NOARGS, gPyGetProfileInfo_doc},
+	{"captureProfile", (PyCFunction)gPyCaptureProfile, METH_VARARGS, gPyCaptureProfile_doc},
 	/* library functions */
 	{"LibLoad", (PyCFunction)gLibLoad, METH_VARARGS|METH_KEYWORDS, (const char *)""},
 	{"LibNew", (PyCFunction)gLibNew, METH_VARARGS, (const char *)""},
 	{"LibFree", (PyCFunction)gLibFree, METH_VARARGS, (const char *)""},
 	{"LibList", (PyCFunction)gLibList, METH_VARARGS, (const char *)""},
+	{"getLibLoadStreamBudget", (PyCFunction)gLibGetStreamBudget, METH_NOARGS, (const char *)"Get the time spent merging streamed libraries per logic frame"},
+	{"setLibLoadStreamBudget", (PyCFunction)gLibSetStreamBudget, METH_VARARGS, (const char *)"Set the time spent merging streamed libraries per logic frame"},
+	{"getActionBakeRate", (PyCFunction)gPyGetActionBakeRate, METH_NOARGS, (const char *)"Get the number of samples per frame baked for the actions"},
+	{"setActionBakeRate", (PyCFunction)gPySetActionBakeRate, METH_VARARGS, (const char *)"Set the number of samples per frame baked for the actions"},
 	
 	{nullptr, (PyCFunction) nullptr, 0, nullptr }
 };
@@ -59,7 +59,6 @@
 #include "RAS_MeshObject.h"
 #include "SCA_IScene.h"
 #include "KX_LodManager.h"
-#include "KX_CullingHandler.h"
 
 #include "RAS_Rasterizer.h"
 #include "RAS_ICanvas.h"
@@ -75,6 +74,7 @@
 #include "SG_Controller.h"
 #include "SG_Node.h"
 #include "DNA_group_types.h"
+#include "DNA_object_types.h" // for OB_MAX_COL_MASKS
 #include "DNA_scene_types.h"
 #include "DNA_property_types.h"
 
@@ -86,9 +86,11 @@
 #include "PHY_IPhysicsController.h"
 #include "BL_BlenderConverter.h"
 #include "KX_MotionState.h"
+#include "KX_ClientObjectInfo.h"
 
 #include "BL_ModifierDeformer.h"
 #include "BL_ShapeDeformer.h"
+#include "BL_ArmatureObject.h"
 #include "BL_DeformableGameObject.h"
 #include "KX_ObstacleSimulation.h"
 
@@ -105,6 +107,10 @@
 #include "BLI_task.h"
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
+
+/// Minimum number of scheduled nodes to update the scene graph in parallel.
+#define KX_SCENEGRAPH_PARALLEL_MIN_NODES 16
 
 static void *KX_SceneReplicationFunc(SG_Node* node,void* gameobj,void* scene)
 {
@@ -198,7 +204,7 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 	m_bucketmanager=new RAS_BucketManager(textMaterial);
 	m_boundingBoxManager = new RAS_BoundingBoxManager();
 
-	m_animationPool = BLI_task_pool_create(KX_GetActiveEngine()->GetTaskScheduler(), &m_animationPoolData);
+	m_animationPool = BLI_task_pool_create(KX_GetActiveEngine()->GetTaskScheduler(), nullptr);
 
 #ifdef WITH_PYTHON
 	m_attr_dict = nullptr;
@@ -218,6 +224,11 @@ KX_Scene::~KX_Scene()
 	// reference might be hanging and causing late release of objects
 	RemoveAllDebugProperties();
 
+	// Free the parked replicas and destruct the other replicas normally.
+	while (!m_spawnPools.empty()) {
+		ClearSpawnPool(m_spawnPools.begin()->first);
+	}
+
 	while (GetRootParentList()->GetCount() > 0) 
 	{
 		KX_GameObject* parentobj = GetRootParentList()->GetValue(0);
@@ -397,6 +408,10 @@ void KX_Scene::Resume()
 
 void KX_Scene::SetActivityCulling(bool b)
 {
+	if (m_activity_culling && !b) {
+		// Resume the objects suspended while the activity culling was enabled.
+		m_activityCullingHandler.Clear(m_objectlist);
+	}
 	m_activity_culling = b;
 }
 
@@ -826,8 +841,17 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject, KX_Game
 
 	m_ueberExecutionPriority++;
 
-	// lets create a replica
-	KX_GameObject* replica = (KX_GameObject*) AddNodeReplicaObject(nullptr,originalobj);
+	// lets create a replica, or reuse a parked one
+	KX_GameObject *replica;
+	const std::map<KX_GameObject *, SpawnPool>::iterator poolit = m_spawnPools.find(originalobj);
+	if (poolit != m_spawnPools.end()) {
+		SpawnPool& pool = poolit->second;
+		replica = pool.m_objects.empty() ? AddNodeReplicaObject(nullptr, originalobj) : RespawnObject(originalobj, pool);
+		m_spawnedObjects[replica] = originalobj;
+	}
+	else {
+		replica = (KX_GameObject*) AddNodeReplicaObject(nullptr,originalobj);
+	}
 
 	// add a timebomb to this object
 	// lifespan of zero means 'this object lives forever'
@@ -920,6 +944,11 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject, KX_Game
 
 void KX_Scene::RemoveObject(KX_GameObject *gameobj)
 {
+	// Keep the replica for the next addition of its original object.
+	if (ParkObject(gameobj)) {
+		return;
+	}
+
 	// disconnect child from parent
 	SG_Node* node = gameobj->GetSGNode();
 
@@ -952,6 +981,9 @@ void KX_Scene::DelayedRemoveObject(KX_GameObject *gameobj)
 
 bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 {
+	// The parked replicas of an original object can't be reused anymore.
+	ClearSpawnPool(gameobj);
+
 	/* remove property from debug list */
 	RemoveObjectDebugProperties(gameobj);
 
@@ -972,35 +1004,8 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 	}
 
 	// remove all sensors/controllers/actuators from logicsystem...
-	
-	SCA_SensorList& sensors = gameobj->GetSensors();
-	for (SCA_ISensor *sensor : sensors) {
-		m_logicmgr->RemoveSensor(sensor);
-	}
-
-	SCA_ControllerList& controllers = gameobj->GetControllers();
-	for (SCA_IController *controller : controllers) {
-		m_logicmgr->RemoveController(controller);
-		controller->ReParent(nullptr);
-	}
-
-	SCA_ActuatorList& actuators = gameobj->GetActuators();
-	for (SCA_IActuator *actuator : actuators) {
-		m_logicmgr->RemoveActuator(actuator);
-	}
 	// the sensors/controllers/actuators must also be released, this is done in ~SCA_IObject
-
-	// now remove the timer properties from the time manager
-	int numprops = gameobj->GetPropertyCount();
-
-	for (int i = 0; i < numprops; i++)
-	{
-		EXP_Value* propval = gameobj->GetProperty(i);
-		if (propval->GetProperty("timer"))
-		{
-			m_timemgr->RemoveTimeProperty(propval);
-		}
-	}
+	UnregisterObjectLogic(gameobj);
 
 	// if the object is the dupligroup proxy, you have to cleanup all m_pDupliGroupObject's in all
 	// instances refering to this group
@@ -1043,6 +1048,17 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 		ret = (gameobj->Release() != nullptr);
 	}
 
+	const std::map<KX_GameObject *, KX_GameObject *>::iterator spawnit = m_spawnedObjects.find(gameobj);
+	if (spawnit != m_spawnedObjects.end()) {
+		std::vector<KX_GameObject *>& parked = m_spawnPools[spawnit->second].m_objects;
+		m_spawnedObjects.erase(spawnit);
+		const std::vector<KX_GameObject *>::iterator parkit = std::find(parked.begin(), parked.end(), gameobj);
+		if (parkit != parked.end()) {
+			parked.erase(parkit);
+			ret = (gameobj->Release() != nullptr);
+		}
+	}
+
 	/* Warning 'gameobj' maye be freed now, only compare, don't access */
 
 	const std::vector<KX_GameObject *>::const_iterator animit = std::find(m_animatedlist.begin(), m_animatedlist.end(), gameobj);
@@ -1076,6 +1092,191 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 	return ret;
 }
 
+void KX_Scene::UnregisterObjectLogic(KX_GameObject *gameobj)
+{
+	SCA_SensorList& sensors = gameobj->GetSensors();
+	for (SCA_ISensor *sensor : sensors) {
+		m_logicmgr->RemoveSensor(sensor);
+	}
+
+	SCA_ControllerList& controllers = gameobj->GetControllers();
+	for (SCA_IController *controller : controllers) {
+		m_logicmgr->RemoveController(controller);
+		controller->ReParent(nullptr);
+	}
+
+	SCA_ActuatorList& actuators = gameobj->GetActuators();
+	for (SCA_IActuator *actuator : actuators) {
+		m_logicmgr->RemoveActuator(actuator);
+	}
+
+	// now remove the timer properties from the time manager
+	int numprops = gameobj->GetPropertyCount();
+
+	for (int i = 0; i < numprops; i++)
+	{
+		EXP_Value* propval = gameobj->GetProperty(i);
+		if (propval->GetProperty("timer"))
+		{
+			m_timemgr->RemoveTimeProperty(propval);
+		}
+	}
+}
+
+bool KX_Scene::SetSpawnPoolSize(KX_GameObject *gameobj, unsigned int size)
+{
+	if (size == 0) {
+		ClearSpawnPool(gameobj);
+		return true;
+	}
+
+	// The replicas must be reset without replicating a hierarchy or deformers, the armatures,
+	// cameras, lights and texts have a specific game object type.
+	SG_Node *node = gameobj->GetSGNode();
+	Object *blenderobj = gameobj->GetBlenderObject();
+	if (gameobj->GetGameObjectType() != -1 || !blenderobj || !node ||
+		node->GetSGParent() || !node->GetSGChildren().empty() || gameobj->IsDupliGroup() ||
+		gameobj->IsDeformable() || gameobj->GetComponents() || blenderobj->body_type == OB_BODY_TYPE_SOFT)
+	{
+		return false;
+	}
+
+	SpawnPool& pool = m_spawnPools[gameobj];
+	pool.m_size = size;
+	// Free the parked replicas out of the new size, they are removed from the pool by NewRemoveObject.
+	while (pool.m_objects.size() > size) {
+		pool.m_objects.back()->GetSGNode()->Destruct();
+	}
+
+	return true;
+}
+
+void KX_Scene::SetAnimationLodDistances(float halfRateDistance, float quarterRateDistance)
+{
+	m_animationScheduler.SetLodDistances(halfRateDistance, quarterRateDistance);
+}
+
+unsigned int KX_Scene::GetSpawnPoolSize(KX_GameObject *gameobj) const
+{
+	const std::map<KX_GameObject *, SpawnPool>::const_iterator poolit = m_spawnPools.find(gameobj);
+	return (poolit != m_spawnPools.end()) ? poolit->second.m_size : 0;
+}
+
+bool KX_Scene::ParkObject(KX_GameObject *gameobj)
+{
+	const std::map<KX_GameObject *, KX_GameObject *>::iterator spawnit = m_spawnedObjects.find(gameobj);
+	if (spawnit == m_spawnedObjects.end()) {
+		return false;
+	}
+
+	KX_GameObject *originalobj = spawnit->second;
+	SpawnPool& pool = m_spawnPools[originalobj];
+	SG_Node *node = gameobj->GetSGNode();
+	// Only a replica with the same hierarchy and meshes as its original object can be reused.
+	if (pool.m_objects.size() >= pool.m_size || !node || node->GetSGParent() || !node->GetSGChildren().empty() ||
+		gameobj->GetDupliGroupObject() || gameobj->GetMeshList() != originalobj->GetMeshList())
+	{
+		return false;
+	}
+
+	// The pool owns a reference of the parked replica.
+	pool.m_objects.push_back(CM_AddRef(gameobj));
+
+	RemoveObjectDebugProperties(gameobj);
+	// The replica is a new object for python once reused.
+	gameobj->InvalidateProxy();
+	UnregisterObjectLogic(gameobj);
+
+	if (m_obstacleSimulation) {
+		m_obstacleSimulation->DestroyObstacleForObj(gameobj);
+	}
+
+	m_rendererManager->InvalidateViewpoint(gameobj);
+
+	gameobj->Park();
+
+	if (m_objectlist->RemoveValue(gameobj)) {
+		gameobj->Release();
+	}
+	if (m_parentlist->RemoveValue(gameobj)) {
+		gameobj->Release();
+	}
+
+	const std::vector<KX_GameObject *>::const_iterator animit = std::find(m_animatedlist.begin(), m_animatedlist.end(), gameobj);
+	if (animit != m_animatedlist.end()) {
+		m_animatedlist.erase(animit);
+	}
+
+	const std::vector<KX_GameObject *>::const_iterator euthit = std::find(m_euthanasyobjects.begin(), m_euthanasyobjects.end(), gameobj);
+	if (euthit != m_euthanasyobjects.end()) {
+		m_euthanasyobjects.erase(euthit);
+	}
+
+	const std::vector<KX_GameObject *>::const_iterator tempit = std::find(m_tempObjectList.begin(), m_tempObjectList.end(), gameobj);
+	if (tempit != m_tempObjectList.end()) {
+		m_tempObjectList.erase(tempit);
+	}
+
+	return true;
+}
+
+KX_GameObject *KX_Scene::RespawnObject(KX_GameObject *originalobj, SpawnPool& pool)
+{
+	// The reference of the pool is given to the caller as for a new replica.
+	KX_GameObject *replica = pool.m_objects.back();
+	pool.m_objects.pop_back();
+
+	replica->Respawn(originalobj);
+	m_map_gameobject_to_replica[originalobj] = replica;
+
+	// also register 'timers' (time properties) of the replica
+	int numprops = replica->GetPropertyCount();
+
+	for (int i = 0; i < numprops; i++)
+	{
+		EXP_Value* prop = replica->GetProperty(i);
+
+		if (prop->GetProperty("timer"))
+			this->m_timemgr->AddTimeProperty(prop);
+	}
+
+	if (m_obstacleSimulation && originalobj->GetBlenderObject()->gameflag & OB_HASOBSTACLE) {
+		m_obstacleSimulation->AddObstacleForObj(replica);
+	}
+
+	m_objectlist->Add(CM_AddRef(replica));
+
+	// logic cannot be replicated, until the whole hierarchy is replicated.
+	m_logicHierarchicalGameObjects.push_back(replica);
+
+	return replica;
+}
+
+void KX_Scene::ClearSpawnPool(KX_GameObject *originalobj)
+{
+	const std::map<KX_GameObject *, SpawnPool>::iterator poolit = m_spawnPools.find(originalobj);
+	if (poolit == m_spawnPools.end()) {
+		return;
+	}
+
+	// The parked replicas are removed from the pool and released by NewRemoveObject.
+	std::vector<KX_GameObject *>& parked = poolit->second.m_objects;
+	while (!parked.empty()) {
+		parked.back()->GetSGNode()->Destruct();
+	}
+
+	for (std::map<KX_GameObject *, KX_GameObject *>::iterator it = m_spawnedObjects.begin(); it != m_spawnedObjects.end();) {
+		if (it->second == originalobj) {
+			it = m_spawnedObjects.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+
+	m_spawnPools.erase(poolit);
+}
+
 KX_Camera* KX_Scene::GetActiveCamera()
 {
 	// nullptr if not defined
@@ -1122,6 +1323,15 @@ void KX_Scene::PhysicsCullingCallback(KX_ClientObjectInfo *objectInfo, void *cul
 	info->m_nodes.push_back(gameobj->GetCullingNode());
 }
 
+void KX_Scene::BeginCullingFrame()
+{
+	for (KX_GameObject *gameobj : m_objectlist) {
+		gameobj->GetCullingNode()->ResetFrameCulled();
+	}
+	// The deformers are updated again for the objects seen by the passes of this frame.
+	m_deformerScheduler.BeginFrame();
+}
+
 void KX_Scene::CalculateVisibleMeshes(KX_CullingNodeList& nodes, KX_Camera *cam, int layer)
 {
 	if (!cam->GetFrustumCulling()) {
@@ -1138,6 +1348,8 @@ void KX_Scene::CalculateVisibleMeshes(KX_CullingNodeList& nodes, KX_Camera *cam,
 
 void KX_Scene::CalculateVisibleMeshes(KX_CullingNodeList& nodes, const SG_Frustum& frustum, int layer)
 {
+	CM_ProfileScope scope("Culling");
+
 	m_boundingBoxManager->Update(false);
 
 	bool dbvt_culling = false;
@@ -1168,22 +1380,7 @@ void KX_Scene::CalculateVisibleMeshes(KX_CullingNodeList& nodes, const SG_Frustu
 		dbvt_culling = m_physicsEnvironment->CullingTest(PhysicsCullingCallback, &info, planes, m_dbvt_occlusion_res, viewport, matrix);
 	}
 	if (!dbvt_culling) {
-		KX_CullingHandler handler(nodes, frustum);
-		for (KX_GameObject *gameobj : m_objectlist) {
-			if (gameobj->UseCulling() && gameobj->GetVisible() && (layer == 0 || gameobj->GetLayer() & layer)) {
-				if (gameobj->GetDeformer()) {
-					/** Update all the deformer, not only per material.
-					 * One of the side effect is to clear some flags about AABB calculation.
-					 * like in KX_SoftBodyDeformer.
-					 */
-					gameobj->GetDeformer()->UpdateBuckets();
-				}
-				// Update the object bounding volume box.
-				gameobj->UpdateBounds(false);
-
-				handler.Process(gameobj->GetCullingNode());
-			}
-		}
+		m_cullingHandler.Process(m_objectlist, frustum, layer, nodes);
 	}
 
 	m_boundingBoxManager->ClearModified();
@@ -1310,79 +1507,31 @@ void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
 	}
 }
 
-static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
+void KX_Scene::UpdateAnimations(double curtime)
 {
-	KX_GameObject *gameobj, *parent;
-	EXP_ListValue<KX_GameObject> *children;
-	bool needs_update;
-	KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData *)BLI_task_pool_userdata(pool);
-	double curtime = data->curtime;
-
-	gameobj = (KX_GameObject*)taskdata;
-
-	// Non-armature updates are fast enough, so just update them
-	needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
-
-	if (!needs_update) {
-		// If we got here, we're looking to update an armature, so check its children meshes
-		// to see if we need to bother with a more expensive pose update
-		children = gameobj->GetChildren();
+	CM_ProfileScope scope("Animations");
 
-		bool has_mesh = false, has_non_mesh = false;
-
-		// Check for meshes that haven't been culled
-		for (KX_GameObject *child : children) {
-			if (!child->GetCulled()) {
-				needs_update = true;
-				break;
-			}
-
-			if (child->GetMeshList().empty())
-				has_non_mesh = true;
-			else
-				has_mesh = true;
-		}
-
-		// If we didn't find a non-culled mesh, check to see
-		// if we even have any meshes, and update if this
-		// armature has only non-mesh children.
-		if (!needs_update && !has_mesh && has_non_mesh)
-			needs_update = true;
-
-		children->Release();
+	std::vector<MT_Vector3> cameras;
+	if (m_animationScheduler.GetHalfRateDistance() > 0.0f || m_animationScheduler.GetQuarterRateDistance() > 0.0f) {
+		GetActiveCameraPositions(cameras);
 	}
 
-	// If the object is a culled armature, then we manage only the animation time and end of its animations.
-	gameobj->UpdateActionManager(curtime, needs_update);
-
-	if (needs_update) {
-		children = gameobj->GetChildren();
-		parent = gameobj->GetParent();
-
-		// Only do deformers here if they are not parented to an armature, otherwise the armature will
-		// handle updating its children
-		if (gameobj->GetDeformer() && (!parent || parent->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE))
-			gameobj->GetDeformer()->Update();
-
-		for (KX_GameObject *child : children) {
-			if (child->GetDeformer()) {
-				child->GetDeformer()->Update();
-			}
-		}
+	m_animationScheduler.Update(curtime, m_animatedlist, cameras, &m_deformerScheduler, m_animationPool);
 
-		children->Release();
-	}
+	// Update the deformers of all the animated objects at once.
+	m_deformerScheduler.Update(m_animationPool);
 }
 
-void KX_Scene::UpdateAnimations(double curtime)
+bool KX_Scene::AnimationsUsePhysics() const
 {
-	m_animationPoolData.curtime = curtime;
-
 	for (KX_GameObject *gameobj : m_animatedlist) {
-		BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false, TASK_PRIORITY_LOW);
+		// The children can be physics objects with a world transformation updated by the animation.
+		if (gameobj->GetPhysicsController() || !gameobj->GetSGNode()->GetSGChildren().empty()) {
+			return true;
+		}
 	}
 
-	BLI_task_pool_work_and_wait(m_animationPool);
+	return false;
 }
 
 void KX_Scene::LogicUpdateFrame(double curtime)
@@ -1396,11 +1545,19 @@ void KX_Scene::LogicUpdateFrame(double curtime)
 		objects.push_back(gameobj);
 	}
 
-	for (KX_GameObject *gameobj : objects) {
-		gameobj->UpdateComponents();
+	{
+		CM_ProfileScope scope("Components");
+		for (KX_GameObject *gameobj : objects) {
+			gameobj->UpdateComponents();
+		}
 	}
 
 	m_logicmgr->UpdateFrame(curtime);
+
+	// Adjust and apply the velocities of the steering actuators updated in this frame.
+	if (m_obstacleSimulation) {
+		m_obstacleSimulation->UpdateAgents();
+	}
 }
 
 void KX_Scene::LogicEndFrame()
@@ -1433,9 +1590,23 @@ void KX_Scene::LogicEndFrame()
  */
 void KX_Scene::UpdateParents(double curtime)
 {
+	CM_ProfileScope scope("Scene graph");
+
 	// we use the SG dynamic list
 	SG_Node* node;
 
+	// Update in parallel only if there is enough scheduled hierarchies to amortize the threads.
+	unsigned int numScheduled = 0;
+	SG_DList::iterator<SG_Node> it(m_sghead);
+	for (it.begin(); !it.end() && numScheduled < KX_SCENEGRAPH_PARALLEL_MIN_NODES; ++it) {
+		++numScheduled;
+	}
+
+	if (numScheduled == KX_SCENEGRAPH_PARALLEL_MIN_NODES) {
+		SG_Node::UpdateScheduledWorldDataParallel(m_sghead, curtime);
+	}
+
+	// Nodes scheduled during the parallel update are updated here.
 	while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr)
 	{
 		node->UpdateWorldData(curtime);
@@ -1479,12 +1650,7 @@ void KX_Scene::RenderTextureRenderers(KX_TextureRendererManager::RendererCategor
 
 void KX_Scene::UpdateObjectLods(KX_Camera *cam, const KX_CullingNodeList& nodes)
 {
-	const MT_Vector3& cam_pos = cam->NodeGetWorldPosition();
-	const float lodfactor = cam->GetLodDistanceFactor();
-
-	for (KX_CullingNode *node : nodes) {
-		node->GetObject()->UpdateLod(cam_pos, lodfactor);
-	}
+	m_lodHandler.Process(nodes, cam->NodeGetWorldPosition(), cam->GetLodDistanceFactor(), this);
 }
 
 void KX_Scene::SetLodHysteresis(bool active)
@@ -1507,8 +1673,32 @@ int KX_Scene::GetLodHysteresisValue(void)
 	return m_lodHysteresisValue;
 }
 
+void KX_Scene::GetActiveCameraPositions(std::vector<MT_Vector3>& positions) const
+{
+	for (KX_Camera *cam : m_cameralist) {
+		if (cam == m_active_camera || cam->GetViewport()) {
+			positions.push_back(cam->NodeGetWorldPosition());
+		}
+	}
+}
+
 void KX_Scene::UpdateObjectActivity(void) 
 {
+	if (!m_activity_culling) {
+		return;
+	}
+
+	CM_ProfileScope scope("Activity culling");
+
+	// The active camera and the cameras rendering a viewport keep the objects around them active.
+	std::vector<MT_Vector3> cameras;
+	GetActiveCameraPositions(cameras);
+
+	const unsigned int suspended = m_activityCullingHandler.Process(m_objectlist, cameras, m_activity_box_radius);
+
+	if (CM_Profiler::IsCapturing()) {
+		CM_Profiler::AddCounter(CM_Profiler::InternName(GetName() + " suspended objects"), suspended);
+	}
 }
 
 void KX_Scene::SetActivityCullingRadius(float f)
@@ -1648,7 +1838,7 @@ static void MergeScene_GameObject(KX_GameObject* gameobj, KX_Scene *to, KX_Scene
 	}
 }
 
-bool KX_Scene::MergeScene(KX_Scene *other)
+bool KX_Scene::MergeScene(KX_Scene *other, bool mergeBuckets)
 {
 	PHY_IPhysicsEnvironment *env = this->GetPhysicsEnvironment();
 	PHY_IPhysicsEnvironment *env_other = other->GetPhysicsEnvironment();
@@ -1659,7 +1849,9 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 		return false;
 	}
 
-	GetBucketManager()->MergeBucketManager(other->GetBucketManager(), this);
+	if (mergeBuckets) {
+		MergeSceneBuckets(other);
+	}
 	GetBoundingBoxManager()->Merge(other->GetBoundingBoxManager());
 	GetTextureRendererManager()->Merge(other->GetTextureRendererManager());
 
@@ -1749,6 +1941,11 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 	return true;
 }
 
+void KX_Scene::MergeSceneBuckets(KX_Scene *other)
+{
+	GetBucketManager()->MergeBucketManager(other->GetBucketManager(), this);
+}
+
 RAS_2DFilterManager *KX_Scene::Get2DFilterManager() const
 {
 	return m_filterManager;
@@ -1756,6 +1953,7 @@ RAS_2DFilterManager *KX_Scene::Get2DFilterManager() const
 
 RAS_OffScreen *KX_Scene::Render2DFilters(RAS_Rasterizer *rasty, RAS_ICanvas *canvas, RAS_OffScreen *inputofs, RAS_OffScreen *targetofs)
 {
+	CM_ProfileScope scope("2D filters");
 	return m_filterManager->RenderFilters(rasty, canvas, inputofs, targetofs);
 }
 
@@ -1787,6 +1985,12 @@ void KX_Scene::RunDrawingCallbacks(DrawingCallbackType callbackType, KX_Camera *
 	}
 }
 
+bool KX_Scene::HasDrawingCallbacks(DrawingCallbackType callbackType) const
+{
+	PyObject *list = m_drawCallbacks[callbackType];
+	return (list && PyList_GET_SIZE(list) > 0);
+}
+
 //----------------------------------------------------------------------------
 //Python
 
@@ -1823,6 +2027,11 @@ PyMethodDef KX_Scene::Methods[] = {
 	EXP_PYMETHODTABLE(KX_Scene, suspend),
 	EXP_PYMETHODTABLE(KX_Scene, resume),
 	EXP_PYMETHODTABLE(KX_Scene, drawObstacleSimulation),
+	EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, rayCastBatch),
+	EXP_PYMETHODTABLE(KX_Scene, setSpawnPoolSize),
+	EXP_PYMETHODTABLE(KX_Scene, getSpawnPoolSize),
+	EXP_PYMETHODTABLE(KX_Scene, setAnimationLodDistances),
+	EXP_PYMETHODTABLE_NOARGS(KX_Scene, getAnimationLodDistances),
 
 	
 	/* dict style access */
@@ -2216,6 +2425,181 @@ EXP_PYMETHODDEF_DOC(KX_Scene, drawObstacleSimulation,
 	Py_RETURN_NONE;
 }
 
+EXP_PYMETHODDEF_DOC(KX_Scene, setSpawnPoolSize,
+"setSpawnPoolSize(object, size)\n"
+"Keep up to size removed replicas of object to reuse them when it is added again.\n")
+{
+	PyObject *pyob;
+	KX_GameObject *ob;
+	int size;
+
+	if (!PyArg_ParseTuple(args, "Oi:setSpawnPoolSize", &pyob, &size)) {
+		return nullptr;
+	}
+
+	if (!ConvertPythonToGameObject(m_logicmgr, pyob, &ob, false, "scene.setSpawnPoolSize(object, size): KX_Scene (first argument)")) {
+		return nullptr;
+	}
+
+	if (size < 0) {
+		PyErr_SetString(PyExc_ValueError, "scene.setSpawnPoolSize(object, size): KX_Scene (second argument): size must be positive");
+		return nullptr;
+	}
+
+	if (!SetSpawnPoolSize(ob, size)) {
+		PyErr_Format(PyExc_ValueError, "scene.setSpawnPoolSize(object, size): KX_Scene (first argument): "
+		             "object must be a mesh object without parent, children, dupli group, python component or soft body");
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene, getSpawnPoolSize,
+"getSpawnPoolSize(object)\n"
+"Returns the maximum number of removed replicas of object kept to be reused.\n")
+{
+	PyObject *pyob;
+	KX_GameObject *ob;
+
+	if (!PyArg_ParseTuple(args, "O:getSpawnPoolSize", &pyob)) {
+		return nullptr;
+	}
+
+	if (!ConvertPythonToGameObject(m_logicmgr, pyob, &ob, false, "scene.getSpawnPoolSize(object): KX_Scene (first argument)")) {
+		return nullptr;
+	}
+
+	return PyLong_FromLong(GetSpawnPoolSize(ob));
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene, setAnimationLodDistances,
+"setAnimationLodDistances(halfRateDistance, quarterRateDistance)\n"
+"Set the distances from the cameras from which the armatures are animated at half and quarter rate.\n")
+{
+	float halfRateDistance;
+	float quarterRateDistance;
+
+	if (!PyArg_ParseTuple(args, "ff:setAnimationLodDistances", &halfRateDistance, &quarterRateDistance)) {
+		return nullptr;
+	}
+
+	if (halfRateDistance < 0.0f || quarterRateDistance < 0.0f) {
+		PyErr_SetString(PyExc_ValueError, "scene.setAnimationLodDistances(halfRateDistance, quarterRateDistance): KX_Scene, distances must be positive");
+		return nullptr;
+	}
+
+	SetAnimationLodDistances(halfRateDistance, quarterRateDistance);
+
+	Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC_NOARGS(KX_Scene, getAnimationLodDistances,
+"getAnimationLodDistances()\n"
+"Returns the distances from the cameras from which the armatures are animated at half and quarter rate.\n")
+{
+	return Py_BuildValue("(ff)", m_animationScheduler.GetHalfRateDistance(), m_animationScheduler.GetQuarterRateDistance());
+}
+
+/// Filter of the batch ray casts, keeps the objects of the collision groups in the ray mask.
+class KX_RayBatchFilterCallback : public PHY_IRayBatchFilterCallback
+{
+public:
+	virtual bool NeedRayCast(PHY_IPhysicsController *controller, unsigned int mask) const
+	{
+		KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(controller->GetNewClientInfo());
+		if (!info || !info->m_gameobject || info->m_type > KX_ClientObjectInfo::ACTOR) {
+			return false;
+		}
+
+		return (info->m_gameobject->GetUserCollisionGroup() & mask);
+	}
+};
+
+static bool ConvertPythonToRayPoints(PyObject *value, std::vector<MT_Vector3>& points, const char *error_prefix)
+{
+	PyObject *fast = PySequence_Fast(value, error_prefix);
+	if (!fast) {
+		return false;
+	}
+
+	const Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+	points.resize(size);
+	for (Py_ssize_t i = 0; i < size; ++i) {
+		if (!PyVecTo(PySequence_Fast_GET_ITEM(fast, i), points[i])) {
+			Py_DECREF(fast);
+			return false;
+		}
+	}
+
+	Py_DECREF(fast);
+	return true;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene, rayCastBatch,
+"rayCastBatch(froms, tos, mask)\n"
+"Casts a ray from each point of froms to the point of same index in tos.\n"
+"Returns a list containing for each ray a tuple (object, point, normal), or None if the ray hit nothing.\n"
+" mask = collision mask: the collision mask that rays can hit, 0 < mask < 65536\n")
+{
+	PyObject *pyfroms;
+	PyObject *pytos;
+	int mask = (1 << OB_MAX_COL_MASKS) - 1;
+
+	static const char *kwlist[] = {"froms", "tos", "mask", nullptr};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|i:rayCastBatch", const_cast<char **>(kwlist), &pyfroms, &pytos, &mask)) {
+		return nullptr;
+	}
+
+	if (mask == 0 || mask & ~((1 << OB_MAX_COL_MASKS) - 1)) {
+		PyErr_Format(PyExc_TypeError, "scene.rayCastBatch(froms, tos, mask): KX_Scene, mask argument must be a int bitfield, 0 < mask < %i", (1 << OB_MAX_COL_MASKS));
+		return nullptr;
+	}
+
+	std::vector<MT_Vector3> froms;
+	std::vector<MT_Vector3> tos;
+	if (!ConvertPythonToRayPoints(pyfroms, froms, "scene.rayCastBatch(froms, tos, mask): KX_Scene, froms must be a sequence of vectors") ||
+		!ConvertPythonToRayPoints(pytos, tos, "scene.rayCastBatch(froms, tos, mask): KX_Scene, tos must be a sequence of vectors"))
+	{
+		return nullptr;
+	}
+
+	if (froms.size() != tos.size()) {
+		PyErr_SetString(PyExc_ValueError, "scene.rayCastBatch(froms, tos, mask): KX_Scene, froms and tos must have the same length");
+		return nullptr;
+	}
+
+	PHY_RayBatch batch;
+	for (unsigned int i = 0, size = froms.size(); i < size; ++i) {
+		batch.AddRay(froms[i], tos[i], mask);
+	}
+
+	KX_RayBatchFilterCallback filterCallback;
+	std::vector<PHY_RayBatchHit> hits;
+	m_physicsEnvironment->RayTestBatch(batch, filterCallback, hits);
+
+	PyObject *list = PyList_New(hits.size());
+	for (unsigned int i = 0, size = hits.size(); i < size; ++i) {
+		const PHY_RayBatchHit& hit = hits[i];
+		PyObject *item;
+		if (hit.m_controller) {
+			KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(hit.m_controller->GetNewClientInfo());
+			item = PyTuple_New(3);
+			PyTuple_SET_ITEM(item, 0, info->m_gameobject->GetProxy());
+			PyTuple_SET_ITEM(item, 1, PyObjectFrom(MT_Vector3(hit.m_hitPoint)));
+			PyTuple_SET_ITEM(item, 2, PyObjectFrom(MT_Vector3(hit.m_hitNormal)));
+		}
+		else {
+			item = Py_None;
+			Py_INCREF(item);
+		}
+		PyList_SET_ITEM(list, i, item);
+	}
+
+	return list;
+}
+
 /* Matches python dict.get(key, [default]) */
 EXP_PYMETHODDEF_DOC(KX_Scene, get, "")
 {
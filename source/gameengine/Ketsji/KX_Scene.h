@@ -36,10 +36,16 @@
 #include "KX_PhysicsEngineEnums.h"
 #include "KX_TextureRendererManager.h" // For KX_TextureRendererManager::RendererCategory.
 #include "KX_CullingNode.h" // For KX_CullingNodeList.
+#include "KX_CullingHandler.h"
+#include "KX_ActivityCullingHandler.h"
+#include "KX_LodHandler.h"
+#include "KX_DeformerScheduler.h"
+#include "KX_AnimationScheduler.h"
 
 #include <vector>
 #include <set>
 #include <list>
+#include <map>
 
 #include "SG_Node.h"
 #include "SG_Frustum.h"
@@ -113,11 +119,6 @@ public:
 		MAX_DRAW_CALLBACK
 	};
 
-	struct AnimationPoolData
-	{
-		double curtime;
-	};
-
 private:
 	Py_Header
 
@@ -160,6 +161,20 @@ protected:
 	/// All animated objects, no need of EXP_ListValue because the list isn't exposed in python.
 	std::vector<KX_GameObject *> m_animatedlist;
 
+	/// Removed replicas of an object kept to be reused by the next additions of this object.
+	struct SpawnPool
+	{
+		/// Maximum number of parked replicas.
+		unsigned int m_size;
+		/// Parked replicas, each one owns a reference.
+		std::vector<KX_GameObject *> m_objects;
+	};
+
+	/// Spawn pools indexed by their original object.
+	std::map<KX_GameObject *, SpawnPool> m_spawnPools;
+	/// Original object of the active and parked replicas of the objects using a spawn pool.
+	std::map<KX_GameObject *, KX_GameObject *> m_spawnedObjects;
+
 	/// The set of cameras for this scene
 	EXP_ListValue<KX_Camera> *m_cameralist;
 	/// The set of fonts for this scene
@@ -263,7 +278,7 @@ protected:
 	double m_suspendeddelta;
 
 	/**
-	 * Radius in Manhattan distance of the box for activity culling.
+	 * Radius around the cameras of the activity culling, added to the bounding radius of the objects.
 	 */
 	float m_activity_box_radius;
 
@@ -305,8 +320,17 @@ protected:
 
 	KX_ObstacleSimulation* m_obstacleSimulation;
 
-	AnimationPoolData m_animationPoolData;
 	TaskPool *m_animationPool;
+	/// Animations updated in parallel by the animation pool.
+	KX_AnimationScheduler m_animationScheduler;
+	/// Deformers updated after the animations.
+	KX_DeformerScheduler m_deformerScheduler;
+	/// Frustum culling used when the DBVT culling is disabled.
+	KX_CullingHandler m_cullingHandler;
+	/// Suspension of the objects far from the cameras.
+	KX_ActivityCullingHandler m_activityCullingHandler;
+	/// Level of detail selection of the visible objects.
+	KX_LodHandler m_lodHandler;
 
 	/**
 	 * LOD Hysteresis settings
@@ -357,6 +381,19 @@ public:
 
 	void AddAnimatedObject(KX_GameObject *gameobj);
 
+	/** Set the maximum number of removed replicas of an object kept to be reused
+	 * by AddReplicaObject, zero disables the pool and frees the parked replicas.
+	 * \return False if the object can't use a spawn pool: only mesh objects
+	 * without children, dupli group or python components are supported.
+	 */
+	bool SetSpawnPoolSize(KX_GameObject *gameobj, unsigned int size);
+	unsigned int GetSpawnPoolSize(KX_GameObject *gameobj) const;
+
+	/** Set the distances from the cameras from which the armatures poses are evaluated
+	 * at half and quarter rate, zero disables a rate.
+	 */
+	void SetAnimationLodDistances(float halfRateDistance, float quarterRateDistance);
+
 	/**
 	 * \section Logic stuff
 	 * Initiate an update of the logic system.
@@ -364,6 +401,10 @@ public:
 	void LogicBeginFrame(double curtime, double framestep);
 	void LogicUpdateFrame(double curtime);
 	void UpdateAnimations(double curtime);
+	/** Return true if an animated object has a physics controller or children,
+	 * its animation then writes data read by the physics step.
+	 */
+	bool AnimationsUsePhysics() const;
 
 		void
 	LogicEndFrame(
@@ -471,6 +512,8 @@ public:
 
 	void SetWorldInfo(class KX_WorldInfo* wi);
 	KX_WorldInfo* GetWorldInfo();
+	/// Start the culling passes of a frame, the objects are culled for the frame until a pass sees them.
+	void BeginCullingFrame();
 	void CalculateVisibleMeshes(KX_CullingNodeList& nodes, KX_Camera *cam, int layer);
 	void CalculateVisibleMeshes(KX_CullingNodeList& nodes, const SG_Frustum& frustum, int layer);
 
@@ -483,6 +526,17 @@ public:
 	 */
 
 	void ReplicateLogic(class KX_GameObject* newobj);
+
+	/// Remove the bricks of an object from the logic and time managers.
+	void UnregisterObjectLogic(KX_GameObject *gameobj);
+	/** Disable a removed replica and keep it in the spawn pool of its original object.
+	 * \return False if the replica must be destructed normally.
+	 */
+	bool ParkObject(KX_GameObject *gameobj);
+	/// Reactivate the last parked replica of a spawn pool as AddNodeReplicaObject does for a new replica.
+	KX_GameObject *RespawnObject(KX_GameObject *originalobj, SpawnPool& pool);
+	/// Destruct the parked replicas of an object and forget its replicas.
+	void ClearSpawnPool(KX_GameObject *originalobj);
 	static SG_Callbacks	m_callbacks;
 
 	// Suspend the entire scene.
@@ -500,7 +554,10 @@ public:
 	void SetLodHysteresisValue(int hysteresisvalue);
 	int GetLodHysteresisValue();
 	
-	// Update the activity box settings for objects in this scene, if needed.
+	/// Get the world positions of the active camera and the cameras rendering a viewport.
+	void GetActiveCameraPositions(std::vector<MT_Vector3>& positions) const;
+
+	// Suspend the objects out of the activity radius of the cameras and resume the others.
 	void UpdateObjectActivity(void);
 
 	// Enable/disable activity culling.
@@ -557,6 +614,11 @@ public:
 	EXP_PYMETHOD_DOC(KX_Scene, resume);
 	EXP_PYMETHOD_DOC(KX_Scene, get);
 	EXP_PYMETHOD_DOC(KX_Scene, drawObstacleSimulation);
+	EXP_PYMETHOD_DOC(KX_Scene, rayCastBatch);
+	EXP_PYMETHOD_DOC(KX_Scene, setSpawnPoolSize);
+	EXP_PYMETHOD_DOC(KX_Scene, getSpawnPoolSize);
+	EXP_PYMETHOD_DOC(KX_Scene, setAnimationLodDistances);
+	EXP_PYMETHOD_DOC_NOARGS(KX_Scene, getAnimationLodDistances);
 
 
 	/* attributes */
@@ -585,6 +647,8 @@ public:
 	 * Run the registered python drawing functions.
 	 */
 	void RunDrawingCallbacks(DrawingCallbackType callbackType, KX_Camera *camera);
+	/// Return true if python drawing functions are registered for this type.
+	bool HasDrawingCallbacks(DrawingCallbackType callbackType) const;
 #endif
 
 	/**
@@ -602,7 +666,13 @@ public:
 	 */
 	struct Scene *GetBlenderScene() { return m_blenderScene; }
 
-	bool MergeScene(KX_Scene *other);
+	/** Merge the objects and managers of an other scene into this scene.
+	 * \param mergeBuckets Merge the material buckets, when false the objects of
+	 * the other scene are not rendered until a call to MergeSceneBuckets.
+	 */
+	bool MergeScene(KX_Scene *other, bool mergeBuckets);
+	/// Merge the material buckets of an other scene, once their shaders are initialized.
+	void MergeSceneBuckets(KX_Scene *other);
 
 
 	//void PrintStats(int verbose_level) {
@@ -67,6 +67,7 @@ KX_SteeringActuator::KX_SteeringActuator(SCA_IObject *gameobj,
       m_turnspeed(turnspeed),
       m_simulation(simulation),
       m_updateTime(0),
+      m_steeringDelta(0.0),
       m_obstacle(nullptr),
       m_isActive(false),
       m_isSelfTerminated(isSelfTerminated),
@@ -270,35 +271,21 @@ bool KX_SteeringActuator::Update(double curtime)
 			m_steerVec.normalize();
 		MT_Vector3 newvel = m_velocity * m_steerVec;
 
+		m_steeringDelta = delta;
+
 		//adjust velocity to avoid obstacles
 		if (m_simulation && m_obstacle /*&& !newvel.fuzzyZero()*/)
 		{
 			if (m_enableVisualization)
 				KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(1.0f, 0.0f, 0.0f, 1.0f));
-			m_simulation->AdjustObstacleVelocity(m_obstacle, m_mode!=KX_STEERING_PATHFOLLOWING ? m_navmesh : nullptr,
+			// The velocity is adjusted with the other agents and applied at the end of the actuators update.
+			obj->ResetLinearMotionSet();
+			m_simulation->AddAgent(this, m_obstacle, m_mode!=KX_STEERING_PATHFOLLOWING ? m_navmesh : nullptr,
 							newvel, m_acceleration*(float)delta, m_turnspeed/(180.0f*(float)(M_PI*delta)));
-			if (m_enableVisualization)
-				KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(0.0f, 1.0f, 0.0f, 1.0f));
-		}
-
-		HandleActorFace(newvel);
-		if (isdyna)
-		{
-			//temporary solution: set 2D steering velocity directly to obj
-			//correct way is to apply physical force
-			MT_Vector3 curvel = obj->GetLinearVelocity();
-
-			if (m_lockzvel)
-				newvel.z() = 0.0f;
-			else
-				newvel.z() = curvel.z();
-
-			obj->setLinearVelocity(newvel, false);
 		}
 		else
 		{
-			MT_Vector3 movement = delta*newvel;
-			obj->ApplyMovement(movement, false);
+			ApplySteering(newvel);
 		}
 	}
 	else
@@ -317,6 +304,44 @@ bool KX_SteeringActuator::Update(double curtime)
 	return true;
 }
 
+void KX_SteeringActuator::ApplySteering(const MT_Vector3& velocity)
+{
+	KX_GameObject *obj = (KX_GameObject*) GetParent();
+	MT_Vector3 newvel = velocity;
+
+	if (m_enableVisualization && m_simulation && m_obstacle)
+	{
+		const MT_Vector3& mypos = obj->NodeGetWorldPosition();
+		KX_RasterizerDrawDebugLine(mypos, mypos + newvel, MT_Vector4(0.0f, 1.0f, 0.0f, 1.0f));
+	}
+
+	HandleActorFace(newvel);
+
+	/* An actuator updated after this one in the frame moved the object or set its velocity,
+	 * the motion of the last actuator is kept as for the actuators updated before. */
+	if (m_simulation && m_obstacle && obj->IsLinearMotionSet())
+		return;
+
+	if (obj->IsDynamic())
+	{
+		//temporary solution: set 2D steering velocity directly to obj
+		//correct way is to apply physical force
+		MT_Vector3 curvel = obj->GetLinearVelocity();
+
+		if (m_lockzvel)
+			newvel.z() = 0.0f;
+		else
+			newvel.z() = curvel.z();
+
+		obj->setLinearVelocity(newvel, false);
+	}
+	else
+	{
+		MT_Vector3 movement = m_steeringDelta*newvel;
+		obj->ApplyMovement(movement, false);
+	}
+}
+
 const MT_Vector3& KX_SteeringActuator::GetSteeringVec()
 {
 	static MT_Vector3 ZERO_VECTOR(0, 0, 0);
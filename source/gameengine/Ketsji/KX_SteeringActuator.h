@@ -52,6 +52,8 @@ class KX_SteeringActuator : public SCA_IActuator
 	KX_ObstacleSimulation* m_simulation;
 	
 	double m_updateTime;
+	/// Time step of the steering velocity waiting for the crowd update.
+	double m_steeringDelta;
 	KX_Obstacle* m_obstacle;
 	bool m_isActive;
 	bool m_isSelfTerminated;
@@ -101,6 +103,10 @@ public:
 	virtual void Relink(std::map<SCA_IObject *, SCA_IObject *>& obj_map);
 	virtual bool UnlinkObject(SCA_IObject* clientobj);
 	const MT_Vector3& GetSteeringVec();
+	/** Apply the steering velocity to the object, after the adjustment of the obstacle simulation.
+	 * The linear velocity or movement set by an actuator updated after this one in the same frame is kept.
+	 */
+	void ApplySteering(const MT_Vector3& velocity);
 
 #ifdef WITH_PYTHON
 
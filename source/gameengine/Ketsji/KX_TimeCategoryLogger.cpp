@@ -63,6 +63,16 @@ void KX_TimeCategoryLogger::AddCategory(TimeCategory tc)
 	}
 }
 
+void KX_TimeCategoryLogger::SetOverlapCategory(TimeCategory tc, bool overlap)
+{
+	if (overlap) {
+		m_overlapCategories.insert(tc);
+	}
+	else {
+		m_overlapCategories.erase(tc);
+	}
+}
+
 void KX_TimeCategoryLogger::StartLog(TimeCategory tc, double now)
 {
 	if (m_lastCategory != -1) {
@@ -83,6 +93,16 @@ void KX_TimeCategoryLogger::EndLog(double now)
 	m_lastCategory = -1;
 }
 
+void KX_TimeCategoryLogger::AddTime(TimeCategory tc, double time)
+{
+	m_loggers[tc].AddTime(time);
+}
+
+KX_TimeCategoryLogger::TimeCategory KX_TimeCategoryLogger::GetCurrentCategory() const
+{
+	return m_lastCategory;
+}
+
 void KX_TimeCategoryLogger::NextMeasurement(double now)
 {
 	for (TimeLoggerMap::value_type& pair : m_loggers) {
@@ -100,7 +120,27 @@ double KX_TimeCategoryLogger::GetAverage()
 	double time = 0.0;
 
 	for (TimeLoggerMap::value_type& pair : m_loggers) {
-		time += pair.second.GetAverage();
+		if (m_overlapCategories.find(pair.first) == m_overlapCategories.end()) {
+			time += pair.second.GetAverage();
+		}
+	}
+
+	return time;
+}
+
+double KX_TimeCategoryLogger::GetLastMeasurement(TimeCategory tc)
+{
+	return m_loggers[tc].GetLastMeasurement();
+}
+
+double KX_TimeCategoryLogger::GetLastMeasurement()
+{
+	double time = 0.0;
+
+	for (TimeLoggerMap::value_type& pair : m_loggers) {
+		if (m_overlapCategories.find(pair.first) == m_overlapCategories.end()) {
+			time += pair.second.GetLastMeasurement();
+		}
 	}
 
 	return time;
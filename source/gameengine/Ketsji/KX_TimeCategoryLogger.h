@@ -37,6 +37,7 @@
 #endif
 
 #include <map>
+#include <set>
 
 #include "KX_TimeLogger.h"
 
@@ -79,6 +80,14 @@ public:
 	 */
 	void AddCategory(TimeCategory tc);
 
+	/**
+	 * Sets if a category overlaps the others, e.g. time spent in an other thread.
+	 * Overlapping categories are not included in the grand total.
+	 * \param tc		The category.
+	 * \param overlap	True if the category overlaps the others.
+	 */
+	void SetOverlapCategory(TimeCategory tc, bool overlap);
+
 	/**
 	 * Starts logging in current measurement for the given category.
 	 * \param tc					The category to log to.
@@ -99,6 +108,18 @@ public:
 	 */
 	void EndLog(double now);
 
+	/**
+	 * Adds a duration measured externally to the current measurement of the given category.
+	 * \param tc	The category to log to.
+	 * \param time	The duration to add.
+	 */
+	void AddTime(TimeCategory tc, double time);
+
+	/**
+	 * Returns the category currently logged, -1 if none.
+	 */
+	TimeCategory GetCurrentCategory() const;
+
 	/**
 	 * Logs time in next measurement.
 	 * \param now	The current time.
@@ -112,13 +133,25 @@ public:
 	double GetAverage(TimeCategory tc);
 
 	/**
-	 * Returns average for grand total.
+	 * Returns average for grand total, overlapping categories excepted.
 	 */
 	double GetAverage();
 
+	/**
+	 * Returns the last complete measurement of the given category.
+	 */
+	double GetLastMeasurement(TimeCategory tc);
+
+	/**
+	 * Returns the last complete measurement for grand total, overlapping categories excepted.
+	 */
+	double GetLastMeasurement();
+
 protected:
 	/// Storage for the loggers.
 	TimeLoggerMap m_loggers;
+	/// Categories not included in the grand total.
+	std::set<TimeCategory> m_overlapCategories;
 	/// Maximum number of measurements.
 	unsigned int m_maxNumMeasurements;
 
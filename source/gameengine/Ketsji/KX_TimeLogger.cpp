@@ -75,6 +75,13 @@ void KX_TimeLogger::EndLog(double now)
 	}
 }
 
+void KX_TimeLogger::AddTime(double time)
+{
+	if (!m_measurements.empty()) {
+		m_measurements[0] += time;
+	}
+}
+
 void KX_TimeLogger::NextMeasurement(double now)
 {
 	// End logging to current measurement
@@ -106,3 +113,12 @@ double KX_TimeLogger::GetAverage() const
 
 	return avg;
 }
+
+double KX_TimeLogger::GetLastMeasurement() const
+{
+	if (m_measurements.size() > 1) {
+		return m_measurements[1];
+	}
+
+	return 0.0;
+}
@@ -77,6 +77,12 @@ public:
 	 */
 	void EndLog(double now);
 
+	/**
+	 * Adds a duration measured externally to the current measurement.
+	 * \param time	The duration to add.
+	 */
+	void AddTime(double time);
+
 	/**
 	 * Logs time in next measurement.
 	 * \param now	The current time.
@@ -89,6 +95,11 @@ public:
 	 */
 	double GetAverage() const;
 
+	/**
+	 * Returns the last complete measurement, the one before the current measurement.
+	 */
+	double GetLastMeasurement() const;
+
 protected:
 	/// Storage for the measurements.
 	std::deque<double> m_measurements;
@@ -48,6 +48,8 @@
 
 #include "KX_NetworkMessageManager.h"
 
+#include "EXP_PropertyKey.h"
+
 #ifdef WITH_PYTHON
 #  include "Texture.h" // For FreeAllTextures.
 #endif  // WITH_PYTHON
@@ -61,6 +63,7 @@
 #include "DEV_Joystick.h"
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 extern "C" {
 #  include "GPU_extensions.h"
@@ -68,6 +71,9 @@ extern "C" {
 #  include "BKE_sound.h"
 #  include "BKE_main.h"
 
+#  include "BLI_path_util.h"
+#  include "BLI_string.h"
+
 #  include "DNA_scene_types.h"
 #  include "DNA_material_types.h"
 
@@ -104,6 +110,7 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system, Main *maggie, Scene *scene, Glob
 	m_argv(argv)
 {
 	m_pythonConsole.use = false;
+	m_benchmark.use = false;
 }
 
 LA_Launcher::~LA_Launcher()
@@ -154,14 +161,34 @@ void LA_Launcher::InitEngine()
 	short showShadowFrustum = SYS_GetCommandLineInt(syshandle, "show_shadow_frustum", gm.showShadowFrustum);
 	bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
 	bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+	bool pipelinedPhysics = (SYS_GetCommandLineInt(syshandle, "pipelined_physics", 0) != 0);
+	bool parallelScenes = (SYS_GetCommandLineInt(syshandle, "parallel_scenes", 0) != 0);
 
+	m_benchmark.frames = SYS_GetCommandLineInt(syshandle, "benchmark", 0);
+	m_benchmark.use = (m_benchmark.frames > 0);
+	m_benchmark.filepath = SYS_GetCommandLineString(syshandle, "benchmark_output", "benchmark.json");
+
+	/* The benchmark frames are proceeded on a clock advanced by a fixed time step
+	 * to be independent of the real time. */
 	const KX_KetsjiEngine::FlagType flags = (KX_KetsjiEngine::FlagType)
-		((fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
+		((m_benchmark.use ? (KX_KetsjiEngine::FIXED_FRAMERATE | KX_KetsjiEngine::USE_EXTERNAL_CLOCK) : 0) |
+		(fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
 		(frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
 		(renderQueries ? KX_KetsjiEngine::SHOW_RENDER_QUERIES : 0) |
 		(restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
 		(properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
-		(profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
+		(profile ? KX_KetsjiEngine::SHOW_PROFILE : 0) |
+		(pipelinedPhysics ? KX_KetsjiEngine::PIPELINED_PHYSICS : 0) |
+		(parallelScenes ? KX_KetsjiEngine::PARALLEL_SCENES : 0));
+
+	// Capture the first frames in a trace file, relative to the blend file as in python.
+	const std::string profileCapture = SYS_GetCommandLineString(syshandle, "profile_capture", "");
+	if (!profileCapture.empty()) {
+		char expanded[FILE_MAX];
+		BLI_strncpy(expanded, profileCapture.c_str(), FILE_MAX);
+		BLI_path_abs(expanded, m_maggie->name);
+		CM_Profiler::StartCapture(expanded, SYS_GetCommandLineInt(syshandle, "profile_capture_frames", 1));
+	}
 
 	// Setup python console keys used as shortcut.
 	for (unsigned short i = 0; i < 4; ++i) {
@@ -257,7 +284,9 @@ void LA_Launcher::InitEngine()
 #endif
 
 	m_ketsjiEngine->SetFlag(flags, true);
-	m_ketsjiEngine->SetRender(true);
+	/* The benchmark measures the logic, physics, scene graph, culling, levels of detail and animations,
+	 * the drawing and the mesh deformers are skipped. */
+	m_ketsjiEngine->SetRender(!m_benchmark.use);
 	m_ketsjiEngine->SetShowBoundingBox((KX_DebugOption)showBoundingBox);
 	m_ketsjiEngine->SetShowArmatures((KX_DebugOption)showArmatures);
 	m_ketsjiEngine->SetShowCameraFrustum((KX_DebugOption)showCameraFrustum);
@@ -313,6 +342,11 @@ void LA_Launcher::InitEngine()
 	 */
 	Scene *scene = m_kxStartScene->GetBlenderScene(); // needed for macro
 	m_ketsjiEngine->SetAnimFrameRate(FPS);
+
+	if (m_benchmark.use) {
+		CM_Message("benchmark of " << m_benchmark.frames << " frames");
+		m_ketsjiEngine->StartBenchmark();
+	}
 }
 
 
@@ -325,6 +359,10 @@ void LA_Launcher::ExitEngine()
 	DEV_Joystick::Close();
 	m_ketsjiEngine->StopEngine();
 
+	if (m_benchmark.use) {
+		m_ketsjiEngine->WriteBenchmark(m_benchmark.filepath);
+	}
+
 #ifdef WITH_PYTHON
 
 	/* Clears the dictionary by hand:
@@ -389,6 +427,9 @@ void LA_Launcher::ExitEngine()
 	// Call this after we're sure nothing needs Python anymore (e.g., destructors).
 	ExitPython();
 
+	// All the values are freed, the property names of this game are not used anymore.
+	EXP_PropertyKey::ReleaseNames();
+
 #ifdef WITH_AUDASPACE
 	// Stop all remaining playing sounds.
 	AUD_Device_stopAll(BKE_sound_get_device());
@@ -491,9 +532,18 @@ bool LA_Launcher::EngineNextFrame()
 	// Check if we can create a python console debugging.
 	HandlePythonConsole();
 #endif
+	if (m_benchmark.use) {
+		// Proceed exactly one logic frame.
+		m_ketsjiEngine->SetClockTime(m_ketsjiEngine->GetClockTime() + m_ketsjiEngine->GetTimeScale() / m_ketsjiEngine->GetTicRate());
+	}
+
 	// Kick the engine.
 	bool renderFrame = m_ketsjiEngine->NextFrame();
 
+	if (m_benchmark.use && --m_benchmark.frames == 0) {
+		m_ketsjiEngine->RequestExit(KX_ExitRequest::QUIT_GAME);
+	}
+
 	// First check if we want to exit.
 	m_exitRequested = m_ketsjiEngine->GetExitCode();
 	m_exitString = m_ketsjiEngine->GetExitString();
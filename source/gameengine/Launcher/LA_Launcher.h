@@ -107,6 +107,15 @@ protected:
 		std::vector<SCA_IInputDevice::SCA_EnumInputs> keys;
 	} m_pythonConsole;
 
+	/// Benchmark mode, a fixed number of frames is proceeded on a fixed time step without render.
+	struct Benchmark {
+		bool use;
+		/// Number of frames left.
+		int frames;
+		/// The file the frame times are written to.
+		std::string filepath;
+	} m_benchmark;
+
 #ifdef WITH_PYTHON
 	void HandlePythonConsole();
 #endif  // WITH_PYTHON
@@ -0,0 +1,307 @@
+/*
+   Bullet Continuous Collision Detection and Physics Library
+   Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+
+   This software is provided 'as-is', without any express or implied warranty.
+   In no event will the authors be held liable for any damages arising from the use of this software.
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it freely,
+   subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+ */
+
+/** \file gameengine/Physics/Bullet/CcdDynamicsWorld.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdDynamicsWorld.h"
+
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+
+#include <algorithm>
+
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+/// Number of rigid bodies integrated in a task.
+#define CCD_BODY_TASK_SIZE 128
+/// Minimum number of rigid bodies to integrate them in several threads.
+#define CCD_PARALLEL_MIN_BODIES 512
+
+/// Island of a constraint, as computed by btDiscreteDynamicsWorld.
+static int GetConstraintIslandId(const btTypedConstraint *constraint)
+{
+	const btCollisionObject& colObj0 = constraint->getRigidBodyA();
+	const btCollisionObject& colObj1 = constraint->getRigidBodyB();
+	return (colObj0.getIslandTag() >= 0) ? colObj0.getIslandTag() : colObj1.getIslandTag();
+}
+
+static bool ConstraintIslandLess(const btTypedConstraint *lhs, const btTypedConstraint *rhs)
+{
+	return GetConstraintIslandId(lhs) < GetConstraintIslandId(rhs);
+}
+
+/** Return true if the object is converted to a solver body by the constraint
+ * solver while it is not part of the island.
+ */
+static bool IsSharedSolverBody(const btCollisionObject *object, int islandId)
+{
+	const btRigidBody *body = btRigidBody::upcast(object);
+	return (body && (body->getInvMass() != 0.0f || body->isKinematicObject()) && body->getIslandTag() != islandId);
+}
+
+class CcdDynamicsWorld::IslandGatherCallback : public btSimulationIslandManager::IslandCallback
+{
+private:
+	CcdDynamicsWorld *m_world;
+
+public:
+	IslandGatherCallback(CcdDynamicsWorld *world)
+		:m_world(world)
+	{
+	}
+
+	virtual void processIsland(btCollisionObject **bodies, int numBodies, btPersistentManifold **manifolds, int numManifolds, int islandId)
+	{
+		const std::vector<btTypedConstraint *>& constraints = m_world->m_islandConstraints;
+
+		Island island;
+		island.m_bodyStart = m_world->m_islandBodies.size();
+		island.m_numBodies = numBodies;
+		island.m_manifolds = manifolds;
+		island.m_numManifolds = numManifolds;
+		island.m_shared = false;
+
+		m_world->m_islandBodies.insert(m_world->m_islandBodies.end(), bodies, bodies + numBodies);
+
+		// The constraints are sorted by island.
+		std::vector<btTypedConstraint *>::const_iterator begin = constraints.begin();
+		while (begin != constraints.end() && GetConstraintIslandId(*begin) < islandId) {
+			++begin;
+		}
+		std::vector<btTypedConstraint *>::const_iterator end = begin;
+		while (end != constraints.end() && GetConstraintIslandId(*end) == islandId) {
+			if (IsSharedSolverBody(&(*end)->getRigidBodyA(), islandId) || IsSharedSolverBody(&(*end)->getRigidBodyB(), islandId)) {
+				island.m_shared = true;
+			}
+			++end;
+		}
+		island.m_constraintStart = begin - constraints.begin();
+		island.m_numConstraints = end - begin;
+
+		for (int i = 0; i < numManifolds && !island.m_shared; ++i) {
+			if (IsSharedSolverBody(manifolds[i]->getBody0(), islandId) || IsSharedSolverBody(manifolds[i]->getBody1(), islandId)) {
+				island.m_shared = true;
+			}
+		}
+
+		m_world->m_islands.push_back(island);
+	}
+};
+
+CcdDynamicsWorld::CcdDynamicsWorld(btDispatcher *dispatcher, btBroadphaseInterface *pairCache, btConstraintSolver *constraintSolver,
+		btCollisionConfiguration *collisionConfiguration)
+	:btSoftRigidDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+	m_useMultithreading(false)
+{
+}
+
+CcdDynamicsWorld::~CcdDynamicsWorld()
+{
+	for (btSequentialImpulseConstraintSolver *solver : m_islandSolvers) {
+		delete solver;
+	}
+}
+
+bool CcdDynamicsWorld::GetUseMultithreading() const
+{
+	return m_useMultithreading;
+}
+
+void CcdDynamicsWorld::SetUseMultithreading(bool use)
+{
+	m_useMultithreading = use;
+}
+
+bool CcdDynamicsWorld::UseParallelSolving() const
+{
+	// The island tasks use their own sequential impulse solvers.
+	return (m_useMultithreading && m_constraintSolver->getSolverType() == BT_SEQUENTIAL_IMPULSE_SOLVER &&
+			m_islandManager->getSplitIslands());
+}
+
+struct CcdIntegrateTaskData
+{
+	const btAlignedObjectArray<btRigidBody *> *bodies;
+	btScalar timeStep;
+};
+
+void CcdDynamicsWorld::PredictMotionTask(void *userdata, const int iter)
+{
+	const CcdIntegrateTaskData *data = (CcdIntegrateTaskData *)userdata;
+	const btAlignedObjectArray<btRigidBody *>& bodies = *data->bodies;
+
+	const int start = iter * CCD_BODY_TASK_SIZE;
+	const int end = std::min(start + CCD_BODY_TASK_SIZE, bodies.size());
+	for (int i = start; i < end; ++i) {
+		btRigidBody *body = bodies[i];
+		if (!body->isStaticOrKinematicObject()) {
+			body->applyDamping(data->timeStep);
+			body->predictIntegratedTransform(data->timeStep, body->getInterpolationWorldTransform());
+		}
+	}
+}
+
+void CcdDynamicsWorld::IntegrateTransformsTask(void *userdata, const int iter)
+{
+	const CcdIntegrateTaskData *data = (CcdIntegrateTaskData *)userdata;
+	const btAlignedObjectArray<btRigidBody *>& bodies = *data->bodies;
+
+	const int start = iter * CCD_BODY_TASK_SIZE;
+	const int end = std::min(start + CCD_BODY_TASK_SIZE, bodies.size());
+	for (int i = start; i < end; ++i) {
+		btRigidBody *body = bodies[i];
+		body->setHitFraction(1.0f);
+		if (body->isActive() && !body->isStaticOrKinematicObject()) {
+			btTransform predictedTrans;
+			body->predictIntegratedTransform(data->timeStep, predictedTrans);
+			body->proceedToTransform(predictedTrans);
+		}
+	}
+}
+
+void CcdDynamicsWorld::predictUnconstraintMotion(btScalar timeStep)
+{
+	const int count = m_nonStaticRigidBodies.size();
+	if (!m_useMultithreading || count < CCD_PARALLEL_MIN_BODIES) {
+		btSoftRigidDynamicsWorld::predictUnconstraintMotion(timeStep);
+		return;
+	}
+
+	m_parallelBodies.copyFromArray(m_nonStaticRigidBodies);
+
+	CcdIntegrateTaskData data;
+	data.bodies = &m_parallelBodies;
+	data.timeStep = timeStep;
+
+	const int tasks = (count + CCD_BODY_TASK_SIZE - 1) / CCD_BODY_TASK_SIZE;
+	BLI_task_parallel_range(0, tasks, &data, PredictMotionTask, true);
+
+	// Let the base world predict the soft bodies motion only.
+	m_nonStaticRigidBodies.resize(0);
+	btSoftRigidDynamicsWorld::predictUnconstraintMotion(timeStep);
+	m_nonStaticRigidBodies.copyFromArray(m_parallelBodies);
+}
+
+void CcdDynamicsWorld::integrateTransforms(btScalar timeStep)
+{
+	const int count = m_nonStaticRigidBodies.size();
+	if (!m_useMultithreading || count < CCD_PARALLEL_MIN_BODIES) {
+		btSoftRigidDynamicsWorld::integrateTransforms(timeStep);
+		return;
+	}
+
+	/* The motion clamping of the bodies using CCD sweeps a sphere in the broadphase
+	 * which is not thread safe, these bodies are integrated by the base world. */
+	m_allBodies.copyFromArray(m_nonStaticRigidBodies);
+	m_parallelBodies.resize(0);
+	m_ccdBodies.resize(0);
+	const bool useContinuous = getDispatchInfo().m_useContinuous;
+	for (int i = 0; i < count; ++i) {
+		btRigidBody *body = m_allBodies[i];
+		if (useContinuous && body->getCcdSquareMotionThreshold() != 0.0f) {
+			m_ccdBodies.push_back(body);
+		}
+		else {
+			m_parallelBodies.push_back(body);
+		}
+	}
+
+	CcdIntegrateTaskData data;
+	data.bodies = &m_parallelBodies;
+	data.timeStep = timeStep;
+
+	const int tasks = (m_parallelBodies.size() + CCD_BODY_TASK_SIZE - 1) / CCD_BODY_TASK_SIZE;
+	BLI_task_parallel_range(0, tasks, &data, IntegrateTransformsTask, true);
+
+	m_nonStaticRigidBodies.copyFromArray(m_ccdBodies);
+	btSoftRigidDynamicsWorld::integrateTransforms(timeStep);
+	m_nonStaticRigidBodies.copyFromArray(m_allBodies);
+}
+
+struct CcdSolveIslandTaskData
+{
+	CcdDynamicsWorld *world;
+	const btContactSolverInfo *solverInfo;
+};
+
+void CcdDynamicsWorld::SolveIslandTask(void *userdata, void *userdata_chunk, const int iter, const int thread_id)
+{
+	const CcdSolveIslandTaskData *data = (CcdSolveIslandTaskData *)userdata;
+	CcdDynamicsWorld *world = data->world;
+
+	const Island& island = world->m_islands[world->m_parallelIslands[iter]];
+	world->SolveIsland(world->m_islandSolvers[thread_id], island, *data->solverInfo);
+}
+
+void CcdDynamicsWorld::SolveIsland(btSequentialImpulseConstraintSolver *solver, const Island& island, const btContactSolverInfo& solverInfo)
+{
+	btCollisionObject **bodies = island.m_numBodies ? &m_islandBodies[island.m_bodyStart] : nullptr;
+	btTypedConstraint **constraints = island.m_numConstraints ? &m_islandConstraints[island.m_constraintStart] : nullptr;
+
+	// Don't depend on the islands previously solved by this thread.
+	solver->setRandSeed(0);
+	solver->solveGroup(bodies, island.m_numBodies, island.m_manifolds, island.m_numManifolds, constraints,
+			island.m_numConstraints, solverInfo, m_debugDrawer, m_dispatcher1);
+}
+
+void CcdDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
+{
+	if (!UseParallelSolving()) {
+		btSoftRigidDynamicsWorld::solveConstraints(solverInfo);
+		return;
+	}
+
+	const unsigned int numThreads = BLI_task_scheduler_num_threads(BLI_task_scheduler_get());
+	while (m_islandSolvers.size() < numThreads) {
+		m_islandSolvers.push_back(new btSequentialImpulseConstraintSolver());
+	}
+
+	m_islandConstraints.resize(m_constraints.size());
+	for (int i = 0, size = m_constraints.size(); i < size; ++i) {
+		m_islandConstraints[i] = m_constraints[i];
+	}
+	std::stable_sort(m_islandConstraints.begin(), m_islandConstraints.end(), ConstraintIslandLess);
+
+	m_islands.clear();
+	m_islandBodies.clear();
+
+	IslandGatherCallback callback(this);
+	m_islandManager->buildAndProcessIslands(m_dispatcher1, this, &callback);
+
+	m_parallelIslands.clear();
+	for (unsigned int i = 0, size = m_islands.size(); i < size; ++i) {
+		if (!m_islands[i].m_shared) {
+			m_parallelIslands.push_back(i);
+		}
+	}
+
+	CcdSolveIslandTaskData data;
+	data.world = this;
+	data.solverInfo = &solverInfo;
+
+	const unsigned int numParallel = m_parallelIslands.size();
+	BLI_task_parallel_range_ex(0, numParallel, &data, nullptr, 0, SolveIslandTask, (numParallel > 1), true);
+
+	// The islands sharing a kinematic object are solved in their build order on this thread.
+	for (const Island& island : m_islands) {
+		if (island.m_shared) {
+			SolveIsland(m_islandSolvers[0], island, solverInfo);
+		}
+	}
+}
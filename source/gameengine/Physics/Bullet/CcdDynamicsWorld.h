@@ -0,0 +1,92 @@
+/*
+   Bullet Continuous Collision Detection and Physics Library
+   Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+
+   This software is provided 'as-is', without any express or implied warranty.
+   In no event will the authors be held liable for any damages arising from the use of this software.
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it freely,
+   subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+ */
+
+/** \file CcdDynamicsWorld.h
+ *  \ingroup physbullet
+ */
+
+#ifndef __CCDDYNAMICSWORLD_H__
+#define __CCDDYNAMICSWORLD_H__
+
+#include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+
+#include <vector>
+
+class btSequentialImpulseConstraintSolver;
+
+/** Dynamics world able to run the rigid body integration and the island solving on several threads.
+ * The islands are solved in their build order, each with a solver owned by the thread and reset
+ * before every island, so the result doesn't depend on the thread scheduling. Islands touching a
+ * kinematic object share its solver body and are solved after on the calling thread.
+ * Collision detection and the soft bodies are unchanged.
+ */
+class CcdDynamicsWorld : public btSoftRigidDynamicsWorld
+{
+private:
+	/// Range of an island in the gathered bodies, manifolds and constraints.
+	struct Island
+	{
+		unsigned int m_bodyStart;
+		unsigned int m_numBodies;
+		btPersistentManifold **m_manifolds;
+		unsigned int m_numManifolds;
+		unsigned int m_constraintStart;
+		unsigned int m_numConstraints;
+		/// The island shares a kinematic object with other islands.
+		bool m_shared;
+	};
+
+	class IslandGatherCallback;
+
+	bool m_useMultithreading;
+
+	std::vector<Island> m_islands;
+	std::vector<btCollisionObject *> m_islandBodies;
+	std::vector<btTypedConstraint *> m_islandConstraints;
+	/// Indices of the islands solved in parallel.
+	std::vector<unsigned int> m_parallelIslands;
+	/// Constraint solvers of the island tasks, indexed by thread.
+	std::vector<btSequentialImpulseConstraintSolver *> m_islandSolvers;
+	/// Non static rigid bodies of the world while only a part of them is passed to the base world.
+	btAlignedObjectArray<btRigidBody *> m_allBodies;
+	/// Rigid bodies integrated by the tasks.
+	btAlignedObjectArray<btRigidBody *> m_parallelBodies;
+	/// Rigid bodies using continuous collision detection, integrated serially.
+	btAlignedObjectArray<btRigidBody *> m_ccdBodies;
+
+	/// Return true when the islands can be solved by the tasks.
+	bool UseParallelSolving() const;
+
+	static void PredictMotionTask(void *userdata, const int iter);
+	static void IntegrateTransformsTask(void *userdata, const int iter);
+	static void SolveIslandTask(void *userdata, void *userdata_chunk, const int iter, const int thread_id);
+
+	void SolveIsland(btSequentialImpulseConstraintSolver *solver, const Island& island, const btContactSolverInfo& solverInfo);
+
+protected:
+	virtual void predictUnconstraintMotion(btScalar timeStep);
+	virtual void integrateTransforms(btScalar timeStep);
+	virtual void solveConstraints(btContactSolverInfo& solverInfo);
+
+public:
+	CcdDynamicsWorld(btDispatcher *dispatcher, btBroadphaseInterface *pairCache, btConstraintSolver *constraintSolver,
+			btCollisionConfiguration *collisionConfiguration);
+	virtual ~CcdDynamicsWorld();
+
+	bool GetUseMultithreading() const;
+	void SetUseMultithreading(bool use);
+};
+
+#endif  // __CCDDYNAMICSWORLD_H__
@@ -40,6 +40,11 @@
 //profiling/timings
 #include "LinearMath/btQuickprof.h"
 
+/* The environments are stepped in parallel (pipelined and parallel scenes physics),
+ * the profile manager of Bullet uses a global current node and is not thread safe.
+ * The bundled Bullet is built with BT_NO_PROFILE, with a Bullet using its profiler
+ * (system Bullet) the steps and the islands are proceeded serially. */
+
 
 #include "PHY_IMotionState.h"
 #include "PHY_ICharacter.h"
@@ -58,6 +63,10 @@
 #include "DNA_object_types.h" // for OB_MAX_COL_MASKS
 #include "DNA_object_force.h"
 
+#include "CM_Profiler.h"
+
+#include "BLI_task.h"
+
 extern "C" {
 	#include "BLI_utildefines.h"
 	#include "BKE_object.h"
@@ -414,6 +423,7 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
 	for (int i = 0; i < PHY_NUM_RESPONSE; i++) {
 		m_triggerCallbacks[i] = nullptr;
 	}
+	m_numCollisionCallbacks = 0;
 
 	m_collisionConfiguration = new btSoftBodyRigidBodyCollisionConfiguration();
 
@@ -435,7 +445,7 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
 
 	SetSolverType(solverType);
 
-	m_dynamicsWorld = new btSoftRigidDynamicsWorld(dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+	m_dynamicsWorld = new CcdDynamicsWorld(dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
 	m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback, this);
 
 	SetGravity(0.0f, 0.0f, -9.81f);
@@ -448,6 +458,11 @@ void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
 		return;
 	}
 
+	// The controller can come from an other environment with its collision callbacks, e.g. with LibLoad.
+	if (ctrl->Registered()) {
+		++m_numCollisionCallbacks;
+	}
+
 	btRigidBody *body = ctrl->GetRigidBody();
 	btCollisionObject *obj = ctrl->GetCollisionObject();
 
@@ -584,6 +599,10 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
 		return false;
 	}
 
+	if (ctrl->Registered()) {
+		--m_numCollisionCallbacks;
+	}
+
 	//also remove constraint
 	btRigidBody *body = ctrl->GetRigidBody();
 	if (body) {
@@ -717,6 +736,37 @@ void CcdPhysicsEnvironment::DebugDrawWorld()
 		m_dynamicsWorld->debugDrawWorld();
 }
 
+bool CcdPhysicsEnvironment::IsRenderIndependent()
+{
+	// Soft bodies vertices are read by KX_SoftBodyDeformer during the rendering.
+	return (m_dynamicsWorld->getSoftBodyArray().size() == 0);
+}
+
+bool CcdPhysicsEnvironment::IsStepCompatible(PHY_IPhysicsEnvironment *other) const
+{
+#ifdef BT_NO_PROFILE
+	const CcdPhysicsEnvironment *env = dynamic_cast<CcdPhysicsEnvironment *>(other);
+	// The environments without Bullet don't use its global variables.
+	return (!env || (env->m_deactivationTime == m_deactivationTime &&
+	                 env->m_contactBreakingThreshold == m_contactBreakingThreshold));
+#else
+	// The profiler of Bullet is not thread safe, no step is proceeded on an other thread.
+	return false;
+#endif
+}
+
+void CcdPhysicsEnvironment::ApplyGlobalSettings()
+{
+	/* Update Bullet global variables, they are written only when they change so the
+	 * compatible steps proceeded in parallel only read them. */
+	if (gDeactivationTime != m_deactivationTime) {
+		gDeactivationTime = m_deactivationTime;
+	}
+	if (gContactBreakingThreshold != m_contactBreakingThreshold) {
+		gContactBreakingThreshold = m_contactBreakingThreshold;
+	}
+}
+
 void CcdPhysicsEnvironment::StaticSimulationSubtickCallback(btDynamicsWorld *world, btScalar timeStep)
 {
 	// Get the pointer to the CcdPhysicsEnvironment associated with this Bullet world.
@@ -735,12 +785,12 @@ void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
 
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
 {
+	CM_ProfileScope scope("Physics step");
+
 	std::set<CcdPhysicsController *>::iterator it;
 	int i;
 
-	// Update Bullet global variables.
-	gDeactivationTime = m_deactivationTime;
-	gContactBreakingThreshold = m_contactBreakingThreshold;
+	ApplyGlobalSettings();
 
 	for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
 		(*it)->SynchronizeMotionStates(timeStep);
@@ -997,6 +1047,15 @@ void CcdPhysicsEnvironment::SetUseEpa(bool epa)
 	//gUseEpa = epa;
 }
 
+void CcdPhysicsEnvironment::SetUseMultithreading(bool use)
+{
+#ifndef BT_NO_PROFILE
+	// The solvers of the islands call the profiler of Bullet which is not thread safe.
+	use = false;
+#endif
+	m_dynamicsWorld->SetUseMultithreading(use);
+}
+
 void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
 {
 	if (m_solverType == solverType) {
@@ -1311,6 +1370,158 @@ SKIP_UV_NORMAL:
 	return result.m_controller;
 }
 
+static void copyVector(const btVector3& vec, float r[3])
+{
+	r[0] = vec.x();
+	r[1] = vec.y();
+	r[2] = vec.z();
+}
+
+/// Number of rays tested in a task of a batch ray test.
+#define CCD_RAY_BATCH_TASK_SIZE 64
+/// Minimum number of rays to test a batch in several threads.
+#define CCD_RAY_BATCH_PARALLEL_MIN_RAYS 128
+
+/// Closest result callback of a ray of a batch, filtering objects with the batch filter callback.
+struct BatchClosestRayResultCallback : public btCollisionWorld::ClosestRayResultCallback
+{
+	const PHY_IRayBatchFilterCallback& m_phyRayFilter;
+	unsigned int m_mask;
+
+	BatchClosestRayResultCallback(const PHY_IRayBatchFilterCallback& phyRayFilter, unsigned int mask,
+			const btVector3& rayFrom, const btVector3& rayTo)
+		:btCollisionWorld::ClosestRayResultCallback(rayFrom, rayTo),
+		m_phyRayFilter(phyRayFilter),
+		m_mask(mask)
+	{
+		// Don't collide with sensor objects.
+		m_collisionFilterMask = CcdConstructionInfo::AllFilter ^ CcdConstructionInfo::SensorFilter;
+		// Use faster (less accurate) ray callback, works better with 0 collision margins.
+		m_flags |= btTriangleRaycastCallback::kF_UseSubSimplexConvexCastRaytest;
+	}
+
+	virtual bool needsCollision(btBroadphaseProxy *proxy0) const
+	{
+		if (!(proxy0->m_collisionFilterGroup & m_collisionFilterMask)) {
+			return false;
+		}
+		if (!(m_collisionFilterGroup & proxy0->m_collisionFilterMask)) {
+			return false;
+		}
+		btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
+		CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+		return m_phyRayFilter.NeedRayCast(phyCtrl, m_mask);
+	}
+};
+
+/** Leaf collider of the broadphase tree for a ray of a batch.
+ * btDbvtBroadphase::rayTest uses a stack shared by all the calls, the batch
+ * uses instead btDbvt::rayTest which allocates its own stack and then
+ * can be called from several threads.
+ */
+struct BatchRayCollider : public btDbvt::ICollide
+{
+	btTransform m_rayFromTrans;
+	btTransform m_rayToTrans;
+	BatchClosestRayResultCallback& m_resultCallback;
+
+	BatchRayCollider(const btVector3& rayFrom, const btVector3& rayTo, BatchClosestRayResultCallback& resultCallback)
+		:m_resultCallback(resultCallback)
+	{
+		m_rayFromTrans.setIdentity();
+		m_rayFromTrans.setOrigin(rayFrom);
+		m_rayToTrans.setIdentity();
+		m_rayToTrans.setOrigin(rayTo);
+	}
+
+	void Process(const btDbvtNode *leaf)
+	{
+		// Nothing can be closer than a hit at the ray origin.
+		if (m_resultCallback.m_closestHitFraction == 0.0f) {
+			return;
+		}
+
+		btBroadphaseProxy *proxy = (btBroadphaseProxy *)leaf->data;
+		if (!m_resultCallback.needsCollision(proxy)) {
+			return;
+		}
+
+		btCollisionObject *object = (btCollisionObject *)proxy->m_clientObject;
+		btSoftRigidDynamicsWorld::rayTestSingle(m_rayFromTrans, m_rayToTrans, object, object->getCollisionShape(),
+				object->getWorldTransform(), m_resultCallback);
+	}
+};
+
+struct RayBatchTaskData
+{
+	const PHY_RayBatch *batch;
+	const PHY_IRayBatchFilterCallback *filterCallback;
+	const btDbvtBroadphase *broadphase;
+	PHY_RayBatchHit *hits;
+	unsigned int count;
+};
+
+static void RayBatchTask(void *userdata, const int iter)
+{
+	const RayBatchTaskData *data = (RayBatchTaskData *)userdata;
+	const PHY_RayBatch& batch = *data->batch;
+
+	const unsigned int start = iter * CCD_RAY_BATCH_TASK_SIZE;
+	const unsigned int end = std::min(start + CCD_RAY_BATCH_TASK_SIZE, data->count);
+
+	for (unsigned int i = start; i < end; ++i) {
+		const btVector3 rayFrom(batch.m_fromX[i], batch.m_fromY[i], batch.m_fromZ[i]);
+		const btVector3 rayTo(batch.m_toX[i], batch.m_toY[i], batch.m_toZ[i]);
+
+		BatchClosestRayResultCallback rayCallback(*data->filterCallback, batch.m_masks[i], rayFrom, rayTo);
+		BatchRayCollider collider(rayFrom, rayTo, rayCallback);
+		// Dynamic and static objects sets.
+		btDbvt::rayTest(data->broadphase->m_sets[0].m_root, rayFrom, rayTo, collider);
+		btDbvt::rayTest(data->broadphase->m_sets[1].m_root, rayFrom, rayTo, collider);
+
+		PHY_RayBatchHit& hit = data->hits[i];
+		if (rayCallback.hasHit()) {
+			hit.m_controller = static_cast<CcdPhysicsController *>(rayCallback.m_collisionObject->getUserPointer());
+			btVector3 normal = rayCallback.m_hitNormalWorld;
+			if (normal.length2() > (SIMD_EPSILON * SIMD_EPSILON)) {
+				normal.normalize();
+			}
+			else {
+				normal.setValue(1.0f, 0.0f, 0.0f);
+			}
+			copyVector(rayCallback.m_hitPointWorld, hit.m_hitPoint);
+			copyVector(normal, hit.m_hitNormal);
+			hit.m_hitFraction = rayCallback.m_closestHitFraction;
+		}
+		else {
+			hit.m_controller = nullptr;
+			hit.m_hitFraction = 1.0f;
+		}
+	}
+}
+
+void CcdPhysicsEnvironment::RayTestBatch(const PHY_RayBatch& batch, const PHY_IRayBatchFilterCallback& filterCallback,
+		std::vector<PHY_RayBatchHit>& hits)
+{
+	CM_ProfileScope scope("Ray batch");
+
+	const unsigned int count = batch.GetSize();
+	hits.resize(count);
+	if (count == 0) {
+		return;
+	}
+
+	RayBatchTaskData data;
+	data.batch = &batch;
+	data.filterCallback = &filterCallback;
+	data.broadphase = static_cast<btDbvtBroadphase *>(m_broadphase);
+	data.hits = hits.data();
+	data.count = count;
+
+	const unsigned int tasks = (count + CCD_RAY_BATCH_TASK_SIZE - 1) / CCD_RAY_BATCH_TASK_SIZE;
+	BLI_task_parallel_range(0, tasks, &data, RayBatchTask, (count >= CCD_RAY_BATCH_PARALLEL_MIN_RAYS));
+}
+
 // Handles occlusion culling.
 // The implementation is based on the CDTestFramework
 struct OcclusionBuffer {
@@ -2030,7 +2241,14 @@ void CcdPhysicsEnvironment::AddSensor(PHY_IPhysicsController *ctrl)
 bool CcdPhysicsEnvironment::RemoveCollisionCallback(PHY_IPhysicsController *ctrl)
 {
 	CcdPhysicsController *ccdCtrl = (CcdPhysicsController *)ctrl;
-	return ccdCtrl->Unregister();
+	if (ccdCtrl->Unregister()) {
+		// Only the controllers in the environment are counted.
+		if (m_controllers.find(ccdCtrl) != m_controllers.end()) {
+			--m_numCollisionCallbacks;
+		}
+		return true;
+	}
+	return false;
 }
 
 void CcdPhysicsEnvironment::RemoveSensor(PHY_IPhysicsController *ctrl)
@@ -2046,14 +2264,37 @@ void CcdPhysicsEnvironment::AddCollisionCallback(int response_class, PHY_Respons
 bool CcdPhysicsEnvironment::RequestCollisionCallback(PHY_IPhysicsController *ctrl)
 {
 	CcdPhysicsController *ccdCtrl = static_cast<CcdPhysicsController *>(ctrl);
-	return ccdCtrl->Register();
+	if (ccdCtrl->Register()) {
+		if (m_controllers.find(ccdCtrl) != m_controllers.end()) {
+			++m_numCollisionCallbacks;
+		}
+		return true;
+	}
+	return false;
+}
+
+const std::vector<PHY_CollisionPair>& CcdPhysicsEnvironment::GetCollisions()
+{
+	// The contact data can't be referenced while recording as the buffer grows.
+	for (unsigned int i = 0, size = m_collisions.size(); i < size; ++i) {
+		m_collisions[i].m_collData = &m_collDatas[i];
+	}
+
+	return m_collisions;
+}
+
+void CcdPhysicsEnvironment::ClearCollisions()
+{
+	m_contactPoints.clear();
+	m_collDatas.clear();
+	m_collisions.clear();
 }
 
 void CcdPhysicsEnvironment::CallbackTriggers()
 {
 	bool draw_contact_points = m_debugDrawer && (m_debugDrawer->getDebugMode() & btIDebugDraw::DBG_DrawContactPoints);
 
-	if (!m_triggerCallbacks[PHY_OBJECT_RESPONSE] && !draw_contact_points)
+	if (m_numCollisionCallbacks == 0 && !draw_contact_points)
 		return;
 
 	//walk over all overlapping pairs, and if one of the involved bodies is registered for trigger callback, perform callback
@@ -2096,10 +2337,25 @@ void CcdPhysicsEnvironment::CallbackTriggers()
 		}
 
 		if (usecallback) {
-			const CcdCollData *coll_data = new CcdCollData(manifold);
+			/* Copy the contact points as the manifold can be modified or freed before the collisions
+			 * are processed, the buffers keep their memory to avoid allocations in each step. */
+			const unsigned int start = m_contactPoints.size();
+			for (int j = 0; j < numContacts; ++j) {
+				const btManifoldPoint& cp = manifold->getContactPoint(j);
+				CcdContactPoint point;
+				copyVector(cp.m_localPointA, point.m_localPointA);
+				copyVector(cp.m_localPointB, point.m_localPointB);
+				copyVector(cp.m_positionWorldOnB, point.m_positionWorldOnB);
+				copyVector(cp.m_normalWorldOnB, point.m_normalWorldOnB);
+				point.m_combinedFriction = cp.m_combinedFriction;
+				point.m_combinedRollingFriction = cp.m_combinedRollingFriction;
+				point.m_combinedRestitution = cp.m_combinedRestitution;
+				point.m_appliedImpulse = cp.m_appliedImpulse;
+				m_contactPoints.push_back(point);
+			}
 
-			m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE],
-				colliding_ctrl0 ? ctrl0 : ctrl1, colliding_ctrl0 ? ctrl1 : ctrl0, coll_data);
+			m_collDatas.emplace_back(&m_contactPoints, start, numContacts);
+			m_collisions.push_back({colliding_ctrl0 ? ctrl0 : ctrl1, colliding_ctrl0 ? ctrl1 : ctrl0, nullptr});
 		}
 		// Bullet does not refresh the manifold contact point for object without contact response
 		// may need to remove this when a newer Bullet version is integrated
@@ -2668,6 +2924,7 @@ CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool v
 	ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
 	ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
 	ccdPhysEnv->SetDeactivationTime(blenderscene->gm.deactivationtime);
+	ccdPhysEnv->SetUseMultithreading((blenderscene->gm.flag & GAME_PHYSICS_MULTITHREAD) != 0);
 
 	if (visualizePhysics) {
 		ccdPhysEnv->SetDebugMode(btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb | btIDebugDraw::DBG_DrawContactPoints |
@@ -3221,8 +3478,10 @@ void CcdPhysicsEnvironment::SetupObjectConstraints(KX_GameObject *obj_src, KX_Ga
 	}
 }
 
-CcdCollData::CcdCollData(const btPersistentManifold *manifoldPoint)
-	:m_manifoldPoint(manifoldPoint)
+CcdCollData::CcdCollData(const std::vector<CcdContactPoint> *points, unsigned int start, unsigned int numContacts)
+	:m_points(points),
+	m_start(start),
+	m_numContacts(numContacts)
 {
 }
 
@@ -3232,53 +3491,50 @@ CcdCollData::~CcdCollData()
 
 unsigned int CcdCollData::GetNumContacts() const
 {
-	return m_manifoldPoint->getNumContacts();
+	return m_numContacts;
 }
 
 MT_Vector3 CcdCollData::GetLocalPointA(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return MT_Vector3(first ? point.m_localPointA.m_floats : point.m_localPointB.m_floats);
+	const CcdContactPoint& point = GetPoint(index);
+	return MT_Vector3(first ? point.m_localPointA : point.m_localPointB);
 }
 
 MT_Vector3 CcdCollData::GetLocalPointB(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return MT_Vector3(first ? point.m_localPointB.m_floats : point.m_localPointA.m_floats);
+	const CcdContactPoint& point = GetPoint(index);
+	return MT_Vector3(first ? point.m_localPointB : point.m_localPointA);
 }
 
 MT_Vector3 CcdCollData::GetWorldPoint(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return MT_Vector3(point.m_positionWorldOnB.m_floats);
+	const CcdContactPoint& point = GetPoint(index);
+	return MT_Vector3(point.m_positionWorldOnB);
 }
 
 MT_Vector3 CcdCollData::GetNormal(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return MT_Vector3(first ? (-point.m_normalWorldOnB).m_floats : point.m_normalWorldOnB.m_floats);
+	const CcdContactPoint& point = GetPoint(index);
+	const MT_Vector3 normal(point.m_normalWorldOnB);
+	return first ? -normal : normal;
 }
 
 float CcdCollData::GetCombinedFriction(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return point.m_combinedFriction;
+	return GetPoint(index).m_combinedFriction;
 }
 
 float CcdCollData::GetCombinedRollingFriction(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return point.m_combinedRollingFriction;
+	return GetPoint(index).m_combinedRollingFriction;
 }
 
 float CcdCollData::GetCombinedRestitution(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return point.m_combinedRestitution;
+	return GetPoint(index).m_combinedRestitution;
 }
 
 float CcdCollData::GetAppliedImpulse(unsigned int index, bool first) const
 {
-	const btManifoldPoint& point = m_manifoldPoint->getContactPoint(index);
-	return point.m_appliedImpulse;
+	return GetPoint(index).m_appliedImpulse;
 }
@@ -26,6 +26,7 @@
 #include "KX_Globals.h"
 
 #include "CcdPhysicsController.h"
+#include "CcdDynamicsWorld.h"
 
 #include <vector>
 #include <set>
@@ -55,6 +56,46 @@ class CcdShapeConstructionInfo;
 /// Find the id of the closest node to a point in a soft body.
 int Ccd_FindClosestNode(btSoftBody *sb, const btVector3& worldPoint);
 
+/// Contact point copied from a manifold at the end of a physics step.
+struct CcdContactPoint
+{
+	float m_localPointA[3];
+	float m_localPointB[3];
+	float m_positionWorldOnB[3];
+	float m_normalWorldOnB[3];
+	float m_combinedFriction;
+	float m_combinedRollingFriction;
+	float m_combinedRestitution;
+	float m_appliedImpulse;
+};
+
+/// Contact points of a collision in the contact points buffer of the environment.
+class CcdCollData : public PHY_CollData
+{
+	const std::vector<CcdContactPoint> *m_points;
+	unsigned int m_start;
+	unsigned int m_numContacts;
+
+	const CcdContactPoint& GetPoint(unsigned int index) const
+	{
+		return (*m_points)[m_start + index];
+	}
+
+public:
+	CcdCollData(const std::vector<CcdContactPoint> *points, unsigned int start, unsigned int numContacts);
+	virtual ~CcdCollData();
+
+	virtual unsigned int GetNumContacts() const;
+	virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const;
+	virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const;
+	virtual MT_Vector3 GetWorldPoint(unsigned int index, bool first) const;
+	virtual MT_Vector3 GetNormal(unsigned int index, bool first) const;
+	virtual float GetCombinedFriction(unsigned int index, bool first) const;
+	virtual float GetCombinedRollingFriction(unsigned int index, bool first) const;
+	virtual float GetCombinedRestitution(unsigned int index, bool first) const;
+	virtual float GetAppliedImpulse(unsigned int index, bool first) const;
+};
+
 /** CcdPhysicsEnvironment is an experimental mainloop for physics simulation using optional continuous collision detection.
  * Physics Environment takes care of stepping the simulation and is a container for physics entities.
  * It stores rigidbodies,constraints, materials etc.
@@ -130,6 +171,7 @@ public:
 	virtual void SetSolverDamping(float damping);
 	virtual void SetLinearAirDamping(float damping);
 	virtual void SetUseEpa(bool epa);
+	virtual void SetUseMultithreading(bool use);
 
 	virtual int GetNumTimeSubSteps()
 	{
@@ -147,6 +189,9 @@ public:
 	void SimulationSubtickCallback(btScalar timeStep);
 
 	virtual void DebugDrawWorld();
+	virtual bool IsRenderIndependent();
+	virtual bool IsStepCompatible(PHY_IPhysicsEnvironment *other) const;
+	virtual void ApplyGlobalSettings();
 //		virtual bool		proceedDeltaTimeOneStep(float timeStep);
 
 	virtual void SetFixedTimeStep(bool useFixedTimeStep, float fixedTimeStep)
@@ -187,6 +232,8 @@ public:
 	btTypedConstraint *GetConstraintById(int constraintId);
 
 	virtual PHY_IPhysicsController *RayTest(PHY_IRayCastFilterCallback &filterCallback, float fromX, float fromY, float fromZ, float toX, float toY, float toZ);
+	virtual void RayTestBatch(const PHY_RayBatch& batch, const PHY_IRayBatchFilterCallback& filterCallback,
+			std::vector<PHY_RayBatchHit>& hits);
 	virtual bool CullingTest(PHY_CullingCallback callback, void *userData, const std::array<MT_Vector4, 6>& planes,
 							 int occlusionRes, const int *viewport, const MT_Matrix4x4& matrix);
 
@@ -197,6 +244,8 @@ public:
 	virtual void AddCollisionCallback(int response_class, PHY_ResponseCallback callback, void *user);
 	virtual bool RequestCollisionCallback(PHY_IPhysicsController *ctrl);
 	virtual bool RemoveCollisionCallback(PHY_IPhysicsController *ctrl);
+	virtual const std::vector<PHY_CollisionPair>& GetCollisions();
+	virtual void ClearCollisions();
 	//These two methods are used *solely* to create controllers for Near/Radar sensor! Don't use for anything else
 	virtual PHY_IPhysicsController *CreateSphereController(float radius, const MT_Vector3& position);
 	virtual PHY_IPhysicsController *CreateConeController(float coneradius, float coneheight);
@@ -243,7 +292,7 @@ public:
 
 	void SyncMotionStates(float timeStep);
 
-	class btSoftRigidDynamicsWorld *GetDynamicsWorld()
+	CcdDynamicsWorld *GetDynamicsWorld()
 	{
 		return m_dynamicsWorld;
 	}
@@ -274,6 +323,15 @@ protected:
 	PHY_ResponseCallback m_triggerCallbacks[PHY_NUM_RESPONSE];
 	void *m_triggerCallbacksUserPtrs[PHY_NUM_RESPONSE];
 
+	/// Number of controllers of the environment registered for collision callbacks.
+	unsigned int m_numCollisionCallbacks;
+	/// Contact points of the recorded collisions, the memory is kept between the frames.
+	std::vector<CcdContactPoint> m_contactPoints;
+	/// Contact data of each recorded collision.
+	std::vector<CcdCollData> m_collDatas;
+	/// The recorded collisions, their contact data is set by GetCollisions().
+	std::vector<PHY_CollisionPair> m_collisions;
+
 	std::vector<WrapperVehicle *>    m_wrapperVehicles;
 
 	/** use explicit btSoftRigidDynamicsWorld/btDiscreteDynamicsWorld* so that we have access to
@@ -283,7 +341,7 @@ protected:
 	 * Ideally we would like to have access to this function from the btDynamicsWorld interface
 	 */
 	// class btDynamicsWorld *m_dynamicsWorld;
-	class btSoftRigidDynamicsWorld *m_dynamicsWorld;
+	CcdDynamicsWorld *m_dynamicsWorld;
 
 	class btConstraintSolver *m_solver;
 
@@ -298,22 +356,4 @@ protected:
 	virtual void ExportFile(const std::string& filename);
 };
 
-class CcdCollData : public PHY_CollData
-{
-	const btPersistentManifold *m_manifoldPoint;
-public:
-	CcdCollData(const btPersistentManifold *manifoldPoint);
-	virtual ~CcdCollData();
-
-	virtual unsigned int GetNumContacts() const;
-	virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const;
-	virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const;
-	virtual MT_Vector3 GetWorldPoint(unsigned int index, bool first) const;
-	virtual MT_Vector3 GetNormal(unsigned int index, bool first) const;
-	virtual float GetCombinedFriction(unsigned int index, bool first) const;
-	virtual float GetCombinedRollingFriction(unsigned int index, bool first) const;
-	virtual float GetCombinedRestitution(unsigned int index, bool first) const;
-	virtual float GetAppliedImpulse(unsigned int index, bool first) const;
-};
-
 #endif  /* __CCDPHYSICSENVIRONMENT_H__ */
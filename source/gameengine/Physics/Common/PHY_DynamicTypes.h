@@ -23,6 +23,7 @@
 #include "MT_Vector3.h"
 
 struct KX_ClientObjectInfo;
+class PHY_IPhysicsController;
 
 enum
 {
@@ -58,6 +59,16 @@ public:
 	virtual float GetAppliedImpulse(unsigned int index, bool first) const = 0;
 };
 
+/// Collision of an object registered for collision callbacks with an other object.
+struct PHY_CollisionPair
+{
+	/// The registered object.
+	PHY_IPhysicsController *m_first;
+	PHY_IPhysicsController *m_second;
+	/// The contact points, valid until the collisions are cleared.
+	const PHY_CollData *m_collData;
+};
+
 typedef bool (*PHY_ResponseCallback)(void *client_data,
                                      void *client_object1,
                                      void *client_object2,
@@ -39,6 +39,7 @@
 #include "MT_Vector4.h"
 
 #include <array>
+#include <vector>
 
 class PHY_IConstraint;
 class PHY_IVehicle;
@@ -100,6 +101,71 @@ public:
 	}
 };
 
+/**
+ * Rays of a batch query, stored as structure of arrays.
+ * Each ray goes from its origin to its end and owns a filter mask passed to the batch filter callback.
+ */
+struct PHY_RayBatch {
+	std::vector<float> m_fromX;
+	std::vector<float> m_fromY;
+	std::vector<float> m_fromZ;
+	std::vector<float> m_toX;
+	std::vector<float> m_toY;
+	std::vector<float> m_toZ;
+	std::vector<unsigned int> m_masks;
+
+	void AddRay(const MT_Vector3& from, const MT_Vector3& to, unsigned int mask)
+	{
+		m_fromX.push_back(from.x());
+		m_fromY.push_back(from.y());
+		m_fromZ.push_back(from.z());
+		m_toX.push_back(to.x());
+		m_toY.push_back(to.y());
+		m_toZ.push_back(to.z());
+		m_masks.push_back(mask);
+	}
+
+	unsigned int GetSize() const
+	{
+		return m_masks.size();
+	}
+
+	void Clear()
+	{
+		m_fromX.clear();
+		m_fromY.clear();
+		m_fromZ.clear();
+		m_toX.clear();
+		m_toY.clear();
+		m_toZ.clear();
+		m_masks.clear();
+	}
+};
+
+/**
+ * Packed hit record of a ray of a batch query, m_controller is nullptr when the ray hit nothing.
+ */
+struct PHY_RayBatchHit {
+	PHY_IPhysicsController *m_controller;
+	float m_hitPoint[3];
+	float m_hitNormal[3];
+	float m_hitFraction;
+};
+
+/**
+ * Filter of the objects tested by a batch ray query.
+ * NeedRayCast is called concurrently from several threads and must not modify any data.
+ */
+class PHY_IRayBatchFilterCallback
+{
+public:
+	virtual ~PHY_IRayBatchFilterCallback()
+	{
+	}
+
+	virtual bool NeedRayCast(PHY_IPhysicsController *controller, unsigned int mask) const = 0;
+};
+
 /**
  * Physics Environment takes care of stepping the simulation and is a container for physics entities
  * (rigidbodies,constraints, materials etc.)
@@ -117,6 +183,24 @@ public:
 	virtual void DebugDrawWorld()
 	{
 	}
+	/** Return true if ProceedDeltaTime doesn't modify any data read by the rendering
+	 * and can then be run in parallel of it.
+	 */
+	virtual bool IsRenderIndependent()
+	{
+		return false;
+	}
+	/** Return true if ProceedDeltaTime can run in the same time as the step of an other
+	 * environment, their process wide settings must then be the same.
+	 */
+	virtual bool IsStepCompatible(PHY_IPhysicsEnvironment *other) const
+	{
+		return true;
+	}
+	/// Set the process wide settings of the physics engine to the values of this environment.
+	virtual void ApplyGlobalSettings()
+	{
+	}
 	virtual void SetFixedTimeStep(bool useFixedTimeStep, float fixedTimeStep) = 0;
 	// returns 0.f if no fixed timestep is used
 	virtual float GetFixedTimeStep() = 0;
@@ -131,6 +215,10 @@ public:
 	virtual void SetNumIterations(int numIter)
 	{
 	}
+	/// setUseMultithreading run the rigid body integration and the island solving on several threads.
+	virtual void SetUseMultithreading(bool use)
+	{
+	}
 	/// setNumTimeSubSteps set the number of divisions of the timestep. Tradeoff quality versus performance.
 	virtual void SetNumTimeSubSteps(int numTimeSubSteps)
 	{
@@ -205,6 +293,11 @@ public:
 	virtual PHY_ICharacter *GetCharacterController(class KX_GameObject *ob) = 0;
 
 	virtual PHY_IPhysicsController *RayTest(PHY_IRayCastFilterCallback &filterCallback, float fromX, float fromY, float fromZ, float toX, float toY, float toZ) = 0;
+	/** Test all the rays of a batch and write one hit record per ray in hits.
+	 * The rays are tested in parallel, the closest hit of each ray is kept.
+	 */
+	virtual void RayTestBatch(const PHY_RayBatch& batch, const PHY_IRayBatchFilterCallback& filterCallback,
+			std::vector<PHY_RayBatchHit>& hits) = 0;
 
 	// culling based on physical broad phase
 	// the plane number must be set as follow: near, far, left, right, top, botton
@@ -218,6 +311,12 @@ public:
 	virtual void AddCollisionCallback(int response_class, PHY_ResponseCallback callback, void *user) = 0;
 	virtual bool RequestCollisionCallback(PHY_IPhysicsController *ctrl) = 0;
 	virtual bool RemoveCollisionCallback(PHY_IPhysicsController *ctrl) = 0;
+	/** Return the collisions of the objects registered for collision callbacks
+	 * recorded by the physics steps since the last call to ClearCollisions().
+	 */
+	virtual const std::vector<PHY_CollisionPair>& GetCollisions() = 0;
+	/// Clear the recorded collisions, their memory is reused by the next physics steps.
+	virtual void ClearCollisions() = 0;
 	//These two methods are *solely* used to create controllers for sensor! Don't use for anything else
 	virtual PHY_IPhysicsController *CreateSphereController(float radius, const MT_Vector3& position) = 0;
 	virtual PHY_IPhysicsController *CreateConeController(float coneradius, float coneheight) = 0;
@@ -103,3 +103,14 @@ PHY_IPhysicsController *DummyPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallb
 	return nullptr;
 }
 
+void DummyPhysicsEnvironment::RayTestBatch(const PHY_RayBatch& batch, const PHY_IRayBatchFilterCallback& filterCallback,
+		std::vector<PHY_RayBatchHit>& hits)
+{
+	// No collision detection, all the rays miss.
+	hits.resize(batch.GetSize());
+	for (PHY_RayBatchHit& hit : hits) {
+		hit.m_controller = nullptr;
+		hit.m_hitFraction = 1.0f;
+	}
+}
+
@@ -45,6 +45,10 @@
  */
 class DummyPhysicsEnvironment : public PHY_IPhysicsEnvironment
 {
+private:
+	/// Always empty, no collision is detected.
+	std::vector<PHY_CollisionPair> m_collisions;
+
 public:
 	DummyPhysicsEnvironment ();
 	virtual ~DummyPhysicsEnvironment ();
@@ -80,6 +84,8 @@ public:
 	}
 
 	virtual PHY_IPhysicsController *RayTest(PHY_IRayCastFilterCallback &filterCallback, float fromX, float fromY, float fromZ, float toX, float toY, float toZ);
+	virtual void RayTestBatch(const PHY_RayBatch& batch, const PHY_IRayBatchFilterCallback& filterCallback,
+			std::vector<PHY_RayBatchHit>& hits);
 	virtual bool CullingTest(PHY_CullingCallback callback, void *userData, const std::array<MT_Vector4, 6>& planes,
 							 int occlusionRes, const int *viewport, const MT_Matrix4x4& matrix)
 	{
@@ -104,6 +110,13 @@ public:
 	{
 		return false;
 	}
+	virtual const std::vector<PHY_CollisionPair>& GetCollisions()
+	{
+		return m_collisions;
+	}
+	virtual void ClearCollisions()
+	{
+	}
 	virtual PHY_IPhysicsController *CreateSphereController(float radius, const class MT_Vector3& position)
 	{
 		return nullptr;
@@ -42,6 +42,8 @@
 
 #include "RAS_BucketManager.h"
 
+#include "CM_Sort.h"
+
 #include <algorithm>
 /* sorting */
 
@@ -113,12 +115,32 @@ void RAS_BucketManager::RenderSortedBuckets(RAS_Rasterizer *rasty, RAS_BucketMan
 		/* Camera's near plane equation: pnorm.dot(point) + pval,
 		 * but we leave out pval since it's constant anyway */
 		const MT_Vector3 pnorm(m_nodeData.m_trans.getBasis()[2]);
-		std::vector<SortedMeshSlot> sortedSlots(leafs.size());
-		// Generate all SortedMeshSlot corresponding to all the leafs nodes.
-		std::transform(leafs.begin(), leafs.end(), sortedSlots.begin(),
-				[&pnorm](RAS_MeshSlotUpwardNode *node) { return SortedMeshSlot(node, pnorm); });
 
-		std::sort(sortedSlots.begin(), sortedSlots.end(), backtofront());
+		/* Generate all SortedMeshSlot corresponding to all the leafs nodes. The mesh slots
+		 * sorted the last time keep their previous order and the new ones are put after,
+		 * most of the mesh slots are then already sorted when the camera moves slowly. */
+		std::vector<SortedMeshSlot>& sortedSlots = m_sortedSlots[bucketType];
+		const unsigned int lastSize = sortedSlots.size();
+		m_sortScratch.assign(lastSize, SortedMeshSlot());
+		for (RAS_MeshSlotUpwardNode *node : leafs) {
+			const unsigned int index = node->GetOwner()->m_sortIndex;
+			if (index < lastSize && sortedSlots[index].m_node == node && !m_sortScratch[index].m_node) {
+				m_sortScratch[index] = SortedMeshSlot(node, pnorm);
+			}
+			else {
+				m_sortScratch.emplace_back(node, pnorm);
+			}
+		}
+		// Remove the mesh slots not rendered anymore.
+		m_sortScratch.erase(std::remove_if(m_sortScratch.begin(), m_sortScratch.end(),
+				[](const SortedMeshSlot& slot) { return !slot.m_node; }), m_sortScratch.end());
+		sortedSlots.swap(m_sortScratch);
+
+		CM_CoherentSort(sortedSlots, m_sortScratch, [](const SortedMeshSlot& slot) { return slot.m_z; });
+
+		for (unsigned int i = 0, size = sortedSlots.size(); i < size; ++i) {
+			sortedSlots[i].m_node->GetOwner()->m_sortIndex = i;
+		}
 
 		std::vector<SortedMeshSlot>::const_iterator it = sortedSlots.begin();
 		RAS_MeshSlotUpwardNodeIterator iterator((it++)->m_node);
@@ -404,6 +426,12 @@ void RAS_BucketManager::RemoveMaterial(RAS_IPolyMaterial *mat)
 
 void RAS_BucketManager::MergeBucketManager(RAS_BucketManager *other, SCA_IScene *scene)
 {
+	/* The mesh slots activated while the buckets were owned by the other manager
+	 * were not rendered and then not released. */
+	for (RAS_MaterialBucket *bucket : other->m_buckets[ALL_BUCKET]) {
+		bucket->RemoveActiveMeshSlots();
+	}
+
 	for (unsigned short i = 0; i < NUM_BUCKET_TYPE; ++i) {
 		BucketList& buckets = m_buckets[i];
 		BucketList& otherbuckets = other->m_buckets[i];
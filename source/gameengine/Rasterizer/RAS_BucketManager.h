@@ -97,6 +97,11 @@ protected:
 		RAS_DisplayArrayBucket *m_arrayBucket;
 	} m_text;
 
+	/// Mesh slots of the last depth sorted render per bucket type, used as initial order of the next sort.
+	std::vector<SortedMeshSlot> m_sortedSlots[NUM_BUCKET_TYPE];
+	/// Scratch buffer of the mesh slots sort.
+	std::vector<SortedMeshSlot> m_sortScratch;
+
 public:
 	/** Initialize bucket manager and create material bucket for the text material.
 	 * \param textMaterial The material used to render texts.
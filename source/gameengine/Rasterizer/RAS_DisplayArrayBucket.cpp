@@ -162,11 +162,14 @@ void RAS_DisplayArrayBucket::UpdateActiveMeshSlots(RAS_Rasterizer *rasty)
 		// Create the storage info if it was destructed or not yet created.
 		if (!m_storageInfo) {
 			m_storageInfo = rasty->GetStorageInfo(m_displayArray, m_bucket->UseInstancing());
+			// The storage indices are not sorted.
+			m_displayArray->InvalidatePolygonSort();
 		}
 		// Set the storage info modified if the mesh is modified.
 		else {
 			if (modifiedFlag & RAS_IDisplayArray::SIZE_MODIFIED) {
 				m_storageInfo->UpdateSize();
+				m_displayArray->InvalidatePolygonSort();
 			}
 			else if (modifiedFlag & RAS_IDisplayArray::MESH_MODIFIED) {
 				m_storageInfo->UpdateVertexData();
@@ -29,37 +29,20 @@
 
 #include "GPU_glew.h"
 
-#include <algorithm>
-
-struct PolygonSort
-{
-	/// Distance from polygon center to camera near plane.
-	float m_z;
-	/// Index of the first vertex in the polygon.
-	unsigned int m_first;
+#include "CM_Sort.h"
 
-	PolygonSort() = default;
-
-	void Init(unsigned int first, const MT_Vector3& center, const MT_Vector3& pnorm)
-	{
-		m_first = first;
-		m_z = pnorm.dot(center);
-	}
+#include <algorithm>
 
-	struct BackToFront
-	{
-		bool operator()(const PolygonSort &a, const PolygonSort &b) const
-		{
-			return a.m_z < b.m_z;
-		}
-	};
-};
+/** Cosine of the view direction change (0.5 degree) under which the
+ * polygons are not sorted again. */
+#define RAS_POLYGON_SORT_DIRECTION_THRESHOLD 0.99996f
 
 RAS_IDisplayArray::RAS_IDisplayArray(PrimitiveType type, const RAS_VertexFormat& format)
 	:m_type(type),
 	m_modifiedFlag(NONE_MODIFIED),
 	m_format(format),
-	m_maxOrigIndex(0)
+	m_maxOrigIndex(0),
+	m_sortValid(false)
 {
 }
 
@@ -98,16 +81,23 @@ RAS_IDisplayArray *RAS_IDisplayArray::ConstructArray(RAS_IDisplayArray::Primitiv
 #undef NEW_DISPLAY_ARRAY_UV
 #undef NEW_DISPLAY_ARRAY_COLOR
 
-void RAS_IDisplayArray::SortPolygons(const MT_Transform& transform, unsigned int *indexmap)
+bool RAS_IDisplayArray::SortPolygons(const MT_Transform& transform)
 {
 	const unsigned int totpoly = GetPrimitiveIndexCount() / 3;
 
 	if (totpoly <= 1 || m_type == LINES) {
-		return;
+		return false;
 	}
 
 	// Extract camera Z plane.
 	const MT_Vector3 pnorm(transform.getBasis()[2]);
+	const MT_Vector3 direction = pnorm.safe_normalized();
+
+	if (m_sortValid && m_sortedPolygons.size() == totpoly &&
+		direction.dot(m_sortDirection) > RAS_POLYGON_SORT_DIRECTION_THRESHOLD)
+	{
+		return false;
+	}
 
 	if (m_polygonCenters.size() != totpoly) {
 		m_polygonCenters.resize(totpoly);
@@ -122,17 +112,30 @@ void RAS_IDisplayArray::SortPolygons(const MT_Transform& transform, unsigned int
 		}
 	}
 
-	std::vector<PolygonSort> sortedPoly(totpoly);
-	// Get indices and polygon distance into temporary array.
-	for (unsigned int i = 0; i < totpoly; ++i) {
-		sortedPoly[i].Init(i * 3, pnorm, m_polygonCenters[i]);
+	// Start from the previous order, the polygons are almost sorted if the view changed a little.
+	if (m_sortedPolygons.size() != totpoly) {
+		m_sortedPolygons.resize(totpoly);
+		for (unsigned int i = 0; i < totpoly; ++i) {
+			m_sortedPolygons[i].m_first = i * 3;
+		}
+	}
+
+	for (PolygonSort& polygon : m_sortedPolygons) {
+		polygon.m_z = pnorm.dot(m_polygonCenters[polygon.m_first / 3]);
 	}
 
-	std::sort(sortedPoly.begin(), sortedPoly.end(), PolygonSort::BackToFront());
+	CM_CoherentSort(m_sortedPolygons, m_sortScratch, [](const PolygonSort& polygon) { return polygon.m_z; });
+
+	m_sortDirection = direction;
+	m_sortValid = true;
 
-	// Get indices from temporary array.
-	for (unsigned int i = 0; i < totpoly; ++i) {
-		const unsigned int first = sortedPoly[i].m_first;
+	return true;
+}
+
+void RAS_IDisplayArray::GetSortedPolygonIndices(unsigned int *indexmap) const
+{
+	for (unsigned int i = 0, size = m_sortedPolygons.size(); i < size; ++i) {
+		const unsigned int first = m_sortedPolygons[i].m_first;
 		for (unsigned short j = 0; j < 3; ++j) {
 			indexmap[i * 3 + j] = m_primitiveIndices[first + j];
 		}
@@ -142,6 +145,12 @@ void RAS_IDisplayArray::SortPolygons(const MT_Transform& transform, unsigned int
 void RAS_IDisplayArray::InvalidatePolygonCenters()
 {
 	m_polygonCenters.clear();
+	m_sortValid = false;
+}
+
+void RAS_IDisplayArray::InvalidatePolygonSort()
+{
+	m_sortValid = false;
 }
 
 RAS_IDisplayArray::PrimitiveType RAS_IDisplayArray::GetPrimitiveType() const
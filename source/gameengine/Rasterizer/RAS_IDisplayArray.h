@@ -69,6 +69,23 @@ protected:
 	 */
 	std::vector<MT_Vector3> m_polygonCenters;
 
+	struct PolygonSort
+	{
+		/// Distance from polygon center to camera near plane.
+		float m_z;
+		/// Index of the first vertex in the polygon.
+		unsigned int m_first;
+	};
+
+	/// Polygons in the order of the last sort, used as initial order of the next sort.
+	std::vector<PolygonSort> m_sortedPolygons;
+	/// Scratch buffer of the polygons sort.
+	std::vector<PolygonSort> m_sortScratch;
+	/// Normalized view direction in the array space of the last polygons sort.
+	MT_Vector3 m_sortDirection;
+	/// True when m_sortedPolygons matches the index map of the storage.
+	bool m_sortValid;
+
 public:
 	RAS_IDisplayArray(PrimitiveType type, const RAS_VertexFormat& format);
 	virtual ~RAS_IDisplayArray();
@@ -164,8 +181,16 @@ public:
 		return m_maxOrigIndex;
 	}
 
-	void SortPolygons(const MT_Transform &transform, unsigned int *indexmap);
+	/** Sort the polygons back to front for the view of the given transform.
+	 * \return False if the view direction barely changed since the last sort,
+	 * the previous order is then kept.
+	 */
+	bool SortPolygons(const MT_Transform &transform);
+	/// Write the primitive indices in the order of the last polygons sort.
+	void GetSortedPolygonIndices(unsigned int *indexmap) const;
 	void InvalidatePolygonCenters();
+	/// Request a complete polygons sort at the next call to SortPolygons, e.g when the storage indices are reset.
+	void InvalidatePolygonSort();
 
 	virtual RAS_IVertex *CreateVertex(
 				const MT_Vector3& xyz,
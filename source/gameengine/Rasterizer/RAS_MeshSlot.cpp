@@ -51,7 +51,8 @@ RAS_MeshSlot::RAS_MeshSlot(RAS_MeshUser *meshUser, RAS_DisplayArrayBucket *array
 	:m_node(this, &dummyNodeData, &RAS_MeshSlot::RunNode, nullptr),
 	m_displayArrayBucket(arrayBucket),
 	m_meshUser(meshUser),
-	m_batchPartIndex(-1)
+	m_batchPartIndex(-1),
+	m_sortIndex(0)
 {
 }
 
@@ -85,9 +86,12 @@ void RAS_MeshSlot::RunNode(const RAS_MeshSlotNodeTuple& tuple)
 
 		RAS_IStorageInfo *storage = displayArrayData->m_storageInfo;
 		if (materialData->m_zsort && storage) {
-			displayArrayData->m_array->SortPolygons(managerData->m_trans * MT_Transform(m_meshUser->GetMatrix()),
-								 storage->GetIndexMap());
-			storage->FlushIndexMap();
+			RAS_IDisplayArray *array = displayArrayData->m_array;
+			// Update the indices only if the polygons order changed.
+			if (array->SortPolygons(managerData->m_trans * MT_Transform(m_meshUser->GetMatrix()))) {
+				array->GetSortedPolygonIndices(storage->GetIndexMap());
+				storage->FlushIndexMap();
+			}
 		}
 	}
 
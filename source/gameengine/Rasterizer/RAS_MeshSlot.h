@@ -51,6 +51,8 @@ public:
 
 	/// Batch index used for batching render.
 	short m_batchPartIndex;
+	/// Index in the last depth sorted mesh slots of the bucket manager.
+	unsigned int m_sortIndex;
 
 	RAS_MeshSlot(RAS_MeshUser *meshUser, RAS_DisplayArrayBucket *arrayBucket);
 	virtual ~RAS_MeshSlot();
@@ -1,7 +1,8 @@
 #include "SG_CullingNode.h"
 
 SG_CullingNode::SG_CullingNode()
-	:m_culled(true)
+	:m_culled(true),
+	m_frameCulled(true)
 {
 }
 
@@ -23,4 +24,15 @@ bool SG_CullingNode::GetCulled() const
 void SG_CullingNode::SetCulled(bool culled)
 {
 	m_culled = culled;
+	m_frameCulled = m_frameCulled && culled;
+}
+
+bool SG_CullingNode::GetFrameCulled() const
+{
+	return m_frameCulled;
+}
+
+void SG_CullingNode::ResetFrameCulled()
+{
+	m_frameCulled = true;
 }
@@ -13,6 +13,8 @@ private:
 	SG_BBox m_aabb;
 	/// The culling state from the last culling pass.
 	bool m_culled;
+	/// The culling state from all the culling passes of the frame, true if every pass culled the node.
+	bool m_frameCulled;
 
 public:
 	SG_CullingNode();
@@ -23,6 +25,11 @@ public:
 
 	bool GetCulled() const;
 	void SetCulled(bool culled);
+
+	/// Return true if the node was culled by all the culling passes since the last ResetFrameCulled.
+	bool GetFrameCulled() const;
+	/// Start the culling passes of a new frame.
+	void ResetFrameCulled();
 };
 
 using SG_CullingNodeList = std::vector<SG_CullingNode *>;
@@ -32,12 +32,44 @@
 #include "SG_Node.h"
 #include "SG_Familly.h"
 #include "SG_Controller.h"
+#include "SG_ParentRelation.h"
+
+#include "BLI_task.h"
 
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+/// Minimum number of nodes of a same depth to update them with threads.
+#define SG_PARALLEL_UPDATE_MIN_NODES 64
 
 static CM_ThreadMutex scheduleMutex;
 static CM_ThreadMutex transformMutex;
 
+struct SG_Node::ParallelUpdateData
+{
+	struct Entry
+	{
+		SG_Node *m_node;
+		/// Index of the parent entry, -1 for a root.
+		int m_parent;
+		/// The world data was modified by UpdateSpatialData.
+		bool m_updated;
+		/// Parent updated state given to the children.
+		bool m_parentUpdated;
+	};
+
+	/// All the nodes in depth first order, the order used by UpdateWorldData.
+	std::vector<Entry> m_entries;
+	/// Indices of the entries updatable in parallel per depth.
+	std::vector<std::vector<int> > m_parallelLevels;
+	/// Indices of the entries to update in the main thread per depth.
+	std::vector<std::vector<int> > m_serialLevels;
+	/// Level currently updated in parallel.
+	const std::vector<int> *m_level;
+	double m_time;
+};
+
 SG_Node::SG_Node(void *clientobj, void *clientinfo, SG_Callbacks& callbacks)
 	:SG_QList(),
 	m_SGclientObject(clientobj),
@@ -53,7 +85,7 @@ SG_Node::SG_Node(void *clientobj, void *clientinfo, SG_Callbacks& callbacks)
 	m_parent_relation(nullptr),
 	m_familly(new SG_Familly()),
 	m_modified(true),
-	m_dirty(DIRTY_NONE)
+	m_dirty(DIRTY_ALL)
 {
 }
 
@@ -72,7 +104,7 @@ SG_Node::SG_Node(const SG_Node & other)
 	m_worldScaling(other.m_worldScaling),
 	m_parent_relation(other.m_parent_relation->NewCopy()),
 	m_familly(new SG_Familly()),
-	m_dirty(DIRTY_NONE)
+	m_dirty(DIRTY_ALL)
 {
 }
 
@@ -264,6 +296,135 @@ void SG_Node::UpdateWorldDataThreadSchedule(double time, bool parentUpdated)
 	}
 }
 
+bool SG_Node::IsThreadSafeUpdate() const
+{
+	// Controllers can modify shared data as materials or physics controllers.
+	return (m_SGcontrollers.empty() && m_parent_relation->IsThreadSafe());
+}
+
+void SG_Node::AddParallelUpdateEntries(ParallelUpdateData& data, SG_Node *node, int parent, unsigned int depth)
+{
+	const int index = data.m_entries.size();
+	data.m_entries.push_back({node, parent, false, false});
+
+	if (data.m_parallelLevels.size() <= depth) {
+		data.m_parallelLevels.resize(depth + 1);
+		data.m_serialLevels.resize(depth + 1);
+	}
+
+	if (node->IsThreadSafeUpdate()) {
+		data.m_parallelLevels[depth].push_back(index);
+	}
+	else {
+		data.m_serialLevels[depth].push_back(index);
+	}
+
+	for (SG_Node *childnode : node->m_children) {
+		AddParallelUpdateEntries(data, childnode, index, depth + 1);
+	}
+}
+
+void SG_Node::UpdateParallelEntry(ParallelUpdateData& data, int index)
+{
+	ParallelUpdateData::Entry& entry = data.m_entries[index];
+	// Same parent updated state than the one given by UpdateWorldData to the children.
+	bool parentUpdated = (entry.m_parent == -1) ? false : data.m_entries[entry.m_parent].m_parentUpdated;
+
+	entry.m_updated = entry.m_node->UpdateSpatialData(entry.m_node->GetSGParent(), data.m_time, parentUpdated);
+	entry.m_parentUpdated = parentUpdated;
+}
+
+void SG_Node::UpdateParallelEntryTask(void *userdata, const int iter)
+{
+	ParallelUpdateData *data = (ParallelUpdateData *)userdata;
+	UpdateParallelEntry(*data, (*data->m_level)[iter]);
+}
+
+void SG_Node::UpdateWorldDataParallel(const std::vector<SG_Node *>& roots, double time)
+{
+	ParallelUpdateData data;
+	data.m_time = time;
+
+	for (SG_Node *root : roots) {
+		AddParallelUpdateEntries(data, root, -1, 0);
+	}
+
+	/* A node depends only on its parent, all the nodes of a depth can be updated
+	 * once the previous depth is done. */
+	for (unsigned int depth = 0, size = data.m_parallelLevels.size(); depth < size; ++depth) {
+		for (int index : data.m_serialLevels[depth]) {
+			UpdateParallelEntry(data, index);
+		}
+
+		const std::vector<int>& level = data.m_parallelLevels[depth];
+		data.m_level = &level;
+		BLI_task_parallel_range(0, level.size(), &data, UpdateParallelEntryTask,
+				(level.size() >= SG_PARALLEL_UPDATE_MIN_NODES));
+	}
+
+	// Call the transform callbacks and unschedule the nodes in the same order than UpdateWorldData.
+	for (const ParallelUpdateData::Entry& entry : data.m_entries) {
+		if (entry.m_updated) {
+			entry.m_node->ActivateUpdateTransformCallback();
+		}
+		entry.m_node->Delink();
+	}
+}
+
+void SG_Node::UpdateScheduledWorldDataParallel(SG_QList& head, double time)
+{
+	std::vector<SG_Node *> scheduled;
+	SG_Node *node;
+	while ((node = GetNextScheduled(head)) != nullptr) {
+		scheduled.push_back(node);
+	}
+
+	std::unordered_map<const SG_Node *, unsigned int> scheduledOrder;
+	scheduledOrder.reserve(scheduled.size());
+	for (unsigned int i = 0, size = scheduled.size(); i < size; ++i) {
+		scheduledOrder[scheduled[i]] = i;
+	}
+
+	/* The nodes are updated by batch of independent hierarchies. A node scheduled before one
+	 * of its parents is updated alone first and then again with the parent hierarchy, as the
+	 * serial update does. */
+	std::vector<SG_Node *> roots;
+	std::unordered_set<const SG_Node *> rootsParents;
+	for (unsigned int i = 0, size = scheduled.size(); i < size; ++i) {
+		node = scheduled[i];
+
+		// The serial update already updated and unscheduled this node with a parent scheduled before.
+		bool updated = false;
+		for (const SG_Node *parent = node->m_SGparent; parent; parent = parent->m_SGparent) {
+			const std::unordered_map<const SG_Node *, unsigned int>::const_iterator it = scheduledOrder.find(parent);
+			if (it != scheduledOrder.end() && it->second < i) {
+				updated = true;
+				break;
+			}
+		}
+
+		if (updated) {
+			continue;
+		}
+
+		// The node is a parent of a root of the batch, update the batch first.
+		if (rootsParents.find(node) != rootsParents.end()) {
+			UpdateWorldDataParallel(roots, time);
+			roots.clear();
+			rootsParents.clear();
+		}
+
+		roots.push_back(node);
+		for (const SG_Node *parent = node; parent; parent = parent->m_SGparent) {
+			rootsParents.insert(parent);
+		}
+	}
+
+	if (!roots.empty()) {
+		UpdateWorldDataParallel(roots, time);
+	}
+}
+
 void SG_Node::SetSimulatedTime(double time, bool recurse)
 {
 	// update the controllers of this node.
@@ -397,6 +558,11 @@ void SG_Node::SetModified()
 	ActivateScheduleUpdateCallback();
 }
 
+void SG_Node::SetDirty(DirtyFlag flag)
+{
+	m_dirty |= flag;
+}
+
 void SG_Node::ClearDirty(DirtyFlag flag)
 {
 	m_dirty &= ~flag;
@@ -112,7 +112,8 @@ public:
 		DIRTY_NONE = 0,
 		DIRTY_ALL = 0xFF,
 		DIRTY_RENDER = (1 << 0),
-		DIRTY_CULLING = (1 << 1)
+		DIRTY_CULLING = (1 << 1),
+		DIRTY_ACTIVITY = (1 << 2)
 	};
 
 	SG_Node(void *clientobj, void *clientinfo, SG_Callbacks& callbacks);
@@ -189,6 +190,14 @@ public:
 	void UpdateWorldData(double time, bool parentUpdated = false);
 	void UpdateWorldDataThread(double time, bool parentUpdated = false);
 
+	/**
+	 * Update all the nodes scheduled in head as calling UpdateWorldData on each node
+	 * returned by GetNextScheduled. The hierarchies are updated depth by depth and the
+	 * nodes of a same depth are updated in parallel, the transform callbacks are then
+	 * called in the same order than UpdateWorldData.
+	 */
+	static void UpdateScheduledWorldDataParallel(SG_QList& head, double time);
+
 	/**
 	 * Update the simulation time of this node. Iterate through
 	 * the children nodes and update their simulated time.
@@ -290,6 +299,7 @@ public:
 
 	void ClearModified();
 	void SetModified();
+	void SetDirty(DirtyFlag flag);
 	void ClearDirty(DirtyFlag flag);
 
 	/**
@@ -367,8 +377,19 @@ protected:
 	bool UpdateSpatialData(const SG_Node *parent, double time, bool& parentUpdated);
 
 private:
+	struct ParallelUpdateData;
+
 	void UpdateWorldDataThreadSchedule(double time, bool parentUpdated = false);
 
+	/// Return true if UpdateSpatialData doesn't access data shared with other nodes.
+	bool IsThreadSafeUpdate() const;
+	/// Append the node and its children in depth first order to the parallel update data.
+	static void AddParallelUpdateEntries(ParallelUpdateData& data, SG_Node *node, int parent, unsigned int depth);
+	/// Update world data of the nodes of the roots hierarchies in parallel by depth.
+	static void UpdateWorldDataParallel(const std::vector<SG_Node *>& roots, double time);
+	static void UpdateParallelEntry(ParallelUpdateData& data, int index);
+	static void UpdateParallelEntryTask(void *userdata, const int iter);
+
 	void ProcessSGReplica(SG_Node **replica);
 
 	void *m_SGclientObject;
@@ -96,6 +96,15 @@ public:
 		return false;
 	}
 
+	/**
+	 * Return true if UpdateChildCoordinates only reads the parent and writes the child,
+	 * it can then be called in parallel for different children.
+	 */
+	virtual bool IsThreadSafe()
+	{
+		return false;
+	}
+
 protected:
 	/**
 	 * Protected constructors
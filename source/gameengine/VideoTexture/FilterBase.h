@@ -94,6 +94,11 @@ public:
 	/// get first filter's source pixel size
 	unsigned int firstPixelSize (void) { return findFirst()->getPixelSize(); }
 
+	/// return true if the filter only depends on the pixel converted by the previous filters
+	virtual bool canFilterRows (void) { return false; }
+	/// filter in place a row of pixels converted by the previous filters, used if canFilterRows returns true
+	virtual void filterRow (unsigned int *row, unsigned int count) {}
+
 protected:
 	/// previous pixel filter
 	PyFilter * m_previous;
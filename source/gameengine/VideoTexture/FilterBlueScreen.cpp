@@ -36,6 +36,12 @@
 #include "FilterBase.h"
 #include "PyTypeList.h"
 
+#include <algorithm>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 // implementation FilterBlueScreen
 
 // constructor
@@ -67,6 +73,54 @@ void FilterBlueScreen::setLimits (unsigned short minLimit, unsigned short maxLim
 	m_limitDist = m_squareLimits[1] - m_squareLimits[0];
 }
 
+// filter a row of converted pixels
+void FilterBlueScreen::filterRow (unsigned int *row, unsigned int count)
+{
+	unsigned int i = 0;
+#ifdef __SSE2__
+	const __m128i maskLow = _mm_set1_epi32(0xFF);
+	const __m128i maskHigh = _mm_set1_epi32(0xFF0000);
+	const __m128i colorRG = _mm_set1_epi32(m_color[0] | (m_color[1] << 16));
+	const __m128i colorB = _mm_set1_epi32(m_color[2]);
+	// the distances are lower than 2^18, the limits are clamped to compare them as signed values
+	const __m128i limit0 = _mm_set1_epi32((int)std::min(m_squareLimits[0], 0x7FFFFFFFu));
+	const __m128i limit1 = _mm_set1_epi32((int)std::min(m_squareLimits[1], 0x7FFFFFFFu));
+	// the division in double precision gives the same result as the integer division
+	const __m128d limitDist = _mm_set1_pd((double)m_limitDist);
+	const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(row + i));
+		// red and green as pairs of 16 bits values, blue with a zero pair
+		const __m128i rg = _mm_or_si128(_mm_and_si128(pixels, maskLow), _mm_and_si128(_mm_slli_epi32(pixels, 8), maskHigh));
+		const __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 16), maskLow);
+		const __m128i difRG = _mm_sub_epi16(rg, colorRG);
+		const __m128i difB = _mm_sub_epi16(b, colorB);
+		// calc distance from "blue screen" color
+		const __m128i dist = _mm_add_epi32(_mm_madd_epi16(difRG, difRG), _mm_madd_epi16(difB, difB));
+
+		// alpha between the limits, the other pixels are replaced below
+		const __m128i scaled = _mm_slli_epi32(_mm_sub_epi32(dist, limit0), 8);
+		const __m128i alphaLow = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(scaled), limitDist));
+		const __m128i alphaHigh = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(scaled, 8)), limitDist));
+		__m128i alpha = _mm_unpacklo_epi64(alphaLow, alphaHigh);
+
+		// fully opaque color
+		const __m128i belowOpaque = _mm_cmplt_epi32(dist, limit1);
+		alpha = _mm_or_si128(_mm_and_si128(belowOpaque, alpha), _mm_andnot_si128(belowOpaque, maskLow));
+		// fully transparent color
+		alpha = _mm_and_si128(_mm_cmpgt_epi32(dist, limit0), alpha);
+
+		const __m128i result = _mm_or_si128(_mm_and_si128(pixels, colorMask), _mm_slli_epi32(_mm_and_si128(alpha, maskLow), 24));
+		_mm_storeu_si128((__m128i *)(row + i), result);
+	}
+#endif
+	// remaining pixels
+	for (; i < count; ++i)
+		row[i] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, row[i]);
+}
+
 
 
 // cast Filter pointer to FilterBlueScreen
@@ -99,6 +99,12 @@ protected:
 	virtual unsigned int filter (unsigned int *src, short x, short y,
 	                             short * size, unsigned int pixSize, unsigned int val = 0)
 	{ return tFilter(src, x, y, size, pixSize, val); }
+
+public:
+	/// the alpha is only computed from the converted color
+	virtual bool canFilterRows (void) { return true; }
+	/// filter a row of converted pixels, four pixels at once with SSE2
+	virtual void filterRow (unsigned int *row, unsigned int count);
 };
 
 
@@ -36,6 +36,10 @@
 #include "FilterBase.h"
 #include "PyTypeList.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 // implementation FilterGray
 
 // attributes structure
@@ -109,6 +113,45 @@ void FilterColor::setMatrix (ColorMatrix & mat)
 			m_matrix[r][c] = mat[r][c]; 
 }
 
+#ifdef __SSE2__
+/* Calculate one color component of four pixels, the products are summed by pairs of 16 bits
+ * values: the red and green then the blue and alpha components. */
+static inline __m128i calcColorSSE2(__m128i rg, __m128i ba, short row[5])
+{
+	const __m128i coefRG = _mm_set1_epi32((unsigned short)row[0] | ((unsigned int)(unsigned short)row[1] << 16));
+	const __m128i coefBA = _mm_set1_epi32((unsigned short)row[2] | ((unsigned int)(unsigned short)row[3] << 16));
+	const __m128i color = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(rg, coefRG), _mm_madd_epi16(ba, coefBA)),
+		_mm_set1_epi32(row[4]));
+	return _mm_and_si128(_mm_srai_epi32(color, 8), _mm_set1_epi32(0xFF));
+}
+#endif
+
+// filter a row of converted pixels
+void FilterColor::filterRow (unsigned int *row, unsigned int count)
+{
+	unsigned int i = 0;
+#ifdef __SSE2__
+	const __m128i maskLow = _mm_set1_epi32(0xFF);
+	const __m128i maskHigh = _mm_set1_epi32(0xFF0000);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(row + i));
+		// red and green, blue and alpha as pairs of 16 bits values
+		const __m128i rg = _mm_or_si128(_mm_and_si128(pixels, maskLow), _mm_and_si128(_mm_slli_epi32(pixels, 8), maskHigh));
+		const __m128i ba = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), maskLow), _mm_and_si128(_mm_srli_epi32(pixels, 8), maskHigh));
+
+		__m128i result = calcColorSSE2(rg, ba, m_matrix[0]);
+		result = _mm_or_si128(result, _mm_slli_epi32(calcColorSSE2(rg, ba, m_matrix[1]), 8));
+		result = _mm_or_si128(result, _mm_slli_epi32(calcColorSSE2(rg, ba, m_matrix[2]), 16));
+		result = _mm_or_si128(result, _mm_slli_epi32(calcColorSSE2(rg, ba, m_matrix[3]), 24));
+		_mm_storeu_si128((__m128i *)(row + i), result);
+	}
+#endif
+	// remaining pixels
+	for (; i < count; ++i)
+		row[i] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, row[i]);
+}
+
 
 
 // cast Filter pointer to FilterColor
@@ -68,6 +68,16 @@ protected:
 	virtual unsigned int filter (unsigned int * src, short x, short y,
 		short * size, unsigned int pixSize, unsigned int val = 0)
 	{ return tFilter(src, x, y, size, pixSize, val); }
+
+public:
+	/// the pixel is only computed from its converted value
+	virtual bool canFilterRows (void) { return true; }
+	/// filter a row of converted pixels
+	virtual void filterRow (unsigned int *row, unsigned int count)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			row[i] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, row[i]);
+	}
 };
 
 
@@ -118,6 +128,12 @@ protected:
 	virtual unsigned int filter (unsigned int * src, short x, short y,
 		short * size, unsigned int pixSize, unsigned int val = 0)
 	{ return tFilter(src, x, y, size, pixSize, val); }
+
+public:
+	/// the pixel is only computed from its converted value
+	virtual bool canFilterRows (void) { return true; }
+	/// filter a row of converted pixels, four pixels at once with SSE2
+	virtual void filterRow (unsigned int *row, unsigned int count);
 };
 
 
@@ -170,6 +186,16 @@ protected:
 	virtual unsigned int filter (unsigned int * src, short x, short y,
 		short * size, unsigned int pixSize, unsigned int val = 0)
 	{ return tFilter(src, x, y, size, pixSize, val); }
+
+public:
+	/// the pixel is only computed from its converted value
+	virtual bool canFilterRows (void) { return true; }
+	/// filter a row of converted pixels
+	virtual void filterRow (unsigned int *row, unsigned int count)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			row[i] = tFilter((unsigned int *)nullptr, 0, 0, nullptr, 0, row[i]);
+	}
 };
 
 
@@ -34,10 +34,13 @@
 #include "Common.h"
 
 #include <vector>
+#include <algorithm>
 #include "EXP_PyObjectPlus.h"
 
 #include "PyTypeList.h"
 
+#include "BLI_task.h"
+
 #include "FilterBase.h"
 
 // forward declarations
@@ -48,6 +51,11 @@ class ImageSource;
 /// type for list of image sources
 typedef std::vector<ImageSource*> ImageSourceList;
 
+/// number of image rows converted by a task
+#define VT_CONVERT_TASK_ROWS 16
+/// minimum number of pixels to convert an image in parallel
+#define VT_CONVERT_PARALLEL_MIN_PIXELS (256 * 256)
+
 
 /// base class for image filters
 class ImageBase
@@ -169,85 +177,123 @@ protected:
 	/// perform loop detection
 	bool loopDetect(ImageBase * img);
 
-	/// template for image conversion
+	/// parameters of an image conversion by rows
+	template <class SRC> struct ConvData
+	{
+		ImageBase *image;
+		/// filter converting the source pixels, with its previous filters
+		FilterBase *filter;
+		/// next filters of the chain, applied together on each converted row
+		std::vector<FilterBase *> rowFilters;
+		SRC srcBuff;
+		short *srcSize;
+		unsigned int pixSize;
+		/// source row of each image row
+		std::vector<short> rows;
+		/// source column of each image column, empty if the image is not scaled
+		std::vector<short> cols;
+		/// number of pixels of an image row
+		unsigned int width;
+	};
+
+	/// convert the image rows from start to end
+	template <class SRC> void convRows(const ConvData<SRC>& data, int start, int end)
+	{
+		for (int j = start; j < end; ++j)
+		{
+			const short y = data.rows[j];
+			// the rows are contiguous in the image buffer
+			unsigned int *dstBuff = m_image + j * data.width;
+			SRC srcRow = data.srcBuff + y * data.srcSize[0] * data.pixSize;
+			if (data.cols.empty())
+			{
+				for (short x = 0; x < data.srcSize[0]; ++x)
+					dstBuff[x] = data.filter->convert(srcRow + x * data.pixSize, x, y, data.srcSize, data.pixSize);
+			}
+			else
+			{
+				for (unsigned int i = 0; i < data.width; ++i)
+				{
+					const short x = data.cols[i];
+					dstBuff[i] = data.filter->convert(srcRow + x * data.pixSize, x, y, data.srcSize, data.pixSize);
+				}
+			}
+			// the filters of the row are applied while the row is still in cache
+			for (FilterBase *filter : data.rowFilters)
+				filter->filterRow(dstBuff, data.width);
+		}
+	}
+
+	template <class SRC> static void convRowsTask(void *userdata, const int iter)
+	{
+		ConvData<SRC> *data = (ConvData<SRC> *)userdata;
+		const int start = iter * VT_CONVERT_TASK_ROWS;
+		const int end = std::min(start + VT_CONVERT_TASK_ROWS, (int)data->rows.size());
+		data->image->convRows(*data, start, end);
+	}
+
+	/** template for image conversion
+	 * The rows are converted in parallel, the last filters of the chain which only depend on
+	 * the converted pixel are applied on whole rows instead of pixel by pixel.
+	 */
 	template<class FLT, class SRC> void convImage(FLT & filter, SRC srcBuff,
 		short * srcSize)
 	{
-		// destination buffer
-		unsigned int * dstBuff = m_image;
+		ConvData<SRC> data;
+		data.image = this;
+		data.srcBuff = srcBuff;
+		data.srcSize = srcSize;
 		// pixel size from filter
-		unsigned int pixSize = filter.firstPixelSize();
+		data.pixSize = filter.firstPixelSize();
+		// the first filter of the chain converts the source, it is always applied by pixel
+		data.filter = &filter;
+		while (data.filter->canFilterRows() && data.filter->getPrevious() != nullptr)
+		{
+			data.rowFilters.insert(data.rowFilters.begin(), data.filter);
+			data.filter = data.filter->getPrevious()->m_filter;
+		}
+
 		// if no scaling is needed
 		if (srcSize[0] == m_size[0] && srcSize[1] == m_size[1])
-			// if flipping isn't required
-			if (!m_flip)
-				// copy bitmap
-				for (short y = 0; y < m_size[1]; ++y)
-					for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-						// copy pixel
-						*dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
-		// otherwise flip image top to bottom
-			else
-			{
-				// go to last row of image
-				srcBuff += srcSize[0] * (srcSize[1] - 1) * pixSize;
-				// copy bitmap
-				for (short y = m_size[1] - 1; y >= 0; --y, srcBuff -= 2 * srcSize[0] * pixSize)
-					for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-						// copy pixel
-						*dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
-			}
-			// else scale picture (nearest neighbor)
+		{
+			// flip image top to bottom if required
+			for (short y = 0; y < m_size[1]; ++y)
+				data.rows.push_back(m_flip ? m_size[1] - y - 1 : y);
+			data.width = m_size[0];
+		}
+		// else scale picture (nearest neighbor)
 		else
 		{
-			// interpolation accumulator
+			// interpolation accumulators
 			int accHeight = srcSize[1] >> 1;
-			// if flipping is required
-			if (m_flip)
-				// go to last row of image
-				srcBuff += srcSize[0] * (srcSize[1] - 1) * pixSize;
-			// process image rows
-			for (int y = 0; y < srcSize[1]; ++y)
+			for (short y = 0; y < srcSize[1]; ++y)
 			{
-				// increase height accum
 				accHeight += m_size[1];
 				// if pixel row has to be drawn
 				if (accHeight >= srcSize[1])
 				{
-					// decrease accum
 					accHeight -= srcSize[1];
-					// width accum
-					int accWidth = srcSize[0] >> 1;
-					// process row
-					for (int x = 0; x < srcSize[0]; ++x)
-					{
-						// increase width accum
-						accWidth += m_size[0];
-						// if pixel has to be drawn
-						if (accWidth >= srcSize[0])
-						{
-							// decrease accum
-							accWidth -= srcSize[0];
-							// convert pixel
-							*dstBuff = filter.convert(srcBuff, x, m_flip ? srcSize[1] - y - 1 : y,
-								srcSize, pixSize);
-							// next pixel
-							++dstBuff;
-						}
-						// shift source pointer
-						srcBuff += pixSize;
-					}
+					data.rows.push_back(m_flip ? srcSize[1] - y - 1 : y);
 				}
-				// if pixel row will not be drawn
-				else
-					// move source pointer to next row
-					srcBuff += pixSize * srcSize[0];
-				// if y flipping is required
-				if (m_flip)
-					// go to previous row of image
-					srcBuff -= 2 * pixSize * srcSize[0];
 			}
+			int accWidth = srcSize[0] >> 1;
+			for (short x = 0; x < srcSize[0]; ++x)
+			{
+				accWidth += m_size[0];
+				// if pixel has to be drawn
+				if (accWidth >= srcSize[0])
+				{
+					accWidth -= srcSize[0];
+					data.cols.push_back(x);
+				}
+			}
+			data.width = data.cols.size();
 		}
+
+		const unsigned int numRows = data.rows.size();
+		const unsigned int tasks = (numRows + VT_CONVERT_TASK_ROWS - 1) / VT_CONVERT_TASK_ROWS;
+		BLI_task_parallel_range(0, tasks, &data, convRowsTask<SRC>,
+			(numRows * data.width >= VT_CONVERT_PARALLEL_MIN_PIXELS));
 	}
 
 	// template for specific filter preprocessing
@@ -45,13 +45,23 @@
 #include "PIL_time.h"
 
 #include <string>
+#include <algorithm>
 
 #include "VideoFFmpeg.h"
 #include "Exception.h"
 
+extern "C" {
+#include <libavutil/pixdesc.h>
+#include "BLI_task.h"
+}
+
 
 // default framerate
 const double defFrameRate = 25.0;
+// minimum number of pixels of a frame to convert it by slices in parallel
+#define VIDEO_PARALLEL_MIN_PIXELS (1280 * 720)
+// minimum number of rows of a slice
+#define VIDEO_SLICE_MIN_ROWS 64
 
 // macro for exception handling and logging
 #define CATCH_EXCP catch (Exception & exp) \
@@ -62,11 +72,13 @@ const double defFrameRate = 25.0;
 // constructor
 VideoFFmpeg::VideoFFmpeg (HRESULT * hRslt) : VideoBase(), 
 m_codec(nullptr), m_formatCtx(nullptr), m_codecCtx(nullptr), 
-m_frame(nullptr), m_frameDeinterlaced(nullptr), m_frameRGB(nullptr), m_imgConvertCtx(nullptr),
+m_frame(nullptr), m_frameDeinterlaced(nullptr), m_frameRGB(nullptr),
 m_deinterlace(false), m_preseek(0),	m_videoStream(-1), m_baseFrameRate(25.0),
 m_lastFrame(-1),  m_eof(false), m_externTime(false), m_curPosition(-1), m_startTime(0), 
 m_captWidth(0), m_captHeight(0), m_captRate(0.f), m_isImage(false),
-m_isThreaded(false), m_isStreaming(false), m_stopThread(false), m_cacheStarted(false)
+m_isThreaded(false), m_isStreaming(false), m_stopThread(false), m_cacheStarted(false),
+m_frameCacheWrite(0), m_frameCacheRead(0), m_cacheConversion(CACHE_CONVERT_NONE),
+m_cacheFrameDeinterlaced(nullptr)
 {
 	// set video format
 	m_format = RGB24;
@@ -75,9 +87,13 @@ m_isThreaded(false), m_isStreaming(false), m_stopThread(false), m_cacheStarted(f
 	// construction is OK
 	*hRslt = S_OK;
 	BLI_listbase_clear(&m_thread);
-	pthread_mutex_init(&m_cacheMutex, nullptr);
-	BLI_listbase_clear(&m_frameCacheFree);
-	BLI_listbase_clear(&m_frameCacheBase);
+	for (int i=0; i<CACHE_FRAME_SIZE; i++)
+	{
+		m_frameCache[i].framePosition = -1;
+		m_frameCache[i].frame = nullptr;
+		m_frameCache[i].frameRGB = nullptr;
+		m_frameCache[i].conversion = CACHE_CONVERT_NONE;
+	}
 	BLI_listbase_clear(&m_packetCacheFree);
 	BLI_listbase_clear(&m_packetCacheBase);
 }
@@ -112,6 +128,7 @@ bool VideoFFmpeg::release()
 	}
 	if (m_frame)
 	{
+		av_frame_unref(m_frame);
 		av_free(m_frame);
 		m_frame = nullptr;
 	}
@@ -127,11 +144,7 @@ bool VideoFFmpeg::release()
 		av_free(m_frameRGB);
 		m_frameRGB = nullptr;
 	}
-	if (m_imgConvertCtx)
-	{
-		sws_freeContext(m_imgConvertCtx);
-		m_imgConvertCtx = nullptr;
-	}
+	releaseConvert(m_convertSlices);
 	m_codec = nullptr;
 	m_status = SourceStopped;
 	m_lastFrame = -1;
@@ -142,26 +155,228 @@ AVFrame	*VideoFFmpeg::allocFrameRGB()
 {
 	AVFrame *frame;
 	frame = av_frame_alloc();
-	if (m_format == RGBA32)
+	avpicture_fill((AVPicture*)frame, 
+		(uint8_t*)MEM_callocN(avpicture_get_size(
+			AV_PIX_FMT_RGBA,
+			m_codecCtx->width, m_codecCtx->height),
+			"ffmpeg rgba"),
+		AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height);
+	return frame;
+}
+
+AVFrame *VideoFFmpeg::allocFrameDeinterlaced()
+{
+	AVFrame *frame = av_frame_alloc();
+	avpicture_fill((AVPicture*)frame, 
+		(uint8_t*)MEM_callocN(avpicture_get_size(
+		m_codecCtx->pix_fmt,
+		m_codecCtx->width, m_codecCtx->height), 
+		"ffmpeg deinterlace"), 
+		m_codecCtx->pix_fmt, m_codecCtx->width, m_codecCtx->height);
+	return frame;
+}
+
+bool VideoFFmpeg::initConvert(std::vector<ConvertSlice>& slices)
+{
+	const int width = m_codecCtx->width;
+	const int height = m_codecCtx->height;
+	const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(m_codecCtx->pix_fmt);
+
+	// only the planar formats are split, the second plane of the other formats can be a palette
+	int sliceCount = 1;
+	if (desc && (desc->flags & AV_PIX_FMT_FLAG_PLANAR) &&
+		!(desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_BITSTREAM)) &&
+		width * height >= VIDEO_PARALLEL_MIN_PIXELS)
 	{
-		avpicture_fill((AVPicture*)frame, 
-			(uint8_t*)MEM_callocN(avpicture_get_size(
-				AV_PIX_FMT_RGBA,
-				m_codecCtx->width, m_codecCtx->height),
-				"ffmpeg rgba"),
-			AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height);
-	} else 
+		sliceCount = std::max(1, std::min(BLI_system_thread_count(), height / VIDEO_SLICE_MIN_ROWS));
+	}
+
+	// the slices start on a row of the subsampled chroma planes
+	const int align = desc ? (1 << desc->log2_chroma_h) : 1;
+	const int rows = ((height / sliceCount + align - 1) / align) * align;
+
+	for (int start = 0; start < height; start += rows)
 	{
-		avpicture_fill((AVPicture*)frame, 
-			(uint8_t*)MEM_callocN(avpicture_get_size(
-				AV_PIX_FMT_RGB24,
-				m_codecCtx->width, m_codecCtx->height),
-				"ffmpeg rgb"),
-			AV_PIX_FMT_RGB24, m_codecCtx->width, m_codecCtx->height);
+		ConvertSlice slice;
+		slice.start = start;
+		slice.height = std::min(rows, height - start);
+		slice.context = sws_getContext(
+			width,
+			slice.height,
+			m_codecCtx->pix_fmt,
+			width,
+			slice.height,
+			AV_PIX_FMT_RGBA,
+			SWS_FAST_BILINEAR,
+			nullptr, nullptr, nullptr);
+		if (!slice.context)
+		{
+			releaseConvert(slices);
+			return false;
+		}
+		slices.push_back(slice);
+	}
+	return true;
+}
+
+void VideoFFmpeg::releaseConvert(std::vector<ConvertSlice>& slices)
+{
+	for (ConvertSlice& slice : slices)
+		sws_freeContext(slice.context);
+	slices.clear();
+}
+
+void VideoFFmpeg::convertSliceTask(void *userdata, const int iter)
+{
+	ConvertData *data = (ConvertData *)userdata;
+	const ConvertSlice& slice = (*data->slices)[iter];
+	AVFrame *frame = data->frame;
+
+	uint8_t *src[4];
+	for (int p=0; p<4; p++)
+	{
+		// the second and third planes are the chroma planes
+		const int row = (p == 1 || p == 2) ? (slice.start >> data->chromaShift) : slice.start;
+		src[p] = frame->data[p] ? frame->data[p] + row * frame->linesize[p] : nullptr;
+	}
+	uint8_t *dst[4] = {data->dst + slice.start * data->stride, nullptr, nullptr, nullptr};
+	int dstStride[4] = {data->stride, 0, 0, 0};
+
+	sws_scale(slice.context,
+		src,
+		frame->linesize,
+		0,
+		slice.height,
+		dst,
+		dstStride);
+}
+
+void VideoFFmpeg::convertFrame(const std::vector<ConvertSlice>& slices, AVFrame *frame, uint8_t *dst, int stride)
+{
+	const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(m_codecCtx->pix_fmt);
+
+	ConvertData data;
+	data.slices = &slices;
+	data.frame = frame;
+	data.dst = dst;
+	data.stride = stride;
+	data.chromaShift = desc ? desc->log2_chroma_h : 0;
+
+	const unsigned int count = slices.size();
+	BLI_task_parallel_range(0, count, &data, convertSliceTask, (count > 1));
+}
+
+AVFrame *VideoFFmpeg::deinterlaceFrame(AVFrame *frame, AVFrame *deinterlaced)
+{
+	if (avpicture_deinterlace(
+		(AVPicture*) deinterlaced,
+		(const AVPicture*) frame,
+		m_codecCtx->pix_fmt,
+		m_codecCtx->width,
+		m_codecCtx->height) >= 0)
+	{
+		return deinterlaced;
 	}
 	return frame;
 }
 
+void VideoFFmpeg::processFrame(AVFrame *frame)
+{
+	// init image, if needed
+	init(short(m_codecCtx->width), short(m_codecCtx->height));
+	if (m_image == nullptr || m_avail)
+		return;
+
+	// without filter and scaling, convert straight in the image buffer to avoid the copy of process
+	const bool direct = (m_pyfilter == nullptr && m_size[0] == m_orgSize[0] && m_size[1] == m_orgSize[1]);
+	const CacheConversion conversion = direct ? CACHE_CONVERT_NONE :
+		(m_deinterlace ? CACHE_CONVERT_DEINTERLACE_RGB : CACHE_CONVERT_RGB);
+	// the cache thread converts the next frames when the RGBA frame is needed
+	m_cacheConversion.store(conversion, std::memory_order_relaxed);
+
+	if (!direct)
+	{
+		// this frame MUST be the first one of the queue if it comes from the cache
+		const CacheFrame *cacheFrame = m_cacheStarted ? firstCacheFrame() : nullptr;
+		if (cacheFrame && cacheFrame->frame == frame && cacheFrame->conversion == conversion)
+		{
+			// already converted by the cache thread, only the filters are applied
+			process((BYTE*)(cacheFrame->frameRGB->data[0]));
+			return;
+		}
+	}
+
+	AVFrame *input = m_deinterlace ? deinterlaceFrame(frame, m_frameDeinterlaced) : frame;
+
+	if (direct)
+	{
+		const int stride = m_size[0] * sizeof(unsigned int);
+		uint8_t *image = (uint8_t *)m_image;
+		// a negative stride writes the rows bottom to top
+		if (m_flip)
+			convertFrame(m_convertSlices, input, image + (m_size[1] - 1) * stride, -stride);
+		else
+			convertFrame(m_convertSlices, input, image, stride);
+		m_avail = true;
+	}
+	else
+	{
+		convertFrame(m_convertSlices, input, m_frameRGB->data[0], m_frameRGB->linesize[0]);
+		process((BYTE*)(m_frameRGB->data[0]));
+	}
+}
+
+void VideoFFmpeg::convertCacheFrame(CacheFrame *cacheFrame)
+{
+	const CacheConversion conversion = (CacheConversion)m_cacheConversion.load(std::memory_order_relaxed);
+	cacheFrame->conversion = CACHE_CONVERT_NONE;
+	// the frame is converted by the main thread, or the cache thread has no conversion context
+	if (conversion == CACHE_CONVERT_NONE || m_cacheConvertSlices.empty())
+		return;
+
+	if (!cacheFrame->frameRGB)
+		cacheFrame->frameRGB = allocFrameRGB();
+
+	AVFrame *input = cacheFrame->frame;
+	if (conversion == CACHE_CONVERT_DEINTERLACE_RGB)
+	{
+		if (!m_cacheFrameDeinterlaced)
+			m_cacheFrameDeinterlaced = allocFrameDeinterlaced();
+		input = deinterlaceFrame(input, m_cacheFrameDeinterlaced);
+	}
+
+	convertFrame(m_cacheConvertSlices, input, cacheFrame->frameRGB->data[0], cacheFrame->frameRGB->linesize[0]);
+	cacheFrame->conversion = conversion;
+}
+
+int VideoFFmpeg::decodePacket(AVFrame *frame, AVPacket *packet)
+{
+	AVPacket flushPacket;
+	if (packet == nullptr)
+	{
+		// an empty packet returns the frames still in the decoder
+		av_init_packet(&flushPacket);
+		flushPacket.data = nullptr;
+		flushPacket.size = 0;
+		packet = &flushPacket;
+	}
+	int frameFinished = 0;
+	// the frames are reference counted, release the previous one
+	av_frame_unref(frame);
+	avcodec_decode_video2(m_codecCtx, frame, &frameFinished, packet);
+	return frameFinished;
+}
+
+long VideoFFmpeg::getFramePosition(AVFrame *frame, int64_t dts, int64_t startTs, double timeBase)
+{
+	// with frame threading the frame is returned after the next packets, use the dts of its own packet
+	if (frame->pkt_dts != AV_NOPTS_VALUE)
+		dts = frame->pkt_dts;
+	if (dts == AV_NOPTS_VALUE)
+		return m_curPosition + 1;
+	return (long)((dts-startTs) * (m_baseFrameRate*timeBase) + 0.5);
+}
+
 // set initial parameters
 void VideoFFmpeg::initParams (short width, short height, float rate, bool image)
 {
@@ -217,6 +432,11 @@ int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AV
 		return -1;
 	}
 	codecCtx->workaround_bugs = 1;
+	// decode on several threads, the frame threads delay the frames so they are not used for images and capture
+	codecCtx->thread_count = BLI_system_thread_count();
+	codecCtx->thread_type = (m_isImage || inputFormat) ? FF_THREAD_SLICE : (FF_THREAD_FRAME | FF_THREAD_SLICE);
+	// the decoded frames are kept in the cache without copy
+	codecCtx->refcounted_frames = 1;
 	if (avcodec_open2(codecCtx, codec, nullptr) < 0)
 	{
 		avformat_close_input(&formatCtx);
@@ -238,52 +458,16 @@ int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AV
 	m_formatCtx = formatCtx;
 	m_videoStream = videoStream;
 	m_frame = av_frame_alloc();
-	m_frameDeinterlaced = av_frame_alloc();
 
 	// allocate buffer if deinterlacing is required
-	avpicture_fill((AVPicture*)m_frameDeinterlaced, 
-		(uint8_t*)MEM_callocN(avpicture_get_size(
-		m_codecCtx->pix_fmt,
-		m_codecCtx->width, m_codecCtx->height), 
-		"ffmpeg deinterlace"), 
-		m_codecCtx->pix_fmt, m_codecCtx->width, m_codecCtx->height);
+	m_frameDeinterlaced = allocFrameDeinterlaced();
 
-	// check if the pixel format supports Alpha
-	if (m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32 ||
-		m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32 ||
-		m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32_1 ||
-		m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32_1) 
-	{
-		// allocate buffer to store final decoded frame
-		m_format = RGBA32;
-		// allocate sws context
-		m_imgConvertCtx = sws_getContext(
-			m_codecCtx->width,
-			m_codecCtx->height,
-			m_codecCtx->pix_fmt,
-			m_codecCtx->width,
-			m_codecCtx->height,
-			AV_PIX_FMT_RGBA,
-			SWS_FAST_BILINEAR,
-			nullptr, nullptr, nullptr);
-	} else
-	{
-		// allocate buffer to store final decoded frame
-		m_format = RGB24;
-		// allocate sws context
-		m_imgConvertCtx = sws_getContext(
-			m_codecCtx->width,
-			m_codecCtx->height,
-			m_codecCtx->pix_fmt,
-			m_codecCtx->width,
-			m_codecCtx->height,
-			AV_PIX_FMT_RGB24,
-			SWS_FAST_BILINEAR,
-			nullptr, nullptr, nullptr);
-	}
+	// the frames are always converted to RGBA, the formats without alpha get an opaque alpha
+	m_format = RGBA32;
+	// allocate buffer to store final decoded frame if it can't be converted in the image
 	m_frameRGB = allocFrameRGB();
 
-	if (!m_imgConvertCtx) {
+	if (!initConvert(m_convertSlices)) {
 		avcodec_close(m_codecCtx);
 		m_codecCtx = nullptr;
 		avformat_close_input(&m_formatCtx);
@@ -307,7 +491,9 @@ int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AV
  * The main thread is responsible for positioning the frame pointer in the
  * file correctly before calling startCache() which starts this thread.
  * The cache is organized in two layers: 1) a cache of 20-30 undecoded packets to keep
- * memory and CPU low 2) a cache of 5 decoded frames. 
+ * memory and CPU low 2) a ring of decoded frames, converted to RGB by this thread only when
+ * the main thread applies filters or scaling, else converted when displayed. The ring has
+ * a single writer, this thread, and a single reader, the main thread, so it doesn't lock. 
  * If the main thread does not find the frame in the cache (because the video has restarted
  * or because the GE is lagging), it stops the cache with StopCache() (this is a synchronous
  * function: it sends a signal to stop the cache thread and wait for confirmation), then
@@ -316,8 +502,6 @@ int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AV
 void *VideoFFmpeg::cacheThread(void *data)
 {
 	VideoFFmpeg* video = (VideoFFmpeg*)data;
-	// holds the frame that is being decoded
-	CacheFrame *currentFrame = nullptr;
 	CachePacket *cachePacket;
 	bool endOfFile = false;
 	int frameFinished = 0;
@@ -362,88 +546,65 @@ void *VideoFFmpeg::cacheThread(void *data)
 				break;
 			}
 		}
-		// frame cache is also used by main thread, lock
-		if (currentFrame == nullptr) 
+		// frame cache is also used by main thread, a frame is free when the main thread is less than a full ring behind
+		bool frameReady = false;
+		const unsigned int write = video->m_frameCacheWrite.load(std::memory_order_relaxed);
+		if (write - video->m_frameCacheRead.load(std::memory_order_acquire) < CACHE_FRAME_SIZE)
 		{
-			// no current frame being decoded, take free one
-			pthread_mutex_lock(&video->m_cacheMutex);
-			if ((currentFrame = (CacheFrame *)video->m_frameCacheFree.first) != nullptr)
-				BLI_remlink(&video->m_frameCacheFree, currentFrame);
-			pthread_mutex_unlock(&video->m_cacheMutex);
-		}
-		if (currentFrame != nullptr)
-		{
-			// this frame is out of free and busy queue, we can manipulate it without locking
+			// this frame is out of the frames read by the main thread, we can manipulate it without locking
+			CacheFrame *currentFrame = &video->m_frameCache[write % CACHE_FRAME_SIZE];
 			frameFinished = 0;
 			while (!frameFinished && (cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr)
 			{
 				BLI_remlink(&video->m_packetCacheBase, cachePacket);
-				// use m_frame because when caching, it is not used in main thread
-				// we can't use currentFrame directly because we need to convert to RGB first
-				avcodec_decode_video2(video->m_codecCtx, 
-					video->m_frame, &frameFinished, 
-					&cachePacket->packet);
+				// decode directly in the cache frame, it is converted to RGB only when displayed
+				frameFinished = video->decodePacket(currentFrame->frame, &cachePacket->packet);
 				if (frameFinished) 
 				{
-					AVFrame * input = video->m_frame;
+					AVFrame * input = currentFrame->frame;
 
 					/* This means the data wasnt read properly, this check stops crashing */
 					if (   input->data[0]!=0 || input->data[1]!=0 
 						|| input->data[2]!=0 || input->data[3]!=0)
 					{
-						if (video->m_deinterlace) 
-						{
-							if (avpicture_deinterlace(
-								(AVPicture*) video->m_frameDeinterlaced,
-								(const AVPicture*) video->m_frame,
-								video->m_codecCtx->pix_fmt,
-								video->m_codecCtx->width,
-								video->m_codecCtx->height) >= 0)
-							{
-								input = video->m_frameDeinterlaced;
-							}
-						}
-						// convert to RGB24
-						sws_scale(video->m_imgConvertCtx,
-							input->data,
-							input->linesize,
-							0,
-							video->m_codecCtx->height,
-							currentFrame->frame->data,
-							currentFrame->frame->linesize);
-						// move frame to queue, this frame is necessarily the next one
-						video->m_curPosition = (long)((cachePacket->packet.dts-startTs) * (video->m_baseFrameRate*timeBase) + 0.5);
+						// this frame is necessarily the next one
+						video->m_curPosition = video->getFramePosition(input, cachePacket->packet.dts, startTs, timeBase);
 						currentFrame->framePosition = video->m_curPosition;
-						pthread_mutex_lock(&video->m_cacheMutex);
-						BLI_addtail(&video->m_frameCacheBase, currentFrame);
-						pthread_mutex_unlock(&video->m_cacheMutex);
-						currentFrame = nullptr;
+						frameReady = true;
 					}
 				}
 				av_free_packet(&cachePacket->packet);
 				BLI_addtail(&video->m_packetCacheFree, cachePacket);
 			} 
-			if (currentFrame && endOfFile) 
+			if (!frameReady && endOfFile && video->m_packetCacheBase.first == nullptr) 
 			{
-				// no more packet and end of file => put a special frame that indicates that
-				currentFrame->framePosition = -1;
-				pthread_mutex_lock(&video->m_cacheMutex);
-				BLI_addtail(&video->m_frameCacheBase, currentFrame);
-				pthread_mutex_unlock(&video->m_cacheMutex);
-				currentFrame = nullptr;
-				// no need to stay any longer in this thread
-				break;
+				// no more packet, get the frames delayed by the decoding threads
+				if (video->decodePacket(currentFrame->frame, nullptr) && currentFrame->frame->data[0] != 0)
+				{
+					video->m_curPosition = video->getFramePosition(currentFrame->frame, AV_NOPTS_VALUE, startTs, timeBase);
+					currentFrame->framePosition = video->m_curPosition;
+					frameReady = true;
+				}
+				else
+				{
+					// end of file => put a special frame that indicates that
+					currentFrame->framePosition = -1;
+					video->m_frameCacheWrite.store(write + 1, std::memory_order_release);
+					// no need to stay any longer in this thread
+					break;
+				}
+			}
+			if (frameReady)
+			{
+				// convert the frame here if the main thread would only copy it for the filters
+				video->convertCacheFrame(currentFrame);
+				// move frame to queue, the release makes the frame visible to the main thread
+				video->m_frameCacheWrite.store(write + 1, std::memory_order_release);
 			}
 		}
-		// small sleep to avoid unnecessary looping
-		PIL_sleep_ms(10);
-	}
-	// before quitting, put back the current frame to queue to allow freeing
-	if (currentFrame)
-	{
-		pthread_mutex_lock(&video->m_cacheMutex);
-		BLI_addtail(&video->m_frameCacheFree, currentFrame);
-		pthread_mutex_unlock(&video->m_cacheMutex);
+		// small sleep to avoid unnecessary looping, a decoded frame is directly followed by the next one
+		if (!frameReady)
+			PIL_sleep_ms(10);
 	}
 	return 0;
 }
@@ -458,10 +619,14 @@ bool VideoFFmpeg::startCache()
 		m_stopThread = false;
 		for (int i=0; i<CACHE_FRAME_SIZE; i++)
 		{
-			CacheFrame *frame = new CacheFrame();
-			frame->frame = allocFrameRGB();
-			BLI_addtail(&m_frameCacheFree, frame);
+			m_frameCache[i].framePosition = -1;
+			m_frameCache[i].frame = av_frame_alloc();
+			m_frameCache[i].conversion = CACHE_CONVERT_NONE;
 		}
+		// without conversion contexts the main thread converts all the frames
+		initConvert(m_cacheConvertSlices);
+		m_frameCacheWrite = 0;
+		m_frameCacheRead = 0;
 		for (int i=0; i<CACHE_PACKET_SIZE; i++) 
 		{
 			CachePacket *packet = new CachePacket();
@@ -481,22 +646,26 @@ void VideoFFmpeg::stopCache()
 		m_stopThread = true;
 		BLI_end_threads(&m_thread);
 		// now delete the cache
-		CacheFrame *frame;
 		CachePacket *packet;
-		while ((frame = (CacheFrame *)m_frameCacheBase.first) != nullptr)
+		for (int i=0; i<CACHE_FRAME_SIZE; i++)
 		{
-			BLI_remlink(&m_frameCacheBase, frame);
-			MEM_freeN(frame->frame->data[0]);
-			av_free(frame->frame);
-			delete frame;
+			av_frame_unref(m_frameCache[i].frame);
+			av_free(m_frameCache[i].frame);
+			m_frameCache[i].frame = nullptr;
+			if (m_frameCache[i].frameRGB)
+			{
+				MEM_freeN(m_frameCache[i].frameRGB->data[0]);
+				av_free(m_frameCache[i].frameRGB);
+				m_frameCache[i].frameRGB = nullptr;
+			}
 		}
-		while ((frame = (CacheFrame *)m_frameCacheFree.first) != nullptr)
+		if (m_cacheFrameDeinterlaced)
 		{
-			BLI_remlink(&m_frameCacheFree, frame);
-			MEM_freeN(frame->frame->data[0]);
-			av_free(frame->frame);
-			delete frame;
+			MEM_freeN(m_cacheFrameDeinterlaced->data[0]);
+			av_free(m_cacheFrameDeinterlaced);
+			m_cacheFrameDeinterlaced = nullptr;
 		}
+		releaseConvert(m_cacheConvertSlices);
 		while ((packet = (CachePacket *)m_packetCacheBase.first) != nullptr)
 		{
 			BLI_remlink(&m_packetCacheBase, packet);
@@ -512,20 +681,35 @@ void VideoFFmpeg::stopCache()
 	}
 }
 
+VideoFFmpeg::CacheFrame *VideoFFmpeg::firstCacheFrame()
+{
+	const unsigned int read = m_frameCacheRead.load(std::memory_order_relaxed);
+	// the acquire makes the frame written by the cache thread visible
+	if (read == m_frameCacheWrite.load(std::memory_order_acquire))
+		return nullptr;
+	return &m_frameCache[read % CACHE_FRAME_SIZE];
+}
+
+void VideoFFmpeg::popCacheFrame()
+{
+	const unsigned int read = m_frameCacheRead.load(std::memory_order_relaxed);
+	// release the decoder buffers before giving the frame back to the cache thread
+	av_frame_unref(m_frameCache[read % CACHE_FRAME_SIZE].frame);
+	m_frameCacheRead.store(read + 1, std::memory_order_release);
+}
+
 void VideoFFmpeg::releaseFrame(AVFrame *frame)
 {
-	if (frame == m_frameRGB)
+	if (frame == m_frame)
 	{
 		// this is not a frame from the cache, ignore
 		return;
 	}
 	// this frame MUST be the first one of the queue
-	pthread_mutex_lock(&m_cacheMutex);
-	CacheFrame *cacheFrame = (CacheFrame *)m_frameCacheBase.first;
+	CacheFrame *cacheFrame = firstCacheFrame();
 	assert (cacheFrame != nullptr && cacheFrame->frame == frame);
-	BLI_remlink(&m_frameCacheBase, cacheFrame);
-	BLI_addtail(&m_frameCacheFree, cacheFrame);
-	pthread_mutex_unlock(&m_cacheMutex);
+	(void)cacheFrame;
+	popCacheFrame();
 }
 
 // open video file
@@ -831,10 +1015,8 @@ void VideoFFmpeg::calcImage (unsigned int texId, double ts, bool mipmap, unsigne
 				}
 				// save actual frame
 				m_lastFrame = actFrame;
-				// init image, if needed
-				init(short(m_codecCtx->width), short(m_codecCtx->height));
-				// process image
-				process((BYTE*)(frame->data[0]));
+				// convert and process image
+				processFrame(frame);
 				// finished with the frame, release it so that cache can reuse it
 				releaseFrame(frame);
 				// in case it is an image, automatically stop reading it
@@ -887,9 +1069,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 	{
 		// when cache is active, we must not read the file directly
 		do {
-			pthread_mutex_lock(&m_cacheMutex);
-			frame = (CacheFrame *)m_frameCacheBase.first;
-			pthread_mutex_unlock(&m_cacheMutex);
+			frame = firstCacheFrame();
 			// no need to remove the frame from the queue: the cache thread does not touch the head, only the tail
 			if (frame == nullptr)
 			{
@@ -924,10 +1104,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 				return nullptr;
 			}
 			// this frame is not useful, release it
-			pthread_mutex_lock(&m_cacheMutex);
-			BLI_remlink(&m_frameCacheBase, frame);
-			BLI_addtail(&m_frameCacheFree, frame);
-			pthread_mutex_unlock(&m_cacheMutex);
+			popCacheFrame();
 		} while (true);
 	}
 	double timeBase = av_q2d(m_formatCtx->streams[m_videoStream]->time_base);
@@ -949,13 +1126,9 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 			{
 				if (packet.stream_index == m_videoStream) 
 				{
-					avcodec_decode_video2(
-						m_codecCtx, 
-						m_frame, &frameFinished, 
-						&packet);
-					if (frameFinished)
+					if (decodePacket(m_frame, &packet))
 					{
-						m_curPosition = (long)((packet.dts-startTs) * (m_baseFrameRate*timeBase) + 0.5);
+						m_curPosition = getFramePosition(m_frame, packet.dts, startTs, timeBase);
 					}
 				}
 				av_free_packet(&packet);
@@ -1020,6 +1193,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 
 	// find the correct frame, in case of streaming and no cache, it means just
 	// return the next frame. This is not quite correct, may need more work
+	bool readEnd = true;
 	while (av_read_frame(m_formatCtx, &packet) >= 0)
 	{
 		if (packet.stream_index == m_videoStream) 
@@ -1029,12 +1203,12 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 
 			/* If m_isImage, while the data is not read properly (png, tiffs, etc formats may need several pass), else don't need while loop*/
 			do {
-				avcodec_decode_video2(m_codecCtx, m_frame, &frameFinished, &packet);
+				frameFinished = decodePacket(m_frame, &packet);
 				counter++;
 			} while ((input->data[0] == 0 && input->data[1] == 0 && input->data[2] == 0 && input->data[3] == 0) && counter < 10 && m_isImage);
 
-			// remember dts to compute exact frame number
-			dts = packet.dts;
+			// remember dts to compute exact frame number, the frame can come from a previous packet
+			dts = (frameFinished && m_frame->pkt_dts != AV_NOPTS_VALUE) ? m_frame->pkt_dts : packet.dts;
 			if (frameFinished && !posFound) 
 			{
 				if (dts >= targetTs)
@@ -1053,40 +1227,36 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 					&& input->data[2]==0 && input->data[3]==0)
 				{
 					av_free_packet(&packet);
+					readEnd = false;
 					break;
 				}
 
-				if (m_deinterlace) 
-				{
-					if (avpicture_deinterlace(
-						(AVPicture*) m_frameDeinterlaced,
-						(const AVPicture*) m_frame,
-						m_codecCtx->pix_fmt,
-						m_codecCtx->width,
-						m_codecCtx->height) >= 0)
-					{
-						input = m_frameDeinterlaced;
-					}
-				}
-				// convert to RGB24
-				sws_scale(m_imgConvertCtx,
-					input->data,
-					input->linesize,
-					0,
-					m_codecCtx->height,
-					m_frameRGB->data,
-					m_frameRGB->linesize);
+				// the frame is converted to RGB by the caller
 				av_free_packet(&packet);
 				frameLoaded = true;
+				readEnd = false;
 				break;
 			}
 		}
 		av_free_packet(&packet);
 	}
+	if (m_isFile && readEnd)
+	{
+		// no more packet, get the frames delayed by the decoding threads
+		while (!frameLoaded && decodePacket(m_frame, nullptr))
+		{
+			dts = m_frame->pkt_dts;
+			if (!posFound && dts != AV_NOPTS_VALUE && dts >= targetTs)
+				posFound = 1;
+			frameLoaded = (posFound == 1 && m_frame->data[0] != 0);
+		}
+		// the decoder must be reset after it was drained
+		avcodec_flush_buffers(m_codecCtx);
+	}
 	m_eof = m_isFile && !frameLoaded;
 	if (frameLoaded)
 	{
-		m_curPosition = (long)((dts-startTs) * (m_baseFrameRate*timeBase) + 0.5);
+		m_curPosition = getFramePosition(m_frame, dts, startTs, timeBase);
 		if (m_isThreaded)
 		{
 			// normal case for file: first locate, then start cache
@@ -1096,7 +1266,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 				m_isThreaded = false;
 			}
 		}
-		return m_frameRGB;
+		return m_frame;
 	}
 	return nullptr;
 }
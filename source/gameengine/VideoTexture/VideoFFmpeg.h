@@ -64,6 +64,9 @@ static inline AVCodecContext *get_codec_from_stream(AVStream* stream)
 
 #include "VideoBase.h"
 
+#include <atomic>
+#include <vector>
+
 #define CACHE_FRAME_SIZE	10
 #define CACHE_PACKET_SIZE	30
 
@@ -113,10 +116,16 @@ protected:
 	AVFrame	*m_frame;
 	// deinterlaced frame if codec requires it
 	AVFrame	*m_frameDeinterlaced;
-	// decoded RGB24 frame if codec requires it
+	// decoded RGBA frame if the image can't be converted directly
 	AVFrame	*m_frameRGB;
-	// conversion from raw to RGB is done with sws_scale
-	struct SwsContext *m_imgConvertCtx;
+	// conversion from raw to RGBA is done with sws_scale, by slices of rows converted in parallel
+	struct ConvertSlice {
+		struct SwsContext *context;
+		int start;
+		int height;
+	};
+	// conversion slices of the main thread, the cache thread has its own contexts
+	std::vector<ConvertSlice> m_convertSlices;
 	// should the codec be deinterlaced?
 	bool m_deinterlace;
 	// number of frame of preseek
@@ -175,38 +184,98 @@ protected:
 	/// common function to video file and capture
 	int openStream(const char *filename, AVInputFormat *inputFormat, AVDictionary **formatParams);
 
-	/// check if a frame is available and load it in pFrame, return true if a frame could be retrieved
+	/// check if a frame is available and load it in pFrame, return the decoded frame if it could be retrieved
 	AVFrame* grabFrame(long frame);
 
 	/// in case of caching, put the frame back in free queue
 	void releaseFrame(AVFrame* frame);
 
+	/// create the conversion contexts of the slices
+	bool initConvert(std::vector<ConvertSlice>& slices);
+	/// release the conversion contexts
+	void releaseConvert(std::vector<ConvertSlice>& slices);
+	/// convert a decoded frame to RGBA rows, flipped if stride is negative
+	void convertFrame(const std::vector<ConvertSlice>& slices, AVFrame *frame, uint8_t *dst, int stride);
+	/// return the deinterlaced frame, or the frame itself if it can't be deinterlaced
+	AVFrame *deinterlaceFrame(AVFrame *frame, AVFrame *deinterlaced);
+	/** convert a decoded frame to the image, directly in the image buffer when no filter or scaling is used.
+	 * With a filter or scaling the frame is converted to RGBA by the cache thread when it is available,
+	 * the main thread then only applies the filters.
+	 */
+	void processFrame(AVFrame *frame);
+
 	/// start thread to load the video file/capture/stream 
 	bool startCache();
 	void stopCache();
 
 private:
+	/// conversion of the decoded frames done by the cache thread
+	enum CacheConversion {
+		/// the frames are converted by the main thread directly in the image
+		CACHE_CONVERT_NONE = 0,
+		/// the frames are converted to RGBA for the filters or scaling
+		CACHE_CONVERT_RGB,
+		/// the frames are deinterlaced and converted to RGBA
+		CACHE_CONVERT_DEINTERLACE_RGB
+	};
+
 	typedef struct {
-		Link link;
 		long framePosition;
 		AVFrame *frame;
+		/// RGBA frame converted by the cache thread, allocated at its first conversion
+		AVFrame *frameRGB;
+		/// conversion done in frameRGB
+		CacheConversion conversion;
 	} CacheFrame;
 	typedef struct {
 		Link link;
 		AVPacket packet;
 	} CachePacket;
 
+	struct ConvertData {
+		const std::vector<ConvertSlice> *slices;
+		AVFrame *frame;
+		uint8_t *dst;
+		int stride;
+		/// vertical subsampling of the chroma planes
+		int chromaShift;
+	};
+
 	bool m_stopThread;
 	bool m_cacheStarted;
 	ListBase m_thread;
-	ListBase m_frameCacheBase;	// list of frames that are ready
-	ListBase m_frameCacheFree;	// list of frames that are unused
+	/** Ring of decoded frames, the cache thread is the only writer and the main thread the only reader.
+	 * The frames hold a reference on the decoder buffers, they are not copied before the conversion.
+	 */
+	CacheFrame m_frameCache[CACHE_FRAME_SIZE];
+	/// Number of frames written and read in the ring, each one modified only by its thread.
+	std::atomic<unsigned int> m_frameCacheWrite;
+	std::atomic<unsigned int> m_frameCacheRead;
 	ListBase m_packetCacheBase;	// list of packets that are ready for decoding
 	ListBase m_packetCacheFree;	// list of packets that are unused
-	pthread_mutex_t m_cacheMutex;
+	/** Conversion of the next frames by the cache thread, set by the main thread from the path used by
+	 * the last displayed frame. Converting on the cache thread overlaps the conversion with the game,
+	 * but it costs an RGBA copy per cached frame, it's only done when a filter or scaling needs the copy.
+	 */
+	std::atomic<int> m_cacheConversion;
+	/// conversion slices and deinterlaced frame of the cache thread
+	std::vector<ConvertSlice> m_cacheConvertSlices;
+	AVFrame *m_cacheFrameDeinterlaced;
 
 	AVFrame	*allocFrameRGB();
+	AVFrame *allocFrameDeinterlaced();
+	/// convert a decoded frame of the cache thread if the main thread uses the RGBA frames
+	void convertCacheFrame(CacheFrame *cacheFrame);
+	/// decode a packet, nullptr to get the frames delayed by the decoding threads
+	int decodePacket(AVFrame *frame, AVPacket *packet);
+	/// return the frame number of a decoded frame
+	long getFramePosition(AVFrame *frame, int64_t dts, int64_t startTs, double timeBase);
+	/// return the first frame of the ring, nullptr if it is empty
+	CacheFrame *firstCacheFrame();
+	/// remove the first frame of the ring
+	void popCacheFrame();
 	static void *cacheThread(void *);
+	static void convertSliceTask(void *userdata, const int iter);
 };
 
 inline VideoFFmpeg *getFFmpeg(PyImage *self)
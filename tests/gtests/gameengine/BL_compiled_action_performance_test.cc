@@ -0,0 +1,57 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "BL_compiled_action_test_util.h"
+
+extern "C" {
+#include "PIL_time_utildefines.h"
+}
+
+#include <random>
+#include <vector>
+
+#define NUM_FRAMES 2000
+
+/* Evaluate the action over many frames with a F-Curve evaluation per value, with the compiled
+ * channels and with the baked channels. */
+TEST(compiled_action, EvaluatePerformance)
+{
+	std::mt19937 rng(42);
+	TestAction test(rng);
+	BL_CompiledAction compiled(&test.m_action, 0.0f);
+	BL_CompiledAction baked(&test.m_action, BAKE_RATE);
+
+	std::vector<BL_CompiledAction::Target> objectTargets;
+	std::vector<BL_CompiledAction::Target> keyTargets;
+	std::vector<BL_CompiledAction::Target> bakedObjectTargets;
+	std::vector<BL_CompiledAction::Target> bakedKeyTargets;
+	compiled.Bind(&test.m_object->id, objectTargets);
+	compiled.Bind(&test.m_key->id, keyTargets);
+	baked.Bind(&test.m_object->id, bakedObjectTargets);
+	baked.Bind(&test.m_key->id, bakedKeyTargets);
+
+	std::vector<float> frames(NUM_FRAMES);
+	std::uniform_real_distribution<float> frame(0.0f, 40.0f);
+	for (float& value : frames) {
+		value = frame(rng);
+	}
+
+	TIMEIT_START(fcurves);
+	for (float value : frames) {
+		test.Evaluate(value);
+	}
+	TIMEIT_END(fcurves);
+
+	TIMEIT_START(compiled);
+	for (float value : frames) {
+		evaluate_compiled(test, compiled, objectTargets, keyTargets, value);
+	}
+	TIMEIT_END(compiled);
+
+	TIMEIT_START(baked);
+	for (float value : frames) {
+		evaluate_compiled(test, baked, bakedObjectTargets, bakedKeyTargets, value);
+	}
+	TIMEIT_END(baked);
+}
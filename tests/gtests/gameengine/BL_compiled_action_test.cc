@@ -0,0 +1,77 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "BL_compiled_action_test_util.h"
+
+#include <random>
+#include <vector>
+
+#define BAKE_EPSILON 0.05f
+
+namespace {
+
+/** Evaluate the compiled action on frames before, in and after the action range and compare
+ * each animated value with the value of its F-Curve.
+ */
+void expect_compiled_near(TestAction& test, float bakeRate, float epsilon)
+{
+	BL_CompiledAction compiled(&test.m_action, bakeRate);
+	ASSERT_TRUE(compiled.IsSupported());
+
+	std::vector<BL_CompiledAction::Target> objectTargets;
+	std::vector<BL_CompiledAction::Target> keyTargets;
+	compiled.Bind(&test.m_object->id, objectTargets);
+	compiled.Bind(&test.m_key->id, keyTargets);
+
+	// Every value is written by one channel bound to the armature or to the shape key.
+	for (unsigned int i = 0, size = objectTargets.size(); i < size; ++i) {
+		EXPECT_NE(objectTargets[i].m_value == nullptr, keyTargets[i].m_value == nullptr);
+	}
+
+	std::vector<float> expected(test.m_values.size());
+	for (float frame = -5.0f; frame < 50.0f; frame += 0.37f) {
+		test.Evaluate(frame);
+		for (unsigned int i = 0, size = test.m_values.size(); i < size; ++i) {
+			expected[i] = *test.m_values[i];
+			*test.m_values[i] = 0.0f;
+		}
+
+		evaluate_compiled(test, compiled, objectTargets, keyTargets, frame);
+		for (unsigned int i = 0, size = test.m_values.size(); i < size; ++i) {
+			EXPECT_NEAR(expected[i], *test.m_values[i], epsilon) << test.m_fcurves[i]->rna_path << "[" <<
+				test.m_fcurves[i]->array_index << "] at frame " << frame;
+		}
+	}
+}
+
+}  // namespace
+
+/* Without baking the channels are evaluated from their F-Curve, the values must be the same. */
+TEST(compiled_action, CompiledEquivalence)
+{
+	std::mt19937 rng(42);
+	TestAction test(rng);
+	expect_compiled_near(test, 0.0f, 0.0f);
+}
+
+/* The baked channels are interpolated between samples, the values must be close.
+ * The cyclic curves ending before the action range are not baked, their jump back to the first key
+ * would be interpolated over a sample. */
+TEST(compiled_action, BakedEquivalence)
+{
+	std::mt19937 rng(42);
+	TestAction test(rng);
+	expect_compiled_near(test, BAKE_RATE, BAKE_EPSILON);
+}
+
+/* The animation system can't evaluate concurrently the drivers of a shared action. */
+TEST(compiled_action, DriverUnsupported)
+{
+	std::mt19937 rng(42);
+	TestAction test(rng);
+	test.m_fcurves.back()->driver = (ChannelDriver *)MEM_callocN(sizeof(ChannelDriver), __func__);
+
+	BL_CompiledAction compiled(&test.m_action, 0.0f);
+	EXPECT_FALSE(compiled.IsSupported());
+}
@@ -0,0 +1,163 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_BL_COMPILED_ACTION_TEST_UTIL_H__
+#define __BLENDER_TESTING_BL_COMPILED_ACTION_TEST_UTIL_H__
+
+#include "BL_CompiledAction.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+#include "BLI_utildefines.h"
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_curve_types.h"
+#include "DNA_key_types.h"
+#include "DNA_object_types.h"
+#include "BKE_action.h"
+#include "BKE_fcurve.h"
+}
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#define NUM_BONES 60
+#define NUM_KEYS 12
+#define BAKE_RATE 4.0f
+
+namespace {
+
+/** Armature object and shape key animated by an action of random F-Curves.
+ * The keys are on integer frames, so the linear curves and the cycle ends don't fall between
+ * two baked samples.
+ */
+class TestAction
+{
+public:
+	bAction m_action;
+	Object *m_object;
+	Key *m_key;
+	/// The F-Curves of the action with the value they animate and its range.
+	std::vector<FCurve *> m_fcurves;
+	std::vector<float *> m_values;
+	std::vector<float> m_mins;
+	std::vector<float> m_maxs;
+
+	TestAction(std::mt19937& rng)
+	{
+		memset(&m_action, 0, sizeof(bAction));
+		BLI_strncpy(m_action.id.name, "ACAction", sizeof(m_action.id.name));
+
+		m_object = (Object *)MEM_callocN(sizeof(Object), __func__);
+		BLI_strncpy(m_object->id.name, "OBArmature", sizeof(m_object->id.name));
+		m_object->pose = (bPose *)MEM_callocN(sizeof(bPose), __func__);
+
+		m_key = (Key *)MEM_callocN(sizeof(Key), __func__);
+		BLI_strncpy(m_key->id.name, "KEKey", sizeof(m_key->id.name));
+
+		for (unsigned int i = 0; i < NUM_BONES; ++i) {
+			const std::string name = "Bone" + std::to_string(i);
+			const std::string path = "pose.bones[\"" + name + "\"].";
+			bPoseChannel *pchan = BKE_pose_channel_verify(m_object->pose, name.c_str());
+
+			for (unsigned short j = 0; j < 3; ++j) {
+				AddCurve(rng, path + "location", j, &pchan->loc[j], -FLT_MAX, FLT_MAX);
+				AddCurve(rng, path + "scale", j, &pchan->size[j], -FLT_MAX, FLT_MAX);
+			}
+			for (unsigned short j = 0; j < 4; ++j) {
+				AddCurve(rng, path + "rotation_quaternion", j, &pchan->quat[j], -FLT_MAX, FLT_MAX);
+			}
+		}
+
+		for (unsigned int i = 0; i < NUM_KEYS; ++i) {
+			KeyBlock *kb = (KeyBlock *)MEM_callocN(sizeof(KeyBlock), __func__);
+			const std::string name = "Key" + std::to_string(i);
+			BLI_strncpy(kb->name, name.c_str(), sizeof(kb->name));
+			kb->slidermin = 0.0f;
+			kb->slidermax = 1.0f;
+			BLI_addtail(&m_key->block, kb);
+
+			AddCurve(rng, "key_blocks[\"" + name + "\"].value", 0, &kb->curval, kb->slidermin, kb->slidermax);
+		}
+	}
+
+	~TestAction()
+	{
+		free_fcurves(&m_action.curves);
+		BKE_pose_free(m_object->pose);
+		MEM_freeN(m_object);
+		BLI_freelistN(&m_key->block);
+		MEM_freeN(m_key);
+	}
+
+	/// Evaluate the F-Curves one by one, as the animation system does without the RNA path resolution.
+	void Evaluate(float frame)
+	{
+		for (unsigned int i = 0, size = m_fcurves.size(); i < size; ++i) {
+			*m_values[i] = std::min(std::max(evaluate_fcurve(m_fcurves[i], frame), m_mins[i]), m_maxs[i]);
+		}
+	}
+
+private:
+	/// Add a F-Curve of random keys in the frames 0 to 40, some curves are constant, linear or cyclic.
+	void AddCurve(std::mt19937& rng, const std::string& path, int index, float *value, float min, float max)
+	{
+		std::uniform_real_distribution<float> keyValue(-1.5f, 1.5f);
+		std::uniform_int_distribution<int> keyStep(2, 8);
+		const unsigned int curve = m_fcurves.size();
+
+		FCurve *fcu = (FCurve *)MEM_callocN(sizeof(FCurve), __func__);
+		fcu->rna_path = BLI_strdup(path.c_str());
+		fcu->array_index = index;
+		fcu->flag = FCURVE_VISIBLE | FCURVE_SELECTED;
+
+		std::vector<BezTriple> bezts;
+		for (int frame = 0; frame <= 40; frame += keyStep(rng)) {
+			BezTriple bezt;
+			memset(&bezt, 0, sizeof(BezTriple));
+			bezt.vec[1][0] = (float)frame;
+			bezt.vec[1][1] = keyValue(rng);
+			bezt.vec[0][0] = (float)frame - 1.0f;
+			bezt.vec[0][1] = bezt.vec[1][1];
+			bezt.vec[2][0] = (float)frame + 1.0f;
+			bezt.vec[2][1] = bezt.vec[1][1];
+			bezt.ipo = (curve % 7 == 3) ? BEZT_IPO_CONST : ((curve % 5 == 2) ? BEZT_IPO_LIN : BEZT_IPO_BEZ);
+			bezt.h1 = bezt.h2 = HD_AUTO_ANIM;
+			bezt.f1 = bezt.f2 = bezt.f3 = SELECT;
+			bezts.push_back(bezt);
+		}
+
+		fcu->totvert = bezts.size();
+		fcu->bezt = (BezTriple *)MEM_mallocN(sizeof(BezTriple) * bezts.size(), __func__);
+		std::copy(bezts.begin(), bezts.end(), fcu->bezt);
+		calchandles_fcurve(fcu);
+
+		if (curve % 11 == 6) {
+			add_fmodifier(&fcu->modifiers, FMODIFIER_TYPE_CYCLES);
+		}
+
+		BLI_addtail(&m_action.curves, fcu);
+		m_fcurves.push_back(fcu);
+		m_values.push_back(value);
+		m_mins.push_back(min);
+		m_maxs.push_back(max);
+	}
+};
+
+/// Evaluate the compiled action for the armature and the shape key.
+void evaluate_compiled(TestAction& test, const BL_CompiledAction& compiled, const std::vector<BL_CompiledAction::Target>& objectTargets,
+		const std::vector<BL_CompiledAction::Target>& keyTargets, float frame)
+{
+	compiled.Evaluate(frame, objectTargets, &test.m_object->id);
+	compiled.Evaluate(frame, keyTargets, &test.m_key->id);
+}
+
+}  // namespace
+
+#endif  // __BLENDER_TESTING_BL_COMPILED_ACTION_TEST_UTIL_H__
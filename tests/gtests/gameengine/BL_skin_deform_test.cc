@@ -0,0 +1,271 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "BL_SkinKernel.h"
+
+#include "DNA_meshdata_types.h"
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/LU>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define NUM_VERTS 5000
+#define NUM_GROUPS 24
+#define MAX_WEIGHTS 6
+#define EPSILON 1e-4f
+
+namespace {
+
+/// Random skinned mesh, the deform groups map directly to the bones.
+class SkinMesh
+{
+public:
+	std::vector<MVert> m_mverts;
+	std::vector<MDeformVert> m_dverts;
+	std::vector<MDeformWeight> m_weights;
+	/// Skinning matrix of each group, nullptr for the groups not deforming the mesh.
+	std::vector<float *> m_groupMats;
+	std::vector<float> m_matrices;
+	float m_preMat[16];
+	float m_postMat[16];
+
+	SkinMesh(unsigned int seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_int_distribution<int> normal(-32767, 32767);
+		std::uniform_int_distribution<int> numWeights(0, MAX_WEIGHTS);
+		// Groups out of the deform groups range are ignored.
+		std::uniform_int_distribution<int> group(0, NUM_GROUPS + 1);
+		std::uniform_real_distribution<float> weight(0.0f, 1.0f);
+
+		m_matrices.resize(NUM_GROUPS * 16);
+		for (unsigned int i = 0; i < NUM_GROUPS; ++i) {
+			Eigen::Matrix4f mat = Eigen::Matrix4f::Identity();
+			mat.topLeftCorner<3, 3>() += Eigen::Matrix3f::Random() * 0.3f;
+			mat.col(3).head<3>() = Eigen::Vector3f(unit(rng), unit(rng), unit(rng));
+			Eigen::Matrix4f::Map(&m_matrices[i * 16]) = mat;
+			// Every fourth group has a non deforming bone.
+			m_groupMats.push_back((i % 4 == 3) ? nullptr : &m_matrices[i * 16]);
+		}
+
+		Eigen::Matrix4f post = Eigen::Matrix4f::Identity();
+		post.topLeftCorner<3, 3>() = Eigen::AngleAxisf(0.7f, Eigen::Vector3f(0.0f, 0.6f, 0.8f)).toRotationMatrix() * 1.5f;
+		post.col(3).head<3>() = Eigen::Vector3f(1.0f, -2.0f, 0.5f);
+		Eigen::Matrix4f::Map(m_postMat) = post;
+		Eigen::Matrix4f::Map(m_preMat) = post.inverse();
+
+		m_mverts.resize(NUM_VERTS);
+		m_dverts.resize(NUM_VERTS);
+		std::vector<int> counts(NUM_VERTS);
+		for (unsigned int i = 0; i < NUM_VERTS; ++i) {
+			MVert& mvert = m_mverts[i];
+			for (unsigned int j = 0; j < 3; ++j) {
+				mvert.co[j] = coord(rng);
+				mvert.no[j] = normal(rng);
+			}
+			counts[i] = numWeights(rng);
+		}
+
+		// The weights are stored once all allocated to keep the pointers valid.
+		for (unsigned int i = 0; i < NUM_VERTS; ++i) {
+			for (int j = 0; j < counts[i]; ++j) {
+				MDeformWeight dw;
+				dw.def_nr = group(rng);
+				// Some weights are null.
+				dw.weight = (j == 2) ? 0.0f : weight(rng);
+				m_weights.push_back(dw);
+			}
+		}
+
+		MDeformWeight *dw = m_weights.data();
+		for (unsigned int i = 0; i < NUM_VERTS; ++i) {
+			m_dverts[i].dw = dw;
+			m_dverts[i].totweight = counts[i];
+			m_dverts[i].flag = 0;
+			dw += counts[i];
+		}
+	}
+
+	/** Deform the vertices as BL_SkinDeformer::BGEDeformVerts did before the packed influences.
+	 * The vertices without deforming influence are skipped as they got a division by zero.
+	 */
+	void DeformReference(std::vector<float>& transverts, std::vector<float>& transnors, std::vector<bool>& deformed) const
+	{
+		const Eigen::Matrix4f pre_mat = Eigen::Matrix4f::Map(m_preMat);
+		const Eigen::Matrix4f post_mat = Eigen::Matrix4f::Map(m_postMat);
+		Eigen::Matrix4f chan_mat, norm_chan_mat;
+
+		const MDeformVert *dv = m_dverts.data();
+		for (int i = 0; i < NUM_VERTS; ++i, dv++) {
+			float contrib = 0.0f, weight, max_weight = -1.0f;
+			const float *pchan = nullptr;
+			Eigen::Vector3f normorg(m_mverts[i].no[0], m_mverts[i].no[1], m_mverts[i].no[2]);
+			Eigen::Map<Eigen::Vector3f> norm = Eigen::Vector3f::Map(&transnors[i * 3]);
+			Eigen::Vector4f vec(0.0f, 0.0f, 0.0f, 1.0f);
+			Eigen::Vector4f co(transverts[i * 3], transverts[i * 3 + 1], transverts[i * 3 + 2], 1.0f);
+
+			deformed[i] = false;
+
+			if (!dv->totweight)
+				continue;
+
+			co = pre_mat * co;
+
+			const MDeformWeight *dw = dv->dw;
+			for (unsigned int j = dv->totweight; j != 0; j--, dw++) {
+				const int index = dw->def_nr;
+
+				if (index < NUM_GROUPS && (pchan = m_groupMats[index])) {
+					weight = dw->weight;
+
+					if (weight) {
+						chan_mat = Eigen::Matrix4f::Map(pchan);
+
+						// Update Vertex Position
+						vec.noalias() += (chan_mat * co - co) * weight;
+
+						// Save the most influential channel so we can use it to update the vertex normal
+						if (weight > max_weight)
+						{
+							max_weight = weight;
+							norm_chan_mat = chan_mat;
+						}
+
+						contrib += weight;
+					}
+				}
+			}
+
+			if (contrib == 0.0f) {
+				continue;
+			}
+
+			// Update Vertex Normal
+			norm = norm_chan_mat.topLeftCorner<3, 3>() * normorg;
+
+			co.noalias() += vec / contrib;
+			co[3] = 1.0f; // Make sure we have a 1 for the w component!
+
+			co = post_mat * co;
+
+			transverts[i * 3] = co[0];
+			transverts[i * 3 + 1] = co[1];
+			transverts[i * 3 + 2] = co[2];
+			deformed[i] = true;
+		}
+	}
+
+	void BuildInfluences(BL_SkinInfluences& influences, std::vector<float>& palette) const
+	{
+		std::vector<int> dfnrToPalette(NUM_GROUPS, -1);
+		for (unsigned int i = 0; i < NUM_GROUPS; ++i) {
+			if (m_groupMats[i]) {
+				dfnrToPalette[i] = palette.size() / 16;
+				palette.insert(palette.end(), m_groupMats[i], m_groupMats[i] + 16);
+			}
+		}
+
+		influences.Build(m_dverts.data(), NUM_VERTS, dfnrToPalette);
+	}
+
+	void InitTransverts(std::vector<float>& transverts, std::vector<float>& transnors) const
+	{
+		transverts.resize(NUM_VERTS * 3);
+		transnors.assign(NUM_VERTS * 3, 0.0f);
+		for (unsigned int i = 0; i < NUM_VERTS; ++i) {
+			for (unsigned int j = 0; j < 3; ++j) {
+				transverts[i * 3 + j] = m_mverts[i].co[j];
+			}
+		}
+	}
+};
+
+typedef void (*DeformFunc)(const BL_SkinInfluences&, const float *, const MVert *, const float[16], const float[16],
+                           float (*)[3], float (*)[3], int, int);
+
+void test_deform_equivalence(DeformFunc func, unsigned int seed)
+{
+	const SkinMesh mesh(seed);
+
+	std::vector<float> refverts, refnors;
+	std::vector<bool> deformed(NUM_VERTS);
+	mesh.InitTransverts(refverts, refnors);
+	mesh.DeformReference(refverts, refnors, deformed);
+
+	BL_SkinInfluences influences;
+	std::vector<float> palette;
+	mesh.BuildInfluences(influences, palette);
+
+	std::vector<float> transverts, transnors;
+	mesh.InitTransverts(transverts, transnors);
+	// Deform by chunks as BL_SkinDeformer does.
+	for (int start = 0; start < NUM_VERTS; start += 256) {
+		func(influences, palette.data(), mesh.m_mverts.data(), mesh.m_preMat, mesh.m_postMat,
+		     (float (*)[3])transverts.data(), (float (*)[3])transnors.data(), start, std::min(start + 256, NUM_VERTS));
+	}
+
+	for (unsigned int i = 0; i < NUM_VERTS; ++i) {
+		for (unsigned int j = 0; j < 3; ++j) {
+			const float ref = refverts[i * 3 + j];
+			EXPECT_NEAR(ref, transverts[i * 3 + j], EPSILON * std::max(1.0f, std::abs(ref))) << "vertex " << i;
+			if (deformed[i]) {
+				const float refnor = refnors[i * 3 + j];
+				EXPECT_NEAR(refnor, transnors[i * 3 + j], EPSILON * std::max(1.0f, std::abs(refnor))) << "normal " << i;
+			}
+		}
+	}
+}
+
+}  // namespace
+
+TEST(skin_deform, InfluencesPacking)
+{
+	const SkinMesh mesh(1);
+	BL_SkinInfluences influences;
+	std::vector<float> palette;
+	mesh.BuildInfluences(influences, palette);
+
+	ASSERT_EQ(NUM_VERTS, influences.m_vertices.size());
+	for (unsigned int i = 0; i < NUM_VERTS; ++i) {
+		const BL_SkinVertex& skinvert = influences.m_vertices[i];
+		const MDeformVert& dv = mesh.m_dverts[i];
+
+		// Only the non-zero weights of the deforming groups are kept.
+		unsigned int count = 0;
+		for (int j = 0; j < dv.totweight; ++j) {
+			const MDeformWeight& dw = dv.dw[j];
+			if (dw.def_nr < NUM_GROUPS && mesh.m_groupMats[dw.def_nr] && dw.weight) {
+				const BL_SkinInfluence& influence = influences.m_influences[skinvert.m_start + count];
+				EXPECT_EQ(dw.weight, influence.m_weight);
+				EXPECT_EQ(0, memcmp(mesh.m_groupMats[dw.def_nr], &palette[influence.m_palette * 16], sizeof(float[16])));
+				++count;
+			}
+		}
+		EXPECT_EQ(count, skinvert.m_count);
+	}
+}
+
+TEST(skin_deform, ScalarEquivalence)
+{
+	for (unsigned int seed = 0; seed < 4; ++seed) {
+		test_deform_equivalence(BL_SkinDeformVertsScalar, seed);
+	}
+}
+
+#ifdef __SSE2__
+TEST(skin_deform, SSE2Equivalence)
+{
+	for (unsigned int seed = 0; seed < 4; ++seed) {
+		test_deform_equivalence(BL_SkinDeformVertsSSE2, seed);
+	}
+}
+#endif
@@ -0,0 +1,54 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "CM_Sort.h"
+
+#include "CM_sort_test_util.h"
+
+extern "C" {
+#include "PIL_time_utildefines.h"
+}
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define NUM_ITEMS 10000
+#define NUM_FRAMES 100
+
+/* Sort again each frame 10k items of the previous frame with slightly moved keys,
+ * with the coherent sort and with std::sort. */
+TEST(sort, CoherentSortPerformance)
+{
+	std::mt19937 rng(42);
+	std::vector<Item> items = random_items(rng, NUM_ITEMS, -10.0f, 10.0f);
+	std::vector<Item> scratch;
+	CM_CoherentSort(items, scratch, item_key);
+
+	std::vector<std::vector<Item> > frames;
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		jitter_items(rng, items);
+		frames.push_back(items);
+		CM_CoherentSort(items, scratch, item_key);
+	}
+
+	std::vector<std::vector<Item> > coherentFrames = frames;
+	TIMEIT_START(coherent);
+	for (std::vector<Item>& frameItems : coherentFrames) {
+		CM_CoherentSort(frameItems, scratch, item_key);
+	}
+	TIMEIT_END(coherent);
+
+	TIMEIT_START(std_sort);
+	for (std::vector<Item>& frameItems : frames) {
+		std::sort(frameItems.begin(), frameItems.end(), [](const Item& a, const Item& b) { return a.m_z < b.m_z; });
+	}
+	TIMEIT_END(std_sort);
+
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		for (unsigned int i = 0; i < NUM_ITEMS; ++i) {
+			EXPECT_EQ(frames[frame][i].m_z, coherentFrames[frame][i].m_z);
+		}
+	}
+}
@@ -0,0 +1,94 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "CM_Sort.h"
+
+#include "CM_sort_test_util.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define NUM_ITEMS 10000
+#define NUM_FRAMES 100
+
+namespace {
+
+std::vector<Item> stable_sorted(const std::vector<Item>& items)
+{
+	std::vector<Item> sorted = items;
+	std::stable_sort(sorted.begin(), sorted.end(), [](const Item& a, const Item& b) { return a.m_z < b.m_z; });
+	return sorted;
+}
+
+void expect_same_order(const std::vector<Item>& expected, const std::vector<Item>& items)
+{
+	ASSERT_EQ(expected.size(), items.size());
+	for (unsigned int i = 0, size = items.size(); i < size; ++i) {
+		EXPECT_EQ(expected[i].m_z, items[i].m_z);
+		EXPECT_EQ(expected[i].m_index, items[i].m_index);
+	}
+}
+
+}  // namespace
+
+TEST(sort, SortableFloatBits)
+{
+	const float values[] = {-1e30f, -2.0f, -1.0f, -1e-30f, -0.0f, 0.0f, 1e-30f, 1.0f, 2.0f, 1e30f};
+	for (unsigned int i = 1; i < sizeof(values) / sizeof(float); ++i) {
+		EXPECT_LE(CM_SortableFloatBits(values[i - 1]), CM_SortableFloatBits(values[i]));
+	}
+}
+
+/* The radix and coherent sorts are stable: the items of equal keys keep their order. */
+TEST(sort, RadixSortStable)
+{
+	std::mt19937 rng(42);
+	std::vector<Item> items = random_items(rng, NUM_ITEMS, -100.0f, 100.0f);
+	// Many equal keys.
+	for (Item& item : items) {
+		item.m_z = (float)(int)item.m_z;
+	}
+
+	const std::vector<Item> expected = stable_sorted(items);
+	std::vector<Item> scratch;
+	CM_RadixSort(items, scratch, item_key);
+	expect_same_order(expected, items);
+}
+
+TEST(sort, InsertionSortMaxMoves)
+{
+	std::mt19937 rng(42);
+	std::vector<Item> items = random_items(rng, NUM_ITEMS, -100.0f, 100.0f);
+
+	// Random items need more than a few moves per item.
+	std::vector<Item> unsorted = items;
+	EXPECT_FALSE(CM_InsertionSort(unsorted, item_key, NUM_ITEMS));
+
+	const std::vector<Item> expected = stable_sorted(items);
+	EXPECT_TRUE(CM_InsertionSort(items, item_key, NUM_ITEMS * NUM_ITEMS));
+	expect_same_order(expected, items);
+}
+
+/* Sort again each frame the items of the previous frame with slightly moved keys,
+ * the result must match a full stable sort. */
+TEST(sort, CoherentSortFrames)
+{
+	std::mt19937 rng(42);
+	std::vector<Item> items = random_items(rng, NUM_ITEMS, -10.0f, 10.0f);
+	std::vector<Item> scratch;
+
+	// First frame in random order, the radix sort is used.
+	std::vector<Item> expected = stable_sorted(items);
+	CM_CoherentSort(items, scratch, item_key);
+	expect_same_order(expected, items);
+
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		jitter_items(rng, items);
+
+		expected = stable_sorted(items);
+		CM_CoherentSort(items, scratch, item_key);
+		expect_same_order(expected, items);
+	}
+}
@@ -0,0 +1,44 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_CM_SORT_TEST_UTIL_H__
+#define __BLENDER_TESTING_CM_SORT_TEST_UTIL_H__
+
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Sorted item remembering its initial index to check the stability.
+struct Item
+{
+	float m_z;
+	unsigned int m_index;
+};
+
+float item_key(const Item& item)
+{
+	return item.m_z;
+}
+
+std::vector<Item> random_items(std::mt19937& rng, unsigned int count, float min, float max)
+{
+	std::uniform_real_distribution<float> dist(min, max);
+	std::vector<Item> items(count);
+	for (unsigned int i = 0; i < count; ++i) {
+		items[i] = {dist(rng), i};
+	}
+	return items;
+}
+
+/// Move slightly the keys, as the depth of the polygons when the camera moves slowly.
+void jitter_items(std::mt19937& rng, std::vector<Item>& items)
+{
+	std::uniform_real_distribution<float> dist(-0.01f, 0.01f);
+	for (Item& item : items) {
+		item.m_z += dist(rng);
+	}
+}
+
+}  // namespace
+
+#endif  // __BLENDER_TESTING_CM_SORT_TEST_UTIL_H__
@@ -0,0 +1,93 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "EXP_PropertyTable.h"
+
+#include <map>
+#include <random>
+#include <string>
+
+/// The table doesn't dereference the values, fake pointers identify them.
+static EXP_Value *fake_value(unsigned int i)
+{
+	return reinterpret_cast<EXP_Value *>((uintptr_t)(i + 1) * 16);
+}
+
+static void check_table(EXP_PropertyTable& table, const std::map<std::string, EXP_Value *>& reference)
+{
+	ASSERT_EQ(reference.size(), table.GetSize());
+
+	// The entries are sorted by name and found by key at their index.
+	unsigned int index = 0;
+	for (const std::pair<const std::string, EXP_Value *>& item : reference) {
+		const EXP_PropertyTable::Entry& entry = table[index];
+		EXPECT_EQ(item.first, *entry.m_name);
+		EXPECT_EQ(item.first, entry.m_key.GetName());
+		EXPECT_EQ(item.second, entry.m_value);
+		EXPECT_EQ(index, table.FindIndex(entry.m_key));
+		EXPECT_EQ(item.second, table.Find(entry.m_key));
+		++index;
+	}
+}
+
+TEST(property_table, InlineAndIndexed)
+{
+	EXP_PropertyTable table;
+	std::map<std::string, EXP_Value *> reference;
+
+	// Go over the inline size and back to test both storages.
+	for (unsigned int i = 0; i < 40; ++i) {
+		const std::string name = "prop" + std::to_string((i * 7) % 40);
+		table.Insert(EXP_PropertyKey(name), fake_value(i));
+		reference[name] = fake_value(i);
+		check_table(table, reference);
+	}
+
+	for (unsigned int i = 0; i < 40; ++i) {
+		const std::string name = "prop" + std::to_string((i * 11) % 40);
+		const int index = table.FindIndex(EXP_PropertyKey::Find(name));
+		ASSERT_NE(-1, index);
+		table.Remove(index);
+		reference.erase(name);
+		check_table(table, reference);
+	}
+
+	EXPECT_EQ(nullptr, table.Find(EXP_PropertyKey("prop0")));
+}
+
+TEST(property_table, RandomInsertRemove)
+{
+	std::mt19937 rng(0);
+	EXP_PropertyTable table;
+	std::map<std::string, EXP_Value *> reference;
+
+	for (unsigned int i = 0; i < 5000; ++i) {
+		const std::string name = "random" + std::to_string(rng() % 300);
+		const EXP_PropertyKey key(name);
+		const int index = table.FindIndex(key);
+		ASSERT_EQ(reference.count(name) == 1, index != -1);
+
+		if (index == -1) {
+			table.Insert(key, fake_value(i));
+			reference[name] = fake_value(i);
+		}
+		else if (rng() % 3 != 0) {
+			table.Remove(index);
+			reference.erase(name);
+		}
+
+		if (i % 100 == 0) {
+			check_table(table, reference);
+		}
+	}
+	check_table(table, reference);
+}
+
+TEST(property_table, UnknownName)
+{
+	EXPECT_FALSE(EXP_PropertyKey::Find("property_table_never_interned").IsValid());
+	EXP_PropertyKey key("property_table_interned");
+	EXPECT_TRUE(key.IsValid());
+	EXPECT_EQ(key, EXP_PropertyKey::Find("property_table_interned"));
+}
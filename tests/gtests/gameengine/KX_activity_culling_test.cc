@@ -0,0 +1,137 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "KX_ActivityCullingHandler.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#define NUM_SPHERES 2000
+#define NUM_PASSES 20
+#define WORLD_SIZE 400.0f
+#define HYSTERESIS 1.2f
+
+namespace {
+
+/// Random bounding spheres, a few of them are large enough for the cameras to test all the spheres.
+class TestSpheres
+{
+public:
+	std::vector<MT_Vector3> m_centers;
+	std::vector<float> m_radius;
+
+	TestSpheres(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> radius(0.1f, 4.0f);
+		for (unsigned int i = 0; i < NUM_SPHERES; ++i) {
+			m_centers.push_back(RandomPosition(rng));
+			m_radius.push_back((i % 500 == 7) ? 300.0f : radius(rng));
+		}
+	}
+
+	MT_Vector3 RandomPosition(std::mt19937& rng) const
+	{
+		std::uniform_real_distribution<float> position(-WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		std::uniform_real_distribution<float> height(-10.0f, 10.0f);
+		return MT_Vector3(position(rng), position(rng), height(rng));
+	}
+
+	void Set(KX_ActivityCullingHandler& handler, unsigned int count, float radius)
+	{
+		handler.Resize(count, radius);
+		for (unsigned int i = 0; i < count; ++i) {
+			handler.SetSphere(i, m_centers[i], m_radius[i]);
+		}
+	}
+
+	/// Return true if a sphere is in a radius of a camera, radius extended by the sphere radius.
+	bool IsInside(unsigned int index, const std::vector<MT_Vector3>& cameras, float radius) const
+	{
+		for (const MT_Vector3& position : cameras) {
+			if ((m_centers[index] - position).length() <= radius + m_radius[index]) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+/// Compare the grid tests to a test of every sphere against every camera.
+void expect_same_activity(const TestSpheres& spheres, const KX_ActivityCullingHandler& handler, unsigned int count,
+		const std::vector<MT_Vector3>& cameras, float radius)
+{
+	for (unsigned int i = 0; i < count; ++i) {
+		EXPECT_EQ(!spheres.IsInside(i, cameras, radius), handler.MustSuspend(i, true)) << "sphere " << i;
+		EXPECT_EQ(!spheres.IsInside(i, cameras, (radius + spheres.m_radius[i]) * HYSTERESIS - spheres.m_radius[i]),
+		          handler.MustSuspend(i, false)) << "sphere " << i;
+	}
+}
+
+}  // namespace
+
+/* The cameras only test the spheres of the cells around them, the spheres to resume and to keep
+ * active must be the same as with a test of all the spheres, also after moving some spheres,
+ * changing the radius and removing slots. */
+TEST(activity_culling, Grid)
+{
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> move(0, 9);
+	std::uniform_int_distribution<int> cameraCount(1, 3);
+	TestSpheres spheres(rng);
+	KX_ActivityCullingHandler handler;
+
+	unsigned int count = NUM_SPHERES;
+	float radius = 20.0f;
+	spheres.Set(handler, count, radius);
+
+	for (unsigned int pass = 0; pass < NUM_PASSES; ++pass) {
+		std::vector<MT_Vector3> cameras;
+		for (int i = 0, size = cameraCount(rng); i < size; ++i) {
+			cameras.push_back(spheres.RandomPosition(rng));
+		}
+
+		handler.TestCameras(cameras, radius);
+		expect_same_activity(spheres, handler, count, cameras, radius);
+
+		if (pass == NUM_PASSES / 2) {
+			// A new radius builds the grid again.
+			radius = 35.0f;
+			spheres.Set(handler, count, radius);
+		}
+		else if (pass == NUM_PASSES / 4) {
+			count = NUM_SPHERES / 2;
+			handler.Resize(count, radius);
+		}
+		else {
+			for (unsigned int i = 0; i < count; ++i) {
+				if (move(rng) == 0) {
+					spheres.m_centers[i] = spheres.RandomPosition(rng);
+					handler.SetSphere(i, spheres.m_centers[i], spheres.m_radius[i]);
+				}
+			}
+		}
+	}
+}
+
+/* An object is resumed in the activity radius and suspended out of the larger radius, between
+ * both it keeps its state. */
+TEST(activity_culling, Hysteresis)
+{
+	KX_ActivityCullingHandler handler;
+	handler.Resize(1, 10.0f);
+	const std::vector<MT_Vector3> cameras = {MT_Vector3(0.0f, 0.0f, 0.0f)};
+
+	// The activity radius is 11 with the sphere radius, the suspend radius is 13.2.
+	bool suspended = false;
+	for (const std::pair<float, bool>& step : std::vector<std::pair<float, bool> >({
+		{10.5f, false}, {12.0f, false}, {13.0f, false}, {13.5f, true}, {12.0f, true}, {11.5f, true},
+		{10.9f, false}, {13.1f, false}, {50.0f, true}, {0.0f, false}}))
+	{
+		handler.SetSphere(0, MT_Vector3(step.first, 0.0f, 0.0f), 1.0f);
+		handler.TestCameras(cameras, 10.0f);
+		suspended = handler.MustSuspend(0, suspended);
+		EXPECT_EQ(step.second, suspended) << "distance " << step.first;
+	}
+}
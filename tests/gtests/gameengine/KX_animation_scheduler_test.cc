@@ -0,0 +1,131 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "KX_AnimationScheduler.h"
+
+extern "C" {
+#include "BLI_task.h"
+}
+
+#include <mutex>
+#include <random>
+#include <vector>
+
+#define NUM_OBJECTS 1000
+#define NUM_LEVELS 4
+#define NUM_THREADS 4
+#define NUM_ARMATURES 8
+
+namespace {
+
+/// Scheduler recording the updated jobs instead of updating objects, the objects are never dereferenced.
+class TestScheduler : public KX_AnimationScheduler
+{
+public:
+	/// The identifiers of the fake objects, a fake object points to its identifier.
+	std::vector<unsigned int> m_ids;
+	/// The identifiers and depths of the updated jobs, in the order of the updates.
+	std::vector<unsigned int> m_updatedIds;
+	std::vector<unsigned int> m_updatedDepths;
+	std::mutex m_mutex;
+
+	TestScheduler()
+		:m_ids(NUM_OBJECTS)
+	{
+		for (unsigned int i = 0; i < NUM_OBJECTS; ++i) {
+			m_ids[i] = i;
+		}
+	}
+
+	void AddJob(unsigned int id, unsigned int depth, double cost)
+	{
+		m_jobs.push_back({reinterpret_cast<KX_GameObject *>(&m_ids[id]), depth, cost, false});
+	}
+
+	void Update(TaskPool *pool)
+	{
+		UpdateJobs(pool);
+	}
+
+	virtual void UpdateJob(const Job& job)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_updatedIds.push_back(*reinterpret_cast<unsigned int *>(job.m_object));
+		m_updatedDepths.push_back(job.m_depth);
+	}
+};
+
+}  // namespace
+
+/* The objects of a level are updated after all the objects of the previous levels, whatever the
+ * order of the objects and the size of the chunks. */
+TEST(animation_scheduler, LevelOrder)
+{
+	TaskScheduler *taskScheduler = BLI_task_scheduler_create(NUM_THREADS);
+	TaskPool *pool = BLI_task_pool_create(taskScheduler, nullptr);
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<unsigned int> depth(0, NUM_LEVELS - 1);
+	// Cheap objects share a chunk, expensive objects get their own one.
+	std::uniform_real_distribution<double> cost(0.0, 2.0e-5);
+	std::uniform_int_distribution<int> expensive(0, 19);
+
+	TestScheduler scheduler;
+	std::vector<unsigned int> depths(NUM_OBJECTS);
+	for (unsigned int frame = 0; frame < 10; ++frame) {
+		for (unsigned int i = 0; i < NUM_OBJECTS; ++i) {
+			depths[i] = (frame == 0) ? 0 : depth(rng);
+			scheduler.AddJob(i, depths[i], (expensive(rng) == 0) ? 1.0e-3 : cost(rng));
+		}
+
+		scheduler.Update(pool);
+
+		ASSERT_EQ(NUM_OBJECTS, scheduler.m_updatedIds.size());
+		std::vector<unsigned int> updates(NUM_OBJECTS, 0);
+		for (unsigned int i = 0; i < NUM_OBJECTS; ++i) {
+			const unsigned int id = scheduler.m_updatedIds[i];
+			++updates[id];
+			EXPECT_EQ(depths[id], scheduler.m_updatedDepths[i]);
+			if (i > 0) {
+				EXPECT_LE(scheduler.m_updatedDepths[i - 1], scheduler.m_updatedDepths[i]) << "update " << i;
+			}
+		}
+		EXPECT_EQ(std::vector<unsigned int>(NUM_OBJECTS, 1), updates);
+
+		scheduler.m_updatedIds.clear();
+		scheduler.m_updatedDepths.clear();
+	}
+
+	BLI_task_pool_free(pool);
+	BLI_task_scheduler_free(taskScheduler);
+}
+
+/* The armatures created one after the other have consecutive phases, at a reduced rate each
+ * armature is evaluated once every rate frames and the evaluations are spread evenly over the frames. */
+TEST(animation_scheduler, PhaseSpreading)
+{
+	for (unsigned int rate : {1, 2, 4}) {
+		std::vector<int> lastEvaluation(NUM_ARMATURES, -1);
+		for (unsigned int frame = 1; frame <= 16; ++frame) {
+			unsigned int evaluations = 0;
+			for (unsigned int phase = 0; phase < NUM_ARMATURES; ++phase) {
+				if (KX_AnimationScheduler::SkipPose(frame, phase, rate)) {
+					continue;
+				}
+
+				++evaluations;
+				if (lastEvaluation[phase] != -1) {
+					EXPECT_EQ(rate, frame - lastEvaluation[phase]) << "phase " << phase << " rate " << rate;
+				}
+				lastEvaluation[phase] = frame;
+			}
+			EXPECT_EQ(NUM_ARMATURES / rate, evaluations) << "frame " << frame << " rate " << rate;
+		}
+
+		// Every armature was evaluated in the first frames.
+		for (unsigned int phase = 0; phase < NUM_ARMATURES; ++phase) {
+			EXPECT_NE(-1, lastEvaluation[phase]);
+		}
+	}
+}
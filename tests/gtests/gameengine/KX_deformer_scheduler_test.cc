@@ -0,0 +1,208 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "KX_DeformerScheduler.h"
+
+#include "RAS_Deformer.h"
+#include "RAS_MeshObject.h"
+#include "SG_CullingNode.h"
+
+#include "DNA_mesh_types.h"
+
+extern "C" {
+#include "BLI_task.h"
+}
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#define NUM_DEFORMERS 200
+#define NUM_THREADS 4
+
+namespace {
+
+/// Deformer counting its updates, the mesh has no material so no display array is created.
+class TestDeformer : public RAS_Deformer
+{
+public:
+	std::atomic<unsigned int> m_updates;
+
+	TestDeformer(RAS_MeshObject *mesh)
+		:RAS_Deformer(mesh),
+		m_updates(0)
+	{
+	}
+
+	virtual void Relink(std::map<SCA_IObject *, SCA_IObject *>& map)
+	{
+	}
+
+	virtual void Apply(RAS_MeshMaterial *meshmat, RAS_IDisplayArray *array)
+	{
+	}
+
+	virtual bool Update()
+	{
+		++m_updates;
+		return true;
+	}
+
+	virtual void UpdateBuckets()
+	{
+	}
+
+	virtual RAS_Deformer *GetReplica()
+	{
+		return nullptr;
+	}
+};
+
+/// Scheduler taking the deformers and the culling nodes of the objects without game objects.
+class TestScheduler : public KX_DeformerScheduler
+{
+public:
+	using KX_DeformerScheduler::AddDeformer;
+};
+
+/// Deformed objects with their culling node, updated by a task pool.
+class TestScene
+{
+public:
+	Mesh m_mesh;
+	RAS_MeshObject *m_meshObject;
+	std::vector<TestDeformer *> m_deformers;
+	std::vector<SG_CullingNode> m_nodes;
+	TestScheduler m_scheduler;
+	TaskScheduler *m_taskScheduler;
+	TaskPool *m_pool;
+
+	TestScene(unsigned int count)
+		:m_nodes(count)
+	{
+		memset(&m_mesh, 0, sizeof(Mesh));
+		strcpy(m_mesh.id.name, "MEmesh");
+		m_meshObject = new RAS_MeshObject(&m_mesh, RAS_MeshObject::LayersInfo());
+
+		for (unsigned int i = 0; i < count; ++i) {
+			m_deformers.push_back(new TestDeformer(m_meshObject));
+		}
+
+		m_taskScheduler = BLI_task_scheduler_create(NUM_THREADS);
+		m_pool = BLI_task_pool_create(m_taskScheduler, nullptr);
+	}
+
+	~TestScene()
+	{
+		BLI_task_pool_free(m_pool);
+		BLI_task_scheduler_free(m_taskScheduler);
+
+		for (TestDeformer *deformer : m_deformers) {
+			delete deformer;
+		}
+		delete m_meshObject;
+	}
+
+	/// Start a frame, the culling state of the frame is reset as by the scene.
+	void BeginFrame()
+	{
+		for (SG_CullingNode& node : m_nodes) {
+			node.ResetFrameCulled();
+		}
+		m_scheduler.BeginFrame();
+	}
+
+	/// Cull the objects as a camera pass and schedule their deformers, return the number of scheduled deformers.
+	unsigned int Pass(const std::vector<bool>& culled)
+	{
+		unsigned int scheduled = 0;
+		for (unsigned int i = 0, size = m_nodes.size(); i < size; ++i) {
+			m_nodes[i].SetCulled(culled[i]);
+			if (m_scheduler.AddDeformer(m_deformers[i], &m_nodes[i])) {
+				++scheduled;
+			}
+		}
+		m_scheduler.Update(m_pool);
+		return scheduled;
+	}
+
+	unsigned int GetUpdates(unsigned int index) const
+	{
+		return m_deformers[index]->m_updates;
+	}
+};
+
+}  // namespace
+
+/* A deformer scheduled by its object and its parent is updated once, whatever the order
+ * of the schedules. */
+TEST(deformer_scheduler, Duplicates)
+{
+	TestScene scene(NUM_DEFORMERS);
+	scene.BeginFrame();
+
+	std::vector<unsigned int> order;
+	for (unsigned int i = 0; i < NUM_DEFORMERS; ++i) {
+		order.push_back(i);
+		order.push_back(i);
+	}
+	std::mt19937 rng(42);
+	std::shuffle(order.begin(), order.end(), rng);
+
+	for (SG_CullingNode& node : scene.m_nodes) {
+		node.SetCulled(false);
+	}
+	for (unsigned int i : order) {
+		EXPECT_TRUE(scene.m_scheduler.AddDeformer(scene.m_deformers[i], &scene.m_nodes[i]));
+	}
+	scene.m_scheduler.Update(scene.m_pool);
+
+	for (unsigned int i = 0; i < NUM_DEFORMERS; ++i) {
+		EXPECT_EQ(1, scene.GetUpdates(i)) << "deformer " << i;
+	}
+
+	// The schedule is cleared by the update.
+	scene.m_scheduler.Update(scene.m_pool);
+	EXPECT_EQ(1, scene.GetUpdates(0));
+}
+
+/* The deformers are updated once per frame by the first pass seeing their object. The objects
+ * culled by the last pass but seen by a previous pass stay scheduled. */
+TEST(deformer_scheduler, Passes)
+{
+	TestScene scene(3);
+
+	// The first object is seen by the first camera only, the second by the second camera only.
+	const std::vector<bool> firstPass = {false, true, true};
+	const std::vector<bool> secondPass = {true, false, true};
+
+	for (unsigned int frame = 1; frame < 4; ++frame) {
+		scene.BeginFrame();
+
+		EXPECT_EQ(1, scene.Pass(firstPass));
+		EXPECT_EQ(frame, scene.GetUpdates(0));
+		EXPECT_EQ(frame - 1, scene.GetUpdates(1));
+
+		// The first object is still visible in the frame, its deformer isn't updated twice.
+		EXPECT_EQ(2, scene.Pass(secondPass));
+		EXPECT_EQ(frame, scene.GetUpdates(0));
+		EXPECT_EQ(frame, scene.GetUpdates(1));
+
+		// An other pass of the same frame updates nothing.
+		EXPECT_EQ(2, scene.Pass(firstPass));
+		EXPECT_EQ(frame, scene.GetUpdates(0));
+		EXPECT_EQ(frame, scene.GetUpdates(1));
+
+		// The third object is culled by all the passes.
+		EXPECT_EQ(0, scene.GetUpdates(2));
+	}
+
+	// A frame culling all the objects updates no deformer.
+	scene.BeginFrame();
+	EXPECT_EQ(0, scene.Pass({true, true, true}));
+	EXPECT_EQ(3, scene.GetUpdates(0));
+	EXPECT_EQ(3, scene.GetUpdates(1));
+}
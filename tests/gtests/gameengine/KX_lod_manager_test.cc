@@ -0,0 +1,156 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "KX_LodManager.h"
+#include "KX_LodLevel.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define NUM_SAMPLES 10000
+#define HYSTERESIS 10
+#define LEVEL_HYSTERESIS 30.0f
+
+namespace {
+
+/// Distances of the levels, the third level uses its own hysteresis.
+std::vector<KX_LodLevel *> create_levels(float firstDistance)
+{
+	const float distances[] = {firstDistance, 10.0f, 25.0f, 60.0f, 120.0f};
+	std::vector<KX_LodLevel *> levels;
+	for (unsigned short i = 0; i < 5; ++i) {
+		const unsigned short flag = (i == 2) ? KX_LodLevel::USE_HYSTERESIS : 0;
+		levels.push_back(new KX_LodLevel(distances[i], LEVEL_HYSTERESIS, i, nullptr, flag));
+	}
+	return levels;
+}
+
+/// Hysteresis of a level as computed by the removed LodLevelIterator.
+float reference_hysteresis(const std::vector<KX_LodLevel *>& levels, short level, bool hysteresis)
+{
+	if (level < 1 || !hysteresis) {
+		return 0.0f;
+	}
+
+	const float factor = ((levels[level]->GetFlag() & KX_LodLevel::USE_HYSTERESIS) ? levels[level]->GetHysteresis() : HYSTERESIS) / 100.0f;
+	return std::abs(levels[level - 1]->GetDistance() - levels[level]->GetDistance()) * factor;
+}
+
+float square(float value)
+{
+	return value * value;
+}
+
+/// The level selection before the bounds were precomputed: a walk from the previous level comparing the distances.
+short reference_level(const std::vector<KX_LodLevel *>& levels, short previouslod, float distance2, float distanceFactor, bool hysteresis)
+{
+	distance2 *= distanceFactor * distanceFactor;
+
+	const short last = levels.size() - 1;
+	short level = previouslod;
+	while (true) {
+		if (level != last && square(levels[level + 1]->GetDistance() + reference_hysteresis(levels, level + 1, hysteresis)) <= distance2) {
+			++level;
+		}
+		else if (square(levels[level]->GetDistance() - reference_hysteresis(levels, level, hysteresis)) > distance2) {
+			--level;
+		}
+		else {
+			break;
+		}
+	}
+
+	return level;
+}
+
+/// Select the level of an object moving slowly and randomly, from the previous level as the lod handler does.
+void expect_same_levels(float distanceFactor, bool hysteresis)
+{
+	const std::vector<KX_LodLevel *> levels = create_levels(0.0f);
+	KX_LodManager manager(levels, distanceFactor);
+	manager.UpdateLevelBounds(hysteresis, HYSTERESIS);
+
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+	std::uniform_real_distribution<float> jump(0.0f, 200.0f);
+	std::uniform_int_distribution<int> teleport(0, 99);
+
+	short level = -1;
+	short expected = -1;
+	float distance = 0.0f;
+	for (unsigned int i = 0; i < NUM_SAMPLES; ++i) {
+		distance = (teleport(rng) == 0) ? jump(rng) : std::max(distance + step(rng), 0.0f);
+		level = manager.GetLevelIndex(level, square(distance));
+		expected = reference_level(levels, expected, square(distance), distanceFactor, hysteresis);
+		ASSERT_EQ(expected, level) << "distance " << distance;
+	}
+}
+
+}  // namespace
+
+/* The precomputed bounds select the same levels as the walk comparing the distances. */
+TEST(lod_manager, SameLevels)
+{
+	expect_same_levels(1.0f, false);
+	expect_same_levels(1.5f, false);
+}
+
+/* The hysteresis of the scene and of the levels is included in the bounds. */
+TEST(lod_manager, SameLevelsHysteresis)
+{
+	expect_same_levels(1.0f, true);
+	expect_same_levels(1.5f, true);
+}
+
+/* The level is kept in the hysteresis margin around the next level distance. */
+TEST(lod_manager, Hysteresis)
+{
+	KX_LodManager manager(create_levels(0.0f), 1.0f);
+
+	manager.UpdateLevelBounds(false, HYSTERESIS);
+	EXPECT_EQ(2, manager.GetLevelIndex(1, square(25.5f)));
+	EXPECT_EQ(1, manager.GetLevelIndex(2, square(24.5f)));
+
+	// The third level uses its own hysteresis: 30% of 15.
+	manager.UpdateLevelBounds(true, HYSTERESIS);
+	EXPECT_EQ(1, manager.GetLevelIndex(1, square(29.0f)));
+	EXPECT_EQ(2, manager.GetLevelIndex(1, square(29.6f)));
+	EXPECT_EQ(2, manager.GetLevelIndex(2, square(21.0f)));
+	EXPECT_EQ(1, manager.GetLevelIndex(2, square(20.4f)));
+	// The fourth level uses the scene hysteresis: 10% of 35.
+	EXPECT_EQ(2, manager.GetLevelIndex(2, square(63.0f)));
+	EXPECT_EQ(3, manager.GetLevelIndex(2, square(63.6f)));
+
+	// The bounds follow the scene hysteresis value.
+	manager.UpdateLevelBounds(true, 0);
+	EXPECT_EQ(3, manager.GetLevelIndex(2, square(60.5f)));
+}
+
+/* The walk from the first level went under the first level for a distance below its distance,
+ * the bounds keep the first level. */
+TEST(lod_manager, FirstLevel)
+{
+	KX_LodManager manager(create_levels(5.0f), 1.0f);
+	manager.UpdateLevelBounds(true, HYSTERESIS);
+
+	EXPECT_EQ(0, manager.GetLevelIndex(0, square(2.0f)));
+	EXPECT_EQ(0, manager.GetLevelIndex(-1, 0.0f));
+	EXPECT_EQ(0, manager.GetLevelIndex(3, 0.0f));
+}
+
+/* The last level is used for any distance after its own, a previous level out of the levels
+ * is clamped. */
+TEST(lod_manager, LastLevel)
+{
+	KX_LodManager manager(create_levels(0.0f), 1.0f);
+	manager.UpdateLevelBounds(true, HYSTERESIS);
+
+	EXPECT_EQ(4, manager.GetLevelIndex(0, FLT_MAX));
+	EXPECT_EQ(4, manager.GetLevelIndex(4, square(1000.0f)));
+	EXPECT_EQ(4, manager.GetLevelIndex(10, square(1000.0f)));
+	EXPECT_EQ(1, manager.GetLevelIndex(10, square(12.0f)));
+}
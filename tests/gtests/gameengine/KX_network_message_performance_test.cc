@@ -0,0 +1,81 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "KX_network_message_test_util.h"
+
+extern "C" {
+#include "PIL_time_utildefines.h"
+}
+
+#include <random>
+#include <string>
+#include <vector>
+
+#define NUM_SENSORS 1000
+#define NUM_RECEIVERS 200
+#define NUM_SUBJECTS 20
+#define NUM_MESSAGES 10000
+#define NUM_FRAMES 100
+
+/* Read the 10k messages of a frame from 1k message sensors, with the names resolved in filters,
+ * with the names looked up at each read and with the nested maps. */
+TEST(network_message, SensorsPerformance)
+{
+	KX_NetworkMessageManager manager;
+	ReferenceManager reference;
+	std::mt19937 rng(42);
+
+	std::vector<Message> messages;
+	for (unsigned int i = 0; i < NUM_MESSAGES; ++i) {
+		messages.push_back(random_message(rng, i, NUM_RECEIVERS, NUM_SUBJECTS));
+	}
+
+	// The receiver and subject of each sensor.
+	std::vector<std::string> receivers;
+	std::vector<std::string> subjects;
+	for (unsigned int i = 0; i < NUM_SENSORS; ++i) {
+		receivers.push_back(receiver_name(i % NUM_RECEIVERS));
+		subjects.push_back((i % 5 == 0) ? "" : subject_name(rng() % NUM_SUBJECTS));
+	}
+	std::vector<KX_NetworkMessageManager::Filter> filters(NUM_SENSORS, {"", "", 0, 0, 0, 0});
+
+	for (const Message& message : messages) {
+		manager.AddMessage(Message(message));
+		reference.AddMessage(message);
+	}
+	manager.ClearMessages();
+	reference.ClearMessages();
+
+	// The sensors read the messages of the same frame again, as in the following frames.
+	unsigned int filterCount = 0;
+	TIMEIT_START(filters);
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		for (unsigned int i = 0; i < NUM_SENSORS; ++i) {
+			manager.UpdateFilter(receivers[i], subjects[i], filters[i]);
+			filterCount += manager.GetMessages(filters[i]).size();
+		}
+	}
+	TIMEIT_END(filters);
+
+	unsigned int managerCount = 0;
+	TIMEIT_START(names);
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		for (unsigned int i = 0; i < NUM_SENSORS; ++i) {
+			managerCount += manager.GetMessages(receivers[i], subjects[i]).size();
+		}
+	}
+	TIMEIT_END(names);
+
+	unsigned int referenceCount = 0;
+	TIMEIT_START(reference);
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		for (unsigned int i = 0; i < NUM_SENSORS; ++i) {
+			referenceCount += reference.GetMessages(receivers[i], subjects[i]).size();
+		}
+	}
+	TIMEIT_END(reference);
+
+	EXPECT_EQ(referenceCount, filterCount);
+	EXPECT_EQ(referenceCount, managerCount);
+}
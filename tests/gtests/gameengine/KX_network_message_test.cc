@@ -0,0 +1,112 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "KX_network_message_test_util.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#define NUM_RECEIVERS 100
+#define NUM_SUBJECTS 20
+#define NUM_MESSAGES 2000
+#define NUM_FRAMES 10
+/// More receivers than the interned names kept between two frames.
+#define NUM_UNIQUE_RECEIVERS 5000
+
+namespace {
+
+/// Compare the messages of the manager to the expected messages.
+void expect_messages_equal(const std::vector<Message>& expected, const KX_NetworkMessageManager::MessageList& messages,
+		const std::string& to, const std::string& subject)
+{
+	ASSERT_EQ(expected.size(), messages.size()) << to << " " << subject;
+	unsigned int i = 0;
+	for (const Message& message : messages) {
+		EXPECT_EQ(expected[i].to, message.to);
+		EXPECT_EQ(expected[i].subject, message.subject);
+		EXPECT_EQ(expected[i].body, message.body);
+		++i;
+	}
+	EXPECT_EQ(expected.size(), i);
+}
+
+}  // namespace
+
+/* Send the same random traffic to the message manager and to the nested maps,
+ * the messages read for each receiver and subject must be the same and in the same order. */
+TEST(network_message, ReferenceEquivalence)
+{
+	KX_NetworkMessageManager manager;
+	ReferenceManager reference;
+	std::mt19937 rng(42);
+
+	std::vector<std::string> subjects = {"", "unknown"};
+	for (unsigned int i = 0; i < NUM_SUBJECTS; ++i) {
+		subjects.push_back(subject_name(i));
+	}
+
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		// Some frames have no message at all.
+		const unsigned int count = (frame % 3 == 2) ? 0 : NUM_MESSAGES;
+		for (unsigned int i = 0; i < count; ++i) {
+			Message message = random_message(rng, i, NUM_RECEIVERS, NUM_SUBJECTS);
+			reference.AddMessage(message);
+			manager.AddMessage(std::move(message));
+		}
+
+		manager.ClearMessages();
+		reference.ClearMessages();
+
+		for (unsigned int i = 0; i < NUM_RECEIVERS + 1; ++i) {
+			const std::string to = receiver_name(i);
+			for (const std::string& subject : subjects) {
+				expect_messages_equal(reference.GetMessages(to, subject), manager.GetMessages(to, subject), to, subject);
+			}
+		}
+	}
+}
+
+/* The filters kept by the message sensors read the same messages as the names, also after
+ * a change of their names and after the interned names were cleared by too many receivers. */
+TEST(network_message, Filters)
+{
+	KX_NetworkMessageManager manager;
+	ReferenceManager reference;
+	std::mt19937 rng(42);
+
+	std::vector<std::string> subjects = {"", "unknown"};
+	for (unsigned int i = 0; i < NUM_SUBJECTS; ++i) {
+		subjects.push_back(subject_name(i));
+	}
+
+	// A filter per receiver, its subject changes every frame like a renamed sensor subject.
+	std::vector<KX_NetworkMessageManager::Filter> filters(NUM_RECEIVERS + 1, {"", "", 0, 0, 0, 0});
+
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		for (unsigned int i = 0; i < NUM_MESSAGES; ++i) {
+			Message message = random_message(rng, i, NUM_RECEIVERS, NUM_SUBJECTS);
+			reference.AddMessage(message);
+			manager.AddMessage(std::move(message));
+		}
+		// Every other frame the messages to many receivers clear the interned names in the next frame.
+		if (frame % 2 == 1) {
+			for (unsigned int i = 0; i < NUM_UNIQUE_RECEIVERS; ++i) {
+				Message message = {receiver_name(NUM_RECEIVERS + frame * NUM_UNIQUE_RECEIVERS + i), nullptr, "", ""};
+				reference.AddMessage(message);
+				manager.AddMessage(std::move(message));
+			}
+		}
+
+		manager.ClearMessages();
+		reference.ClearMessages();
+
+		for (unsigned int i = 0; i < NUM_RECEIVERS + 1; ++i) {
+			const std::string to = receiver_name(i);
+			const std::string& subject = subjects[(i + frame / 3) % subjects.size()];
+			manager.UpdateFilter(to, subject, filters[i]);
+			expect_messages_equal(reference.GetMessages(to, subject), manager.GetMessages(filters[i]), to, subject);
+		}
+	}
+}
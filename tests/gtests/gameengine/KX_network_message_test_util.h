@@ -0,0 +1,81 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_KX_NETWORK_MESSAGE_TEST_UTIL_H__
+#define __BLENDER_TESTING_KX_NETWORK_MESSAGE_TEST_UTIL_H__
+
+#include "KX_NetworkMessageManager.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef KX_NetworkMessageManager::Message Message;
+
+/// The nested maps used by the message manager before the interned names.
+class ReferenceManager
+{
+private:
+	std::map<std::string, std::map<std::string, std::vector<Message> > > m_messages[2];
+	unsigned short m_currentList = 0;
+
+public:
+	void AddMessage(const Message& message)
+	{
+		m_messages[m_currentList][message.to][message.subject].push_back(message);
+	}
+
+	std::vector<Message> GetMessages(const std::string& to, const std::string& subject)
+	{
+		std::vector<Message> messages;
+
+		std::map<std::string, std::vector<Message> >& messagesNoReceiver = m_messages[1 - m_currentList][""];
+		std::map<std::string, std::vector<Message> >& messagesReceiver = m_messages[1 - m_currentList][to];
+		if (subject.empty()) {
+			for (const auto& pair : messagesNoReceiver) {
+				messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+			}
+			for (const auto& pair : messagesReceiver) {
+				messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+			}
+		}
+		else {
+			std::vector<Message>& messagesNoReceiverSubject = messagesNoReceiver[subject];
+			messages.insert(messages.end(), messagesNoReceiverSubject.begin(), messagesNoReceiverSubject.end());
+			std::vector<Message>& messagesReceiverSubject = messagesReceiver[subject];
+			messages.insert(messages.end(), messagesReceiverSubject.begin(), messagesReceiverSubject.end());
+		}
+
+		return messages;
+	}
+
+	void ClearMessages()
+	{
+		m_messages[1 - m_currentList].clear();
+		m_currentList = 1 - m_currentList;
+	}
+};
+
+std::string receiver_name(unsigned int i)
+{
+	return "OB" + std::to_string(i);
+}
+
+std::string subject_name(unsigned int i)
+{
+	return "subject" + std::to_string(i);
+}
+
+/// Random message, a quarter of the messages have no receiver and a quarter no subject.
+Message random_message(std::mt19937& rng, unsigned int index, unsigned int numReceivers, unsigned int numSubjects)
+{
+	const std::string to = (rng() % 4 == 0) ? "" : receiver_name(rng() % numReceivers);
+	const std::string subject = (rng() % 4 == 0) ? "" : subject_name(rng() % numSubjects);
+	return {to, nullptr, subject, std::to_string(index)};
+}
+
+}  // namespace
+
+#endif  // __BLENDER_TESTING_KX_NETWORK_MESSAGE_TEST_UTIL_H__
@@ -0,0 +1,165 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "KX_ObstacleSimulation.h"
+
+#include "BLI_math.h"
+
+#include <algorithm>
+#include <random>
+
+#define NUM_AGENTS 300
+#define NUM_WALLS 40
+#define CROWD_SIZE 40.0f
+#define LEVEL_HEIGHT 2.0f
+
+namespace {
+
+/// Obstacle simulation of a random crowd without game objects, the obstacles are placed directly.
+class TestSimulation : public KX_ObstacleSimulationTOI_rays
+{
+public:
+	TestSimulation()
+		:KX_ObstacleSimulationTOI_rays(LEVEL_HEIGHT, false)
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> position(-CROWD_SIZE * 0.5f, CROWD_SIZE * 0.5f);
+		std::uniform_real_distribution<float> radius(0.2f, 1.0f);
+		std::uniform_real_distribution<float> speed(-2.0f, 2.0f);
+		std::uniform_real_distribution<float> length(-3.0f, 3.0f);
+
+		for (unsigned int i = 0; i < NUM_AGENTS; ++i) {
+			KX_Obstacle *obs = CreateObstacle(nullptr);
+			obs->m_type = KX_OBSTACLE_OBJ;
+			obs->m_shape = KX_OBSTACLE_CIRCLE;
+			obs->m_pos = MT_Vector3(position(rng), position(rng), 0.0f);
+			obs->m_rad = radius(rng);
+			// Some agents are stationary, they are avoided with VO instead of RVO.
+			if (i % 5 != 0) {
+				obs->vel[0] = speed(rng);
+				obs->vel[1] = speed(rng);
+			}
+			obs->dvel[0] = speed(rng);
+			obs->dvel[1] = speed(rng);
+		}
+
+		// Short walls and a few walls across the crowd, overlapping too many cells to be hashed.
+		for (unsigned int i = 0; i < NUM_WALLS; ++i) {
+			KX_Obstacle *obs = CreateObstacle(nullptr);
+			obs->m_type = KX_OBSTACLE_OBJ;
+			obs->m_shape = KX_OBSTACLE_SEGMENT;
+			obs->m_pos = MT_Vector3(position(rng), position(rng), 0.0f);
+			obs->m_pos2 = (i % 10 == 0) ? MT_Vector3(position(rng), position(rng), 0.0f) :
+				obs->m_pos + MT_Vector3(length(rng), length(rng), 0.0f);
+			obs->m_rad = 0.0f;
+			obs->m_worldPos = obs->m_pos;
+			obs->m_worldPos2 = obs->m_pos2;
+		}
+
+		BuildObstacleHash();
+	}
+
+	const KX_Obstacles& GetObstacles() const
+	{
+		return m_obstacles;
+	}
+
+	void Query(KX_Obstacle *activeObst, float range, KX_Obstacles& obstacles) const
+	{
+		QueryObstacles(activeObst, range, obstacles);
+	}
+
+	/// Adjust the velocity of an agent with the obstacles of the spatial hash.
+	void Solve(KX_Obstacle *activeObst, float nvel[2])
+	{
+		KX_ObstacleAgent agent;
+		agent.m_actuator = nullptr;
+		agent.m_obstacle = activeObst;
+		agent.m_navMeshObj = nullptr;
+		agent.m_velocity = MT_Vector3(activeObst->dvel[0], activeObst->dvel[1], 0.0f);
+		agent.m_maxDeltaSpeed = 1.0f;
+		agent.m_maxDeltaAngle = 0.5f;
+		SolveAgent(agent);
+		copy_v2_v2(nvel, agent.m_nvel);
+	}
+
+	/// Adjust the velocity of an agent against all the obstacles, as before the spatial hash.
+	void SolveBruteForce(KX_Obstacle *activeObst, float nvel[2])
+	{
+		sampleRVO(activeObst, nullptr, m_obstacles, 0.5f, nvel);
+	}
+
+	/// Adjust the velocity of an agent without obstacles.
+	void SolveAlone(KX_Obstacle *activeObst, float nvel[2])
+	{
+		sampleRVO(activeObst, nullptr, KX_Obstacles(), 0.5f, nvel);
+	}
+};
+
+/// Return the obstacles closer than a range of the active obstacle by testing all the obstacles.
+KX_Obstacles query_brute_force(const KX_Obstacles& allObstacles, KX_Obstacle *activeObst, float range)
+{
+	const float pos[2] = {(float)activeObst->m_pos.x(), (float)activeObst->m_pos.y()};
+	KX_Obstacles obstacles;
+	for (KX_Obstacle *obs : allObstacles) {
+		if (obs->m_shape == KX_OBSTACLE_SEGMENT) {
+			const float a[2] = {(float)obs->m_worldPos.x(), (float)obs->m_worldPos.y()};
+			const float b[2] = {(float)obs->m_worldPos2.x(), (float)obs->m_worldPos2.y()};
+			if (dist_squared_to_line_segment_v2(pos, a, b) <= range * range) {
+				obstacles.push_back(obs);
+			}
+		}
+		else if ((obs->m_pos.to2d() - activeObst->m_pos.to2d()).length() <= range + obs->m_rad) {
+			obstacles.push_back(obs);
+		}
+	}
+	return obstacles;
+}
+
+}  // namespace
+
+/* The spatial hash returns the same obstacles as a test of all the obstacles, in the same order. */
+TEST(obstacle_simulation, QueryObstacles)
+{
+	TestSimulation simulation;
+	const KX_Obstacles& allObstacles = simulation.GetObstacles();
+
+	for (float range : {0.5f, 3.0f, 12.0f, CROWD_SIZE * 2.0f}) {
+		for (unsigned int i = 0; i < NUM_AGENTS; ++i) {
+			KX_Obstacle *activeObst = allObstacles[i];
+			KX_Obstacles obstacles;
+			simulation.Query(activeObst, range, obstacles);
+			EXPECT_EQ(query_brute_force(allObstacles, activeObst, range), obstacles) << "agent " << i << " range " << range;
+		}
+	}
+}
+
+/* The agents only sample the obstacles reachable before the max time of impact, the adjusted
+ * velocities must be the same as with all the obstacles. */
+TEST(obstacle_simulation, SolveAgent)
+{
+	TestSimulation simulation;
+	const KX_Obstacles& allObstacles = simulation.GetObstacles();
+
+	unsigned int numAvoiding = 0;
+	for (unsigned int i = 0; i < NUM_AGENTS; ++i) {
+		KX_Obstacle *activeObst = allObstacles[i];
+		float nvel[2];
+		float expected[2];
+		float alone[2];
+		simulation.Solve(activeObst, nvel);
+		simulation.SolveBruteForce(activeObst, expected);
+		simulation.SolveAlone(activeObst, alone);
+
+		EXPECT_EQ(expected[0], nvel[0]) << "agent " << i;
+		EXPECT_EQ(expected[1], nvel[1]) << "agent " << i;
+
+		if (!equals_v2v2(expected, alone)) {
+			++numAvoiding;
+		}
+	}
+
+	// The crowd is dense enough for the agents to avoid each other.
+	EXPECT_GT(numAvoiding, NUM_AGENTS / 10);
+}
@@ -0,0 +1,31 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "PHY_dynamics_world_test_util.h"
+
+extern "C" {
+#include "PIL_time_utildefines.h"
+}
+
+/* Simulate the same stacks with the serial and the multithreaded world. */
+TEST(dynamics_world, MultithreadingPerformance)
+{
+	TestWorld serial(false);
+	TestWorld parallel(true);
+
+	TIMEIT_START(serial);
+	run_world(serial);
+	TIMEIT_END(serial);
+
+	TIMEIT_START(parallel);
+	run_world(parallel);
+	TIMEIT_END(parallel);
+
+	for (unsigned int i = 0, size = serial.m_bodies.size(); i < size; ++i) {
+		for (unsigned short j = 0; j < 3; ++j) {
+			EXPECT_NEAR(serial.m_bodies[i]->getWorldTransform().getOrigin()[j],
+			            parallel.m_bodies[i]->getWorldTransform().getOrigin()[j], 1e-4f) << "body " << i;
+		}
+	}
+}
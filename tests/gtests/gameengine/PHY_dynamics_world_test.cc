@@ -0,0 +1,33 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "PHY_dynamics_world_test_util.h"
+
+/* Simulate the same stacks with the serial and the multithreaded world:
+ * the bodies must end at the same place, and two multithreaded runs must match exactly. */
+TEST(dynamics_world, MultithreadingEquivalence)
+{
+	TestWorld serial(false);
+	TestWorld parallel1(true);
+	TestWorld parallel2(true);
+
+	run_world(serial);
+	run_world(parallel1);
+	run_world(parallel2);
+
+	for (unsigned int i = 0, size = serial.m_bodies.size(); i < size; ++i) {
+		const btTransform& trans = serial.m_bodies[i]->getWorldTransform();
+		const btTransform& trans1 = parallel1.m_bodies[i]->getWorldTransform();
+		const btTransform& trans2 = parallel2.m_bodies[i]->getWorldTransform();
+
+		for (unsigned short j = 0; j < 3; ++j) {
+			EXPECT_NEAR(trans.getOrigin()[j], trans1.getOrigin()[j], 1e-4f) << "body " << i;
+			EXPECT_EQ(trans1.getOrigin()[j], trans2.getOrigin()[j]) << "body " << i;
+			for (unsigned short k = 0; k < 3; ++k) {
+				EXPECT_NEAR(trans.getBasis()[j][k], trans1.getBasis()[j][k], 1e-4f) << "body " << i;
+				EXPECT_EQ(trans1.getBasis()[j][k], trans2.getBasis()[j][k]) << "body " << i;
+			}
+		}
+	}
+}
@@ -0,0 +1,110 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_PHY_DYNAMICS_WORLD_TEST_UTIL_H__
+#define __BLENDER_TESTING_PHY_DYNAMICS_WORLD_TEST_UTIL_H__
+
+#include "CcdDynamicsWorld.h"
+
+#include "btBulletDynamicsCommon.h"
+#include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
+
+#include <memory>
+#include <vector>
+
+#define STACK_GRID 10
+#define STACK_HEIGHT 8
+#define NUM_FRAMES 120
+
+namespace {
+
+/// Independent stacks of boxes on a static ground, the two first stacks touch a moving kinematic plank.
+class TestWorld
+{
+public:
+	std::unique_ptr<btCollisionConfiguration> m_configuration;
+	std::unique_ptr<btCollisionDispatcher> m_dispatcher;
+	std::unique_ptr<btBroadphaseInterface> m_broadphase;
+	std::unique_ptr<btConstraintSolver> m_solver;
+	std::unique_ptr<CcdDynamicsWorld> m_world;
+	std::unique_ptr<btCollisionShape> m_groundShape;
+	std::unique_ptr<btCollisionShape> m_boxShape;
+	std::unique_ptr<btCollisionShape> m_plankShape;
+	std::vector<btRigidBody *> m_bodies;
+	btRigidBody *m_plank;
+
+	TestWorld(bool multithreading)
+		:m_configuration(new btSoftBodyRigidBodyCollisionConfiguration()),
+		m_dispatcher(new btCollisionDispatcher(m_configuration.get())),
+		m_broadphase(new btDbvtBroadphase()),
+		m_solver(new btSequentialImpulseConstraintSolver()),
+		m_world(new CcdDynamicsWorld(m_dispatcher.get(), m_broadphase.get(), m_solver.get(), m_configuration.get())),
+		m_groundShape(new btBoxShape(btVector3(100.0f, 100.0f, 1.0f))),
+		m_boxShape(new btBoxShape(btVector3(0.5f, 0.5f, 0.5f))),
+		m_plankShape(new btBoxShape(btVector3(2.5f, 0.5f, 0.1f)))
+	{
+		m_world->SetUseMultithreading(multithreading);
+		m_world->setGravity(btVector3(0.0f, 0.0f, -10.0f));
+
+		AddBody(m_groundShape.get(), 0.0f, btVector3(0.0f, 0.0f, -1.0f));
+
+		for (unsigned int x = 0; x < STACK_GRID; ++x) {
+			for (unsigned int y = 0; y < STACK_GRID; ++y) {
+				for (unsigned int z = 0; z < STACK_HEIGHT; ++z) {
+					// Shift the boxes a bit to make the stacks move.
+					const btVector3 position(x * 4.0f + z * 0.05f, y * 4.0f, z * 1.01f + 0.5f);
+					m_bodies.push_back(AddBody(m_boxShape.get(), 1.0f, position));
+				}
+			}
+		}
+
+		// A kinematic plank lying on the two first stacks, their islands share its solver body.
+		m_plank = AddBody(m_plankShape.get(), 0.0f, btVector3(2.0f, 0.0f, STACK_HEIGHT * 1.01f + 0.1f));
+		m_plank->setCollisionFlags(m_plank->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+		m_plank->setActivationState(DISABLE_DEACTIVATION);
+	}
+
+	~TestWorld()
+	{
+		for (int i = m_world->getNumCollisionObjects() - 1; i >= 0; --i) {
+			btRigidBody *body = btRigidBody::upcast(m_world->getCollisionObjectArray()[i]);
+			m_world->removeRigidBody(body);
+			delete body->getMotionState();
+			delete body;
+		}
+	}
+
+	void Step(unsigned int frame)
+	{
+		// Move the kinematic plank down on the stacks.
+		btTransform transform = m_plank->getWorldTransform();
+		transform.getOrigin().setZ(transform.getOrigin().z() - 0.002f * frame);
+		m_plank->getMotionState()->setWorldTransform(transform);
+
+		m_world->stepSimulation(1.0f / 60.0f, 1, 1.0f / 60.0f);
+	}
+
+private:
+	btRigidBody *AddBody(btCollisionShape *shape, float mass, const btVector3& position)
+	{
+		btVector3 inertia(0.0f, 0.0f, 0.0f);
+		if (mass != 0.0f) {
+			shape->calculateLocalInertia(mass, inertia);
+		}
+
+		btDefaultMotionState *motionState = new btDefaultMotionState(btTransform(btQuaternion::getIdentity(), position));
+		btRigidBody *body = new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(mass, motionState, shape, inertia));
+		m_world->addRigidBody(body);
+		return body;
+	}
+};
+
+void run_world(TestWorld& world)
+{
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		world.Step(frame);
+	}
+}
+
+}  // namespace
+
+#endif  // __BLENDER_TESTING_PHY_DYNAMICS_WORLD_TEST_UTIL_H__
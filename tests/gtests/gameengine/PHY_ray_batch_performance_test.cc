@@ -0,0 +1,46 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "PHY_ray_batch_test_util.h"
+
+extern "C" {
+#include "PIL_time_utildefines.h"
+}
+
+#include <random>
+#include <vector>
+
+/* Test 20k random rays against 1k objects with RayTestBatch and with a RayTest per ray. */
+TEST(ray_batch, RayTestPerformance)
+{
+	std::mt19937 rng(42);
+	TestScene scene(rng);
+
+	PHY_RayBatch batch;
+	random_rays(rng, batch);
+
+	std::vector<PHY_RayBatchHit> hits;
+	GroupRayBatchFilterCallback batchFilter;
+	TIMEIT_START(batch);
+	scene.m_env.RayTestBatch(batch, batchFilter, hits);
+	TIMEIT_END(batch);
+	ASSERT_EQ(batch.GetSize(), hits.size());
+
+	std::vector<GroupRayCastFilterCallback> filters;
+	for (unsigned int i = 0; i < NUM_RAYS; ++i) {
+		filters.emplace_back(batch.m_masks[i]);
+	}
+
+	std::vector<PHY_IPhysicsController *> controllers(NUM_RAYS);
+	TIMEIT_START(single);
+	for (unsigned int i = 0; i < NUM_RAYS; ++i) {
+		controllers[i] = scene.m_env.RayTest(filters[i], batch.m_fromX[i], batch.m_fromY[i], batch.m_fromZ[i],
+				batch.m_toX[i], batch.m_toY[i], batch.m_toZ[i]);
+	}
+	TIMEIT_END(single);
+
+	for (unsigned int i = 0; i < NUM_RAYS; ++i) {
+		EXPECT_EQ(controllers[i], hits[i].m_controller) << "ray " << i;
+	}
+}
@@ -0,0 +1,55 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "PHY_ray_batch_test_util.h"
+
+#include <random>
+#include <vector>
+
+/* Test the same random rays with RayTestBatch and with a RayTest per ray,
+ * the closest hit object, point and normal of each ray must match. */
+TEST(ray_batch, RayTestEquivalence)
+{
+	std::mt19937 rng(42);
+	TestScene scene(rng);
+
+	PHY_RayBatch batch;
+	random_rays(rng, batch);
+
+	std::vector<PHY_RayBatchHit> hits;
+	GroupRayBatchFilterCallback batchFilter;
+	scene.m_env.RayTestBatch(batch, batchFilter, hits);
+	ASSERT_EQ(batch.GetSize(), hits.size());
+
+	std::vector<GroupRayCastFilterCallback> filters;
+	for (unsigned int i = 0; i < NUM_RAYS; ++i) {
+		filters.emplace_back(batch.m_masks[i]);
+	}
+
+	std::vector<PHY_IPhysicsController *> controllers(NUM_RAYS);
+	for (unsigned int i = 0; i < NUM_RAYS; ++i) {
+		controllers[i] = scene.m_env.RayTest(filters[i], batch.m_fromX[i], batch.m_fromY[i], batch.m_fromZ[i],
+				batch.m_toX[i], batch.m_toY[i], batch.m_toZ[i]);
+	}
+
+	unsigned int numHits = 0;
+	for (unsigned int i = 0; i < NUM_RAYS; ++i) {
+		const PHY_RayBatchHit& hit = hits[i];
+		const GroupRayCastFilterCallback& filter = filters[i];
+
+		EXPECT_EQ(controllers[i], hit.m_controller) << "ray " << i;
+		if (!filter.m_hit || !hit.m_controller) {
+			continue;
+		}
+
+		++numHits;
+		for (unsigned short j = 0; j < 3; ++j) {
+			EXPECT_FLOAT_EQ(filter.m_result.m_hitPoint[j], hit.m_hitPoint[j]);
+			EXPECT_FLOAT_EQ(filter.m_result.m_hitNormal[j], hit.m_hitNormal[j]);
+		}
+	}
+
+	// Make sure that the rays don't miss everything.
+	EXPECT_GT(numHits, NUM_RAYS / 10);
+}
@@ -0,0 +1,116 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_PHY_RAY_BATCH_TEST_UTIL_H__
+#define __BLENDER_TESTING_PHY_RAY_BATCH_TEST_UTIL_H__
+
+#include "CcdPhysicsEnvironment.h"
+#include "CcdPhysicsController.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define NUM_OBJECTS 1000
+#define NUM_RAYS 20000
+#define NUM_GROUPS 4
+
+namespace {
+
+/// Ray filter of RayTest keeping the objects of the collision groups of a mask.
+class GroupRayCastFilterCallback : public PHY_IRayCastFilterCallback
+{
+public:
+	unsigned int m_mask;
+	PHY_RayCastResult m_result;
+	bool m_hit;
+
+	GroupRayCastFilterCallback(unsigned int mask)
+		:PHY_IRayCastFilterCallback(nullptr),
+		m_mask(mask),
+		m_hit(false)
+	{
+	}
+
+	virtual bool needBroadphaseRayCast(PHY_IPhysicsController *controller)
+	{
+		return ((uintptr_t)controller->GetNewClientInfo() & m_mask);
+	}
+
+	virtual void reportHit(PHY_RayCastResult *result)
+	{
+		m_result = *result;
+		m_hit = true;
+	}
+};
+
+/// Same filter for RayTestBatch, the mask is given per ray.
+class GroupRayBatchFilterCallback : public PHY_IRayBatchFilterCallback
+{
+public:
+	virtual bool NeedRayCast(PHY_IPhysicsController *controller, unsigned int mask) const
+	{
+		return ((uintptr_t)controller->GetNewClientInfo() & mask);
+	}
+};
+
+/// Static boxes and spheres randomly placed in a 100 units cube, the client info is the collision group bit.
+class TestScene
+{
+public:
+	CcdPhysicsEnvironment m_env;
+	std::vector<CcdPhysicsController *> m_controllers;
+
+	TestScene(std::mt19937& rng)
+		:m_env(PHY_SOLVER_SEQUENTIAL, false)
+	{
+		std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+		std::uniform_real_distribution<float> size(0.5f, 3.0f);
+
+		for (unsigned int i = 0; i < NUM_OBJECTS; ++i) {
+			CcdConstructionInfo cinfo;
+			if (i % 2) {
+				cinfo.m_collisionShape = new btBoxShape(btVector3(size(rng), size(rng), size(rng)));
+			}
+			else {
+				cinfo.m_collisionShape = new btSphereShape(size(rng));
+			}
+			cinfo.m_collisionFlags |= btCollisionObject::CF_STATIC_OBJECT;
+			cinfo.m_collisionFilterGroup = CcdConstructionInfo::StaticFilter;
+			cinfo.m_collisionFilterMask = CcdConstructionInfo::AllFilter ^ CcdConstructionInfo::StaticFilter;
+			cinfo.m_physicsEnv = &m_env;
+
+			DefaultMotionState *motionState = new DefaultMotionState();
+			motionState->m_worldTransform.setIdentity();
+			motionState->m_worldTransform.setOrigin(btVector3(position(rng), position(rng), position(rng)));
+			motionState->m_worldTransform.setRotation(btQuaternion(position(rng), position(rng), position(rng)));
+			cinfo.m_MotionState = motionState;
+
+			CcdPhysicsController *controller = new CcdPhysicsController(cinfo);
+			controller->SetNewClientInfo((void *)(uintptr_t)(1 << (i % NUM_GROUPS)));
+			m_env.AddCcdPhysicsController(controller);
+			m_controllers.push_back(controller);
+		}
+	}
+
+	~TestScene()
+	{
+		for (CcdPhysicsController *controller : m_controllers) {
+			delete controller;
+		}
+	}
+};
+
+/// Random rays crossing the scene with random group masks.
+void random_rays(std::mt19937& rng, PHY_RayBatch& batch)
+{
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	for (unsigned int i = 0; i < NUM_RAYS; ++i) {
+		const MT_Vector3 from(position(rng), position(rng), position(rng));
+		const MT_Vector3 to(position(rng), position(rng), position(rng));
+		batch.AddRay(from, to, 1 + rng() % ((1 << NUM_GROUPS) - 1));
+	}
+}
+
+}  // namespace
+
+#endif  // __BLENDER_TESTING_PHY_RAY_BATCH_TEST_UTIL_H__
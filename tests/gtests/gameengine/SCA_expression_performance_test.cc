@@ -0,0 +1,108 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "SCA_AlwaysSensor.h"
+#include "SCA_ExpressionController.h"
+#include "SCA_IObject.h"
+#include "SCA_LogicManager.h"
+
+#include "EXP_FloatValue.h"
+#include "EXP_InputParser.h"
+#include "EXP_IntValue.h"
+
+extern "C" {
+#include "PIL_time_utildefines.h"
+}
+
+#include <vector>
+
+#define NUM_CONTROLLERS 10000
+#define NUM_FRAMES 100
+
+namespace {
+
+class TestObject : public SCA_IObject
+{
+public:
+	virtual std::string GetName()
+	{
+		return "TestObject";
+	}
+};
+
+}  // namespace
+
+/* Trigger 10k expression controllers reading a sensor and properties, as the
+ * logic of a frame does, with the compiled programs and with the expression trees. */
+TEST(expression, Controllers10k)
+{
+	const std::string text = "sensor and (health > 10 or if(speed * 2.0 > limit, armor - 1, 0) >= 3)";
+
+	std::vector<TestObject *> objects;
+	std::vector<SCA_AlwaysSensor *> sensors;
+	std::vector<SCA_ExpressionController *> controllers;
+
+	for (unsigned int i = 0; i < NUM_CONTROLLERS; ++i) {
+		TestObject *object = new TestObject();
+		object->SetProperty("health", new EXP_IntValue(i % 20));
+		object->SetProperty("speed", new EXP_FloatValue((float)(i % 7)));
+		object->SetProperty("limit", new EXP_FloatValue(6.0f));
+		object->SetProperty("armor", new EXP_IntValue(i % 5));
+
+		SCA_AlwaysSensor *sensor = new SCA_AlwaysSensor(nullptr, object);
+		sensor->SetName("sensor");
+
+		SCA_ExpressionController *controller = new SCA_ExpressionController(object, text);
+		controller->LinkToSensor(sensor);
+
+		objects.push_back(object);
+		sensors.push_back(sensor);
+		controllers.push_back(controller);
+	}
+
+	SCA_LogicManager logicmgr;
+
+	// The first trigger parses and compiles the expressions.
+	TIMEIT_START(compile);
+	for (SCA_ExpressionController *controller : controllers) {
+		controller->Trigger(&logicmgr);
+	}
+	TIMEIT_END(compile);
+
+	TIMEIT_START(program);
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		for (SCA_ExpressionController *controller : controllers) {
+			controller->Trigger(&logicmgr);
+		}
+	}
+	TIMEIT_END(program);
+
+	// The expression trees as calculated by the controllers before the compilation.
+	std::vector<EXP_Expression *> expressions;
+	for (SCA_ExpressionController *controller : controllers) {
+		EXP_Parser parser;
+		parser.SetContext(controller->AddRef());
+		expressions.push_back(parser.ProcessText(text));
+	}
+
+	TIMEIT_START(tree);
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		for (EXP_Expression *expr : expressions) {
+			EXP_Value *value = expr->Calculate();
+			value->Release();
+		}
+	}
+	TIMEIT_END(tree);
+
+	for (EXP_Expression *expr : expressions) {
+		expr->Release();
+	}
+
+	for (unsigned int i = 0; i < NUM_CONTROLLERS; ++i) {
+		controllers[i]->Delete();
+		controllers[i]->Release();
+		sensors[i]->Release();
+		objects[i]->Release();
+	}
+}
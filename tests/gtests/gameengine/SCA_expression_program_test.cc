@@ -0,0 +1,198 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "SCA_AlwaysSensor.h"
+#include "SCA_ExpressionController.h"
+#include "SCA_ExpressionProgram.h"
+#include "SCA_IObject.h"
+#include "SCA_LogicManager.h"
+
+#include "EXP_BoolValue.h"
+#include "EXP_FloatValue.h"
+#include "EXP_InputParser.h"
+#include "EXP_IntValue.h"
+
+#include "MT_Scalar.h"
+
+namespace {
+
+class TestObject : public SCA_IObject
+{
+public:
+	virtual std::string GetName()
+	{
+		return "TestObject";
+	}
+};
+
+/// Object owning the properties and the linked sensors of an expression controller.
+class ExpressionTest : public testing::Test
+{
+protected:
+	TestObject *m_object;
+	SCA_AlwaysSensor *m_sensor;
+	SCA_ExpressionController *m_controller;
+
+	virtual void SetUp()
+	{
+		m_object = new TestObject();
+		m_object->SetProperty("a", new EXP_IntValue(3));
+		m_object->SetProperty("b", new EXP_IntValue(-7));
+		m_object->SetProperty("f", new EXP_FloatValue(2.5f));
+		m_object->SetProperty("t", new EXP_BoolValue(true));
+		m_object->SetProperty("zero", new EXP_IntValue(0));
+
+		m_sensor = new SCA_AlwaysSensor(nullptr, m_object);
+		m_sensor->SetName("sensor");
+
+		m_controller = new SCA_ExpressionController(m_object, "");
+		m_controller->LinkToSensor(m_sensor);
+	}
+
+	virtual void TearDown()
+	{
+		m_controller->Delete();
+		m_controller->Release();
+		m_sensor->Release();
+		m_object->Release();
+	}
+
+	EXP_Expression *Parse(const std::string& text)
+	{
+		EXP_Parser parser;
+		parser.SetContext(m_controller->AddRef());
+		return parser.ProcessText(text);
+	}
+
+	/// Return the result of the expression tree as SCA_ExpressionController::CalculateExpression.
+	static SCA_ExpressionProgram::Result Calculate(EXP_Expression *expr)
+	{
+		EXP_Value *value = expr->Calculate();
+		SCA_ExpressionProgram::Result result = SCA_ExpressionProgram::RESULT_FALLBACK;
+		if (!value->IsError()) {
+			result = MT_fuzzyZero((float)value->GetNumber()) ?
+				SCA_ExpressionProgram::RESULT_FALSE : SCA_ExpressionProgram::RESULT_TRUE;
+		}
+		value->Release();
+		return result;
+	}
+
+	void ExpectSameResult(const std::string& text)
+	{
+		EXP_Expression *expr = Parse(text);
+		ASSERT_TRUE(expr != nullptr) << text;
+
+		SCA_ExpressionProgram *program = SCA_ExpressionProgram::Compile(expr, m_controller->GetLinkedSensors());
+		ASSERT_TRUE(program != nullptr) << text;
+
+		const SCA_ExpressionProgram::Result result = program->Execute(m_object);
+		if (result != SCA_ExpressionProgram::RESULT_FALLBACK) {
+			EXPECT_EQ(Calculate(expr), result) << text;
+		}
+
+		delete program;
+		expr->Release();
+	}
+};
+
+}  // namespace
+
+TEST_F(ExpressionTest, Arithmetic)
+{
+	ExpectSameResult("a + b");
+	ExpectSameResult("a + b + 4");
+	ExpectSameResult("a * b < -20");
+	ExpectSameResult("a - b == 10");
+	ExpectSameResult("b % a");
+	ExpectSameResult("b / a == -2");
+	ExpectSameResult("-a");
+	ExpectSameResult("+b > 0");
+}
+
+TEST_F(ExpressionTest, MixedTypes)
+{
+	ExpectSameResult("a * f");
+	ExpectSameResult("f - 2.5");
+	ExpectSameResult("a > f");
+	ExpectSameResult("f * 0.4 == 1.0");
+	ExpectSameResult("t and a");
+	ExpectSameResult("not t or zero");
+}
+
+TEST_F(ExpressionTest, Logic)
+{
+	ExpectSameResult("a > 1 and b < 0");
+	ExpectSameResult("a > 1 and b > 0");
+	ExpectSameResult("a < 1 or b < 0");
+	ExpectSameResult("not (a == 3)");
+	ExpectSameResult("a != b");
+	ExpectSameResult("a >= 3 and b <= -7");
+	ExpectSameResult("true and not false");
+}
+
+TEST_F(ExpressionTest, Conditional)
+{
+	ExpectSameResult("if(a > b, a, b)");
+	ExpectSameResult("if(a < b, a, zero)");
+	ExpectSameResult("if(t, f, 0.0) > 2.0");
+}
+
+TEST_F(ExpressionTest, Sensors)
+{
+	ExpectSameResult("sensor");
+	ExpectSameResult("not sensor");
+	ExpectSameResult("sensor or a == 3");
+
+	// Activate the sensor to read a positive state.
+	SCA_LogicManager logicmgr;
+	m_sensor->IncLink();
+	m_sensor->Activate(&logicmgr);
+	m_sensor->DecLink();
+
+	ExpectSameResult("sensor");
+	ExpectSameResult("sensor and a > b");
+}
+
+TEST_F(ExpressionTest, Fallback)
+{
+	// A division by zero produces an error value, the tree is then calculated.
+	EXP_Expression *expr = Parse("a / zero");
+	SCA_ExpressionProgram *program = SCA_ExpressionProgram::Compile(expr, m_controller->GetLinkedSensors());
+	ASSERT_TRUE(program != nullptr);
+	EXPECT_EQ(SCA_ExpressionProgram::RESULT_FALLBACK, program->Execute(m_object));
+	delete program;
+	expr->Release();
+
+	// Missing properties are not covered by the program either.
+	expr = Parse("missing + 1");
+	program = SCA_ExpressionProgram::Compile(expr, m_controller->GetLinkedSensors());
+	if (program) {
+		EXPECT_EQ(SCA_ExpressionProgram::RESULT_FALLBACK, program->Execute(m_object));
+		delete program;
+	}
+	expr->Release();
+}
+
+TEST_F(ExpressionTest, LinkedSensorsChange)
+{
+	EXP_Expression *expr = Parse("a");
+	std::vector<SCA_ISensor *> linkedsensors = m_controller->GetLinkedSensors();
+	SCA_ExpressionProgram *program = SCA_ExpressionProgram::Compile(expr, linkedsensors);
+	ASSERT_TRUE(program != nullptr);
+	EXPECT_TRUE(program->IsBoundTo(linkedsensors));
+
+	/* A sensor named as the property hides it, the program is no longer bound
+	 * even if the number of linked sensors didn't change. */
+	SCA_AlwaysSensor *hiding = new SCA_AlwaysSensor(nullptr, m_object);
+	hiding->SetName("a");
+	linkedsensors[0] = hiding;
+	EXPECT_FALSE(program->IsBoundTo(linkedsensors));
+
+	linkedsensors.push_back(m_sensor);
+	EXPECT_FALSE(program->IsBoundTo(linkedsensors));
+
+	delete program;
+	expr->Release();
+	hiding->Release();
+}
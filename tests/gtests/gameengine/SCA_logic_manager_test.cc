@@ -0,0 +1,225 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "SCA_BasicEventManager.h"
+#include "SCA_IController.h"
+#include "SCA_IObject.h"
+#include "SCA_LogicManager.h"
+#include "SCA_PropertySensor.h"
+
+#include "EXP_FloatValue.h"
+#include "EXP_IntValue.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Object counting the lookups of its properties by key, the property sensors poll them this way.
+class TestObject : public SCA_IObject
+{
+public:
+	unsigned int m_lookups = 0;
+
+	virtual std::string GetName()
+	{
+		return "object";
+	}
+
+	virtual EXP_Value *FindIdentifier(const EXP_PropertyKey& key)
+	{
+		++m_lookups;
+		return SCA_IObject::FindIdentifier(key);
+	}
+};
+
+/// Controller writing its name in a log when it is executed.
+class TestController : public SCA_IController
+{
+public:
+	std::vector<std::string>& m_log;
+
+	TestController(SCA_IObject *gameobj, const std::string& name, int priority, std::vector<std::string>& log)
+		:SCA_IController(gameobj),
+		m_log(log)
+	{
+		SetName(name);
+		SetExecutePriority(priority);
+	}
+
+	virtual void Trigger(SCA_LogicManager *logicmgr)
+	{
+		m_log.push_back(GetName());
+	}
+
+	virtual EXP_Value *GetReplica()
+	{
+		return nullptr;
+	}
+};
+
+/// Logic manager with the event manager of the property sensors.
+class TestLogic
+{
+public:
+	SCA_LogicManager m_logicmgr;
+	SCA_BasicEventManager *m_eventmgr;
+	std::vector<std::string> m_log;
+	double m_time = 0.0;
+
+	TestLogic()
+	{
+		m_eventmgr = new SCA_BasicEventManager(&m_logicmgr);
+		m_logicmgr.RegisterEventManager(m_eventmgr);
+	}
+
+	/// Link a sensor to a new controller in the active state of the object.
+	TestController *Link(SCA_IObject *obj, SCA_ISensor *sensor)
+	{
+		TestController *controller = new TestController(obj, "controller", 0, m_log);
+		controller->SetState(1);
+		m_logicmgr.RegisterToSensor(controller, sensor);
+		controller->ApplyState(1);
+		return controller;
+	}
+
+	/// Evaluate the sensors and execute the triggered controllers, return the number of executed controllers.
+	unsigned int NextFrame()
+	{
+		m_log.clear();
+		m_time += 1.0 / 60.0;
+		m_logicmgr.BeginFrame(m_time, 1.0 / 60.0);
+		m_logicmgr.EndFrame();
+		return m_log.size();
+	}
+};
+
+}  // namespace
+
+/* The sensor is triggered by the modifications of its property, without looking it up between them. */
+TEST(logic_manager, PropertySensorModified)
+{
+	TestLogic logic;
+	TestObject *obj = new TestObject();
+	obj->SetProperty("prop", new EXP_FloatValue(0.0f));
+
+	SCA_PropertySensor *sensor = new SCA_PropertySensor(logic.m_eventmgr, obj, "prop", "1.5", "",
+	                                                    SCA_PropertySensor::KX_PROPSENSOR_EQUAL);
+	TestController *controller = logic.Link(obj, sensor);
+
+	// The first evaluation checks the property.
+	EXPECT_EQ(0, logic.NextFrame());
+	EXPECT_FALSE(sensor->IsPositiveTrigger());
+
+	// The value is unchanged, the property isn't checked again.
+	const unsigned int lookups = obj->m_lookups;
+	for (unsigned int i = 0; i < 10; ++i) {
+		EXPECT_EQ(0, logic.NextFrame());
+	}
+	EXPECT_EQ(lookups, obj->m_lookups);
+
+	// Setting the value of the property triggers the sensor.
+	EXP_FloatValue *prop = static_cast<EXP_FloatValue *>(obj->GetProperty("prop"));
+	prop->SetFloat(1.5f);
+	EXPECT_EQ(1, logic.NextFrame());
+	EXPECT_TRUE(sensor->IsPositiveTrigger());
+	EXPECT_EQ(0, logic.NextFrame());
+
+	prop->SetFloat(2.0f);
+	EXPECT_EQ(1, logic.NextFrame());
+	EXPECT_FALSE(sensor->IsPositiveTrigger());
+
+	// Replacing the property triggers the sensor and the new property is observed.
+	obj->SetProperty("prop", new EXP_FloatValue(1.5f));
+	EXPECT_EQ(1, logic.NextFrame());
+	EXPECT_TRUE(sensor->IsPositiveTrigger());
+
+	obj->SetProperty("prop", new EXP_IntValue(3));
+	EXPECT_EQ(1, logic.NextFrame());
+	EXPECT_FALSE(sensor->IsPositiveTrigger());
+
+	const unsigned int replacedLookups = obj->m_lookups;
+	EXPECT_EQ(0, logic.NextFrame());
+	EXPECT_EQ(replacedLookups, obj->m_lookups);
+
+	controller->ApplyState(0);
+	controller->Release();
+	sensor->Release();
+	obj->Release();
+}
+
+/* The changed mode is triggered by each modification and falls back to false on the next frame. */
+TEST(logic_manager, PropertySensorChanged)
+{
+	TestLogic logic;
+	TestObject *obj = new TestObject();
+	obj->SetProperty("prop", new EXP_FloatValue(0.0f));
+
+	SCA_PropertySensor *sensor = new SCA_PropertySensor(logic.m_eventmgr, obj, "prop", "", "",
+	                                                    SCA_PropertySensor::KX_PROPSENSOR_CHANGED);
+	TestController *controller = logic.Link(obj, sensor);
+
+	EXPECT_EQ(0, logic.NextFrame());
+
+	EXP_FloatValue *prop = static_cast<EXP_FloatValue *>(obj->GetProperty("prop"));
+	for (unsigned int i = 1; i < 4; ++i) {
+		prop->SetFloat((float)i);
+		EXPECT_EQ(1, logic.NextFrame());
+		EXPECT_TRUE(sensor->IsPositiveTrigger());
+		EXPECT_EQ(1, logic.NextFrame());
+		EXPECT_FALSE(sensor->IsPositiveTrigger());
+		EXPECT_EQ(0, logic.NextFrame());
+	}
+
+	controller->ApplyState(0);
+	controller->Release();
+	sensor->Release();
+	obj->Release();
+}
+
+/* A controller triggered several times in a frame is executed once, the controllers are executed
+ * bookmarked first, then by object in order of first trigger and by priority. */
+TEST(logic_manager, TriggeredControllers)
+{
+	TestLogic logic;
+	SCA_IObject *obj1 = new TestObject();
+	SCA_IObject *obj2 = new TestObject();
+
+	std::vector<TestController *> controllers = {
+		new TestController(obj1, "A", 2, logic.m_log),
+		new TestController(obj1, "B", 0, logic.m_log),
+		new TestController(obj1, "C", 1, logic.m_log),
+		new TestController(obj2, "D", 0, logic.m_log),
+		new TestController(obj2, "E", 5, logic.m_log)
+	};
+	controllers[4]->SetBookmark(true);
+
+	for (unsigned int i : {0, 3, 0, 2, 1, 4, 3, 0, 4}) {
+		logic.m_logicmgr.AddTriggeredController(controllers[i], nullptr);
+	}
+	logic.NextFrame();
+	EXPECT_EQ(std::vector<std::string>({"E", "B", "C", "A", "D"}), logic.m_log);
+
+	// The queue is empty after the execution, the controllers can be triggered again.
+	logic.NextFrame();
+	EXPECT_TRUE(logic.m_log.empty());
+
+	logic.m_logicmgr.AddTriggeredController(controllers[0], nullptr);
+	logic.m_logicmgr.AddTriggeredController(controllers[0], nullptr);
+	logic.NextFrame();
+	EXPECT_EQ(std::vector<std::string>({"A"}), logic.m_log);
+
+	// A removed controller is not executed.
+	logic.m_logicmgr.AddTriggeredController(controllers[2], nullptr);
+	logic.m_logicmgr.AddTriggeredController(controllers[1], nullptr);
+	logic.m_logicmgr.RemoveController(controllers[2]);
+	logic.NextFrame();
+	EXPECT_EQ(std::vector<std::string>({"B"}), logic.m_log);
+
+	for (TestController *controller : controllers) {
+		controller->Release();
+	}
+	obj1->Release();
+	obj2->Release();
+}
@@ -0,0 +1,161 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "SG_Node.h"
+#include "KX_NodeRelationships.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define NUM_ROOTS 300
+#define MAX_CHILDREN 4
+#define MAX_DEPTH 4
+#define NUM_FRAMES 20
+
+namespace {
+
+/// Normal parent relation updated on the main thread, as a bone parent.
+class SerialParentRelation : public KX_NormalParentRelation
+{
+public:
+	virtual SG_ParentRelation *NewCopy()
+	{
+		return new SerialParentRelation();
+	}
+
+	virtual bool IsThreadSafe()
+	{
+		return false;
+	}
+};
+
+/// Scene graph scheduling the modified nodes and recording the transform callbacks.
+class TestGraph
+{
+public:
+	SG_QList m_head;
+	std::vector<SG_Node *> m_nodes;
+	/// Index of the nodes in the transform callback order.
+	std::vector<intptr_t> m_updated;
+
+	static bool ScheduleFunc(SG_Node *node, void *, void *clientinfo)
+	{
+		return node->Schedule(((TestGraph *)clientinfo)->m_head);
+	}
+
+	static void UpdateFunc(SG_Node *, void *clientobj, void *clientinfo)
+	{
+		((TestGraph *)clientinfo)->m_updated.push_back((intptr_t)clientobj);
+	}
+
+	/// Build the same random hierarchies for a same seed.
+	TestGraph(unsigned int seed)
+	{
+		std::mt19937 rng(seed);
+		SG_Callbacks callbacks(nullptr, nullptr, UpdateFunc, ScheduleFunc, nullptr);
+
+		for (unsigned int i = 0; i < NUM_ROOTS; ++i) {
+			AddNode(rng, callbacks, nullptr, 0);
+		}
+	}
+
+	~TestGraph()
+	{
+		// Unschedule the nodes before freeing them.
+		while (SG_Node::GetNextScheduled(m_head)) {
+		}
+
+		for (SG_Node *node : m_nodes) {
+			delete node;
+		}
+	}
+
+	/// Modify randomly the local transform of some nodes.
+	void Modify(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		for (SG_Node *node : m_nodes) {
+			if (rng() % 8 == 0) {
+				node->SetLocalPosition(MT_Vector3(dist(rng), dist(rng), dist(rng)));
+				node->SetLocalOrientation(MT_Matrix3x3(MT_Vector3(dist(rng), dist(rng), dist(rng))));
+			}
+		}
+	}
+
+	void UpdateSerial(double time)
+	{
+		SG_Node *node;
+		while ((node = SG_Node::GetNextScheduled(m_head)) != nullptr) {
+			node->UpdateWorldData(time);
+		}
+	}
+
+	void UpdateParallel(double time)
+	{
+		SG_Node::UpdateScheduledWorldDataParallel(m_head, time);
+	}
+
+private:
+	void AddNode(std::mt19937& rng, SG_Callbacks& callbacks, SG_Node *parent, unsigned int depth)
+	{
+		SG_Node *node = new SG_Node((void *)(intptr_t)m_nodes.size(), this, callbacks);
+		m_nodes.push_back(node);
+
+		if (parent) {
+			parent->AddChild(node);
+			node->SetFamilly(parent->GetFamilly());
+		}
+
+		std::uniform_real_distribution<float> dist(0.5f, 1.5f);
+		node->SetLocalScale(MT_Vector3(dist(rng), dist(rng), dist(rng)));
+		node->SetParentRelation((rng() % 10 == 0) ? new SerialParentRelation() : new KX_NormalParentRelation());
+
+		if (depth < MAX_DEPTH) {
+			for (unsigned int i = 0, num = rng() % (MAX_CHILDREN + 1); i < num; ++i) {
+				AddNode(rng, callbacks, node, depth + 1);
+			}
+		}
+	}
+};
+
+}  // namespace
+
+/* Update the same random hierarchies with the serial and the parallel updates:
+ * the world transforms and the transform callback order must be identical. */
+TEST(scene_graph, ParallelUpdateEquivalence)
+{
+	TestGraph serial(42);
+	TestGraph parallel(42);
+	ASSERT_EQ(serial.m_nodes.size(), parallel.m_nodes.size());
+
+	std::mt19937 serialRng(7);
+	std::mt19937 parallelRng(7);
+
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame) {
+		const double time = frame / 60.0;
+
+		serial.UpdateSerial(time);
+		parallel.UpdateParallel(time);
+
+		EXPECT_EQ(serial.m_updated, parallel.m_updated) << "frame " << frame;
+		for (unsigned int i = 0, size = serial.m_nodes.size(); i < size; ++i) {
+			const SG_Node *node1 = serial.m_nodes[i];
+			const SG_Node *node2 = parallel.m_nodes[i];
+			for (unsigned short j = 0; j < 3; ++j) {
+				EXPECT_EQ(node1->GetWorldPosition()[j], node2->GetWorldPosition()[j]);
+				EXPECT_EQ(node1->GetWorldScaling()[j], node2->GetWorldScaling()[j]);
+				for (unsigned short k = 0; k < 3; ++k) {
+					EXPECT_EQ(node1->GetWorldOrientation()[j][k], node2->GetWorldOrientation()[j][k]);
+				}
+			}
+		}
+
+		serial.m_updated.clear();
+		parallel.m_updated.clear();
+
+		serial.Modify(serialRng);
+		parallel.Modify(parallelRng);
+	}
+}
@@ -0,0 +1,38 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "VT_image_convert_test_util.h"
+
+extern "C" {
+#include "PIL_time_utildefines.h"
+}
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/* Convert a full HD frame with a color matrix and a blue screen, per pixel and by rows. */
+TEST(image_convert, ConvertPerformance)
+{
+	std::mt19937 rng(42);
+	FilterChain chain({new FilterRGB24(), random_color(rng), random_blue_screen(rng)});
+	short size[2] = {1920, 1080};
+	std::vector<unsigned char> src = random_rgb(rng, size);
+	std::vector<unsigned int> expected(size[0] * size[1]);
+	TestImage image(size[0], size[1], true);
+
+	TIMEIT_START(pixels);
+	for (unsigned int i = 0; i < 10; ++i) {
+		reference_convert(chain.GetLast(), src.data(), size, expected.data(), size, true);
+	}
+	TIMEIT_END(pixels);
+
+	TIMEIT_START(rows);
+	for (unsigned int i = 0; i < 10; ++i) {
+		image.Convert(chain.GetLast(), src.data(), size);
+	}
+	TIMEIT_END(rows);
+
+	EXPECT_TRUE(std::equal(expected.begin(), expected.end(), image.GetBuffer()));
+}
@@ -0,0 +1,72 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "VT_image_convert_test_util.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Convert a random source with a filter chain and compare to the per pixel reference conversion.
+void expect_convert_equal(FilterChain& chain, short srcWidth, short srcHeight, short width, short height)
+{
+	std::mt19937 rng(42);
+	short srcSize[2] = {srcWidth, srcHeight};
+	short size[2] = {width, height};
+	std::vector<unsigned char> src = random_rgb(rng, srcSize);
+
+	for (bool flip : {false, true}) {
+		TestImage image(width, height, flip);
+		image.Convert(chain.GetLast(), src.data(), srcSize);
+
+		std::vector<unsigned int> expected(width * height);
+		reference_convert(chain.GetLast(), src.data(), srcSize, expected.data(), size, flip);
+
+		const unsigned int *buffer = image.GetBuffer();
+		for (unsigned int i = 0, count = expected.size(); i < count; ++i) {
+			ASSERT_EQ(expected[i], buffer[i]) << "pixel " << i % width << " " << i / width << (flip ? " flipped" : "");
+		}
+	}
+}
+
+}  // namespace
+
+/* The source filter only, no row filter. */
+TEST(image_convert, Source)
+{
+	FilterChain chain({new FilterRGB24()});
+	// Large enough to be converted in parallel, with an incomplete last task.
+	expect_convert_equal(chain, 640, 487, 640, 487);
+	expect_convert_equal(chain, 37, 23, 37, 23);
+}
+
+/* All the filters after the source filter are applied by rows, with the SSE2 kernels
+ * of the blue screen and the color matrix on rows of any width. The color matrix is last
+ * to keep the alpha of the blue screen in its result. */
+TEST(image_convert, RowFilters)
+{
+	std::mt19937 rng(42);
+	FilterChain chain({new FilterRGB24(), random_blue_screen(rng), random_level(rng), new FilterGray(), random_color(rng)});
+	expect_convert_equal(chain, 640, 487, 640, 487);
+	expect_convert_equal(chain, 37, 23, 37, 23);
+}
+
+/* Only the filters after the last filter depending on the position are applied by rows. */
+TEST(image_convert, PositionFilter)
+{
+	std::mt19937 rng(42);
+	FilterChain chain({new FilterRGB24(), random_color(rng), new FilterPosition(), random_level(rng), random_blue_screen(rng)});
+	expect_convert_equal(chain, 640, 487, 640, 487);
+}
+
+/* Scaling down picks the source rows and columns, the rows are converted in parallel when the
+ * scaled image is large enough. */
+TEST(image_convert, Scale)
+{
+	std::mt19937 rng(42);
+	FilterChain chain({new FilterRGB24(), random_color(rng), random_blue_screen(rng)});
+	expect_convert_equal(chain, 1280, 720, 512, 512);
+	expect_convert_equal(chain, 100, 75, 64, 64);
+}
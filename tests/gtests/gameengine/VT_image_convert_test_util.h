@@ -0,0 +1,175 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_VT_IMAGE_CONVERT_TEST_UTIL_H__
+#define __BLENDER_TESTING_VT_IMAGE_CONVERT_TEST_UTIL_H__
+
+#include "ImageBase.h"
+#include "FilterBlueScreen.h"
+#include "FilterColor.h"
+#include "FilterSource.h"
+
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Filter depending on the pixel position, it can't be applied by rows.
+class FilterPosition : public FilterBase
+{
+protected:
+	virtual unsigned int filter(unsigned char *src, short x, short y,
+	                            short *size, unsigned int pixSize, unsigned int val = 0)
+	{
+		return val ^ ((x * 7 + y * 13) & 0xFF);
+	}
+};
+
+/// Chain of filters linked without python objects, the first filter converts the source pixels.
+class FilterChain
+{
+public:
+	std::vector<FilterBase *> m_filters;
+	std::vector<PyFilter> m_links;
+
+	FilterChain(std::initializer_list<FilterBase *> filters)
+		:m_filters(filters),
+		m_links(filters.size())
+	{
+		for (unsigned int i = 1, size = m_filters.size(); i < size; ++i) {
+			m_links[i - 1].m_filter = m_filters[i - 1];
+			m_filters[i]->setPrevious(&m_links[i - 1], false);
+		}
+	}
+
+	~FilterChain()
+	{
+		for (FilterBase *filter : m_filters) {
+			filter->setPrevious(nullptr, false);
+			delete filter;
+		}
+	}
+
+	FilterBase& GetLast()
+	{
+		return *m_filters.back();
+	}
+};
+
+/// Image converting a source buffer directly.
+class TestImage : public ImageBase
+{
+public:
+	TestImage(short width, short height, bool flip)
+	{
+		init(width, height);
+		setFlip(flip);
+	}
+
+	void Convert(FilterBase& filter, unsigned char *src, short *srcSize)
+	{
+		convImage(filter, src, srcSize);
+	}
+
+	const unsigned int *GetBuffer() const
+	{
+		return m_image;
+	}
+};
+
+/// The conversion before the rows were converted in parallel: the whole filter chain is applied per pixel.
+void reference_convert(FilterBase& filter, unsigned char *srcBuff, short *srcSize, unsigned int *dstBuff,
+		short *size, bool flip)
+{
+	const unsigned int pixSize = filter.firstPixelSize();
+	if (srcSize[0] == size[0] && srcSize[1] == size[1]) {
+		for (short j = 0; j < size[1]; ++j) {
+			const short y = flip ? size[1] - j - 1 : j;
+			for (short x = 0; x < size[0]; ++x, ++dstBuff) {
+				*dstBuff = filter.convert(srcBuff + (y * srcSize[0] + x) * pixSize, x, y, srcSize, pixSize);
+			}
+		}
+		return;
+	}
+
+	// Nearest neighbor scaling.
+	int accHeight = srcSize[1] >> 1;
+	std::vector<short> rows;
+	for (short y = 0; y < srcSize[1]; ++y) {
+		accHeight += size[1];
+		if (accHeight >= srcSize[1]) {
+			accHeight -= srcSize[1];
+			rows.push_back(y);
+		}
+	}
+	if (flip) {
+		for (short& y : rows) {
+			y = srcSize[1] - y - 1;
+		}
+	}
+
+	for (short y : rows) {
+		int accWidth = srcSize[0] >> 1;
+		for (short x = 0; x < srcSize[0]; ++x) {
+			accWidth += size[0];
+			if (accWidth >= srcSize[0]) {
+				accWidth -= srcSize[0];
+				*dstBuff++ = filter.convert(srcBuff + (y * srcSize[0] + x) * pixSize, x, y, srcSize, pixSize);
+			}
+		}
+	}
+}
+
+std::vector<unsigned char> random_rgb(std::mt19937& rng, short *size)
+{
+	std::uniform_int_distribution<int> value(0, 255);
+	std::vector<unsigned char> src(size[0] * size[1] * 3);
+	for (unsigned char& component : src) {
+		component = value(rng);
+	}
+	return src;
+}
+
+FilterColor *random_color(std::mt19937& rng)
+{
+	std::uniform_int_distribution<int> coefficient(-512, 512);
+	std::uniform_int_distribution<int> bias(-4096, 4096);
+	ColorMatrix matrix;
+	for (unsigned short i = 0; i < 4; ++i) {
+		for (unsigned short j = 0; j < 4; ++j) {
+			matrix[i][j] = coefficient(rng);
+		}
+		matrix[i][4] = bias(rng);
+	}
+
+	FilterColor *filter = new FilterColor();
+	filter->setMatrix(matrix);
+	return filter;
+}
+
+FilterLevel *random_level(std::mt19937& rng)
+{
+	std::uniform_int_distribution<int> value(0, 255);
+	ColorLevel levels;
+	for (unsigned short i = 0; i < 4; ++i) {
+		levels[i][0] = value(rng);
+		levels[i][1] = value(rng);
+	}
+
+	FilterLevel *filter = new FilterLevel();
+	filter->setLevels(levels);
+	return filter;
+}
+
+FilterBlueScreen *random_blue_screen(std::mt19937& rng)
+{
+	std::uniform_int_distribution<int> value(0, 255);
+	FilterBlueScreen *filter = new FilterBlueScreen();
+	filter->setColor(value(rng), value(rng), value(rng));
+	filter->setLimits(60, 200);
+	return filter;
+}
+
+}  // namespace
+
+#endif  // __BLENDER_TESTING_VT_IMAGE_CONVERT_TEST_UTIL_H__
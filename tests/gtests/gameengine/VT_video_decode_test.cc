@@ -0,0 +1,79 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "VideoFFmpeg.h"
+
+extern "C" {
+#include "IMB_imbuf.h"
+#include "PIL_time_utildefines.h"
+}
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+DEFINE_string(video, "", "Video file decoded by the benchmark.");
+DEFINE_int32(video_frames, 1000, "Maximum number of frames decoded by the benchmark.");
+
+namespace {
+
+/// Video giving access to its frame rate and to the last converted frame.
+class TestVideo : public VideoFFmpeg
+{
+public:
+	TestVideo(HRESULT *hRslt)
+		:VideoFFmpeg(hRslt)
+	{
+	}
+
+	double GetFrameRate()
+	{
+		return actFrameRate();
+	}
+
+	long GetLastFrame() const
+	{
+		return m_lastFrame;
+	}
+};
+
+}  // namespace
+
+/* Decode and convert the frames of a video without display, each frame is asked at its own time
+ * instead of the real time, so the frames are processed as fast as the cache thread decodes them.
+ * The video is given with --video, the benchmark is skipped without it. */
+TEST(video_ffmpeg, DecodeThroughput)
+{
+	if (FLAGS_video.empty()) {
+		printf("No video given with --video, the benchmark is skipped.\n");
+		return;
+	}
+
+	IMB_ffmpeg_init();
+
+	HRESULT hRslt;
+	TestVideo video(&hRslt);
+	std::vector<char> path(FLAGS_video.begin(), FLAGS_video.end());
+	path.push_back('\0');
+	video.openFile(path.data());
+	ASSERT_EQ(SourceReady, video.getStatus()) << FLAGS_video;
+	ASSERT_TRUE(video.play());
+
+	const double frameRate = video.GetFrameRate();
+	unsigned int numFrames = 0;
+
+	TIMEIT_START(decode);
+	for (long frame = 0; frame < FLAGS_video_frames && video.getStatus() == SourcePlaying; ++frame) {
+		video.refresh();
+		// Ask for the middle of the frame to not depend on the rounding of the time.
+		if (video.getImage(0, (frame + 0.5) / frameRate, false) && video.GetLastFrame() == frame) {
+			++numFrames;
+		}
+	}
+	printf("%u frames of %dx%d, %.1f frames per second\n", numFrames, video.getSize()[0], video.getSize()[1],
+	       numFrames / TIMEIT_VALUE(decode));
+	TIMEIT_END(decode);
+
+	EXPECT_GT(numFrames, 0u);
+}
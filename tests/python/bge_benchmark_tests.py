@@ -0,0 +1,414 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Game engine benchmark scenarios.
+
+A scenario builds a scene, saves it in a temporary file and runs blenderplayer
+on it with --benchmark: the frames are proceeded on a fixed time step without
+drawing and the frame times per profiling category are written to a json file.
+The median and 99th percentile times are printed, the test fails if the player
+fails or doesn't write the frame times. The stream scenarios also check the
+state their game scripts write. The physics scenarios run the same scene with the
+physics stepped on the main thread and pipelined with the following stages.
+
+The player opens a window, the scenarios are added to the tests only with
+WITH_GAMEENGINE_BENCHMARKS.
+
+Example:
+  ./blender.bin --background --factory-startup \
+      --python tests/python/bge_benchmark_tests.py -- \
+      --blenderplayer ./blenderplayer --scenario spawn_pool
+"""
+
+import bpy
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+
+# Objects kept alive by the spawn scenarios.
+SPAWN_MAX_OBJECTS = 400
+# Objects added and removed each frame by the spawn scenarios.
+SPAWN_PER_FRAME = 20
+
+SPAWN_SCRIPT = """
+from bge import logic
+import random
+
+scene = logic.getCurrentScene()
+owner = logic.getCurrentController().owner
+
+if "objects" not in owner:
+    owner["objects"] = []
+    scene.setSpawnPoolSize(scene.objectsInactive["Projectile"], %(pool_size)d)
+
+objects = owner["objects"]
+for i in range(%(spawn_per_frame)d):
+    ob = scene.addObject("Projectile", owner)
+    ob.setLinearVelocity((random.uniform(-5.0, 5.0), random.uniform(-5.0, 5.0), random.uniform(0.0, 10.0)))
+    objects.append(ob)
+
+while len(objects) > %(max_objects)d:
+    objects.pop(0).endObject()
+"""
+
+# Side of the grid of objects using levels of detail, enough visible objects to select the levels in parallel.
+LOD_GRID = 64
+# Distances of the second and third levels of detail.
+LOD_DISTANCES = (15.0, 30.0)
+
+LOD_CAMERA_SCRIPT = """
+from bge import logic
+import math
+
+owner = logic.getCurrentController().owner
+owner["time"] = owner.get("time", 0) + 1
+owner.worldPosition.y = %(amplitude)f * math.sin(owner["time"] * 0.02)
+"""
+
+# Side of the pile of rigid bodies of the physics scenarios.
+PHYSICS_GRID = 12
+PHYSICS_LAYERS = 8
+
+# Objects and materials of the library loaded by the stream scenarios.
+STREAM_OBJECTS = 200
+STREAM_MATERIALS = 8
+
+# Load the library in the current scene, one merge step per frame, and write the progress seen per frame.
+STREAM_SCRIPT = """
+from bge import logic
+import json
+
+scene = logic.getCurrentScene()
+owner = logic.getCurrentController().owner
+
+if "status" not in owner:
+    logic.setLibLoadStreamBudget(0.0)
+    owner["objects"] = len(scene.objects)
+    owner["progress"] = []
+    owner["status"] = logic.LibLoad(%(library)r, "Scene", stream=True)
+elif "done" not in owner:
+    status = owner["status"]
+    owner["progress"].append(status.progress)
+    if status.finished:
+        owner["done"] = True
+        with open(%(result)r, "w") as f:
+            json.dump({"progress": owner["progress"], "objects": len(scene.objects) - owner["objects"]}, f)
+"""
+
+# Load the library in an overlay scene and remove this scene in the middle of the merge steps.
+STREAM_REMOVE_SCRIPT = """
+from bge import logic
+import json
+
+owner = logic.getCurrentController().owner
+owner["frame"] = owner.get("frame", 0) + 1
+
+if owner["frame"] == 1:
+    logic.setLibLoadStreamBudget(0.0)
+    logic.addScene("Target", True)
+elif owner["frame"] == 2:
+    owner["status"] = logic.LibLoad(%(library)r, "Scene", scene=logic.getSceneList()["Target"], stream=True)
+elif "removed" not in owner:
+    status = owner["status"]
+    if 0.89 < status.progress < 1.0:
+        logic.getSceneList()["Target"].end()
+        owner["removed"] = status.progress
+elif "done" not in owner:
+    owner["done"] = True
+    with open(%(result)r, "w") as f:
+        json.dump({"progress": owner["removed"], "finished": owner["status"].finished,
+                   "scenes": [scene.name for scene in logic.getSceneList()]}, f)
+"""
+
+
+def layers(index):
+    return [i == index for i in range(20)]
+
+
+def clear_scene():
+    scene = bpy.context.scene
+    for ob in list(scene.objects):
+        scene.objects.unlink(ob)
+
+    bpy.ops.object.camera_add(location=(0.0, -40.0, 20.0), rotation=(1.1, 0.0, 0.0))
+    scene.camera = bpy.context.object
+
+    return scene
+
+
+def add_python_logic(ob, name, code):
+    """Run a script every frame on an object."""
+    text = bpy.data.texts.new(name)
+    text.from_string(code)
+
+    bpy.context.scene.objects.active = ob
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+    bpy.ops.logic.controller_add(type='PYTHON', object=ob.name)
+
+    sensor = ob.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+    controller = ob.game.controllers[-1]
+    controller.mode = 'SCRIPT'
+    controller.text = text
+    sensor.link(controller)
+
+
+def build_spawn(pool_size):
+    """Add and remove rigid bodies every frame, with or without the spawn pool."""
+    clear_scene()
+
+    bpy.ops.mesh.primitive_plane_add(radius=50.0)
+    bpy.context.object.game.physics_type = 'STATIC'
+
+    bpy.ops.mesh.primitive_cube_add(radius=0.25, layers=layers(19))
+    projectile = bpy.context.object
+    projectile.name = "Projectile"
+    projectile.game.physics_type = 'RIGID_BODY'
+
+    bpy.ops.object.empty_add(location=(0.0, 0.0, 2.0))
+    add_python_logic(bpy.context.object, "spawn.py", SPAWN_SCRIPT % {
+        "pool_size": pool_size,
+        "spawn_per_frame": SPAWN_PER_FRAME,
+        "max_objects": SPAWN_MAX_OBJECTS,
+    })
+
+
+def build_lod():
+    """Move the camera over a grid of objects using three levels of detail, the levels change every frame."""
+    scene = clear_scene()
+    add_python_logic(scene.camera, "lod_camera.py", LOD_CAMERA_SCRIPT % {"amplitude": LOD_GRID})
+
+    levels = []
+    for subdivisions in (4, 2, 1):
+        bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=subdivisions, size=0.8, layers=layers(19))
+        levels.append(bpy.context.object)
+
+    base = levels[0].copy()
+    base.layers = layers(0)
+    base.game.physics_type = 'NO_COLLISION'
+    scene.objects.link(base)
+    scene.objects.active = base
+    for level, distance in zip(levels[1:], LOD_DISTANCES):
+        bpy.ops.object.lod_add()
+        lod = base.lod_levels[-1]
+        lod.object = level
+        lod.distance = distance
+
+    for i in range(1, LOD_GRID * LOD_GRID):
+        ob = base.copy()
+        ob.location = ((i % LOD_GRID) * 2.0 - LOD_GRID, (i // LOD_GRID) * 2.0, 0.0)
+        scene.objects.link(ob)
+    base.location = (-LOD_GRID, 0.0, 0.0)
+
+
+def build_physics(pipelined):
+    """Drop a pile of rigid bodies on a plane, the pile keeps colliding during the benchmark."""
+    clear_scene()
+
+    bpy.ops.mesh.primitive_plane_add(radius=50.0)
+    bpy.context.object.game.physics_type = 'STATIC'
+
+    bpy.ops.mesh.primitive_cube_add(radius=0.4)
+    base = bpy.context.object
+    base.game.physics_type = 'RIGID_BODY'
+
+    scene = bpy.context.scene
+    for i in range(PHYSICS_GRID * PHYSICS_GRID * PHYSICS_LAYERS):
+        ob = base if i == 0 else base.copy()
+        x, y, z = i % PHYSICS_GRID, (i // PHYSICS_GRID) % PHYSICS_GRID, i // (PHYSICS_GRID * PHYSICS_GRID)
+        # Shift the layers to make the pile collapse.
+        ob.location = (x - PHYSICS_GRID * 0.5 + z * 0.3, y - PHYSICS_GRID * 0.5, z * 1.0 + 1.0)
+        if i:
+            scene.objects.link(ob)
+
+    def check(times):
+        # The worker thread time is only measured when the physics is pipelined.
+        stepped = times["categories"]["Physics (async)"]["max"] > 0.0
+        if stepped != pipelined:
+            raise Exception("the physics is %s pipelined" % ("not" if pipelined else "unexpectedly"))
+
+    return check
+
+
+def build_stream_library(outdir):
+    """Save a library of objects sharing a few materials, the streamed libload merges one material per frame."""
+    scene = bpy.context.scene
+    for ob in list(scene.objects):
+        scene.objects.unlink(ob)
+
+    bpy.ops.mesh.primitive_cube_add(radius=0.25)
+    base = bpy.context.object
+    meshes = []
+    for i in range(STREAM_MATERIALS):
+        mesh = base.data.copy()
+        mesh.materials.append(bpy.data.materials.new("Stream%d" % i))
+        meshes.append(mesh)
+
+    base.data = meshes[0]
+    for i in range(1, STREAM_OBJECTS):
+        ob = base.copy()
+        ob.data = meshes[i % STREAM_MATERIALS]
+        ob.location = ((i % 20) - 10.0, (i // 20) - 5.0, 0.0)
+        scene.objects.link(ob)
+
+    library = os.path.join(outdir, "stream_library.blend")
+    bpy.ops.wm.save_as_mainfile(filepath=library, copy=True)
+    return library
+
+
+def read_result(path):
+    if not os.path.exists(path):
+        raise Exception("the libload didn't finish during the benchmark")
+    with open(path) as f:
+        return json.load(f)
+
+
+def build_stream(outdir):
+    """Stream a library in the current scene and check the merge is spread over frames."""
+    library = build_stream_library(outdir)
+    result = os.path.join(outdir, "stream_result.json")
+
+    clear_scene()
+    bpy.ops.object.empty_add()
+    add_python_logic(bpy.context.object, "stream.py", STREAM_SCRIPT % {"library": library, "result": result})
+
+    def check(times):
+        data = read_result(result)
+        if data["objects"] != STREAM_OBJECTS:
+            raise Exception("%d objects merged, %d expected" % (data["objects"], STREAM_OBJECTS))
+        progress = data["progress"]
+        if progress != sorted(progress):
+            raise Exception("the progress decreased: %r" % progress)
+        # The objects, then each material, are merged on their own frame after the conversion.
+        steps = set(value for value in progress if 0.89 < value < 1.0)
+        if len(steps) < STREAM_MATERIALS:
+            raise Exception("the merge took %d frames, at least %d expected" % (len(steps), STREAM_MATERIALS))
+
+    return check
+
+
+def build_stream_remove(outdir):
+    """Remove the scene a library is streamed in before the end of the merge, the libload is then finished."""
+    library = build_stream_library(outdir)
+    result = os.path.join(outdir, "stream_remove_result.json")
+
+    clear_scene()
+    bpy.ops.object.empty_add()
+    add_python_logic(bpy.context.object, "stream_remove.py", STREAM_REMOVE_SCRIPT % {"library": library, "result": result})
+
+    target = bpy.data.scenes.new("Target")
+    camera = bpy.data.objects.new("TargetCamera", bpy.data.cameras.new("TargetCamera"))
+    target.objects.link(camera)
+    target.camera = camera
+
+    def check(times):
+        data = read_result(result)
+        if not data["finished"]:
+            raise Exception("the libload of the removed scene isn't finished")
+        if "Target" in data["scenes"]:
+            raise Exception("the scene isn't removed")
+
+    return check
+
+
+SCENARIOS = {
+    "spawn_no_pool": lambda outdir: build_spawn(0),
+    "spawn_pool": lambda outdir: build_spawn(SPAWN_MAX_OBJECTS),
+    "lod": lambda outdir: build_lod(),
+    "physics": lambda outdir: build_physics(False),
+    "physics_pipelined": lambda outdir: build_physics(True),
+    "stream": build_stream,
+    "stream_remove": build_stream_remove,
+}
+
+# Player arguments of the scenarios comparing an engine option.
+PLAYER_ARGUMENTS = {
+    "physics_pipelined": ("-g", "pipelined_physics", "=", "1"),
+}
+
+
+def run_scenario(blenderplayer, scenario, frames, outdir):
+    # A scenario can return a check of the frame times and of the game state written by the player.
+    check = SCENARIOS[scenario](outdir)
+
+    blendfile = os.path.join(outdir, scenario + ".blend")
+    jsonfile = os.path.join(outdir, scenario + ".json")
+    bpy.ops.wm.save_as_mainfile(filepath=blendfile)
+
+    command = (
+        blenderplayer,
+        "-w", "320", "240", "0", "0",
+        "-g", "benchmark_output", "=", jsonfile,
+        "--benchmark", str(frames),
+    ) + PLAYER_ARGUMENTS.get(scenario, ()) + (
+        blendfile,
+    )
+    proc = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=600)
+    output = proc.stdout.decode("utf8", errors="replace")
+    if proc.returncode or not os.path.exists(jsonfile):
+        print(output)
+        raise Exception("blenderplayer failed on the %r scenario (code %d)" % (scenario, proc.returncode))
+
+    with open(jsonfile) as f:
+        result = json.load(f)
+
+    if result["frames"] != frames:
+        raise Exception("%d frames measured, %d expected" % (result["frames"], frames))
+
+    if check:
+        check(result)
+
+    print("%s: %d frames" % (scenario, frames))
+    for category, times in sorted(result["categories"].items()):
+        print("    %-20s median %8.3f ms    p99 %8.3f ms" % (category, times["median"], times["p99"]))
+
+
+def main():
+    import argparse
+
+    argv = sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []
+
+    parser = argparse.ArgumentParser(description="Run a game engine benchmark scenario with blenderplayer.")
+    parser.add_argument("--blenderplayer", required=True, help="Path of the blenderplayer executable")
+    parser.add_argument("--scenario", required=True, choices=sorted(SCENARIOS.keys()))
+    parser.add_argument("--frames", type=int, default=600, help="Number of frames to measure")
+    parser.add_argument("--outdir", help="Directory where the scene and the frame times are kept")
+    args = parser.parse_args(argv)
+
+    outdir = args.outdir or tempfile.mkdtemp(prefix="bge-benchmark-")
+    try:
+        run_scenario(args.blenderplayer, args.scenario, args.frames, outdir)
+    finally:
+        if not args.outdir:
+            shutil.rmtree(outdir)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except:
+        import traceback
+        traceback.print_exc()
+        sys.exit(1)